@@ -169,6 +169,13 @@ class AtomicOps {
   static void Store(volatile int* i, int value) {
     *i = value;
   }
+  // Stores |new_value| in |*i| if it equals |old_value|. Returns the value
+  // |*i| had before the call.
+  static int CompareAndSwap(volatile int* i, int old_value, int new_value) {
+    return ::InterlockedCompareExchange(reinterpret_cast<volatile LONG*>(i),
+                                        new_value,
+                                        old_value);
+  }
 #else
   static int Increment(volatile int* i) {
     return __sync_add_and_fetch(i, 1);
@@ -184,6 +191,9 @@ class AtomicOps {
     __sync_synchronize();
     *i = value;
   }
+  static int CompareAndSwap(volatile int* i, int old_value, int new_value) {
+    return __sync_val_compare_and_swap(i, old_value, new_value);
+  }
 #endif
 };
 
@@ -120,6 +120,14 @@ TEST(AtomicOpsTest, Simple) {
   EXPECT_EQ(0, value);
 }
 
+TEST(AtomicOpsTest, CompareAndSwap) {
+  int value = 0;
+  EXPECT_EQ(0, AtomicOps::CompareAndSwap(&value, 0, 1));
+  EXPECT_EQ(1, value);
+  EXPECT_EQ(1, AtomicOps::CompareAndSwap(&value, 0, 2));
+  EXPECT_EQ(1, value);
+}
+
 TEST(AtomicOpsTest, Increment) {
   // Create and start lots of threads.
   AtomicOpRunner<IncrementOp> runner(0);
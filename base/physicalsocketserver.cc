@@ -22,6 +22,7 @@
 #include <string.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <sys/time.h>
 #include <sys/select.h>
 #include <unistd.h>
@@ -131,7 +132,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     udp_ = (SOCK_DGRAM == type);
     UpdateLastError();
     if (udp_)
-      enabled_events_ = DE_READ | DE_WRITE;
+      SetEnabledEvents(DE_READ | DE_WRITE);
     return s_ != INVALID_SOCKET;
   }
 
@@ -213,12 +214,12 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
       state_ = CS_CONNECTED;
     } else if (IsBlockingError(GetError())) {
       state_ = CS_CONNECTING;
-      enabled_events_ |= DE_CONNECT;
+      EnableEvents(DE_CONNECT);
     } else {
       return SOCKET_ERROR;
     }
 
-    enabled_events_ |= DE_READ | DE_WRITE;
+    EnableEvents(DE_READ | DE_WRITE);
     return 0;
   }
 
@@ -280,7 +281,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     // We have seen minidumps where this may be false.
     ASSERT(sent <= static_cast<int>(cb));
     if ((sent < 0) && IsBlockingError(GetError())) {
-      enabled_events_ |= DE_WRITE;
+      EnableEvents(DE_WRITE);
     }
     return sent;
   }
@@ -304,7 +305,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     // We have seen minidumps where this may be false.
     ASSERT(sent <= static_cast<int>(length));
     if ((sent < 0) && IsBlockingError(GetError())) {
-      enabled_events_ |= DE_WRITE;
+      EnableEvents(DE_WRITE);
     }
     return sent;
   }
@@ -319,7 +320,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
       LOG(LS_WARNING) << "EOF from socket; deferring close event";
       // Must turn this back on so that the select() loop will notice the close
       // event.
-      enabled_events_ |= DE_READ;
+      EnableEvents(DE_READ);
       SetError(EWOULDBLOCK);
       return SOCKET_ERROR;
     }
@@ -327,7 +328,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     int error = GetError();
     bool success = (received >= 0) || IsBlockingError(error);
     if (udp_ || success) {
-      enabled_events_ |= DE_READ;
+      EnableEvents(DE_READ);
     }
     if (!success) {
       LOG_F(LS_VERBOSE) << "Error = " << error;
@@ -347,7 +348,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     int error = GetError();
     bool success = (received >= 0) || IsBlockingError(error);
     if (udp_ || success) {
-      enabled_events_ |= DE_READ;
+      EnableEvents(DE_READ);
     }
     if (!success) {
       LOG_F(LS_VERBOSE) << "Error = " << error;
@@ -360,7 +361,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     UpdateLastError();
     if (err == 0) {
       state_ = CS_CONNECTING;
-      enabled_events_ |= DE_ACCEPT;
+      EnableEvents(DE_ACCEPT);
 #ifdef _DEBUG
       dbg_addr_ = "Listening @ ";
       dbg_addr_.append(GetLocalAddress().ToString());
@@ -377,7 +378,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     UpdateLastError();
     if (s == INVALID_SOCKET)
       return NULL;
-    enabled_events_ |= DE_ACCEPT;
+    EnableEvents(DE_ACCEPT);
     if (out_addr != NULL)
       SocketAddressFromSockAddrStorage(addr_storage, out_addr);
     return ss_->WrapSocket(s);
@@ -390,7 +391,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     UpdateLastError();
     s_ = INVALID_SOCKET;
     state_ = CS_CLOSED;
-    enabled_events_ = 0;
+    SetEnabledEvents(0);
     if (resolver_) {
       resolver_->Destroy(false);
       resolver_ = NULL;
@@ -465,6 +466,20 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
   SocketServer* socketserver() { return ss_; }
 
  protected:
+  // Dispatchers override this to let the socket server know that the set of
+  // events they are interested in has changed.
+  virtual void SetEnabledEvents(uint8 events) {
+    enabled_events_ = events;
+  }
+
+  void EnableEvents(uint8 events) {
+    SetEnabledEvents(enabled_events_ | events);
+  }
+
+  void DisableEvents(uint8 events) {
+    SetEnabledEvents(enabled_events_ & ~events);
+  }
+
   void OnResolveResult(AsyncResolverInterface* resolver) {
     if (resolver != resolver_) {
       return;
@@ -869,24 +884,24 @@ class SocketDispatcher : public Dispatcher, public PhysicalSocket {
     // Make sure we deliver connect/accept first. Otherwise, consumers may see
     // something like a READ followed by a CONNECT, which would be odd.
     if ((ff & DE_CONNECT) != 0) {
-      enabled_events_ &= ~DE_CONNECT;
+      DisableEvents(DE_CONNECT);
       SignalConnectEvent(this);
     }
     if ((ff & DE_ACCEPT) != 0) {
-      enabled_events_ &= ~DE_ACCEPT;
+      DisableEvents(DE_ACCEPT);
       SignalReadEvent(this);
     }
     if ((ff & DE_READ) != 0) {
-      enabled_events_ &= ~DE_READ;
+      DisableEvents(DE_READ);
       SignalReadEvent(this);
     }
     if ((ff & DE_WRITE) != 0) {
-      enabled_events_ &= ~DE_WRITE;
+      DisableEvents(DE_WRITE);
       SignalWriteEvent(this);
     }
     if ((ff & DE_CLOSE) != 0) {
       // The socket is now dead to us, so stop checking it.
-      enabled_events_ = 0;
+      SetEnabledEvents(0);
       SignalCloseEvent(this, err);
     }
   }
@@ -898,6 +913,14 @@ class SocketDispatcher : public Dispatcher, public PhysicalSocket {
     ss_->Remove(this);
     return PhysicalSocket::Close();
   }
+
+ protected:
+  void SetEnabledEvents(uint8 events) override {
+    if (events == enabled_events_)
+      return;
+    PhysicalSocket::SetEnabledEvents(events);
+    ss_->Update(this);
+  }
 };
 
 class FileDispatcher: public Dispatcher, public AsyncFile {
@@ -937,12 +960,14 @@ class FileDispatcher: public Dispatcher, public AsyncFile {
 
   void set_readable(bool value) override {
     flags_ = value ? (flags_ | DE_READ) : (flags_ & ~DE_READ);
+    ss_->Update(this);
   }
 
   bool writable() override { return (flags_ & DE_WRITE) != 0; }
 
   void set_writable(bool value) override {
     flags_ = value ? (flags_ | DE_WRITE) : (flags_ & ~DE_WRITE);
+    ss_->Update(this);
   }
 
  private:
@@ -1163,14 +1188,50 @@ class Signaler : public EventDispatcher {
   bool *pf_;
 };
 
+#if defined(WEBRTC_USE_EPOLL)
+// Upper bound on the number of ready descriptors returned by one call to
+// epoll_wait(). Any others are picked up by the next call.
+static const size_t kMaxEpollEvents = 128;
+
+static uint32 GetEpollEvents(uint32 ff) {
+  uint32 events = 0;
+  if (ff & (DE_READ | DE_ACCEPT))
+    events |= EPOLLIN;
+  if (ff & (DE_WRITE | DE_CONNECT))
+    events |= EPOLLOUT;
+  return events;
+}
+#endif
+
 PhysicalSocketServer::PhysicalSocketServer()
-    : fWait_(false) {
+    :
+#if defined(WEBRTC_USE_EPOLL)
+      epoll_fd_(INVALID_SOCKET),
+#endif
+      fWait_(false) {
   signal_wakeup_ = new Signaler(this, &fWait_);
 #if defined(WEBRTC_WIN)
   socket_ev_ = WSACreateEvent();
 #endif
 }
 
+#if defined(WEBRTC_USE_EPOLL)
+PhysicalSocketServer::PhysicalSocketServer(PollMode mode)
+    : epoll_fd_(INVALID_SOCKET),
+      fWait_(false) {
+  if (mode == kEpoll) {
+    // The size argument is ignored by current kernels but must be positive.
+    epoll_fd_ = epoll_create(FD_SETSIZE);
+    if (epoll_fd_ == INVALID_SOCKET) {
+      LOG_E(LS_WARNING, EN, errno) << "epoll_create, falling back to select";
+    } else {
+      epoll_events_.resize(kMaxEpollEvents);
+    }
+  }
+  signal_wakeup_ = new Signaler(this, &fWait_);
+}
+#endif
+
 PhysicalSocketServer::~PhysicalSocketServer() {
 #if defined(WEBRTC_WIN)
   WSACloseEvent(socket_ev_);
@@ -1180,6 +1241,11 @@ PhysicalSocketServer::~PhysicalSocketServer() {
 #endif
   delete signal_wakeup_;
   ASSERT(dispatchers_.empty());
+#if defined(WEBRTC_USE_EPOLL)
+  ASSERT(epoll_interest_.empty());
+  if (epoll_fd_ != INVALID_SOCKET)
+    close(epoll_fd_);
+#endif
 }
 
 void PhysicalSocketServer::WakeUp() {
@@ -1233,6 +1299,13 @@ void PhysicalSocketServer::Add(Dispatcher *pdispatcher) {
   if (pos != dispatchers_.end())
     return;
   dispatchers_.push_back(pdispatcher);
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET) {
+    EpollInterest& interest = epoll_interest_[pdispatcher];
+    interest.events = GetEpollEvents(pdispatcher->GetRequestedEvents());
+    UpdateEpoll(pdispatcher, 0, interest.events);
+  }
+#endif
 }
 
 void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
@@ -1256,10 +1329,99 @@ void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
       --**it;
     }
   }
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET) {
+    EpollInterestMap::iterator interest = epoll_interest_.find(pdispatcher);
+    ASSERT(interest != epoll_interest_.end());
+    UpdateEpoll(pdispatcher, interest->second.events, 0);
+    epoll_interest_.erase(interest);
+    // The dispatcher may be deleted right after this call, so drop any event
+    // for it that WaitEpoll() has not delivered yet.
+    for (size_t i = 0; i < epoll_events_.size(); ++i) {
+      if (epoll_events_[i].data.ptr == pdispatcher)
+        epoll_events_[i].data.ptr = NULL;
+    }
+  }
+#endif
+}
+
+void PhysicalSocketServer::Update(Dispatcher *pdispatcher) {
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ == INVALID_SOCKET)
+    return;
+  CritScope cs(&crit_);
+  EpollInterestMap::iterator interest = epoll_interest_.find(pdispatcher);
+  if (interest == epoll_interest_.end() || interest->second.update_pending)
+    return;
+  interest->second.update_pending = true;
+  pending_epoll_updates_.push_back(pdispatcher);
+#endif
 }
 
 #if defined(WEBRTC_POSIX)
+// Translates the readiness of |pdispatcher|'s descriptor into DE_* flags and
+// delivers them. Shared by the select() and epoll() based wait loops.
+static void ProcessEvents(Dispatcher* pdispatcher,
+                          bool readable,
+                          bool writable) {
+  int fd = pdispatcher->GetDescriptor();
+  uint32 ff = 0;
+  int errcode = 0;
+
+  // Reap any error code, which can be signaled through reads or writes.
+  // TODO: Should we set errcode if getsockopt fails?
+  if (readable || writable) {
+    socklen_t len = sizeof(errcode);
+    ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &errcode, &len);
+  }
+
+  // Check readable descriptors. If we're waiting on an accept, signal
+  // that. Otherwise we're waiting for data, check to see if we're
+  // readable or really closed.
+  // TODO: Only peek at TCP descriptors.
+  if (readable) {
+    if (pdispatcher->GetRequestedEvents() & DE_ACCEPT) {
+      ff |= DE_ACCEPT;
+    } else if (errcode || pdispatcher->IsDescriptorClosed()) {
+      ff |= DE_CLOSE;
+    } else {
+      ff |= DE_READ;
+    }
+  }
+
+  // Check writable descriptors. If we're waiting on a connect, detect
+  // success versus failure by the reaped error code.
+  if (writable) {
+    if (pdispatcher->GetRequestedEvents() & DE_CONNECT) {
+      if (!errcode) {
+        ff |= DE_CONNECT;
+      } else {
+        ff |= DE_CLOSE;
+      }
+    } else {
+      ff |= DE_WRITE;
+    }
+  }
+
+  // Tell the descriptor about the event.
+  if (ff != 0) {
+    pdispatcher->OnPreEvent(ff);
+    pdispatcher->OnEvent(ff, errcode);
+  }
+}
+
 bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET) {
+    // Only the wakeup signaler is of interest when not processing I/O, which
+    // is cheaper to poll directly than to mask out of the epoll set.
+    return process_io ? WaitEpoll(cmsWait) : WaitPoll(cmsWait, signal_wakeup_);
+  }
+#endif
+  return WaitSelect(cmsWait, process_io);
+}
+
+bool PhysicalSocketServer::WaitSelect(int cmsWait, bool process_io) {
   // Calculate timing information
 
   struct timeval *ptvWait = NULL;
@@ -1345,51 +1507,11 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
       for (size_t i = 0; i < dispatchers_.size(); ++i) {
         Dispatcher *pdispatcher = dispatchers_[i];
         int fd = pdispatcher->GetDescriptor();
-        uint32 ff = 0;
-        int errcode = 0;
-
-        // Reap any error code, which can be signaled through reads or writes.
-        // TODO: Should we set errcode if getsockopt fails?
-        if (FD_ISSET(fd, &fdsRead) || FD_ISSET(fd, &fdsWrite)) {
-          socklen_t len = sizeof(errcode);
-          ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &errcode, &len);
-        }
-
-        // Check readable descriptors. If we're waiting on an accept, signal
-        // that. Otherwise we're waiting for data, check to see if we're
-        // readable or really closed.
-        // TODO: Only peek at TCP descriptors.
-        if (FD_ISSET(fd, &fdsRead)) {
-          FD_CLR(fd, &fdsRead);
-          if (pdispatcher->GetRequestedEvents() & DE_ACCEPT) {
-            ff |= DE_ACCEPT;
-          } else if (errcode || pdispatcher->IsDescriptorClosed()) {
-            ff |= DE_CLOSE;
-          } else {
-            ff |= DE_READ;
-          }
-        }
-
-        // Check writable descriptors. If we're waiting on a connect, detect
-        // success versus failure by the reaped error code.
-        if (FD_ISSET(fd, &fdsWrite)) {
-          FD_CLR(fd, &fdsWrite);
-          if (pdispatcher->GetRequestedEvents() & DE_CONNECT) {
-            if (!errcode) {
-              ff |= DE_CONNECT;
-            } else {
-              ff |= DE_CLOSE;
-            }
-          } else {
-            ff |= DE_WRITE;
-          }
-        }
-
-        // Tell the descriptor about the event.
-        if (ff != 0) {
-          pdispatcher->OnPreEvent(ff);
-          pdispatcher->OnEvent(ff, errcode);
-        }
+        bool readable = FD_ISSET(fd, &fdsRead);
+        FD_CLR(fd, &fdsRead);
+        bool writable = FD_ISSET(fd, &fdsWrite);
+        FD_CLR(fd, &fdsWrite);
+        ProcessEvents(pdispatcher, readable, writable);
       }
     }
 
@@ -1417,6 +1539,143 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
   return true;
 }
 
+#if defined(WEBRTC_USE_EPOLL)
+void PhysicalSocketServer::UpdateEpoll(Dispatcher* pdispatcher,
+                                       uint32 old_events,
+                                       uint32 new_events) {
+  if (old_events == new_events)
+    return;
+  // Descriptors without any requested events are kept out of the kernel set,
+  // since EPOLLHUP and EPOLLERR are reported regardless of the interest mask
+  // and would otherwise wake us up continuously.
+  int op;
+  if (old_events == 0) {
+    op = EPOLL_CTL_ADD;
+  } else if (new_events == 0) {
+    op = EPOLL_CTL_DEL;
+  } else {
+    op = EPOLL_CTL_MOD;
+  }
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = new_events;
+  event.data.ptr = pdispatcher;
+  if (epoll_ctl(epoll_fd_, op, pdispatcher->GetDescriptor(), &event) != 0) {
+    LOG_E(LS_ERROR, EN, errno) << "epoll_ctl " << op << " failed for fd "
+                               << pdispatcher->GetDescriptor();
+  }
+}
+
+void PhysicalSocketServer::FlushEpollUpdates() {
+  CritScope cr(&crit_);
+  for (size_t i = 0; i < pending_epoll_updates_.size(); ++i) {
+    Dispatcher* pdispatcher = pending_epoll_updates_[i];
+    // Dispatchers removed since they were queued are no longer in the map.
+    EpollInterestMap::iterator interest = epoll_interest_.find(pdispatcher);
+    if (interest == epoll_interest_.end())
+      continue;
+    interest->second.update_pending = false;
+    uint32 events = GetEpollEvents(pdispatcher->GetRequestedEvents());
+    UpdateEpoll(pdispatcher, interest->second.events, events);
+    interest->second.events = events;
+  }
+  pending_epoll_updates_.clear();
+}
+
+bool PhysicalSocketServer::WaitEpoll(int cmsWait) {
+  ASSERT(epoll_fd_ != INVALID_SOCKET);
+  uint32 msStop = 0;
+  if (cmsWait != kForever)
+    msStop = TimeAfter(cmsWait);
+
+  fWait_ = true;
+  while (fWait_) {
+    FlushEpollUpdates();
+
+    int cmsNext = (cmsWait == kForever) ? -1 : std::max(0, TimeUntil(msStop));
+    int n = epoll_wait(epoll_fd_, &epoll_events_[0],
+                       static_cast<int>(epoll_events_.size()), cmsNext);
+    if (n < 0) {
+      if (errno != EINTR) {
+        LOG_E(LS_ERROR, EN, errno) << "epoll";
+        return false;
+      }
+      // Else ignore the error and keep going. If this EINTR was for one of the
+      // signals managed by this PhysicalSocketServer, the
+      // PosixSignalDeliveryDispatcher will be in the signaled state in the next
+      // iteration.
+    } else if (n == 0) {
+      // If timeout, return success
+      return true;
+    } else {
+      // We have signaled descriptors
+      CritScope cr(&crit_);
+      for (int i = 0; i < n; ++i) {
+        const struct epoll_event& event = epoll_events_[i];
+        Dispatcher* pdispatcher = static_cast<Dispatcher*>(event.data.ptr);
+        if (!pdispatcher) {
+          // Removed while handling an earlier event of this batch.
+          continue;
+        }
+        bool readable = (event.events & (EPOLLIN | EPOLLPRI)) != 0;
+        bool writable = (event.events & EPOLLOUT) != 0;
+        if (event.events & (EPOLLERR | EPOLLHUP)) {
+          // select() reports errors as both readable and writable, so do the
+          // same for whichever of those the dispatcher is waiting for.
+          uint32 requested = GetEpollEvents(pdispatcher->GetRequestedEvents());
+          readable = readable || (requested & EPOLLIN) != 0;
+          writable = writable || (requested & EPOLLOUT) != 0;
+        }
+        ProcessEvents(pdispatcher, readable, writable);
+      }
+    }
+  }
+
+  return true;
+}
+
+bool PhysicalSocketServer::WaitPoll(int cmsWait, Dispatcher* pdispatcher) {
+  ASSERT(pdispatcher);
+  uint32 msStop = 0;
+  if (cmsWait != kForever)
+    msStop = TimeAfter(cmsWait);
+
+  fWait_ = true;
+  while (fWait_) {
+    struct pollfd fds;
+    memset(&fds, 0, sizeof(fds));
+    fds.fd = pdispatcher->GetDescriptor();
+    uint32 requested = GetEpollEvents(pdispatcher->GetRequestedEvents());
+    if (requested & EPOLLIN)
+      fds.events |= POLLIN;
+    if (requested & EPOLLOUT)
+      fds.events |= POLLOUT;
+
+    int cmsNext = (cmsWait == kForever) ? -1 : std::max(0, TimeUntil(msStop));
+    int n = poll(&fds, 1, cmsNext);
+    if (n < 0) {
+      if (errno != EINTR) {
+        LOG_E(LS_ERROR, EN, errno) << "poll";
+        return false;
+      }
+    } else if (n == 0) {
+      return true;
+    } else {
+      CritScope cr(&crit_);
+      bool readable = (fds.revents & POLLIN) != 0;
+      bool writable = (fds.revents & POLLOUT) != 0;
+      if (fds.revents & (POLLERR | POLLHUP)) {
+        readable = readable || (fds.events & POLLIN) != 0;
+        writable = writable || (fds.events & POLLOUT) != 0;
+      }
+      ProcessEvents(pdispatcher, readable, writable);
+    }
+  }
+
+  return true;
+}
+#endif  // WEBRTC_USE_EPOLL
+
 static void GlobalSignalHandler(int signum) {
   PosixSignalHandler::Instance()->OnPosixSignalReceived(signum);
 }
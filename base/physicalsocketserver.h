@@ -22,6 +22,16 @@
 typedef int SOCKET;
 #endif // WEBRTC_POSIX
 
+#if defined(WEBRTC_LINUX)
+#define WEBRTC_USE_EPOLL 1
+#endif
+
+#if defined(WEBRTC_USE_EPOLL)
+#include <sys/epoll.h>
+
+#include <map>
+#endif
+
 namespace rtc {
 
 // Event constants for the Dispatcher class.
@@ -58,6 +68,19 @@ class Dispatcher {
 class PhysicalSocketServer : public SocketServer {
  public:
   PhysicalSocketServer();
+#if defined(WEBRTC_USE_EPOLL)
+  // Mechanism used by Wait() to monitor the dispatchers.
+  // kSelect rebuilds the fd_sets from every dispatcher on each iteration and
+  // is limited to FD_SETSIZE descriptors.
+  // kEpoll keeps a persistent interest set that is updated incrementally as
+  // dispatchers are added, removed or change their requested events, so the
+  // cost of a wakeup scales with the number of ready descriptors instead.
+  enum PollMode {
+    kSelect,
+    kEpoll,
+  };
+  explicit PhysicalSocketServer(PollMode mode);
+#endif
   ~PhysicalSocketServer() override;
 
   // SocketFactory:
@@ -76,6 +99,9 @@ class PhysicalSocketServer : public SocketServer {
 
   void Add(Dispatcher* dispatcher);
   void Remove(Dispatcher* dispatcher);
+  // Must be called by an added dispatcher whenever the value returned by its
+  // GetRequestedEvents() changes.
+  void Update(Dispatcher* dispatcher);
 
 #if defined(WEBRTC_POSIX)
   AsyncFile* CreateFile(int fd);
@@ -103,6 +129,35 @@ class PhysicalSocketServer : public SocketServer {
 #if defined(WEBRTC_POSIX)
   static bool InstallSignal(int signum, void (*handler)(int));
 
+  bool WaitSelect(int cms, bool process_io);
+#endif
+#if defined(WEBRTC_USE_EPOLL)
+  struct EpollInterest {
+    EpollInterest() : events(0), update_pending(false) {}
+    // Epoll events currently registered for the dispatcher's descriptor.
+    // Zero means the descriptor is not in the kernel set.
+    uint32 events;
+    // True if the dispatcher is queued in |pending_epoll_updates_|.
+    bool update_pending;
+  };
+  typedef std::map<Dispatcher*, EpollInterest> EpollInterestMap;
+
+  bool WaitEpoll(int cms);
+  bool WaitPoll(int cms, Dispatcher* dispatcher);
+  void FlushEpollUpdates();
+  void UpdateEpoll(Dispatcher* dispatcher, uint32 old_events,
+                   uint32 new_events);
+
+  int epoll_fd_;
+  EpollInterestMap epoll_interest_;
+  // Dispatchers whose requested events changed since the last call to
+  // epoll_wait(). Applied lazily so that a flag that is cleared and set again
+  // while handling an event does not cost any system calls.
+  std::vector<Dispatcher*> pending_epoll_updates_;
+  std::vector<struct epoll_event> epoll_events_;
+#endif
+#if defined(WEBRTC_POSIX)
+
   scoped_ptr<PosixSignalDispatcher> signal_dispatcher_;
 #endif
   DispatcherList dispatchers_;
@@ -0,0 +1,104 @@
+/*
+ *  Copyright 2015 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <sstream>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/physicalsocketserver.h"
+#include "webrtc/base/scopedptrcollection.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace rtc {
+
+#if defined(WEBRTC_USE_EPOLL)
+
+namespace {
+
+// Returns the average time in nanoseconds a Wait() of |server| takes to
+// return after WakeUp(), while |num_sockets| idle UDP sockets are registered.
+// Returns -1 if the sockets could not be created.
+int64 MeasureIdleWaitNs(PhysicalSocketServer* server, size_t num_sockets) {
+  static const int kIterations = 1000;
+  ScopedPtrCollection<AsyncSocket> sockets;
+  for (size_t i = 0; i < num_sockets; ++i) {
+    AsyncSocket* socket = server->CreateAsyncSocket(AF_INET, SOCK_DGRAM);
+    if (!socket)
+      return -1;
+    sockets.PushBack(socket);
+    if (socket->Bind(SocketAddress("127.0.0.1", 0)) != 0)
+      return -1;
+  }
+  // Deliver the initial write events so that every socket is idle.
+  server->Wait(0, true);
+
+  uint64 start = TimeNanos();
+  for (int i = 0; i < kIterations; ++i) {
+    server->WakeUp();
+    EXPECT_TRUE(server->Wait(SocketServer::kForever, true));
+  }
+  return static_cast<int64>(TimeNanos() - start) / kIterations;
+}
+
+void PrintWaitCost(const char* mode, size_t num_sockets, int64 cost_ns) {
+  std::ostringstream trace;
+  trace << num_sockets << "_idle_sockets";
+  webrtc::test::PrintResult(std::string("socket_server_wait_") + mode, "",
+                            trace.str(), static_cast<size_t>(cost_ns), "ns",
+                            false);
+}
+
+}  // namespace
+
+// Compares the cost of a Wait() with select() and epoll() for an increasing
+// number of idle sockets. select() is skipped once the descriptors no longer
+// fit in FD_SETSIZE.
+TEST(PhysicalSocketServerPerformanceTest, IdleSocketsWaitCost) {
+  // Allow enough descriptors for the largest case, if permitted.
+  struct rlimit original_limit;
+  ASSERT_EQ(0, getrlimit(RLIMIT_NOFILE, &original_limit));
+  struct rlimit limit = original_limit;
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+  ASSERT_EQ(0, getrlimit(RLIMIT_NOFILE, &limit));
+
+  const size_t kNumSockets[] = {100, 1000, 10000};
+  for (size_t num_sockets : kNumSockets) {
+    // Descriptors are allocated lowest first, so a fresh one tells how many
+    // are in use. Leave room for the wakeup pipe.
+    int lowest_free_fd = dup(0);
+    close(lowest_free_fd);
+    if (lowest_free_fd + num_sockets + 2 < FD_SETSIZE) {
+      PhysicalSocketServer server(PhysicalSocketServer::kSelect);
+      int64 cost_ns = MeasureIdleWaitNs(&server, num_sockets);
+      EXPECT_GE(cost_ns, 0);
+      PrintWaitCost("select", num_sockets, cost_ns);
+    }
+    if (lowest_free_fd + num_sockets + 2 > limit.rlim_cur) {
+      LOG(LS_WARNING) << "Skipping " << num_sockets << " sockets, "
+                      << "RLIMIT_NOFILE is " << limit.rlim_cur;
+      continue;
+    }
+    PhysicalSocketServer server(PhysicalSocketServer::kEpoll);
+    int64 cost_ns = MeasureIdleWaitNs(&server, num_sockets);
+    EXPECT_GE(cost_ns, 0);
+    PrintWaitCost("epoll", num_sockets, cost_ns);
+  }
+
+  EXPECT_EQ(0, setrlimit(RLIMIT_NOFILE, &original_limit));
+}
+
+#endif  // WEBRTC_USE_EPOLL
+
+}  // namespace rtc
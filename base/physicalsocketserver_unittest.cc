@@ -10,14 +10,20 @@
 
 #include <signal.h>
 #include <stdarg.h>
+#if defined(WEBRTC_POSIX)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
 
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/physicalsocketserver.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/scopedptrcollection.h"
 #include "webrtc/base/socket_unittest.h"
 #include "webrtc/base/testutils.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/test/testsupport/gtest_disable.h"
 
 namespace rtc {
@@ -153,6 +159,134 @@ TEST_F(PhysicalSocketTest, TestGetSetOptionsIPv6) {
   SocketTest::TestGetSetOptionsIPv6();
 }
 
+#if defined(WEBRTC_USE_EPOLL)
+
+// Runs the generic socket tests against a PhysicalSocketServer using epoll.
+class PhysicalSocketEpollTest : public SocketTest {
+ protected:
+  PhysicalSocketEpollTest()
+      : server_(PhysicalSocketServer::kEpoll), scope_(&server_) {}
+
+  PhysicalSocketServer server_;
+  SocketServerScope scope_;
+};
+
+TEST_F(PhysicalSocketEpollTest, TestConnectIPv4) {
+  SocketTest::TestConnectIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestConnectFailIPv4) {
+  SocketTest::TestConnectFailIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestConnectWithDnsLookupIPv4) {
+  SocketTest::TestConnectWithDnsLookupIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestServerCloseDuringConnectIPv4) {
+  SocketTest::TestServerCloseDuringConnectIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestClientCloseDuringConnectIPv4) {
+  SocketTest::TestClientCloseDuringConnectIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestServerCloseIPv4) {
+  SocketTest::TestServerCloseIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestCloseInClosedCallbackIPv4) {
+  SocketTest::TestCloseInClosedCallbackIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestSocketServerWaitIPv4) {
+  SocketTest::TestSocketServerWaitIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestTcpIPv4) {
+  SocketTest::TestTcpIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestTcpIPv6) {
+  SocketTest::TestTcpIPv6();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestUdpIPv4) {
+  SocketTest::TestUdpIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestUdpIPv6) {
+  SocketTest::TestUdpIPv6();
+}
+
+#if !defined(THREAD_SANITIZER)
+
+TEST_F(PhysicalSocketEpollTest, TestUdpReadyToSendIPv4) {
+  SocketTest::TestUdpReadyToSendIPv4();
+}
+
+#endif // if !defined(THREAD_SANITIZER)
+
+// Registers |num_sockets| idle UDP sockets with |server| and checks that
+// WakeUp() still ends Wait() right away. Returns false if the sockets could not
+// be created.
+static bool WakesUpWithIdleSockets(PhysicalSocketServer* server,
+                                   size_t num_sockets) {
+  static const int kIterations = 100;
+  static const int kTimeoutMs = 1000;
+  ScopedPtrCollection<AsyncSocket> sockets;
+  for (size_t i = 0; i < num_sockets; ++i) {
+    AsyncSocket* socket = server->CreateAsyncSocket(AF_INET, SOCK_DGRAM);
+    if (!socket)
+      return false;
+    sockets.PushBack(socket);
+    if (socket->Bind(SocketAddress("127.0.0.1", 0)) != 0)
+      return false;
+  }
+  // Deliver the initial write events so that every socket is idle.
+  server->Wait(0, true);
+
+  for (int i = 0; i < kIterations; ++i) {
+    server->WakeUp();
+    uint32 start = Time();
+    EXPECT_TRUE(server->Wait(kTimeoutMs, true));
+    EXPECT_LT(TimeSince(start), kTimeoutMs) << num_sockets << " sockets";
+  }
+  return true;
+}
+
+TEST(PhysicalSocketServerTest, WakesUpWithManyIdleSockets) {
+  // Allow enough descriptors for the largest case, if permitted. The original
+  // limit is restored below so that it doesn't leak into other tests.
+  struct rlimit original_limit;
+  ASSERT_EQ(0, getrlimit(RLIMIT_NOFILE, &original_limit));
+  struct rlimit limit = original_limit;
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+
+  const size_t kNumSockets[] = { 100, 1000 };
+  for (size_t i = 0; i < ARRAY_SIZE(kNumSockets); ++i) {
+    const size_t num_sockets = kNumSockets[i];
+    // select() can't handle descriptors beyond FD_SETSIZE. Descriptors are
+    // allocated lowest first, so a fresh one tells how many are in use.
+    int lowest_free_fd = dup(0);
+    close(lowest_free_fd);
+    // Leave room for the wakeup pipe.
+    if (lowest_free_fd + num_sockets + 2 < FD_SETSIZE) {
+      PhysicalSocketServer server(PhysicalSocketServer::kSelect);
+      EXPECT_TRUE(WakesUpWithIdleSockets(&server, num_sockets));
+    }
+    PhysicalSocketServer server(PhysicalSocketServer::kEpoll);
+    if (!WakesUpWithIdleSockets(&server, num_sockets)) {
+      LOG(LS_WARNING) << "Could not create " << num_sockets << " sockets, "
+                      << "RLIMIT_NOFILE is " << limit.rlim_cur;
+    }
+  }
+  EXPECT_EQ(0, setrlimit(RLIMIT_NOFILE, &original_limit));
+}
+
+#endif  // WEBRTC_USE_EPOLL
+
 #if defined(WEBRTC_POSIX)
 
 class PosixSignalDeliveryTest : public testing::Test {
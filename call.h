@@ -69,6 +69,8 @@ class Call {
 
     static const int kDefaultStartBitrateBps;
 
+    // Options for the underlying engine. E.g. set ModuleProcessThreads to
+    // spread the periodic processing of many streams over several threads.
     webrtc::Config* webrtc_config;
 
     newapi::Transport* send_transport;
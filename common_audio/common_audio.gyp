@@ -198,6 +198,8 @@
           'sources': [
             'fir_filter_sse.cc',
             'resampler/sinc_resampler_sse.cc',
+            'signal_processing/cross_correlation_sse2.c',
+            'signal_processing/vector_scaling_operations_sse2.c',
           ],
           'cflags': ['-msse2',],
           'xcode_settings': {
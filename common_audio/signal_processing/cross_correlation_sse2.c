@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+
+// Unlike the NEON version, each product is shifted before it is accumulated,
+// so that the result is bit-exact with WebRtcSpl_CrossCorrelationC().
+static int32_t DotProductWithScaleSSE2(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       int length,
+                                       int scaling) {
+  __m128i sum = _mm_setzero_si128();
+  int32_t sum_res = 0;
+  int i = 0;
+
+  if (scaling == 0) {
+    // The pairwise sums of _mm_madd_epi16() wrap around exactly as the
+    // 32-bit sum in C does.
+    for (; i <= length - 8; i += 8) {
+      __m128i seq1 = _mm_loadu_si128((const __m128i*)&vector1[i]);
+      __m128i seq2 = _mm_loadu_si128((const __m128i*)&vector2[i]);
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(seq1, seq2));
+    }
+  } else {
+    const __m128i shift = _mm_cvtsi32_si128(scaling);
+    for (; i <= length - 8; i += 8) {
+      __m128i seq1 = _mm_loadu_si128((const __m128i*)&vector1[i]);
+      __m128i seq2 = _mm_loadu_si128((const __m128i*)&vector2[i]);
+      __m128i prod_lo = _mm_mullo_epi16(seq1, seq2);
+      __m128i prod_hi = _mm_mulhi_epi16(seq1, seq2);
+      __m128i prod0 = _mm_unpacklo_epi16(prod_lo, prod_hi);
+      __m128i prod1 = _mm_unpackhi_epi16(prod_lo, prod_hi);
+      sum = _mm_add_epi32(sum, _mm_sra_epi32(prod0, shift));
+      sum = _mm_add_epi32(sum, _mm_sra_epi32(prod1, shift));
+    }
+  }
+
+  // Calculate the rest of the samples.
+  for (; i < length; i++) {
+    sum_res += (vector1[i] * vector2[i]) >> scaling;
+  }
+
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum) + sum_res;
+}
+
+/* SSE2 version of WebRtcSpl_CrossCorrelation() for x86 platforms. */
+void WebRtcSpl_CrossCorrelationSSE2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    int16_t dim_seq,
+                                    int16_t dim_cross_correlation,
+                                    int16_t right_shifts,
+                                    int16_t step_seq2) {
+  int i = 0;
+
+  for (i = 0; i < dim_cross_correlation; i++) {
+    *cross_correlation++ = DotProductWithScaleSSE2(seq1,
+                                                   seq2 + step_seq2 * i,
+                                                   dim_seq,
+                                                   right_shifts);
+  }
+}
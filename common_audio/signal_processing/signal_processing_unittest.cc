@@ -472,10 +472,11 @@ TEST_F(SplTest, CrossCorrelationTest) {
   const int32_t kExpected[kCrossCorrelationDimension] =
       {-266947903, -15579555, -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if (defined WEBRTC_DETECT_ARM_NEON) || (defined WEBRTC_ARCH_ARM_NEON) || \
+  (defined WEBRTC_ARCH_ARM64_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] =
       {-266947901, -15579553, -171281999};
-  if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
+  if (WebRtcSpl_CrossCorrelation == WebRtcSpl_CrossCorrelationNeon) {
     expected = kExpectedNeon;
   }
 #endif
@@ -484,6 +485,91 @@ TEST_F(SplTest, CrossCorrelationTest) {
   }
 }
 
+// Compares WebRtcSpl_CrossCorrelation() with the C version on sequences which
+// are long enough to exercise both the vectorized loops and the tail handling
+// of the optimized versions. The NEON version is not bit-exact, and is
+// skipped.
+TEST_F(SplTest, CrossCorrelationMatchesC) {
+#if (defined WEBRTC_DETECT_ARM_NEON) || (defined WEBRTC_ARCH_ARM_NEON) || \
+  (defined WEBRTC_ARCH_ARM64_NEON)
+  if (WebRtcSpl_CrossCorrelation == WebRtcSpl_CrossCorrelationNeon)
+    return;
+#endif
+  const int kSeqLength = 300;
+  const int kMaxLag = 50;
+  int16_t seq1[kSeqLength];
+  int16_t seq2[kSeqLength + 2 * kMaxLag];
+  uint32_t seed = 100000;
+  WebRtcSpl_RandUArray(seq1, kSeqLength, &seed);
+  WebRtcSpl_RandUArray(seq2, kSeqLength + 2 * kMaxLag, &seed);
+  for (int i = 0; i < kSeqLength; i += 7) {
+    // Random values are in [0, 32767]; make some of them large and negative.
+    seq1[i] = WEBRTC_SPL_WORD16_MIN;
+    seq2[i] = -seq2[i];
+  }
+  // Like its callers, scale the input to the shift, so that the sums of
+  // |kSeqLength| products do not overflow.
+  const int kShifts[] = {0, 5, 9};
+  for (size_t s = 0; s < sizeof(kShifts) / sizeof(kShifts[0]); ++s) {
+    const int shift = kShifts[s];
+    const int input_shift = (10 - shift) / 2;
+    int16_t scaled1[kSeqLength];
+    int16_t scaled2[kSeqLength + 2 * kMaxLag];
+    for (int i = 0; i < kSeqLength; ++i)
+      scaled1[i] = seq1[i] >> input_shift;
+    for (int i = 0; i < kSeqLength + 2 * kMaxLag; ++i)
+      scaled2[i] = seq2[i] >> input_shift;
+    for (int length = 1; length <= kSeqLength; length += 37) {
+      for (int step = -1; step <= 1; step += 2) {
+        int32_t expected[kMaxLag];
+        int32_t actual[kMaxLag];
+        WebRtcSpl_CrossCorrelationC(expected, scaled1, &scaled2[kMaxLag],
+                                    length, kMaxLag, shift, step);
+        WebRtcSpl_CrossCorrelation(actual, scaled1, &scaled2[kMaxLag],
+                                   length, kMaxLag, shift, step);
+        for (int i = 0; i < kMaxLag; ++i) {
+          EXPECT_EQ(expected[i], actual[i])
+              << "length " << length << " shift " << shift << " step "
+              << step << " lag " << i;
+        }
+      }
+    }
+  }
+}
+
+TEST_F(SplTest, ScaleAndAddVectorsWithRoundMatchesC) {
+  const int kVectorLength = 83;
+  int16_t in1[kVectorLength];
+  int16_t in2[kVectorLength];
+  uint32_t seed = 100000;
+  WebRtcSpl_RandUArray(in1, kVectorLength, &seed);
+  WebRtcSpl_RandUArray(in2, kVectorLength, &seed);
+  for (int i = 0; i < kVectorLength; i += 3)
+    in2[i] = -in2[i];
+  in1[0] = WEBRTC_SPL_WORD16_MIN;
+  in2[0] = WEBRTC_SPL_WORD16_MIN;
+  // Scales in Q14 which sum to 1, as in NetEq, and scales which overflow the
+  // 16-bit output, to check that both versions truncate it the same way.
+  const int16_t kScales[][2] = {{16384, 0}, {12000, 4384}, {-3, 7},
+                                {32767, 32767}, {-32768, 1}};
+  for (size_t s = 0; s < sizeof(kScales) / sizeof(kScales[0]); ++s) {
+    for (int shift = 0; shift <= 14; shift += 7) {
+      int16_t expected[kVectorLength];
+      int16_t actual[kVectorLength];
+      EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundC(
+          in1, kScales[s][0], in2, kScales[s][1], shift, expected,
+          kVectorLength));
+      EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRound(
+          in1, kScales[s][0], in2, kScales[s][1], shift, actual,
+          kVectorLength));
+      for (int i = 0; i < kVectorLength; ++i) {
+        EXPECT_EQ(expected[i], actual[i])
+            << "scales " << s << " shift " << shift << " index " << i;
+      }
+    }
+  }
+}
+
 TEST_F(SplTest, AutoCorrelationTest) {
   int scale = 0;
   int32_t vector32[kVector16Size];
@@ -9,7 +9,7 @@
  */
 
 /* The global function contained in this file initializes SPL function
- * pointers, currently only for ARM platforms.
+ * pointers, currently only for ARM, MIPS and x86 platforms.
  *
  * Some code came from common/rtcd.c in the WebM project.
  */
@@ -64,6 +64,15 @@ static void InitPointersToNeon() {
 }
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+/* Override the function pointers with SSE2 versions, where available. */
+static void InitPointersToSSE2() {
+  WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationSSE2;
+  WebRtcSpl_ScaleAndAddVectorsWithRound =
+      WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2;
+}
+#endif
+
 #if defined(MIPS32_LE)
 /* Initialize function pointers to the MIPS version. */
 static void InitPointersToMIPS() {
@@ -99,6 +108,11 @@ static void InitFunctionPointers(void) {
   InitPointersToMIPS();
 #else
   InitPointersToC();
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    InitPointersToSSE2();
+  }
+#endif
 #endif  /* WEBRTC_DETECT_ARM_NEON */
 }
 
@@ -11,77 +11,136 @@
 #include "webrtc/common_video/interface/i420_buffer_pool.h"
 
 #include "webrtc/base/checks.h"
+#include "webrtc/base/criticalsection.h"
 
 namespace {
 
-// One extra indirection is needed to make |HasOneRef| work.
-class PooledI420Buffer : public webrtc::VideoFrameBuffer {
+// Set in the reference count of a buffer for as long as it belongs to the
+// pool. The remaining bits count the references handed out, so a buffer is
+// free when its reference count equals this flag.
+const int kOwnedByPool = 1 << 30;
+
+}  // namespace
+
+namespace webrtc {
+
+// One extra indirection is needed to make |HasOneRef| work. The pooled buffer
+// is reused as is, while the I420Buffer it wraps is replaced when a buffer of
+// another size is needed.
+class I420BufferPool::PooledI420Buffer : public VideoFrameBuffer {
  public:
-  explicit PooledI420Buffer(
-      const rtc::scoped_refptr<webrtc::I420Buffer>& buffer)
-      : buffer_(buffer) {}
+  PooledI420Buffer() : ref_count_(kOwnedByPool) {}
+
+  // Claims the buffer if it is free, in which case the caller holds its only
+  // reference. The methods below may only be called while holding it.
+  bool TryClaim() {
+    return rtc::AtomicOps::CompareAndSwap(&ref_count_, kOwnedByPool,
+                                          kOwnedByPool + 1) == kOwnedByPool;
+  }
+  bool HasSize(int width, int height) const {
+    return buffer_ && buffer_->width() == width && buffer_->height() == height;
+  }
+  bool IsAllocated() const { return buffer_.get() != nullptr; }
+  void Allocate(int width, int height) {
+    buffer_ = new rtc::RefCountedObject<I420Buffer>(width, height);
+  }
+  void Free() { buffer_ = nullptr; }
+
+  // Called when the pool is destroyed. A buffer that is in use deletes itself
+  // when its last reference is released.
+  void Orphan() {
+    int count = rtc::AtomicOps::Load(&ref_count_);
+    int previous_count;
+    while ((previous_count = rtc::AtomicOps::CompareAndSwap(
+                &ref_count_, count, count - kOwnedByPool)) != count) {
+      count = previous_count;
+    }
+    if (count == kOwnedByPool)
+      delete this;
+  }
+
+  int AddRef() override {
+    return rtc::AtomicOps::Increment(&ref_count_) & ~kOwnedByPool;
+  }
+  int Release() override {
+    const int count = rtc::AtomicOps::Decrement(&ref_count_);
+    if (count == 0)
+      delete this;
+    return count & ~kOwnedByPool;
+  }
+  bool HasOneRef() const override {
+    return (rtc::AtomicOps::Load(&ref_count_) & ~kOwnedByPool) == 1;
+  }
 
  private:
   ~PooledI420Buffer() override {}
 
   int width() const override { return buffer_->width(); }
   int height() const override { return buffer_->height(); }
-  const uint8_t* data(webrtc::PlaneType type) const override {
-    const webrtc::I420Buffer* cbuffer = buffer_.get();
+  const uint8_t* data(PlaneType type) const override {
+    const I420Buffer* cbuffer = buffer_.get();
     return cbuffer->data(type);
   }
-  uint8_t* data(webrtc::PlaneType type) {
+  uint8_t* data(PlaneType type) override {
     DCHECK(HasOneRef());
-    const webrtc::I420Buffer* cbuffer = buffer_.get();
+    const I420Buffer* cbuffer = buffer_.get();
     return const_cast<uint8_t*>(cbuffer->data(type));
   }
-  int stride(webrtc::PlaneType type) const override {
+  int stride(PlaneType type) const override {
     return buffer_->stride(type);
   }
-  rtc::scoped_refptr<webrtc::NativeHandle> native_handle() const override {
+  rtc::scoped_refptr<NativeHandle> native_handle() const override {
     return nullptr;
   }
 
-  friend class rtc::RefCountedObject<PooledI420Buffer>;
-  rtc::scoped_refptr<webrtc::I420Buffer> buffer_;
+  volatile int ref_count_;
+  rtc::scoped_refptr<I420Buffer> buffer_;
 };
 
-}  // namespace
-
-namespace webrtc {
-
 I420BufferPool::I420BufferPool() {
-  Release();
+  for (PooledI420Buffer*& buffer : buffers_)
+    buffer = new PooledI420Buffer();
+}
+
+I420BufferPool::~I420BufferPool() {
+  for (PooledI420Buffer* buffer : buffers_)
+    buffer->Orphan();
 }
 
 void I420BufferPool::Release() {
-  thread_checker_.DetachFromThread();
-  buffers_.clear();
+  for (PooledI420Buffer* buffer : buffers_) {
+    if (buffer->TryClaim()) {
+      buffer->Free();
+      buffer->Release();
+    }
+  }
 }
 
 rtc::scoped_refptr<VideoFrameBuffer> I420BufferPool::CreateBuffer(int width,
                                                                   int height) {
-  DCHECK(thread_checker_.CalledOnValidThread());
-  // Release buffers with wrong resolution.
-  for (auto it = buffers_.begin(); it != buffers_.end();) {
-    if ((*it)->width() != width || (*it)->height() != height)
-      it = buffers_.erase(it);
-    else
-      ++it;
-  }
-  // Look for a free buffer.
-  for (const rtc::scoped_refptr<I420Buffer>& buffer : buffers_) {
-    // If the buffer is in use, the ref count will be 2, one from the list we
-    // are looping over and one from a PooledI420Buffer returned from
-    // CreateBuffer that has not been released yet. If the ref count is 1
-    // (HasOneRef), then the list we are looping over holds the only reference
-    // and it's safe to reuse.
-    if (buffer->HasOneRef())
-      return new rtc::RefCountedObject<PooledI420Buffer>(buffer);
+  // Look for a free buffer of the right size first. Failing that, allocate
+  // into an unused slot, and only then reallocate a free buffer of another
+  // size, so that buffers of sizes in concurrent use are kept.
+  enum { kSameSize, kUnallocated, kAnySize, kNumPasses };
+  for (int pass = kSameSize; pass < kNumPasses; ++pass) {
+    for (PooledI420Buffer* buffer : buffers_) {
+      if (!buffer->TryClaim())
+        continue;
+      const bool same_size = buffer->HasSize(width, height);
+      if (same_size || (pass == kUnallocated && !buffer->IsAllocated()) ||
+          pass == kAnySize) {
+        if (!same_size)
+          buffer->Allocate(width, height);
+        // Hand over the reference taken by TryClaim.
+        rtc::scoped_refptr<VideoFrameBuffer> pooled_buffer(buffer);
+        buffer->Release();
+        return pooled_buffer;
+      }
+      buffer->Release();
+    }
   }
-  // Allocate new buffer.
-  buffers_.push_back(new rtc::RefCountedObject<I420Buffer>(width, height));
-  return new rtc::RefCountedObject<PooledI420Buffer>(buffers_.back());
+  // All buffers are in use.
+  return new rtc::RefCountedObject<I420Buffer>(width, height);
 }
 
 }  // namespace webrtc
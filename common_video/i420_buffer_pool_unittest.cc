@@ -8,10 +8,15 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string.h>
+
 #include <string>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_video/interface/i420_buffer_pool.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
 
 namespace webrtc {
 
@@ -71,4 +76,112 @@ TEST(TestI420BufferPool, FrameValidAfterPoolDestruction) {
   memset(buffer->data(kYPlane), 0xA5, 16 * buffer->stride(kYPlane));
 }
 
+TEST(TestI420BufferPool, ReusesBuffersOfSeveralSizes) {
+  I420BufferPool pool;
+  rtc::scoped_refptr<VideoFrameBuffer> small_buffer = pool.CreateBuffer(16, 16);
+  rtc::scoped_refptr<VideoFrameBuffer> large_buffer = pool.CreateBuffer(32, 32);
+  const uint8_t* small_y_ptr = small_buffer->data(kYPlane);
+  const uint8_t* large_y_ptr = large_buffer->data(kYPlane);
+  small_buffer = nullptr;
+  large_buffer = nullptr;
+  // Requesting the sizes in turn does not reallocate either of them.
+  for (int i = 0; i < 3; ++i) {
+    large_buffer = pool.CreateBuffer(32, 32);
+    EXPECT_EQ(large_y_ptr, large_buffer->data(kYPlane));
+    large_buffer = nullptr;
+    small_buffer = pool.CreateBuffer(16, 16);
+    EXPECT_EQ(small_y_ptr, small_buffer->data(kYPlane));
+    small_buffer = nullptr;
+  }
+}
+
+TEST(TestI420BufferPool, AllocatesOnlyWhileFillingUp) {
+  I420BufferPool pool;
+  const int num_allocated = I420Buffer::NumAllocated();
+  rtc::scoped_refptr<VideoFrameBuffer> buffer = pool.CreateBuffer(16, 16);
+  rtc::scoped_refptr<VideoFrameBuffer> other_buffer = pool.CreateBuffer(16, 16);
+  EXPECT_EQ(num_allocated + 2, I420Buffer::NumAllocated());
+  for (int i = 0; i < 10; ++i) {
+    buffer = nullptr;
+    other_buffer = nullptr;
+    buffer = pool.CreateBuffer(16, 16);
+    other_buffer = pool.CreateBuffer(16, 16);
+  }
+  EXPECT_EQ(num_allocated + 2, I420Buffer::NumAllocated());
+}
+
+TEST(TestI420BufferPool, CreatesBufferWhenAllAreInUse) {
+  I420BufferPool pool;
+  std::vector<rtc::scoped_refptr<VideoFrameBuffer>> buffers;
+  for (int i = 0; i < I420BufferPool::kMaxNumberOfBuffers; ++i)
+    buffers.push_back(pool.CreateBuffer(16, 16));
+  rtc::scoped_refptr<VideoFrameBuffer> buffer = pool.CreateBuffer(16, 16);
+  EXPECT_TRUE(buffer->HasOneRef());
+  EXPECT_EQ(16, buffer->width());
+  for (const rtc::scoped_refptr<VideoFrameBuffer>& pooled_buffer : buffers)
+    EXPECT_NE(pooled_buffer->data(kYPlane), buffer->data(kYPlane));
+}
+
+TEST(TestI420BufferPool, ReleaseKeepsBuffersInUse) {
+  I420BufferPool pool;
+  rtc::scoped_refptr<VideoFrameBuffer> buffer = pool.CreateBuffer(16, 16);
+  const uint8_t* y_ptr = buffer->data(kYPlane);
+  pool.Release();
+  EXPECT_EQ(y_ptr, buffer->data(kYPlane));
+  memset(buffer->data(kYPlane), 0xA5, 16 * buffer->stride(kYPlane));
+}
+
+class ConcurrentPoolUser {
+ public:
+  ConcurrentPoolUser(I420BufferPool* pool, uint8_t marker)
+      : pool_(pool), marker_(marker), corrupted_(false) {}
+
+  static bool Run(void* obj) {
+    static_cast<ConcurrentPoolUser*>(obj)->Process();
+    return false;
+  }
+
+  bool corrupted() const { return corrupted_; }
+
+ private:
+  static const int kIterations = 1000;
+
+  void Process() {
+    for (int i = 0; i < kIterations; ++i) {
+      // Alternate between two sizes to exercise reallocation as well.
+      const int size = (i % 2) ? 16 : 32;
+      rtc::scoped_refptr<VideoFrameBuffer> buffer =
+          pool_->CreateBuffer(size, size);
+      const int y_size = size * buffer->stride(kYPlane);
+      memset(buffer->data(kYPlane), marker_, y_size);
+      const VideoFrameBuffer* const_buffer = buffer.get();
+      for (int j = 0; j < y_size; ++j)
+        corrupted_ |= const_buffer->data(kYPlane)[j] != marker_;
+    }
+  }
+
+  I420BufferPool* const pool_;
+  const uint8_t marker_;
+  bool corrupted_;
+};
+
+TEST(TestI420BufferPool, BuffersAreExclusiveAcrossThreads) {
+  const int kNumThreads = 4;
+  I420BufferPool pool;
+  std::vector<ConcurrentPoolUser*> users;
+  std::vector<ThreadWrapper*> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    users.push_back(new ConcurrentPoolUser(&pool, static_cast<uint8_t>(i)));
+    threads.push_back(ThreadWrapper::CreateThread(
+        &ConcurrentPoolUser::Run, users.back(), "PoolUser").release());
+    EXPECT_TRUE(threads.back()->Start());
+  }
+  for (int i = 0; i < kNumThreads; ++i) {
+    EXPECT_TRUE(threads[i]->Stop());
+    EXPECT_FALSE(users[i]->corrupted());
+    delete threads[i];
+    delete users[i];
+  }
+}
+
 }  // namespace webrtc
@@ -11,9 +11,7 @@
 #ifndef WEBRTC_COMMON_VIDEO_INTERFACE_I420_BUFFER_POOL_H_
 #define WEBRTC_COMMON_VIDEO_INTERFACE_I420_BUFFER_POOL_H_
 
-#include <list>
-
-#include "webrtc/base/thread_checker.h"
+#include "webrtc/base/constructormagic.h"
 #include "webrtc/common_video/interface/video_frame_buffer.h"
 
 namespace webrtc {
@@ -21,21 +19,35 @@ namespace webrtc {
 // Simple buffer pool to avoid unnecessary allocations of I420Buffer objects.
 // The pool manages the memory of the I420Buffer returned from CreateBuffer.
 // When the I420Buffer is destructed, the memory is returned to the pool for use
-// by subsequent calls to CreateBuffer. If the resolution passed to CreateBuffer
-// changes, old buffers will be purged from the pool.
+// by subsequent calls to CreateBuffer.
+//
+// Free buffers are kept per resolution, so a pool can serve frames of several
+// sizes at once (e.g. the streams of a simulcast encoder) without reallocating
+// on every call. A free buffer of another size is only reallocated when all of
+// the pool's |kMaxNumberOfBuffers| slots have been used.
+//
+// CreateBuffer and Release may be called on any thread, and buffers may be
+// released on any thread. Neither takes a lock; buffers are claimed and
+// returned with atomic operations on their reference counts.
 class I420BufferPool {
  public:
+  static const int kMaxNumberOfBuffers = 32;
+
   I420BufferPool();
+  ~I420BufferPool();
   // Returns a buffer from the pool, or creates a new buffer if no suitable
-  // buffer exists in the pool.
+  // buffer exists in the pool. If all buffers are in use, the returned buffer
+  // is not pooled.
   rtc::scoped_refptr<VideoFrameBuffer> CreateBuffer(int width, int height);
-  // Clears buffers_ and detaches the thread checker so that it can be reused
-  // later from another thread.
+  // Frees the memory of all buffers that are not in use.
   void Release();
 
  private:
-  rtc::ThreadChecker thread_checker_;
-  std::list<rtc::scoped_refptr<I420Buffer>> buffers_;
+  class PooledI420Buffer;
+
+  PooledI420Buffer* buffers_[kMaxNumberOfBuffers];
+
+  DISALLOW_COPY_AND_ASSIGN(I420BufferPool);
 };
 
 }  // namespace webrtc
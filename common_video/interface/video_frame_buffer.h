@@ -69,6 +69,10 @@ class I420Buffer : public VideoFrameBuffer {
   int stride(PlaneType type) const override;
   rtc::scoped_refptr<NativeHandle> native_handle() const override;
 
+  // Returns the number of I420Buffers constructed so far in this process. Lets
+  // tests check that frame memory is reused rather than allocated.
+  static int NumAllocated();
+
  protected:
   ~I420Buffer() override;
 
@@ -11,10 +11,14 @@
 #include "webrtc/common_video/interface/video_frame_buffer.h"
 
 #include "webrtc/base/checks.h"
+#include "webrtc/base/criticalsection.h"
 
 // Aligning pointer to 64 bytes for improved performance, e.g. use SIMD.
 static const int kBufferAlignment = 64;
 
+// Number of I420Buffers constructed, see I420Buffer::NumAllocated().
+static volatile int g_num_allocated_i420_buffers = 0;
+
 namespace webrtc {
 
 VideoFrameBuffer::~VideoFrameBuffer() {}
@@ -41,11 +45,16 @@ I420Buffer::I420Buffer(int width,
   DCHECK_GE(stride_y, width);
   DCHECK_GE(stride_u, (width + 1) / 2);
   DCHECK_GE(stride_v, (width + 1) / 2);
+  rtc::AtomicOps::Increment(&g_num_allocated_i420_buffers);
 }
 
 I420Buffer::~I420Buffer() {
 }
 
+int I420Buffer::NumAllocated() {
+  return rtc::AtomicOps::Load(&g_num_allocated_i420_buffers);
+}
+
 int I420Buffer::width() const {
   return width_;
 }
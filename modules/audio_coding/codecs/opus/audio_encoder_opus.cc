@@ -33,6 +33,10 @@ const int kDefaultComplexity = 9;
 // We always encode at 48 kHz.
 const int kSampleRateHz = 48000;
 
+// More than two channels are coded with the multistream encoder, which
+// supports up to 7.1 surround.
+const int kMaxNumChannels = 8;
+
 int16_t ClampInt16(size_t x) {
   return static_cast<int16_t>(
       std::min(x, static_cast<size_t>(std::numeric_limits<int16_t>::max())));
@@ -60,7 +64,11 @@ AudioEncoderOpus::Config::Config()
 bool AudioEncoderOpus::Config::IsOk() const {
   if (frame_size_ms <= 0 || frame_size_ms % 10 != 0)
     return false;
-  if (num_channels != 1 && num_channels != 2)
+  if (num_channels < 1 || num_channels > kMaxNumChannels)
+    return false;
+  // The receiver cannot find the FEC data in multistream packets, and the
+  // DTX of each stream cannot be signaled, so neither is supported.
+  if (num_channels > 2 && (fec_enabled || dtx_enabled))
     return false;
   if (bitrate_bps < kMinBitrateBps || bitrate_bps > kMaxBitrateBps)
     return false;
@@ -83,7 +91,12 @@ AudioEncoderOpus::AudioEncoderOpus(const Config& config)
       packet_loss_rate_(0.0) {
   CHECK(config.IsOk());
   input_buffer_.reserve(num_10ms_frames_per_packet_ * samples_per_10ms_frame_);
-  CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, num_channels_, application_));
+  if (num_channels_ > 2) {
+    CHECK_EQ(0, WebRtcOpus_MultistreamEncoderCreate(&inst_, num_channels_,
+                                                    application_));
+  } else {
+    CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, num_channels_, application_));
+  }
   SetTargetBitrate(config.bitrate_bps);
   if (config.fec_enabled) {
     CHECK_EQ(0, WebRtcOpus_EnableFec(inst_));
@@ -77,4 +77,51 @@ TEST_F(AudioEncoderOpusTest, PacketLossRateOptimized) {
   TestSetPacketLossRate(0.0, 0.0, 0.0);
 }
 
+TEST(AudioEncoderOpusConfigTest, SurroundChannels) {
+  AudioEncoderOpus::Config config;
+  config.application = AudioEncoderOpus::kAudio;
+  config.num_channels = 6;
+  EXPECT_TRUE(config.IsOk());
+  config.num_channels = 8;
+  EXPECT_TRUE(config.IsOk());
+  config.num_channels = 9;
+  EXPECT_FALSE(config.IsOk());
+  config.num_channels = 0;
+  EXPECT_FALSE(config.IsOk());
+
+  // FEC and DTX are not supported with more than two channels.
+  config.num_channels = 6;
+  config.fec_enabled = true;
+  EXPECT_FALSE(config.IsOk());
+  config.fec_enabled = false;
+  config.application = AudioEncoderOpus::kVoip;
+  config.dtx_enabled = true;
+  EXPECT_FALSE(config.IsOk());
+}
+
+TEST(AudioEncoderOpusConfigTest, EncodesSurround) {
+  AudioEncoderOpus::Config config;
+  config.application = AudioEncoderOpus::kAudio;
+  config.num_channels = 6;
+  config.bitrate_bps = 192000;
+  AudioEncoderOpus encoder(config);
+  EXPECT_EQ(6, encoder.NumChannels());
+
+  // 10 ms of 5.1 audio, a different tone in each channel.
+  const int kSamplesPer10Ms = 480;
+  int16_t audio[kSamplesPer10Ms * 6];
+  for (int i = 0; i < kSamplesPer10Ms; ++i) {
+    for (int channel = 0; channel < 6; ++channel)
+      audio[i * 6 + channel] = ((i * (channel + 1)) % 64 - 32) * 256;
+  }
+  rtc::scoped_ptr<uint8_t[]> encoded(new uint8_t[encoder.MaxEncodedBytes()]);
+  AudioEncoder::EncodedInfo info;
+  for (int i = 0; i < encoder.Num10MsFramesInNextPacket(); ++i) {
+    info = encoder.Encode(i * kSamplesPer10Ms, audio, kSamplesPer10Ms,
+                          encoder.MaxEncodedBytes(), encoded.get());
+  }
+  EXPECT_GT(info.encoded_bytes, 0u);
+  EXPECT_EQ(0u, info.encoded_timestamp);
+}
+
 }  // namespace webrtc
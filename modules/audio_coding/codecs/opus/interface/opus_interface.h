@@ -44,6 +44,37 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
                                  int32_t channels,
                                  int32_t application);
 
+/****************************************************************************
+ * WebRtcOpus_MultistreamEncoderCreate(...)
+ *
+ * This function creates an Opus multistream encoder, for audio with more than
+ * two channels, e.g., 5.1 surround. The channels are coded in coupled (stereo)
+ * and single (mono) streams which all go in the same packet, in the Vorbis
+ * channel order (channel mapping family 1 of RFC 7845). For 5.1 the channels
+ * are front left, center, front right, rear left, rear right and LFE.
+ * An encoder created by this function is used through the same functions as
+ * one created by WebRtcOpus_EncoderCreate(), but the packets it produces can
+ * only be decoded by a decoder created by
+ * WebRtcOpus_MultistreamDecoderCreate() with the same number of channels.
+ *
+ * Input:
+ *      - channels           : number of channels, 1 - 8.
+ *      - application        : 0 - VOIP applications.
+ *                                 Favor speech intelligibility.
+ *                             1 - Audio applications.
+ *                                 Favor faithfulness to the original input.
+ *
+ * Output:
+ *      - inst               : a pointer to Encoder context that is created
+ *                             if success.
+ *
+ * Return value              : 0 - Success
+ *                            -1 - Error
+ */
+int16_t WebRtcOpus_MultistreamEncoderCreate(OpusEncInst** inst,
+                                            int32_t channels,
+                                            int32_t application);
+
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst);
 
 /****************************************************************************
@@ -194,6 +225,27 @@ int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst);
 int16_t WebRtcOpus_SetComplexity(OpusEncInst* inst, int32_t complexity);
 
 int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst, int channels);
+
+/****************************************************************************
+ * WebRtcOpus_MultistreamDecoderCreate(...)
+ *
+ * This function creates a decoder for the packets of an encoder created by
+ * WebRtcOpus_MultistreamEncoderCreate() with |channels| channels. The decoded
+ * audio has the channel order of the encoder input. Packets with FEC data
+ * are decoded, but WebRtcOpus_PacketHasFec() and WebRtcOpus_FecDurationEst()
+ * do not support multistream packets.
+ *
+ * Input:
+ *      - channels           : number of channels, 1 - 8.
+ *
+ * Output:
+ *      - inst               : a pointer to Decoder context that is created
+ *                             if success.
+ *
+ * Return value              : 0 - Success
+ *                            -1 - Error
+ */
+int16_t WebRtcOpus_MultistreamDecoderCreate(OpusDecInst** inst, int channels);
 int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst);
 
 /****************************************************************************
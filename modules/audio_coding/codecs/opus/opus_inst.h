@@ -12,14 +12,19 @@
 #define WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_INST_H_
 
 #include "opus.h"
+#include "opus_multistream.h"
 
+// Exactly one of |encoder| and |multistream_encoder| is set.
 struct WebRtcOpusEncInst {
   OpusEncoder* encoder;
+  OpusMSEncoder* multistream_encoder;
   int in_dtx_mode;
 };
 
+// Exactly one of |decoder| and |multistream_decoder| is set.
 struct WebRtcOpusDecInst {
   OpusDecoder* decoder;
+  OpusMSDecoder* multistream_decoder;
   int prev_decoded_samples;
   int channels;
   int in_dtx_mode;
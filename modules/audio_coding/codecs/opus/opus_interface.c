@@ -29,8 +29,52 @@ enum {
 
   /* Default frame size, 20 ms @ 48 kHz, in samples (for one channel). */
   kWebRtcOpusDefaultFrameSize = 960,
+
+  /* Maximum number of channels of a multistream encoder or decoder. */
+  kWebRtcOpusMaxMultistreamChannels = 8,
+};
+
+/* The streams of a multistream packet, and the order of the channels, for
+ * channel mapping family 1 (Vorbis channel order, RFC 7845 section 5.1.1.2),
+ * indexed by the number of channels - 1. This is the vorbis_mappings table of
+ * libopus' opus_multistream_encoder.c, which the surround encoder uses, so
+ * every channel is decoded to where it was encoded. */
+static const struct {
+  int streams;
+  int coupled_streams;
+  unsigned char mapping[kWebRtcOpusMaxMultistreamChannels];
+} kVorbisMappings[kWebRtcOpusMaxMultistreamChannels] = {
+  {1, 0, {0}},                       /* Mono. */
+  {1, 1, {0, 1}},                    /* Stereo. */
+  {2, 1, {0, 2, 1}},                 /* L, C, R. */
+  {2, 2, {0, 1, 2, 3}},              /* Quadraphonic. */
+  {3, 2, {0, 4, 1, 2, 3}},           /* 5.0. */
+  {4, 2, {0, 4, 1, 2, 3, 5}},        /* 5.1. */
+  {4, 3, {0, 4, 1, 2, 3, 5, 6}},     /* 6.1. */
+  {5, 3, {0, 6, 1, 2, 3, 4, 5, 7}},  /* 7.1. */
 };
 
+/* Forwards an encoder CTL to the encoder of |inst|, which is either a
+ * single stream or a multistream encoder. */
+#define ENCODER_CTL(inst, vargs) \
+    ((inst)->encoder ? opus_encoder_ctl((inst)->encoder, vargs) : \
+         opus_multistream_encoder_ctl((inst)->multistream_encoder, vargs))
+
+#define DECODER_CTL(inst, vargs) \
+    ((inst)->decoder ? opus_decoder_ctl((inst)->decoder, vargs) : \
+         opus_multistream_decoder_ctl((inst)->multistream_decoder, vargs))
+
+static int GetOpusApplication(int32_t application) {
+  switch (application) {
+    case 0:
+      return OPUS_APPLICATION_VOIP;
+    case 1:
+      return OPUS_APPLICATION_AUDIO;
+    default:
+      return -1;
+  }
+}
+
 int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
                                  int32_t channels,
                                  int32_t application) {
@@ -38,20 +82,10 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
   if (inst != NULL) {
     state = (OpusEncInst*) calloc(1, sizeof(OpusEncInst));
     if (state) {
-      int opus_app;
-      switch (application) {
-        case 0: {
-          opus_app = OPUS_APPLICATION_VOIP;
-          break;
-        }
-        case 1: {
-          opus_app = OPUS_APPLICATION_AUDIO;
-          break;
-        }
-        default: {
-          free(state);
-          return -1;
-        }
+      int opus_app = GetOpusApplication(application);
+      if (opus_app < 0) {
+        free(state);
+        return -1;
       }
 
       int error;
@@ -68,9 +102,51 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
   return -1;
 }
 
+int16_t WebRtcOpus_MultistreamEncoderCreate(OpusEncInst** inst,
+                                            int32_t channels,
+                                            int32_t application) {
+  OpusEncInst* state;
+  int opus_app;
+  int streams;
+  int coupled_streams;
+  unsigned char mapping[kWebRtcOpusMaxMultistreamChannels];
+  int error;
+
+  if (inst == NULL || channels < 1 ||
+      channels > kWebRtcOpusMaxMultistreamChannels) {
+    return -1;
+  }
+  opus_app = GetOpusApplication(application);
+  if (opus_app < 0) {
+    return -1;
+  }
+  state = (OpusEncInst*) calloc(1, sizeof(OpusEncInst));
+  if (state == NULL) {
+    return -1;
+  }
+
+  /* The surround encoder analyzes all channels together, to allocate the bits
+   * between the streams. With channel mapping family 1 it creates the streams
+   * of |kVorbisMappings|, which is what the decoder expects. */
+  state->multistream_encoder = opus_multistream_surround_encoder_create(
+      48000, channels, 1, &streams, &coupled_streams, mapping, opus_app,
+      &error);
+  state->in_dtx_mode = 0;
+  if (error == OPUS_OK && state->multistream_encoder != NULL) {
+    *inst = state;
+    return 0;
+  }
+  free(state);
+  return -1;
+}
+
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst) {
   if (inst) {
-    opus_encoder_destroy(inst->encoder);
+    if (inst->encoder) {
+      opus_encoder_destroy(inst->encoder);
+    } else {
+      opus_multistream_encoder_destroy(inst->multistream_encoder);
+    }
     free(inst);
     return 0;
   } else {
@@ -89,11 +165,19 @@ int16_t WebRtcOpus_Encode(OpusEncInst* inst,
     return -1;
   }
 
-  res = opus_encode(inst->encoder,
-                    (const opus_int16*)audio_in,
-                    samples,
-                    encoded,
-                    length_encoded_buffer);
+  if (inst->encoder) {
+    res = opus_encode(inst->encoder,
+                      (const opus_int16*)audio_in,
+                      samples,
+                      encoded,
+                      length_encoded_buffer);
+  } else {
+    res = opus_multistream_encode(inst->multistream_encoder,
+                                  (const opus_int16*)audio_in,
+                                  samples,
+                                  encoded,
+                                  length_encoded_buffer);
+  }
 
   if (res == 1) {
     // Indicates DTX since the packet has nothing but a header. In principle,
@@ -115,7 +199,7 @@ int16_t WebRtcOpus_Encode(OpusEncInst* inst,
 
 int16_t WebRtcOpus_SetBitRate(OpusEncInst* inst, int32_t rate) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_BITRATE(rate));
+    return ENCODER_CTL(inst, OPUS_SET_BITRATE(rate));
   } else {
     return -1;
   }
@@ -123,8 +207,7 @@ int16_t WebRtcOpus_SetBitRate(OpusEncInst* inst, int32_t rate) {
 
 int16_t WebRtcOpus_SetPacketLossRate(OpusEncInst* inst, int32_t loss_rate) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder,
-                            OPUS_SET_PACKET_LOSS_PERC(loss_rate));
+    return ENCODER_CTL(inst, OPUS_SET_PACKET_LOSS_PERC(loss_rate));
   } else {
     return -1;
   }
@@ -147,13 +230,12 @@ int16_t WebRtcOpus_SetMaxPlaybackRate(OpusEncInst* inst, int32_t frequency_hz) {
   } else {
     set_bandwidth = OPUS_BANDWIDTH_FULLBAND;
   }
-  return opus_encoder_ctl(inst->encoder,
-                          OPUS_SET_MAX_BANDWIDTH(set_bandwidth));
+  return ENCODER_CTL(inst, OPUS_SET_MAX_BANDWIDTH(set_bandwidth));
 }
 
 int16_t WebRtcOpus_EnableFec(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_INBAND_FEC(1));
+    return ENCODER_CTL(inst, OPUS_SET_INBAND_FEC(1));
   } else {
     return -1;
   }
@@ -161,7 +243,7 @@ int16_t WebRtcOpus_EnableFec(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_DisableFec(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_INBAND_FEC(0));
+    return ENCODER_CTL(inst, OPUS_SET_INBAND_FEC(0));
   } else {
     return -1;
   }
@@ -169,7 +251,7 @@ int16_t WebRtcOpus_DisableFec(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_EnableDtx(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_DTX(1));
+    return ENCODER_CTL(inst, OPUS_SET_DTX(1));
   } else {
     return -1;
   }
@@ -177,7 +259,7 @@ int16_t WebRtcOpus_EnableDtx(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_DTX(0));
+    return ENCODER_CTL(inst, OPUS_SET_DTX(0));
   } else {
     return -1;
   }
@@ -185,7 +267,7 @@ int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_SetComplexity(OpusEncInst* inst, int32_t complexity) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_COMPLEXITY(complexity));
+    return ENCODER_CTL(inst, OPUS_SET_COMPLEXITY(complexity));
   } else {
     return -1;
   }
@@ -222,9 +304,46 @@ int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst, int channels) {
   return -1;
 }
 
+int16_t WebRtcOpus_MultistreamDecoderCreate(OpusDecInst** inst,
+                                            int channels) {
+  int error;
+  OpusDecInst* state;
+
+  if (inst == NULL || channels < 1 ||
+      channels > kWebRtcOpusMaxMultistreamChannels) {
+    return -1;
+  }
+  state = (OpusDecInst*) calloc(1, sizeof(OpusDecInst));
+  if (state == NULL) {
+    return -1;
+  }
+
+  state->multistream_decoder = opus_multistream_decoder_create(
+      48000, channels, kVorbisMappings[channels - 1].streams,
+      kVorbisMappings[channels - 1].coupled_streams,
+      kVorbisMappings[channels - 1].mapping, &error);
+  if (error == OPUS_OK && state->multistream_decoder != NULL) {
+    state->channels = channels;
+    state->prev_decoded_samples = kWebRtcOpusDefaultFrameSize;
+    state->in_dtx_mode = 0;
+    *inst = state;
+    return 0;
+  }
+
+  if (state->multistream_decoder) {
+    opus_multistream_decoder_destroy(state->multistream_decoder);
+  }
+  free(state);
+  return -1;
+}
+
 int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst) {
   if (inst) {
-    opus_decoder_destroy(inst->decoder);
+    if (inst->decoder) {
+      opus_decoder_destroy(inst->decoder);
+    } else {
+      opus_multistream_decoder_destroy(inst->multistream_decoder);
+    }
     free(inst);
     return 0;
   } else {
@@ -237,7 +356,7 @@ int WebRtcOpus_DecoderChannels(OpusDecInst* inst) {
 }
 
 int16_t WebRtcOpus_DecoderInit(OpusDecInst* inst) {
-  int error = opus_decoder_ctl(inst->decoder, OPUS_RESET_STATE);
+  int error = DECODER_CTL(inst, OPUS_RESET_STATE);
   if (error == OPUS_OK) {
     inst->in_dtx_mode = 0;
     return 0;
@@ -266,8 +385,15 @@ static int16_t DetermineAudioType(OpusDecInst* inst, int16_t encoded_bytes) {
 static int DecodeNative(OpusDecInst* inst, const uint8_t* encoded,
                         int16_t encoded_bytes, int frame_size,
                         int16_t* decoded, int16_t* audio_type, int decode_fec) {
-  int res = opus_decode(inst->decoder, encoded, encoded_bytes,
-                        (opus_int16*)decoded, frame_size, decode_fec);
+  int res;
+  if (inst->decoder) {
+    res = opus_decode(inst->decoder, encoded, encoded_bytes,
+                      (opus_int16*)decoded, frame_size, decode_fec);
+  } else {
+    res = opus_multistream_decode(inst->multistream_decoder, encoded,
+                                  encoded_bytes, (opus_int16*)decoded,
+                                  frame_size, decode_fec);
+  }
 
   if (res <= 0)
     return -1;
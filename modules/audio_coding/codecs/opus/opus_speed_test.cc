@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <vector>
+
 #include "webrtc/modules/audio_coding/codecs/opus/interface/opus_interface.h"
 #include "webrtc/modules/audio_coding/codecs/tools/audio_codec_speed_test.h"
 
@@ -44,8 +46,15 @@ void OpusSpeedTest::SetUp() {
   // If channels_ == 1, use Opus VOIP mode, otherwise, audio mode.
   int app = channels_ == 1 ? 0 : 1;
   /* Create encoder memory. */
-  EXPECT_EQ(0, WebRtcOpus_EncoderCreate(&opus_encoder_, channels_, app));
-  EXPECT_EQ(0, WebRtcOpus_DecoderCreate(&opus_decoder_, channels_));
+  if (channels_ > 2) {
+    EXPECT_EQ(0, WebRtcOpus_MultistreamEncoderCreate(&opus_encoder_, channels_,
+                                                     app));
+    EXPECT_EQ(0, WebRtcOpus_MultistreamDecoderCreate(&opus_decoder_,
+                                                     channels_));
+  } else {
+    EXPECT_EQ(0, WebRtcOpus_EncoderCreate(&opus_encoder_, channels_, app));
+    EXPECT_EQ(0, WebRtcOpus_DecoderCreate(&opus_decoder_, channels_));
+  }
   /* Set bitrate. */
   EXPECT_EQ(0, WebRtcOpus_SetBitRate(opus_encoder_, bit_rate_));
 }
@@ -103,6 +112,131 @@ ADD_TEST(2);
 ADD_TEST(1);
 ADD_TEST(0);
 
+// Codes surround audio as pairs of channels, with one stereo encoder and
+// decoder per pair. This is what the multistream codec is compared with.
+class OpusParallelStereoSpeedTest : public AudioCodecSpeedTest {
+ protected:
+  OpusParallelStereoSpeedTest();
+  void SetUp() override;
+  void TearDown() override;
+  virtual float EncodeABlock(int16_t* in_data, uint8_t* bit_stream,
+                             int max_bytes, int* encoded_bytes);
+  virtual float DecodeABlock(const uint8_t* bit_stream, int encoded_bytes,
+                             int16_t* out_data);
+  std::vector<WebRtcOpusEncInst*> opus_encoders_;
+  std::vector<WebRtcOpusDecInst*> opus_decoders_;
+  // Number of bytes of each pair in the last encoded block.
+  std::vector<int> pair_encoded_bytes_;
+  std::vector<int16_t> pair_data_;
+};
+
+OpusParallelStereoSpeedTest::OpusParallelStereoSpeedTest()
+    : AudioCodecSpeedTest(kOpusBlockDurationMs,
+                          kOpusSamplingKhz,
+                          kOpusSamplingKhz) {
+}
+
+void OpusParallelStereoSpeedTest::SetUp() {
+  AudioCodecSpeedTest::SetUp();
+  ASSERT_EQ(0, channels_ % 2);
+  const int num_pairs = channels_ / 2;
+  opus_encoders_.resize(num_pairs);
+  opus_decoders_.resize(num_pairs);
+  pair_encoded_bytes_.resize(num_pairs);
+  pair_data_.resize(2 * output_length_sample_);
+  for (int i = 0; i < num_pairs; ++i) {
+    EXPECT_EQ(0, WebRtcOpus_EncoderCreate(&opus_encoders_[i], 2, 1));
+    EXPECT_EQ(0, WebRtcOpus_DecoderCreate(&opus_decoders_[i], 2));
+    // Split the bit rate evenly between the pairs.
+    EXPECT_EQ(0, WebRtcOpus_SetBitRate(opus_encoders_[i],
+                                       bit_rate_ / num_pairs));
+  }
+}
+
+void OpusParallelStereoSpeedTest::TearDown() {
+  AudioCodecSpeedTest::TearDown();
+  for (size_t i = 0; i < opus_encoders_.size(); ++i) {
+    EXPECT_EQ(0, WebRtcOpus_EncoderFree(opus_encoders_[i]));
+    EXPECT_EQ(0, WebRtcOpus_DecoderFree(opus_decoders_[i]));
+  }
+}
+
+// The time spent splitting and merging the channels is included, since it is
+// part of the cost of coding surround audio with stereo instances.
+float OpusParallelStereoSpeedTest::EncodeABlock(int16_t* in_data,
+                                                uint8_t* bit_stream,
+                                                int max_bytes,
+                                                int* encoded_bytes) {
+  clock_t clocks = clock();
+  *encoded_bytes = 0;
+  for (size_t pair = 0; pair < opus_encoders_.size(); ++pair) {
+    for (int i = 0; i < input_length_sample_; ++i) {
+      pair_data_[2 * i] = in_data[i * channels_ + 2 * pair];
+      pair_data_[2 * i + 1] = in_data[i * channels_ + 2 * pair + 1];
+    }
+    int value = WebRtcOpus_Encode(opus_encoders_[pair], &pair_data_[0],
+                                  input_length_sample_,
+                                  max_bytes - *encoded_bytes,
+                                  &bit_stream[*encoded_bytes]);
+    EXPECT_GT(value, 0);
+    pair_encoded_bytes_[pair] = value;
+    *encoded_bytes += value;
+  }
+  clocks = clock() - clocks;
+  return 1000.0 * clocks / CLOCKS_PER_SEC;
+}
+
+float OpusParallelStereoSpeedTest::DecodeABlock(const uint8_t* bit_stream,
+                                                int encoded_bytes,
+                                                int16_t* out_data) {
+  int16_t audio_type;
+  clock_t clocks = clock();
+  for (size_t pair = 0; pair < opus_decoders_.size(); ++pair) {
+    int value = WebRtcOpus_Decode(opus_decoders_[pair], bit_stream,
+                                  pair_encoded_bytes_[pair], &pair_data_[0],
+                                  &audio_type);
+    EXPECT_EQ(output_length_sample_, value);
+    bit_stream += pair_encoded_bytes_[pair];
+    for (int i = 0; i < output_length_sample_; ++i) {
+      out_data[i * channels_ + 2 * pair] = pair_data_[2 * i];
+      out_data[i * channels_ + 2 * pair + 1] = pair_data_[2 * i + 1];
+    }
+  }
+  clocks = clock() - clocks;
+  return 1000.0 * clocks / CLOCKS_PER_SEC;
+}
+
+#define ADD_PARALLEL_TEST(complexity) \
+TEST_P(OpusParallelStereoSpeedTest, OpusSetComplexityTest##complexity) { \
+  /* Test audio length in second. */ \
+  size_t kDurationSec = 400; \
+  /* Set complexity. */ \
+  printf("Setting complexity to %d ...\n", complexity); \
+  for (size_t i = 0; i < opus_encoders_.size(); ++i) \
+    EXPECT_EQ(0, WebRtcOpus_SetComplexity(opus_encoders_[i], complexity)); \
+  EncodeDecode(kDurationSec); \
+}
+
+ADD_PARALLEL_TEST(10);
+ADD_PARALLEL_TEST(9);
+ADD_PARALLEL_TEST(5);
+ADD_PARALLEL_TEST(0);
+
+// There is no 5.1 test file, so the surround test cases read the stereo file
+// as six channels, i.e., each pair of channels gets every third stereo frame.
+const coding_param surround_param_set[] =
+    {::std::tr1::make_tuple(6, 192000,
+                            string("audio_coding/music_stereo_48kHz"),
+                            string("pcm"), false)};
+
+// Compare the output of these with the 5.1 cases of OpusSpeedTest, which uses
+// the multistream codec.
+INSTANTIATE_TEST_CASE_P(SurroundTest, OpusParallelStereoSpeedTest,
+                        ::testing::ValuesIn(surround_param_set));
+
+INSTANTIATE_TEST_CASE_P(SurroundTest, OpusSpeedTest,
+                        ::testing::ValuesIn(surround_param_set));
+
 // List all test cases: (channel, bit rat, filename, extension).
 const coding_param param_set[] =
     {::std::tr1::make_tuple(1, 64000,
@@ -7,7 +7,10 @@
  *  in the file PATENTS.  All contributing project authors may
  *  be found in the AUTHORS file in the root of the source tree.
  */
+#include <math.h>
+
 #include <string>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/audio_coding/codecs/opus/interface/opus_interface.h"
@@ -602,6 +605,137 @@ TEST_P(OpusTest, OpusDecodeRepacketized) {
   EXPECT_EQ(0, WebRtcOpus_DecoderFree(opus_decoder_));
 }
 
+TEST(OpusTest, MultistreamCreateFail) {
+  WebRtcOpusEncInst* opus_encoder;
+  WebRtcOpusDecInst* opus_decoder;
+
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(NULL, 6, 1));
+  // Invalid channel number.
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(&opus_encoder, 0, 1));
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(&opus_encoder, 9, 1));
+  // Invalid application mode.
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(&opus_encoder, 6, 2));
+
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamDecoderCreate(NULL, 6));
+  // Invalid channel number.
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamDecoderCreate(&opus_decoder, 0));
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamDecoderCreate(&opus_decoder, 9));
+}
+
+// Codes 5.1 audio, made of three copies of a stereo file, with one
+// multistream encoder and decoder.
+TEST(OpusTest, MultistreamEncodeDecode) {
+  const int kChannels = 6;
+  const int kPackets = 10;
+  AudioLoop stereo_data;
+  ASSERT_TRUE(stereo_data.Init(
+      webrtc::test::ResourcePath("audio_coding/teststereo32kHz", "pcm"),
+      kPackets * kOpus20msFrameSamples * 2, kOpus20msFrameSamples * 2));
+
+  WebRtcOpusEncInst* opus_encoder;
+  WebRtcOpusDecInst* opus_decoder;
+  ASSERT_EQ(0, WebRtcOpus_MultistreamEncoderCreate(&opus_encoder, kChannels,
+                                                   1));
+  ASSERT_EQ(0, WebRtcOpus_MultistreamDecoderCreate(&opus_decoder, kChannels));
+  EXPECT_EQ(kChannels, WebRtcOpus_DecoderChannels(opus_decoder));
+
+  // The encoder settings apply to all streams.
+  EXPECT_EQ(0, WebRtcOpus_SetBitRate(opus_encoder, 192000));
+  EXPECT_EQ(0, WebRtcOpus_SetComplexity(opus_encoder, 9));
+  EXPECT_EQ(0, WebRtcOpus_SetMaxPlaybackRate(opus_encoder, 48000));
+  EXPECT_EQ(0, WebRtcOpus_SetPacketLossRate(opus_encoder, 5));
+
+  int16_t input[kOpus20msFrameSamples * kChannels];
+  int16_t output[kOpus20msFrameSamples * kChannels];
+  uint8_t bitstream[kMaxBytes];
+  int16_t audio_type;
+  for (int packet = 0; packet < kPackets; ++packet) {
+    const int16_t* stereo_block = stereo_data.GetNextBlock();
+    for (int i = 0; i < kOpus20msFrameSamples; ++i) {
+      for (int channel = 0; channel < kChannels; ++channel)
+        input[i * kChannels + channel] = stereo_block[2 * i + channel % 2];
+    }
+    int16_t encoded_bytes = WebRtcOpus_Encode(
+        opus_encoder, input, kOpus20msFrameSamples, kMaxBytes, bitstream);
+    ASSERT_GT(encoded_bytes, 0);
+    EXPECT_EQ(kOpus20msFrameSamples,
+              WebRtcOpus_DurationEst(opus_decoder, bitstream, encoded_bytes));
+    EXPECT_EQ(kOpus20msFrameSamples,
+              WebRtcOpus_Decode(opus_decoder, bitstream, encoded_bytes, output,
+                                &audio_type));
+    EXPECT_EQ(0, audio_type);
+  }
+
+  // Packet loss concealment and re-initialization work as for one stream.
+  EXPECT_EQ(kOpus20msFrameSamples,
+            WebRtcOpus_DecodePlc(opus_decoder, output, 1));
+  EXPECT_EQ(0, WebRtcOpus_DecoderInit(opus_decoder));
+
+  EXPECT_EQ(0, WebRtcOpus_EncoderFree(opus_encoder));
+  EXPECT_EQ(0, WebRtcOpus_DecoderFree(opus_decoder));
+}
+
+// Codes a tone in one channel at a time and checks that it is decoded into the
+// same channel. The encoder takes its stream layout from libopus, while the
+// decoder uses kVorbisMappings, so this fails if a row of the table differs
+// from libopus.
+TEST(OpusTest, MultistreamChannelRouting) {
+  const int kPackets = 10;
+  // Low enough to pass through the LFE channel of 5.1 and 7.1.
+  const double kToneHz = 100;
+  int16_t input[kOpus20msFrameSamples * 8];
+  int16_t output[kOpus20msFrameSamples * 8];
+  uint8_t bitstream[kMaxBytes];
+  int16_t audio_type;
+  for (int channels = 1; channels <= 8; ++channels) {
+    for (int tone_channel = 0; tone_channel < channels; ++tone_channel) {
+      WebRtcOpusEncInst* opus_encoder;
+      WebRtcOpusDecInst* opus_decoder;
+      ASSERT_EQ(0, WebRtcOpus_MultistreamEncoderCreate(&opus_encoder,
+                                                       channels, 1));
+      ASSERT_EQ(0, WebRtcOpus_MultistreamDecoderCreate(&opus_decoder,
+                                                       channels));
+      std::vector<double> energy(channels);
+      for (int packet = 0; packet < kPackets; ++packet) {
+        for (int i = 0; i < kOpus20msFrameSamples; ++i) {
+          const int n = packet * kOpus20msFrameSamples + i;
+          for (int channel = 0; channel < channels; ++channel) {
+            input[i * channels + channel] =
+                channel == tone_channel
+                    ? static_cast<int16_t>(
+                          8000 * sin(2 * M_PI * kToneHz * n / 48000))
+                    : 0;
+          }
+        }
+        int16_t encoded_bytes = WebRtcOpus_Encode(
+            opus_encoder, input, kOpus20msFrameSamples, kMaxBytes, bitstream);
+        ASSERT_GT(encoded_bytes, 0);
+        ASSERT_EQ(kOpus20msFrameSamples,
+                  WebRtcOpus_Decode(opus_decoder, bitstream, encoded_bytes,
+                                    output, &audio_type));
+        // Skip the encoder's look-ahead and ramp-up.
+        if (packet < kPackets / 2)
+          continue;
+        for (int i = 0; i < kOpus20msFrameSamples; ++i) {
+          for (int channel = 0; channel < channels; ++channel) {
+            const double sample = output[i * channels + channel];
+            energy[channel] += sample * sample;
+          }
+        }
+      }
+      for (int channel = 0; channel < channels; ++channel) {
+        if (channel != tone_channel) {
+          EXPECT_GT(energy[tone_channel], 100 * energy[channel])
+              << channels << " channels, tone in channel " << tone_channel
+              << ", leaked into channel " << channel;
+        }
+      }
+      EXPECT_EQ(0, WebRtcOpus_EncoderFree(opus_encoder));
+      EXPECT_EQ(0, WebRtcOpus_DecoderFree(opus_decoder));
+    }
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(VariousMode,
                         OpusTest,
                         Combine(Values(1, 2), Values(0, 1)));
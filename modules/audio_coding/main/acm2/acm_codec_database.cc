@@ -67,7 +67,7 @@ const CodecInst ACMCodecDB::database_[] = {
 #endif
 #ifdef WEBRTC_CODEC_OPUS
   // Opus internally supports 48, 24, 16, 12, 8 kHz.
-  // Mono and stereo.
+  // Mono, stereo, 5.1 and 7.1 surround.
   {120, "opus", 48000, 960, 2, 64000},
 #endif
   // Comfort noise for four different sampling frequencies.
@@ -128,8 +128,8 @@ const ACMCodecDB::CodecSettings ACMCodecDB::codec_settings_[] = {
 #ifdef WEBRTC_CODEC_OPUS
     // Opus supports frames shorter than 10ms,
     // but it doesn't help us to use them.
-    // Mono and stereo.
-    {4, {480, 960, 1920, 2880}, 0, 2, false},
+    // Mono, stereo, 5.1 and 7.1 surround.
+    {4, {480, 960, 1920, 2880}, 0, 8, false},
 #endif
     // Comfort noise for three different sampling frequencies.
     {1, {240}, 240, 1, false},
@@ -184,7 +184,7 @@ const NetEqDecoder ACMCodecDB::neteq_decoders_[] = {
     kDecoderG722_2ch,
 #endif
 #ifdef WEBRTC_CODEC_OPUS
-    // Mono and stereo.
+    // Mono, stereo, 5.1 and 7.1 surround.
     kDecoderOpus,
 #endif
     // Comfort noise for three different sampling frequencies.
@@ -337,8 +337,11 @@ int ACMCodecDB::CodecId(const char* payload_name, int frequency, int channels) {
     if (STR_CASE_CMP(payload_name, "opus") != 0) {
       channels_match = (channels == database_[id].channels);
     } else {
-      // For opus we just check that number of channels is valid.
-      channels_match = (channels == 1 || channels == 2);
+      // For opus we just check that number of channels is valid. More than
+      // two channels are coded with the multistream codec, which NetEq can
+      // decode for 5.1 and 7.1 surround.
+      channels_match = (channels == 1 || channels == 2 || channels == 6 ||
+                        channels == 8);
     }
 
     if (name_match && frequency_match && channels_match) {
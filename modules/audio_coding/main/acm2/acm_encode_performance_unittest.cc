@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_coding/main/interface/audio_coding_module.h"
+#include "webrtc/modules/audio_coding/neteq/tools/input_audio_file.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kInputSampleRateHz = 32000;
+const int kSimulationTimeMs = 60000;
+
+// Counts the encoded packets.
+class PacketCounter : public AudioPacketizationCallback {
+ public:
+  PacketCounter() : num_packets_(0) {}
+
+  int32_t SendData(FrameType frame_type,
+                   uint8_t payload_type,
+                   uint32_t timestamp,
+                   const uint8_t* payload_data,
+                   size_t payload_len_bytes,
+                   const RTPFragmentationHeader* fragmentation) override {
+    ++num_packets_;
+    return 0;
+  }
+
+  int num_packets() const { return num_packets_; }
+
+ private:
+  int num_packets_;
+};
+
+// Encodes |kSimulationTimeMs| of audio with the codec |payload_name|. The
+// audio is added |batch_ms| at a time through AddMultiple10MsData(), or 10 ms
+// at a time through Add10MsData() if |batch_ms| is 0. Returns the runtime in
+// ms, or -1 on error.
+int64_t RunEncode(const char* payload_name,
+                  int sampling_freq_hz,
+                  int channels,
+                  int batch_ms) {
+  CodecInst codec;
+  if (AudioCodingModule::Codec(payload_name, &codec, sampling_freq_hz,
+                               channels) != 0)
+    return -1;
+  rtc::scoped_ptr<AudioCodingModule> acm(AudioCodingModule::Create(0));
+  PacketCounter packet_counter;
+  if (acm->RegisterSendCodec(codec) != 0 ||
+      acm->RegisterTransportCallback(&packet_counter) != 0)
+    return -1;
+
+  // Read all input audio up front, so that only the encoding is timed.
+  const int kSamplesPer10Ms = kInputSampleRateHz / 100;
+  const int kNumSamples = kSimulationTimeMs * kInputSampleRateHz / 1000;
+  test::InputAudioFile input_file(
+      test::ResourcePath("audio_coding/testfile32kHz", "pcm"));
+  std::vector<int16_t> audio(kNumSamples * channels);
+  for (int i = 0; i < kNumSamples; i += kSamplesPer10Ms) {
+    int16_t* block = &audio[i * channels];
+    if (!input_file.Read(kSamplesPer10Ms, block))
+      return -1;
+    if (channels > 1) {
+      test::InputAudioFile::DuplicateInterleaved(block, kSamplesPer10Ms,
+                                                 channels, block);
+    }
+  }
+
+  AudioFrame frame;
+  frame.sample_rate_hz_ = kInputSampleRateHz;
+  frame.num_channels_ = channels;
+  frame.samples_per_channel_ = kSamplesPer10Ms;
+  const int kSamplesPerBatch =
+      batch_ms > 0 ? batch_ms * kInputSampleRateHz / 1000 : kSamplesPer10Ms;
+  int64_t start_time_ms = Clock::GetRealTimeClock()->TimeInMilliseconds();
+  for (int i = 0; i < kNumSamples; i += kSamplesPerBatch) {
+    const int length = std::min(kSamplesPerBatch, kNumSamples - i);
+    if (batch_ms > 0) {
+      if (acm->AddMultiple10MsData(&audio[i * channels], length,
+                                   kInputSampleRateHz, channels, i) < 0)
+        return -1;
+    } else {
+      // Copy the block, as a caller of Add10MsData() would.
+      memcpy(frame.data_, &audio[i * channels],
+             length * channels * sizeof(int16_t));
+      frame.timestamp_ = i;
+      if (acm->Add10MsData(frame) < 0)
+        return -1;
+    }
+  }
+  int64_t runtime_ms =
+      Clock::GetRealTimeClock()->TimeInMilliseconds() - start_time_ms;
+  if (packet_counter.num_packets() == 0)
+    return -1;
+  return runtime_ms;
+}
+
+void RunAndPrint(const char* payload_name,
+                 int sampling_freq_hz,
+                 int channels,
+                 const std::string& trace) {
+  int64_t runtime = RunEncode(payload_name, sampling_freq_hz, channels, 0);
+  ASSERT_GT(runtime, 0);
+  webrtc::test::PrintResult(
+      "acm_encode_performance", "", trace, runtime, "ms", true);
+  // Add one second of audio per call.
+  runtime = RunEncode(payload_name, sampling_freq_hz, channels, 1000);
+  ASSERT_GT(runtime, 0);
+  webrtc::test::PrintResult(
+      "acm_encode_performance", "", trace + "_batch", runtime, "ms", true);
+}
+
+}  // namespace
+
+// Each test encodes the same audio twice, first one 10 ms block per call and
+// then one second per call, and reports the runtime of both.
+TEST(AcmEncodePerformanceTest, Opus) {
+  RunAndPrint("opus", 48000, 2, "opus_stereo");
+}
+
+TEST(AcmEncodePerformanceTest, Isac) {
+  RunAndPrint("ISAC", 16000, 1, "isac_wb");
+}
+
+TEST(AcmEncodePerformanceTest, G722) {
+  RunAndPrint("G722", 16000, 1, "g722");
+}
+
+}  // namespace webrtc
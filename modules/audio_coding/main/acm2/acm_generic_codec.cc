@@ -262,7 +262,8 @@ void ACMGenericCodec::ResetAudioEncoder() {
 #ifdef WEBRTC_CODEC_OPUS
   } else if (!STR_CASE_CMP(codec_inst.plname, "opus")) {
     is_opus_ = true;
-    has_internal_fec_ = true;
+    // FEC is not supported for multistream (surround) Opus.
+    has_internal_fec_ = codec_inst.channels <= 2;
     AudioEncoderOpus::Config config;
     config.frame_size_ms = codec_inst.pacsize / 48;
     config.num_channels = codec_inst.channels;
@@ -478,6 +479,8 @@ AudioDecoder* ACMGenericCodec::Decoder() {
 int ACMGenericCodec::EnableOpusDtx(bool force_voip) {
   if (!is_opus_)
     return -1;  // Needed for tests to pass.
+  if (encoder_->NumChannels() > 2)
+    return -1;  // DTX is not supported for multistream (surround) Opus.
   if (!force_voip &&
       GetOpusApplication(encoder_->NumChannels(), true) != kVoip) {
       // Opus DTX can only be enabled when application mode is KVoip.
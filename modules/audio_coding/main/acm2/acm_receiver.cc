@@ -483,8 +483,14 @@ int32_t AcmReceiver::AddCodec(int acm_codec_id,
   NetEqDecoder neteq_decoder = ACMCodecDB::neteq_decoders_[acm_codec_id];
 
   // Make sure the right decoder is registered for Opus.
-  if (neteq_decoder == kDecoderOpus && channels == 2) {
-    neteq_decoder = kDecoderOpus_2ch;
+  if (neteq_decoder == kDecoderOpus) {
+    if (channels == 2) {
+      neteq_decoder = kDecoderOpus_2ch;
+    } else if (channels == 6) {
+      neteq_decoder = kDecoderOpus_6ch;
+    } else if (channels == 8) {
+      neteq_decoder = kDecoderOpus_8ch;
+    }
   }
 
   CriticalSectionScoped lock(crit_sect_.get());
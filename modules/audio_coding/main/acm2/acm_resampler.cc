@@ -64,5 +64,58 @@ int ACMResampler::Resample10Msec(const int16_t* in_audio,
   return out_length / num_audio_channels;
 }
 
+int ACMResampler::ResampleMultiple10Msec(const int16_t* in_audio,
+                                         int num_blocks,
+                                         int in_freq_hz,
+                                         int out_freq_hz,
+                                         int num_audio_channels,
+                                         int out_capacity_samples,
+                                         int16_t* out_audio) {
+  int in_block_length = in_freq_hz * num_audio_channels / 100;
+  int out_block_length = out_freq_hz * num_audio_channels / 100;
+  if (num_blocks <= 0) {
+    assert(false);
+    return -1;
+  }
+  if (in_freq_hz == out_freq_hz) {
+    if (out_capacity_samples < num_blocks * in_block_length) {
+      assert(false);
+      return -1;
+    }
+    memcpy(out_audio, in_audio,
+           num_blocks * in_block_length * sizeof(int16_t));
+    return num_blocks * in_block_length / num_audio_channels;
+  }
+
+  if (out_capacity_samples < num_blocks * out_block_length) {
+    assert(false);
+    return -1;
+  }
+  if (resampler_.InitializeIfNeeded(in_freq_hz, out_freq_hz,
+                                    num_audio_channels) != 0) {
+    LOG_FERR3(LS_ERROR, InitializeIfNeeded, in_freq_hz, out_freq_hz,
+              num_audio_channels);
+    return -1;
+  }
+
+  // The resampler works on one 10 ms block at a time.
+  for (int n = 0; n < num_blocks; ++n) {
+    if (resampler_.Resample(in_audio, in_block_length, out_audio,
+                            out_block_length) != out_block_length) {
+      LOG_FERR4(LS_ERROR,
+                Resample,
+                in_audio,
+                in_block_length,
+                out_audio,
+                out_block_length);
+      return -1;
+    }
+    in_audio += in_block_length;
+    out_audio += out_block_length;
+  }
+
+  return num_blocks * out_block_length / num_audio_channels;
+}
+
 }  // namespace acm2
 }  // namespace webrtc
@@ -29,6 +29,18 @@ class ACMResampler {
                      int out_capacity_samples,
                      int16_t* out_audio);
 
+  // Resamples |num_blocks| consecutive 10 ms blocks of interleaved audio in
+  // one pass. The output is the same as when calling Resample10Msec() once
+  // per block. Returns the number of output samples per channel, or -1 on
+  // error.
+  int ResampleMultiple10Msec(const int16_t* in_audio,
+                             int num_blocks,
+                             int in_freq_hz,
+                             int out_freq_hz,
+                             int num_audio_channels,
+                             int out_capacity_samples,
+                             int16_t* out_audio);
+
  private:
   PushResampler<int16_t> resampler_;
 };
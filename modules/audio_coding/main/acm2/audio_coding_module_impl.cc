@@ -76,27 +76,43 @@ bool IsCodecCN(int index) {
 }
 
 // Stereo-to-mono can be used as in-place.
-int DownMix(const AudioFrame& frame, int length_out_buff, int16_t* out_buff) {
-  if (length_out_buff < frame.samples_per_channel_) {
+int DownMix(const int16_t* audio,
+            int samples_per_channel,
+            int length_out_buff,
+            int16_t* out_buff) {
+  if (length_out_buff < samples_per_channel) {
     return -1;
   }
-  for (int n = 0; n < frame.samples_per_channel_; ++n)
-    out_buff[n] = (frame.data_[2 * n] + frame.data_[2 * n + 1]) >> 1;
+  for (int n = 0; n < samples_per_channel; ++n)
+    out_buff[n] = (audio[2 * n] + audio[2 * n + 1]) >> 1;
   return 0;
 }
 
+int DownMix(const AudioFrame& frame, int length_out_buff, int16_t* out_buff) {
+  return DownMix(frame.data_, frame.samples_per_channel_, length_out_buff,
+                 out_buff);
+}
+
 // Mono-to-stereo can be used as in-place.
-int UpMix(const AudioFrame& frame, int length_out_buff, int16_t* out_buff) {
-  if (length_out_buff < frame.samples_per_channel_) {
+int UpMix(const int16_t* audio,
+          int samples_per_channel,
+          int length_out_buff,
+          int16_t* out_buff) {
+  if (length_out_buff < samples_per_channel) {
     return -1;
   }
-  for (int n = frame.samples_per_channel_ - 1; n >= 0; --n) {
-    out_buff[2 * n + 1] = frame.data_[n];
-    out_buff[2 * n] = frame.data_[n];
+  for (int n = samples_per_channel - 1; n >= 0; --n) {
+    out_buff[2 * n + 1] = audio[n];
+    out_buff[2 * n] = audio[n];
   }
   return 0;
 }
 
+int UpMix(const AudioFrame& frame, int length_out_buff, int16_t* out_buff) {
+  return UpMix(frame.data_, frame.samples_per_channel_, length_out_buff,
+               out_buff);
+}
+
 void ConvertEncodedInfoToFragmentationHeader(
     const AudioEncoder::EncodedInfo& info,
     RTPFragmentationHeader* frag) {
@@ -118,6 +134,18 @@ void ConvertEncodedInfoToFragmentationHeader(
     frag->fragmentationPlType[i] = info.redundant[i].payload_type;
   }
 }
+
+// Returns the frame type of an encoded packet. An empty packet gets the
+// payload type of the previous packet, |previous_pltype|.
+FrameType GetFrameType(uint8_t previous_pltype,
+                       AudioEncoder::EncodedInfo* encoded_info) {
+  if (encoded_info->encoded_bytes == 0 && encoded_info->send_even_if_empty) {
+    encoded_info->payload_type = previous_pltype;
+    return kFrameEmpty;
+  }
+  DCHECK_GT(encoded_info->encoded_bytes, 0u);
+  return encoded_info->speech ? kAudioFrameSpeech : kAudioFrameCN;
+}
 }  // namespace
 
 AudioCodingModuleImpl::AudioCodingModuleImpl(
@@ -221,7 +249,7 @@ AudioCodingModuleImpl::~AudioCodingModuleImpl() {
 int32_t AudioCodingModuleImpl::Encode(const InputData& input_data) {
   uint8_t stream[2 * MAX_PAYLOAD_SIZE_BYTE];  // Make room for 1 RED payload.
   AudioEncoder::EncodedInfo encoded_info;
-  uint8_t previous_pltype;
+  FrameType frame_type;
 
   // Keep the scope of the ACM critical section limited.
   {
@@ -231,56 +259,17 @@ int32_t AudioCodingModuleImpl::Encode(const InputData& input_data) {
       return -1;
     }
 
-    AudioEncoder* audio_encoder =
-        codecs_[current_send_codec_idx_]->GetAudioEncoder();
-    // Scale the timestamp to the codec's RTP timestamp rate.
-    uint32_t rtp_timestamp =
-        first_frame_ ? input_data.input_timestamp
-                     : last_rtp_timestamp_ +
-                           rtc::CheckedDivExact(
-                               input_data.input_timestamp - last_timestamp_,
-                               static_cast<uint32_t>(rtc::CheckedDivExact(
-                                   audio_encoder->SampleRateHz(),
-                                   audio_encoder->RtpTimestampRateHz())));
-    last_timestamp_ = input_data.input_timestamp;
-    last_rtp_timestamp_ = rtp_timestamp;
-    first_frame_ = false;
-
-    encoded_info = audio_encoder->Encode(rtp_timestamp, input_data.audio,
-                                         input_data.length_per_channel,
-                                         sizeof(stream), stream);
-    if (encoded_info.encoded_bytes == 0 && !encoded_info.send_even_if_empty) {
+    if (!EncodeSafe(input_data, sizeof(stream), stream, &encoded_info)) {
       // Not enough data.
       return 0;
     }
-    previous_pltype = previous_pltype_;  // Read it while we have the critsect.
-  }
-
-  RTPFragmentationHeader my_fragmentation;
-  ConvertEncodedInfoToFragmentationHeader(encoded_info, &my_fragmentation);
-  FrameType frame_type;
-  if (encoded_info.encoded_bytes == 0 && encoded_info.send_even_if_empty) {
-    frame_type = kFrameEmpty;
-    encoded_info.payload_type = previous_pltype;
-  } else {
-    DCHECK_GT(encoded_info.encoded_bytes, 0u);
-    frame_type = encoded_info.speech ? kAudioFrameSpeech : kAudioFrameCN;
+    // Read |previous_pltype_| while we have the critsect.
+    frame_type = GetFrameType(previous_pltype_, &encoded_info);
   }
 
   {
     CriticalSectionScoped lock(callback_crit_sect_);
-    if (packetization_callback_) {
-      packetization_callback_->SendData(
-          frame_type, encoded_info.payload_type, encoded_info.encoded_timestamp,
-          stream, encoded_info.encoded_bytes,
-          my_fragmentation.fragmentationVectorSize > 0 ? &my_fragmentation
-              : nullptr);
-    }
-
-    if (vad_callback_) {
-      // Callback with VAD decision.
-      vad_callback_->InFrameType(frame_type);
-    }
+    SendEncodedData(frame_type, encoded_info, stream);
   }
   {
     CriticalSectionScoped lock(acm_crit_sect_);
@@ -289,6 +278,52 @@ int32_t AudioCodingModuleImpl::Encode(const InputData& input_data) {
   return static_cast<int32_t>(encoded_info.encoded_bytes);
 }
 
+bool AudioCodingModuleImpl::EncodeSafe(
+    const InputData& input_data,
+    size_t stream_size,
+    uint8_t* stream,
+    AudioEncoder::EncodedInfo* encoded_info) {
+  AudioEncoder* audio_encoder =
+      codecs_[current_send_codec_idx_]->GetAudioEncoder();
+  // Scale the timestamp to the codec's RTP timestamp rate.
+  uint32_t rtp_timestamp =
+      first_frame_ ? input_data.input_timestamp
+                   : last_rtp_timestamp_ +
+                         rtc::CheckedDivExact(
+                             input_data.input_timestamp - last_timestamp_,
+                             static_cast<uint32_t>(rtc::CheckedDivExact(
+                                 audio_encoder->SampleRateHz(),
+                                 audio_encoder->RtpTimestampRateHz())));
+  last_timestamp_ = input_data.input_timestamp;
+  last_rtp_timestamp_ = rtp_timestamp;
+  first_frame_ = false;
+
+  *encoded_info = audio_encoder->Encode(rtp_timestamp, input_data.audio,
+                                        input_data.length_per_channel,
+                                        stream_size, stream);
+  return encoded_info->encoded_bytes > 0 || encoded_info->send_even_if_empty;
+}
+
+void AudioCodingModuleImpl::SendEncodedData(
+    FrameType frame_type,
+    const AudioEncoder::EncodedInfo& encoded_info,
+    const uint8_t* stream) {
+  RTPFragmentationHeader my_fragmentation;
+  ConvertEncodedInfoToFragmentationHeader(encoded_info, &my_fragmentation);
+  if (packetization_callback_) {
+    packetization_callback_->SendData(
+        frame_type, encoded_info.payload_type, encoded_info.encoded_timestamp,
+        stream, encoded_info.encoded_bytes,
+        my_fragmentation.fragmentationVectorSize > 0 ? &my_fragmentation
+            : nullptr);
+  }
+
+  if (vad_callback_) {
+    // Callback with VAD decision.
+    vad_callback_->InFrameType(frame_type);
+  }
+}
+
 /////////////////////////////////////////
 //   Sender
 //
@@ -335,10 +370,11 @@ static int IsValidSendCodec(const CodecInst& send_codec,
                             bool is_primary_encoder,
                             int acm_id,
                             int* mirror_id) {
-  if ((send_codec.channels != 1) && (send_codec.channels != 2)) {
+  // The number of channels each codec supports is checked below.
+  if (send_codec.channels < 1) {
     WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, acm_id,
-                 "Wrong number of channels (%d, only mono and stereo are "
-                 "supported) for %s encoder", send_codec.channels,
+                 "Wrong number of channels (%d) for %s encoder",
+                 send_codec.channels,
                  is_primary_encoder ? "primary" : "secondary");
     return -1;
   }
@@ -470,8 +506,8 @@ int AudioCodingModuleImpl::RegisterSendCodec(const CodecInst& send_codec) {
     return 0;
   }
 
-  // Set Stereo, and make sure VAD and DTX is turned off.
-  if (send_codec.channels == 2) {
+  // Set Stereo (also for surround), and make sure VAD and DTX is turned off.
+  if (send_codec.channels >= 2) {
     stereo_send_ = true;
     if (vad_enabled_ || dtx_enabled_) {
       WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceAudioCoding, id_,
@@ -767,18 +803,18 @@ int AudioCodingModuleImpl::Add10MsDataInternal(const AudioFrame& audio_frame,
     return -1;
   }
 
-  if (audio_frame.num_channels_ != 1 && audio_frame.num_channels_ != 2) {
-    WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
-                 "Cannot Add 10 ms audio, invalid number of channels.");
-    return -1;
-  }
-
   CriticalSectionScoped lock(acm_crit_sect_);
   // Do we have a codec registered?
   if (!HaveValidEncoder("Add10MsData")) {
     return -1;
   }
 
+  if (!IsValidInputChannels(audio_frame.num_channels_)) {
+    WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                 "Cannot Add 10 ms audio, invalid number of channels.");
+    return -1;
+  }
+
   const AudioFrame* ptr_frame;
   // Perform a resampling, also down-mix if it is required and can be
   // performed before resampling (a down mix prior to resampling will take
@@ -817,6 +853,116 @@ int AudioCodingModuleImpl::Add10MsDataInternal(const AudioFrame& audio_frame,
   return 0;
 }
 
+// Add several consecutive 10 ms blocks of raw (PCM) audio data to the encoder.
+int AudioCodingModuleImpl::AddMultiple10MsData(const int16_t* audio,
+                                               int samples_per_channel,
+                                               int sample_rate_hz,
+                                               int num_channels,
+                                               uint32_t timestamp) {
+  if (audio == NULL) {
+    assert(false);
+    WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                 "Cannot add audio, no input buffer");
+    return -1;
+  }
+
+  if (sample_rate_hz < 100 || sample_rate_hz > 48000) {
+    assert(false);
+    WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                 "Cannot add audio, input frequency not valid");
+    return -1;
+  }
+
+  // We only accept whole 10 ms blocks.
+  const int samples_per_block = sample_rate_hz / 100;
+  if (samples_per_channel <= 0 ||
+      samples_per_channel % samples_per_block != 0) {
+    WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                 "Cannot add audio, length is not a multiple of 10 ms");
+    return -1;
+  }
+
+  const int num_blocks = samples_per_channel / samples_per_block;
+  // The packets are delivered after the ACM critical section is released.
+  std::vector<EncodedPacket> packets;
+  std::vector<uint8_t> payloads;
+  {
+    CriticalSectionScoped lock(acm_crit_sect_);
+    // Do we have a codec registered?
+    if (!HaveValidEncoder("AddMultiple10MsData")) {
+      return -1;
+    }
+
+    if (!IsValidInputChannels(num_channels)) {
+      WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                   "Cannot add audio, invalid number of channels.");
+      return -1;
+    }
+
+    const int16_t* codec_audio;
+    int codec_channels;
+    int codec_samples_per_block;
+    uint32_t codec_timestamp;
+    if (PreprocessMultipleToAddData(audio, num_blocks, sample_rate_hz,
+                                    num_channels, timestamp, &codec_audio,
+                                    &codec_channels, &codec_samples_per_block,
+                                    &codec_timestamp) < 0) {
+      return -1;
+    }
+
+    // A down-mix is done by PreprocessMultipleToAddData(), so an up-mix is
+    // the only re-mix that can remain. All blocks have the same length, so
+    // check that it fits before encoding any of them.
+    const bool up_mix = codec_channels != send_codec_inst_.channels;
+    if (up_mix && codec_samples_per_block > WEBRTC_10MS_PCM_AUDIO) {
+      WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                   "Cannot add audio, block too long to up-mix");
+      return -1;
+    }
+
+    uint8_t stream[2 * MAX_PAYLOAD_SIZE_BYTE];  // Make room for 1 RED payload.
+    uint8_t previous_pltype = previous_pltype_;
+    InputData input_data;
+    input_data.length_per_channel = codec_samples_per_block;
+    input_data.audio_channel = send_codec_inst_.channels;
+    for (int i = 0; i < num_blocks; ++i) {
+      input_data.audio =
+          &codec_audio[i * codec_samples_per_block * codec_channels];
+      if (up_mix) {
+        UpMix(input_data.audio, codec_samples_per_block, WEBRTC_10MS_PCM_AUDIO,
+              input_data.buffer);
+        input_data.audio = input_data.buffer;
+      }
+      input_data.input_timestamp =
+          codec_timestamp + static_cast<uint32_t>(i * codec_samples_per_block);
+
+      EncodedPacket packet;
+      if (!EncodeSafe(input_data, sizeof(stream), stream, &packet.info)) {
+        // Not enough data.
+        continue;
+      }
+      packet.frame_type = GetFrameType(previous_pltype, &packet.info);
+      packet.payload_offset = payloads.size();
+      payloads.insert(payloads.end(), stream,
+                      stream + packet.info.encoded_bytes);
+      packets.push_back(packet);
+      previous_pltype = packet.info.payload_type;
+    }
+    previous_pltype_ = previous_pltype;
+  }
+
+  int32_t encoded_bytes = 0;
+  {
+    CriticalSectionScoped lock(callback_crit_sect_);
+    for (size_t i = 0; i < packets.size(); ++i) {
+      SendEncodedData(packets[i].frame_type, packets[i].info,
+                      payloads.data() + packets[i].payload_offset);
+      encoded_bytes += static_cast<int32_t>(packets[i].info.encoded_bytes);
+    }
+  }
+  return encoded_bytes;
+}
+
 // Perform a resampling and down-mix if required. We down-mix only if
 // encoder is mono and input is stereo. In case of dual-streaming, both
 // encoders has to be mono for down-mix to take place.
@@ -831,17 +977,7 @@ int AudioCodingModuleImpl::PreprocessToAddData(const AudioFrame& in_frame,
   bool down_mix =
       (in_frame.num_channels_ == 2) && (send_codec_inst_.channels == 1);
 
-  if (!first_10ms_data_) {
-    expected_in_ts_ = in_frame.timestamp_;
-    expected_codec_ts_ = in_frame.timestamp_;
-    first_10ms_data_ = true;
-  } else if (in_frame.timestamp_ != expected_in_ts_) {
-    // TODO(turajs): Do we need a warning here.
-    expected_codec_ts_ += (in_frame.timestamp_ - expected_in_ts_) *
-        static_cast<uint32_t>((static_cast<double>(send_codec_inst_.plfreq) /
-                    static_cast<double>(in_frame.sample_rate_hz_)));
-    expected_in_ts_ = in_frame.timestamp_;
-  }
+  UpdateExpectedTimestamps(in_frame.timestamp_, in_frame.sample_rate_hz_);
 
 
   if (!down_mix && !resample) {
@@ -899,6 +1035,92 @@ int AudioCodingModuleImpl::PreprocessToAddData(const AudioFrame& in_frame,
   return 0;
 }
 
+int AudioCodingModuleImpl::PreprocessMultipleToAddData(
+    const int16_t* audio,
+    int num_blocks,
+    int sample_rate_hz,
+    int num_channels,
+    uint32_t timestamp,
+    const int16_t** ptr_out,
+    int* num_channels_out,
+    int* samples_per_block_out,
+    uint32_t* timestamp_out) {
+  const int samples_per_block = sample_rate_hz / 100;
+  const int samples_per_channel = num_blocks * samples_per_block;
+  bool resample = (sample_rate_hz != send_codec_inst_.plfreq);
+  bool down_mix = (num_channels == 2) && (send_codec_inst_.channels == 1);
+
+  UpdateExpectedTimestamps(timestamp, sample_rate_hz);
+
+  *num_channels_out = num_channels;
+  *samples_per_block_out = samples_per_block;
+  if (!down_mix && !resample) {
+    // No pre-processing is required.
+    expected_in_ts_ += samples_per_channel;
+    expected_codec_ts_ += samples_per_channel;
+    *ptr_out = audio;
+    *timestamp_out = timestamp;
+    return 0;
+  }
+
+  *timestamp_out = expected_codec_ts_;
+  const int16_t* src_ptr_audio = audio;
+  if (down_mix) {
+    // If a resampling is required the output of a down-mix is written into a
+    // separate buffer, otherwise, it is the output of the pre-processing.
+    std::vector<int16_t>* down_mix_out =
+        resample ? &down_mix_buffer_ : &preprocess_buffer_;
+    down_mix_out->resize(samples_per_channel);
+    if (DownMix(audio, samples_per_channel, samples_per_channel,
+                &(*down_mix_out)[0]) < 0)
+      return -1;
+    *num_channels_out = 1;
+    // Set the input of the resampler is the down-mixed signal.
+    src_ptr_audio = &(*down_mix_out)[0];
+  }
+
+  // If it is required, we have to do a resampling, of all blocks in one pass.
+  if (resample) {
+    preprocess_buffer_.resize(
+        num_blocks * (send_codec_inst_.plfreq / 100) * *num_channels_out);
+    int resampled_samples_per_channel =
+        resampler_.ResampleMultiple10Msec(src_ptr_audio,
+                                          num_blocks,
+                                          sample_rate_hz,
+                                          send_codec_inst_.plfreq,
+                                          *num_channels_out,
+                                          preprocess_buffer_.size(),
+                                          &preprocess_buffer_[0]);
+    if (resampled_samples_per_channel < 0) {
+      WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                   "Cannot add audio, resampling failed");
+      return -1;
+    }
+    *samples_per_block_out = resampled_samples_per_channel / num_blocks;
+  }
+  *ptr_out = &preprocess_buffer_[0];
+
+  expected_codec_ts_ += num_blocks * *samples_per_block_out;
+  expected_in_ts_ += samples_per_channel;
+
+  return 0;
+}
+
+void AudioCodingModuleImpl::UpdateExpectedTimestamps(uint32_t in_timestamp,
+                                                     int in_sample_rate_hz) {
+  if (!first_10ms_data_) {
+    expected_in_ts_ = in_timestamp;
+    expected_codec_ts_ = in_timestamp;
+    first_10ms_data_ = true;
+  } else if (in_timestamp != expected_in_ts_) {
+    // TODO(turajs): Do we need a warning here.
+    expected_codec_ts_ += (in_timestamp - expected_in_ts_) *
+        static_cast<uint32_t>((static_cast<double>(send_codec_inst_.plfreq) /
+                    static_cast<double>(in_sample_rate_hz)));
+    expected_in_ts_ = in_timestamp;
+  }
+}
+
 /////////////////////////////////////////
 //   (RED) Redundant Coding
 //
@@ -1002,7 +1224,7 @@ int AudioCodingModuleImpl::SetVADSafe(bool enable_dtx,
   }
 
   // Check that the send codec is mono. We don't support VAD/DTX for stereo
-  // sending.
+  // (or surround) sending.
   if ((enable_dtx || enable_vad) && stereo_send_) {
     WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
                  "VAD/DTX not supported for stereo sending");
@@ -1119,7 +1341,9 @@ int AudioCodingModuleImpl::PlayoutFrequency() const {
 int AudioCodingModuleImpl::RegisterReceiveCodec(const CodecInst& codec) {
   CriticalSectionScoped lock(acm_crit_sect_);
 
-  if (codec.channels > 2 || codec.channels < 0) {
+  // Only Opus supports more than two channels, which is checked when the
+  // codec is looked up below.
+  if (codec.channels > 8 || codec.channels < 0) {
     WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
                  "Unsupported number of channels, %d.", codec.channels);
     return -1;
@@ -1414,6 +1638,12 @@ bool AudioCodingModuleImpl::HaveValidEncoder(const char* caller_name) const {
   return true;
 }
 
+bool AudioCodingModuleImpl::IsValidInputChannels(int num_channels) const {
+  if (num_channels == 1 || num_channels == 2)
+    return send_codec_inst_.channels <= 2;
+  return num_channels == send_codec_inst_.channels;
+}
+
 int AudioCodingModuleImpl::UnregisterReceiveCodec(uint8_t payload_type) {
   return receiver_.RemoveCodec(payload_type);
 }
@@ -17,6 +17,7 @@
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/common_types.h"
 #include "webrtc/engine_configurations.h"
+#include "webrtc/modules/audio_coding/codecs/audio_encoder.h"
 #include "webrtc/modules/audio_coding/main/acm2/acm_codec_database.h"
 #include "webrtc/modules/audio_coding/main/acm2/acm_receiver.h"
 #include "webrtc/modules/audio_coding/main/acm2/acm_resampler.h"
@@ -73,6 +74,14 @@ class AudioCodingModuleImpl : public AudioCodingModule {
   // Add 10 ms of raw (PCM) audio data to the encoder.
   int Add10MsData(const AudioFrame& audio_frame) override;
 
+  // Add several consecutive 10 ms blocks of raw (PCM) audio data to the
+  // encoder.
+  int AddMultiple10MsData(const int16_t* audio,
+                          int samples_per_channel,
+                          int sample_rate_hz,
+                          int num_channels,
+                          uint32_t timestamp) override;
+
   /////////////////////////////////////////
   // (RED) Redundant Coding
   //
@@ -246,9 +255,31 @@ class AudioCodingModuleImpl : public AudioCodingModule {
     int16_t buffer[WEBRTC_10MS_PCM_AUDIO];
   };
 
+  // An encoded packet waiting to be delivered by AddMultiple10MsData(). The
+  // payload is stored at |payload_offset| in a buffer shared by all packets.
+  struct EncodedPacket {
+    AudioEncoder::EncodedInfo info;
+    FrameType frame_type;
+    size_t payload_offset;
+  };
+
   int Add10MsDataInternal(const AudioFrame& audio_frame, InputData* input_data);
   int Encode(const InputData& input_data);
 
+  // Encodes |input_data| into |stream|, which must have room for
+  // |stream_size| bytes. Returns false if no packet was produced.
+  bool EncodeSafe(const InputData& input_data,
+                  size_t stream_size,
+                  uint8_t* stream,
+                  AudioEncoder::EncodedInfo* encoded_info)
+      EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
+
+  // Delivers an encoded packet to the registered callbacks.
+  void SendEncodedData(FrameType frame_type,
+                       const AudioEncoder::EncodedInfo& encoded_info,
+                       const uint8_t* stream)
+      EXCLUSIVE_LOCKS_REQUIRED(callback_crit_sect_);
+
   ACMGenericCodec* CreateCodec(const CodecInst& codec);
 
   int InitializeReceiverSafe() EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
@@ -256,6 +287,12 @@ class AudioCodingModuleImpl : public AudioCodingModule {
   bool HaveValidEncoder(const char* caller_name) const
       EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
 
+  // Returns true if audio with |num_channels| channels can be encoded by the
+  // send codec. Mono and stereo audio is re-mixed to the channels of a mono
+  // or stereo codec, but surround audio must have the channels of the codec.
+  bool IsValidInputChannels(int num_channels) const
+      EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
+
   // Set VAD/DTX status. This function does not acquire a lock, and it is
   // created to be called only from inside a critical section.
   int SetVADSafe(bool enable_dtx, bool enable_vad, ACMVADMode mode)
@@ -276,6 +313,38 @@ class AudioCodingModuleImpl : public AudioCodingModule {
                           const AudioFrame** ptr_out)
       EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
 
+  // Same as PreprocessToAddData(), but for |num_blocks| consecutive 10 ms
+  // blocks of interleaved audio.
+  //
+  // audio: input audio, |num_blocks| * |sample_rate_hz| / 100 samples per
+  //        channel.
+  // ptr_out: pointer to the output audio. If no preprocessing is required
+  //          |*ptr_out| will be pointing to |audio|, otherwise to
+  //          |preprocess_buffer_|.
+  // num_channels_out: number of channels of |*ptr_out|.
+  // samples_per_block_out: samples per channel in each 10 ms block of
+  //                        |*ptr_out|.
+  // timestamp_out: timestamp of the first sample of |*ptr_out|.
+  //
+  // Return value:
+  //   -1: if encountering an error.
+  //    0: otherwise.
+  int PreprocessMultipleToAddData(const int16_t* audio,
+                                  int num_blocks,
+                                  int sample_rate_hz,
+                                  int num_channels,
+                                  uint32_t timestamp,
+                                  const int16_t** ptr_out,
+                                  int* num_channels_out,
+                                  int* samples_per_block_out,
+                                  uint32_t* timestamp_out)
+      EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
+
+  // Updates the expected timestamps of the input and the codec, given that the
+  // next input block starts at |in_timestamp|.
+  void UpdateExpectedTimestamps(uint32_t in_timestamp, int in_sample_rate_hz)
+      EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
+
   // Change required states after starting to receive the codec corresponding
   // to |index|.
   int UpdateUponReceivingCodec(int index);
@@ -344,6 +413,9 @@ class AudioCodingModuleImpl : public AudioCodingModule {
   bool receiver_initialized_ GUARDED_BY(acm_crit_sect_);
 
   AudioFrame preprocess_frame_ GUARDED_BY(acm_crit_sect_);
+  // Down-mixed and resampled input of AddMultiple10MsData().
+  std::vector<int16_t> preprocess_buffer_ GUARDED_BY(acm_crit_sect_);
+  std::vector<int16_t> down_mix_buffer_ GUARDED_BY(acm_crit_sect_);
   bool first_10ms_data_ GUARDED_BY(acm_crit_sect_);
 
   bool first_frame_ GUARDED_BY(acm_crit_sect_);
@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <math.h>
 #include <string.h>
 #include <vector>
 
@@ -365,6 +366,169 @@ TEST_F(AudioCodingModuleTestOldApi, TimestampSeriesContinuesWhenCodecChanges) {
   }
 }
 
+// Encodes the same audio with Add10MsData() in one ACM and with
+// AddMultiple10MsData() in another, and verifies that both produce the same
+// packets.
+class AcmAddMultiple10MsDataOldApi : public ::testing::Test {
+ protected:
+  struct EncodedPacket {
+    FrameType frame_type;
+    uint8_t payload_type;
+    uint32_t timestamp;
+    std::vector<uint8_t> payload;
+  };
+
+  // Stores all packets.
+  class PacketCollector : public AudioPacketizationCallback {
+   public:
+    int32_t SendData(FrameType frame_type,
+                     uint8_t payload_type,
+                     uint32_t timestamp,
+                     const uint8_t* payload_data,
+                     size_t payload_len_bytes,
+                     const RTPFragmentationHeader* fragmentation) override {
+      EncodedPacket packet;
+      packet.frame_type = frame_type;
+      packet.payload_type = payload_type;
+      packet.timestamp = timestamp;
+      packet.payload.assign(payload_data, payload_data + payload_len_bytes);
+      packets_.push_back(packet);
+      return 0;
+    }
+
+    const std::vector<EncodedPacket>& packets() const { return packets_; }
+
+   private:
+    std::vector<EncodedPacket> packets_;
+  };
+
+  static const int kNumBlocks = 100;
+
+  void Run(const char* payload_name,
+           int sampling_freq_hz,
+           int channels,
+           int input_rate_hz,
+           int input_channels,
+           bool enable_dtx) {
+    CodecInst codec;
+    ASSERT_EQ(0, AudioCodingModule::Codec(payload_name, &codec,
+                                          sampling_freq_hz, channels));
+    rtc::scoped_ptr<AudioCodingModule> acm(AudioCodingModule::Create(0));
+    rtc::scoped_ptr<AudioCodingModule> acm_batch(AudioCodingModule::Create(1));
+    PacketCollector packets;
+    PacketCollector batch_packets;
+    ASSERT_EQ(0, acm->RegisterSendCodec(codec));
+    ASSERT_EQ(0, acm->RegisterTransportCallback(&packets));
+    ASSERT_EQ(0, acm_batch->RegisterSendCodec(codec));
+    ASSERT_EQ(0, acm_batch->RegisterTransportCallback(&batch_packets));
+    if (enable_dtx) {
+      ASSERT_EQ(0, acm->SetVAD(true, true, VADNormal));
+      ASSERT_EQ(0, acm_batch->SetVAD(true, true, VADNormal));
+    }
+
+    // Generate two tones, one per channel, followed by silence.
+    const double kPi = 3.14159265358979323846;
+    const int samples_per_block = input_rate_hz / 100;
+    const int num_samples = kNumBlocks * samples_per_block;
+    std::vector<int16_t> audio(num_samples * input_channels);
+    for (int i = 0; i < num_samples / 2; ++i) {
+      for (int channel = 0; channel < input_channels; ++channel) {
+        audio[i * input_channels + channel] = static_cast<int16_t>(
+            8000 * sin(2 * kPi * (400 + 300 * channel) * i / input_rate_hz));
+      }
+    }
+
+    const uint32_t kFirstTimestamp = 0x12345678;
+    int encoded_bytes = 0;
+    AudioFrame frame;
+    frame.sample_rate_hz_ = input_rate_hz;
+    frame.num_channels_ = input_channels;
+    frame.samples_per_channel_ = samples_per_block;
+    for (int i = 0; i < kNumBlocks; ++i) {
+      memcpy(frame.data_, &audio[i * samples_per_block * input_channels],
+             samples_per_block * input_channels * sizeof(int16_t));
+      frame.timestamp_ = kFirstTimestamp + i * samples_per_block;
+      int r = acm->Add10MsData(frame);
+      ASSERT_GE(r, 0);
+      encoded_bytes += r;
+    }
+
+    // Add the audio in two calls, to also test the state kept between them.
+    const int kFirstBatchBlocks = 7;
+    int r = acm_batch->AddMultiple10MsData(
+        &audio[0], kFirstBatchBlocks * samples_per_block, input_rate_hz,
+        input_channels, kFirstTimestamp);
+    ASSERT_GE(r, 0);
+    int batch_encoded_bytes = r;
+    r = acm_batch->AddMultiple10MsData(
+        &audio[kFirstBatchBlocks * samples_per_block * input_channels],
+        (kNumBlocks - kFirstBatchBlocks) * samples_per_block, input_rate_hz,
+        input_channels,
+        kFirstTimestamp + kFirstBatchBlocks * samples_per_block);
+    ASSERT_GE(r, 0);
+    batch_encoded_bytes += r;
+
+    EXPECT_GT(encoded_bytes, 0);
+    EXPECT_EQ(encoded_bytes, batch_encoded_bytes);
+    ASSERT_GT(packets.packets().size(), 0u);
+    ASSERT_EQ(packets.packets().size(), batch_packets.packets().size());
+    for (size_t i = 0; i < packets.packets().size(); ++i) {
+      const EncodedPacket& packet = packets.packets()[i];
+      const EncodedPacket& batch_packet = batch_packets.packets()[i];
+      EXPECT_EQ(packet.frame_type, batch_packet.frame_type);
+      EXPECT_EQ(packet.payload_type, batch_packet.payload_type);
+      EXPECT_EQ(packet.timestamp, batch_packet.timestamp);
+      EXPECT_TRUE(packet.payload == batch_packet.payload)
+          << "Packet " << i << " differs.";
+    }
+  }
+};
+
+TEST_F(AcmAddMultiple10MsDataOldApi, Pcm16Resampled) {
+  Run("L16", 16000, 1, 32000, 1, false);
+}
+
+TEST_F(AcmAddMultiple10MsDataOldApi, PcmuDownMixed) {
+  Run("PCMU", 8000, 1, 8000, 2, false);
+}
+
+TEST_F(AcmAddMultiple10MsDataOldApi, PcmuDownMixedAndResampled) {
+  Run("PCMU", 8000, 1, 48000, 2, false);
+}
+
+TEST_F(AcmAddMultiple10MsDataOldApi, PcmuWithDtx) {
+  Run("PCMU", 8000, 1, 16000, 1, true);
+}
+
+TEST_F(AcmAddMultiple10MsDataOldApi, Pcm16StereoUpMixed) {
+  Run("L16", 32000, 2, 32000, 1, false);
+}
+
+TEST_F(AcmAddMultiple10MsDataOldApi, DISABLED_ON_ANDROID(Isac)) {
+  Run("ISAC", 16000, 1, 32000, 1, false);
+}
+
+TEST_F(AcmAddMultiple10MsDataOldApi, DISABLED_ON_ANDROID(G722Stereo)) {
+  Run("G722", 16000, 2, 16000, 2, false);
+}
+
+TEST_F(AcmAddMultiple10MsDataOldApi, OpusStereo) {
+  Run("opus", 48000, 2, 48000, 2, false);
+}
+
+TEST_F(AcmAddMultiple10MsDataOldApi, RejectsPartialBlocks) {
+  CodecInst codec;
+  ASSERT_EQ(0, AudioCodingModule::Codec("L16", &codec, 16000, 1));
+  rtc::scoped_ptr<AudioCodingModule> acm(AudioCodingModule::Create(0));
+  ASSERT_EQ(0, acm->RegisterSendCodec(codec));
+  int16_t audio[2 * 160] = {0};
+  EXPECT_EQ(-1, acm->AddMultiple10MsData(audio, 250, 16000, 1, 0));
+  EXPECT_EQ(-1, acm->AddMultiple10MsData(audio, 0, 16000, 1, 0));
+  EXPECT_EQ(-1, acm->AddMultiple10MsData(audio, 160, 16000, 3, 0));
+  // Two 10 ms packets.
+  EXPECT_EQ(2 * 160 * 2, acm->AddMultiple10MsData(audio, 320, 16000, 1, 0));
+}
+
 // Introduce this class to set different expectations on the number of encoded
 // bytes. This class expects all encoded packets to be 9 bytes (matching one
 // CNG SID frame) or 0 bytes. This test depends on |input_frame_| containing
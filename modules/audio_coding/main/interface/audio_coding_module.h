@@ -229,6 +229,10 @@ class AudioCodingModule {
   // Note: If a stereo codec is registered as send codec, VAD/DTX will
   // automatically be turned off, since it is not supported for stereo sending.
   //
+  // Note: Opus can also be registered with 6 (5.1) or 8 (7.1) channels, in
+  // Vorbis channel order. Surround audio is not re-mixed or resampled, so the
+  // audio added must have the channels of the codec and be sampled at 48 kHz.
+  //
   // Note: If a secondary encoder is already registered, and the new send-codec
   // has a sampling rate that does not match the secondary encoder, the
   // secondary encoder will be unregistered.
@@ -334,6 +338,38 @@ class AudioCodingModule {
   //
   virtual int32_t Add10MsData(const AudioFrame& audio_frame) = 0;
 
+  ///////////////////////////////////////////////////////////////////////////
+  // int32_t AddMultiple10MsData()
+  // Add several consecutive 10 ms blocks of raw (PCM) audio data and encode
+  // them. The result is the same as calling Add10MsData() once per block, but
+  // ACM is only locked once and the whole buffer is resampled in one pass,
+  // which makes this the faster choice when a long buffer is available up
+  // front, e.g., when encoding pre-recorded audio. All packets produced are
+  // delivered via the callback object registered using
+  // RegisterTransportCallback, after the last block is encoded. Note that ACM
+  // stays locked while all blocks are encoded, so other calls to ACM may have
+  // to wait that long.
+  //
+  // Input:
+  //   -audio              : interleaved input audio.
+  //   -samples_per_channel: number of samples per channel in |audio|; must be
+  //                         a multiple of |sample_rate_hz| / 100.
+  //   -sample_rate_hz     : sampling frequency of |audio|.
+  //   -num_channels       : number of channels in |audio|, 1 or 2, or the
+  //                         number of channels of a surround send codec.
+  //   -timestamp          : timestamp of the first sample in |audio|.
+  //
+  // Return value:
+  //   >= 0   total number of bytes encoded.
+  //     -1   some error occurred. No block has been encoded and no packet has
+  //          been delivered.
+  //
+  virtual int32_t AddMultiple10MsData(const int16_t* audio,
+                                      int samples_per_channel,
+                                      int sample_rate_hz,
+                                      int num_channels,
+                                      uint32_t timestamp) = 0;
+
   ///////////////////////////////////////////////////////////////////////////
   // (RED) Redundant Coding
   //
@@ -788,7 +824,8 @@ class AudioCodingModule {
   ///////////////////////////////////////////////////////////////////////////
   // int32_t PlayoutData10Ms(
   // Get 10 milliseconds of raw audio data for playout, at the given sampling
-  // frequency. ACM will perform a resampling if required.
+  // frequency. ACM will perform a resampling if required. Surround audio
+  // cannot be resampled, so it has to be played out at 48 kHz.
   //
   // Input:
   //   -desired_freq_hz    : the desired sampling frequency, in Hertz, of the
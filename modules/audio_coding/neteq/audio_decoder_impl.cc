@@ -260,8 +260,13 @@ void AudioDecoderG722Stereo::SplitStereoPacket(const uint8_t* encoded,
 // Opus
 #ifdef WEBRTC_CODEC_OPUS
 AudioDecoderOpus::AudioDecoderOpus(int num_channels) : channels_(num_channels) {
-  DCHECK(num_channels == 1 || num_channels == 2);
-  WebRtcOpus_DecoderCreate(&dec_state_, static_cast<int>(channels_));
+  DCHECK(num_channels >= 1 && num_channels <= 8);
+  if (num_channels > 2) {
+    WebRtcOpus_MultistreamDecoderCreate(&dec_state_,
+                                        static_cast<int>(channels_));
+  } else {
+    WebRtcOpus_DecoderCreate(&dec_state_, static_cast<int>(channels_));
+  }
 }
 
 AudioDecoderOpus::~AudioDecoderOpus() {
@@ -328,6 +333,9 @@ int AudioDecoderOpus::PacketDurationRedundant(const uint8_t* encoded,
 
 bool AudioDecoderOpus::PacketHasFec(const uint8_t* encoded,
                                     size_t encoded_len) const {
+  // The FEC data of a multistream packet cannot be located, so it is not used.
+  if (channels_ > 2)
+    return false;
   int fec;
   fec = WebRtcOpus_PacketHasFec(encoded, static_cast<int>(encoded_len));
   return (fec == 1);
@@ -380,6 +388,8 @@ bool CodecSupported(NetEqDecoder codec_type) {
 #ifdef WEBRTC_CODEC_OPUS
     case kDecoderOpus:
     case kDecoderOpus_2ch:
+    case kDecoderOpus_6ch:
+    case kDecoderOpus_8ch:
 #endif
     case kDecoderRED:
     case kDecoderAVT:
@@ -446,7 +456,9 @@ int CodecSampleRateHz(NetEqDecoder codec_type) {
 #endif
 #ifdef WEBRTC_CODEC_OPUS
     case kDecoderOpus:
-    case kDecoderOpus_2ch: {
+    case kDecoderOpus_2ch:
+    case kDecoderOpus_6ch:
+    case kDecoderOpus_8ch: {
       return 48000;
     }
 #endif
@@ -520,6 +532,10 @@ AudioDecoder* CreateAudioDecoder(NetEqDecoder codec_type) {
       return new AudioDecoderOpus(1);
     case kDecoderOpus_2ch:
       return new AudioDecoderOpus(2);
+    case kDecoderOpus_6ch:
+      return new AudioDecoderOpus(6);
+    case kDecoderOpus_8ch:
+      return new AudioDecoderOpus(8);
 #endif
     case kDecoderCNGnb:
     case kDecoderCNGwb:
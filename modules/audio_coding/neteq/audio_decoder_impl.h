@@ -207,6 +207,9 @@ class AudioDecoderG722Stereo : public AudioDecoder {
 #endif
 
 #ifdef WEBRTC_CODEC_OPUS
+// Decodes Opus with |num_channels| channels. More than two channels are
+// decoded with the multistream decoder, see
+// WebRtcOpus_MultistreamDecoderCreate().
 class AudioDecoderOpus : public AudioDecoder {
  public:
   explicit AudioDecoderOpus(int num_channels);
@@ -301,6 +304,8 @@ enum NetEqDecoder {
   kDecoderArbitrary,
   kDecoderOpus,
   kDecoderOpus_2ch,
+  kDecoderOpus_6ch,  // 5.1 surround.
+  kDecoderOpus_8ch,  // 7.1 surround.
 };
 
 // Returns true if |codec_type| is supported.
@@ -473,6 +473,23 @@ class AudioDecoderOpusStereoTest : public AudioDecoderOpusTest {
   }
 };
 
+class AudioDecoderOpusSurroundTest : public AudioDecoderOpusTest {
+ protected:
+  AudioDecoderOpusSurroundTest() : AudioDecoderOpusTest() {
+    channels_ = 6;
+    delete decoder_;
+    decoder_ = new AudioDecoderOpus(6);
+    AudioEncoderOpus::Config config;
+    config.frame_size_ms = static_cast<int>(frame_size_) / 48;
+    config.num_channels = 6;
+    // The same bitrate per channel as the stereo test.
+    config.bitrate_bps = 192000;
+    config.payload_type = payload_type_;
+    config.application = AudioEncoderOpus::kAudio;
+    audio_encoder_.reset(new AudioEncoderOpus(config));
+  }
+};
+
 TEST_F(AudioDecoderPcmUTest, EncodeDecode) {
   int tolerance = 251;
   double mse = 1734.0;
@@ -601,6 +618,16 @@ TEST_F(AudioDecoderOpusStereoTest, EncodeDecode) {
   EXPECT_FALSE(decoder_->HasDecodePlc());
 }
 
+TEST_F(AudioDecoderOpusSurroundTest, EncodeDecode) {
+  int tolerance = 6176;
+  double mse = 238630.0;
+  int delay = 22;  // Delay from input to output.
+  EXPECT_TRUE(CodecSupported(kDecoderOpus_6ch));
+  EncodeDecodeTest(0, tolerance, mse, delay);
+  ReInitTest();
+  EXPECT_FALSE(decoder_->HasDecodePlc());
+}
+
 TEST(AudioDecoder, CodecSampleRateHz) {
   EXPECT_EQ(8000, CodecSampleRateHz(kDecoderPCMu));
   EXPECT_EQ(8000, CodecSampleRateHz(kDecoderPCMa));
@@ -628,6 +655,8 @@ TEST(AudioDecoder, CodecSampleRateHz) {
   EXPECT_EQ(32000, CodecSampleRateHz(kDecoderCNGswb32kHz));
   EXPECT_EQ(48000, CodecSampleRateHz(kDecoderOpus));
   EXPECT_EQ(48000, CodecSampleRateHz(kDecoderOpus_2ch));
+  EXPECT_EQ(48000, CodecSampleRateHz(kDecoderOpus_6ch));
+  EXPECT_EQ(48000, CodecSampleRateHz(kDecoderOpus_8ch));
   // TODO(tlegrand): Change 32000 to 48000 below once ACM has 48 kHz support.
   EXPECT_EQ(32000, CodecSampleRateHz(kDecoderCNGswb48kHz));
   EXPECT_EQ(-1, CodecSampleRateHz(kDecoderArbitrary));
@@ -662,6 +691,8 @@ TEST(AudioDecoder, CodecSupported) {
   EXPECT_TRUE(CodecSupported(kDecoderArbitrary));
   EXPECT_TRUE(CodecSupported(kDecoderOpus));
   EXPECT_TRUE(CodecSupported(kDecoderOpus_2ch));
+  EXPECT_TRUE(CodecSupported(kDecoderOpus_6ch));
+  EXPECT_TRUE(CodecSupported(kDecoderOpus_8ch));
 }
 
 }  // namespace webrtc
@@ -18,20 +18,25 @@
 
 namespace webrtc {
 
-AudioMultiVector::AudioMultiVector(size_t N) {
+AudioMultiVector::AudioMultiVector(size_t N) : channel_capacity_(0) {
   assert(N > 0);
   if (N < 1) N = 1;
+  storage_.reset(new int16_t[0]);
   for (size_t n = 0; n < N; ++n) {
-    channels_.push_back(new AudioVector);
+    channels_.push_back(new AudioVector(storage_.get(), 0));
   }
   num_channels_ = N;
 }
 
-AudioMultiVector::AudioMultiVector(size_t N, size_t initial_size) {
+AudioMultiVector::AudioMultiVector(size_t N, size_t initial_size)
+    : channel_capacity_(initial_size) {
   assert(N > 0);
   if (N < 1) N = 1;
+  storage_.reset(new int16_t[N * initial_size]);
   for (size_t n = 0; n < N; ++n) {
-    channels_.push_back(new AudioVector(initial_size));
+    channels_.push_back(
+        new AudioVector(storage_.get() + n * initial_size, initial_size));
+    channels_[n]->Extend(initial_size);
   }
   num_channels_ = N;
 }
@@ -51,14 +56,17 @@ void AudioMultiVector::Clear() {
 }
 
 void AudioMultiVector::Zeros(size_t length) {
+  Clear();
+  Reserve(length);
   for (size_t i = 0; i < num_channels_; ++i) {
-    channels_[i]->Clear();
     channels_[i]->Extend(length);
   }
 }
 
 void AudioMultiVector::CopyTo(AudioMultiVector* copy_to) const {
-  if (copy_to) {
+  if (copy_to && copy_to != this) {
+    copy_to->Clear();
+    copy_to->Reserve(Size());
     for (size_t i = 0; i < num_channels_; ++i) {
       channels_[i]->CopyTo(&(*copy_to)[i]);
     }
@@ -68,29 +76,29 @@ void AudioMultiVector::CopyTo(AudioMultiVector* copy_to) const {
 void AudioMultiVector::PushBackInterleaved(const int16_t* append_this,
                                            size_t length) {
   assert(length % num_channels_ == 0);
+  size_t length_per_channel = length / num_channels_;
+  Reserve(Size() + length_per_channel);
   if (num_channels_ == 1) {
-    // Special case to avoid extra allocation and data shuffling.
+    // Special case to avoid the strided copy below.
     channels_[0]->PushBack(append_this, length);
     return;
   }
-  size_t length_per_channel = length / num_channels_;
-  int16_t* temp_array = new int16_t[length_per_channel];  // Temporary storage.
   for (size_t channel = 0; channel < num_channels_; ++channel) {
-    // Copy elements to |temp_array|.
+    // Copy the elements of this channel directly to its new samples.
+    int16_t* destination = channels_[channel]->GrowBack(length_per_channel);
     // Set |source_ptr| to first element of this channel.
     const int16_t* source_ptr = &append_this[channel];
     for (size_t i = 0; i < length_per_channel; ++i) {
-      temp_array[i] = *source_ptr;
+      destination[i] = *source_ptr;
       source_ptr += num_channels_;  // Jump to next element of this channel.
     }
-    channels_[channel]->PushBack(temp_array, length_per_channel);
   }
-  delete [] temp_array;
 }
 
 void AudioMultiVector::PushBack(const AudioMultiVector& append_this) {
   assert(num_channels_ == append_this.num_channels_);
   if (num_channels_ == append_this.num_channels_) {
+    Reserve(Size() + append_this.Size());
     for (size_t i = 0; i < num_channels_; ++i) {
       channels_[i]->PushBack(append_this[i]);
     }
@@ -104,6 +112,7 @@ void AudioMultiVector::PushBackFromIndex(const AudioMultiVector& append_this,
   size_t length = append_this.Size() - index;
   assert(num_channels_ == append_this.num_channels_);
   if (num_channels_ == append_this.num_channels_) {
+    Reserve(Size() + length);
     for (size_t i = 0; i < num_channels_; ++i) {
       channels_[i]->PushBack(&append_this[i][index], length);
     }
@@ -133,24 +142,30 @@ size_t AudioMultiVector::ReadInterleavedFromIndex(size_t start_index,
   if (!destination) {
     return 0;
   }
-  size_t index = 0;  // Number of elements written to |destination| so far.
   assert(start_index <= Size());
   start_index = std::min(start_index, Size());
   if (length + start_index > Size()) {
     length = Size() - start_index;
   }
+  if (length == 0) {
+    return 0;
+  }
   if (num_channels_ == 1) {
-    // Special case to avoid the nested for loop below.
+    // Special case to avoid the strided copy below.
     memcpy(destination, &(*this)[0][start_index], length * sizeof(int16_t));
     return length;
   }
-  for (size_t i = 0; i < length; ++i) {
-    for (size_t channel = 0; channel < num_channels_; ++channel) {
-      destination[index] = (*this)[channel][i + start_index];
-      ++index;
+  for (size_t channel = 0; channel < num_channels_; ++channel) {
+    // Each channel is contiguous, so it is copied directly to every
+    // |num_channels_|th element of |destination|.
+    const int16_t* source_ptr = &(*this)[channel][start_index];
+    int16_t* destination_ptr = &destination[channel];
+    for (size_t i = 0; i < length; ++i) {
+      *destination_ptr = source_ptr[i];
+      destination_ptr += num_channels_;
     }
   }
-  return index;
+  return length * num_channels_;
 }
 
 size_t AudioMultiVector::ReadInterleavedFromEnd(size_t length,
@@ -167,6 +182,7 @@ void AudioMultiVector::OverwriteAt(const AudioMultiVector& insert_this,
   assert(length <= insert_this.Size());
   length = std::min(length, insert_this.Size());
   if (num_channels_ == insert_this.num_channels_) {
+    Reserve(std::min(position, Size()) + length);
     for (size_t i = 0; i < num_channels_; ++i) {
       channels_[i]->OverwriteAt(&insert_this[i][0], length, position);
     }
@@ -177,6 +193,9 @@ void AudioMultiVector::CrossFade(const AudioMultiVector& append_this,
                                  size_t fade_length) {
   assert(num_channels_ == append_this.num_channels_);
   if (num_channels_ == append_this.num_channels_) {
+    size_t overlap = std::min(fade_length,
+                              std::min(Size(), append_this.Size()));
+    Reserve(Size() + append_this.Size() - overlap);
     for (size_t i = 0; i < num_channels_; ++i) {
       channels_[i]->CrossFade(append_this[i], fade_length);
     }
@@ -191,6 +210,7 @@ size_t AudioMultiVector::Size() const {
 void AudioMultiVector::AssertSize(size_t required_size) {
   if (Size() < required_size) {
     size_t extend_length = required_size - Size();
+    Reserve(required_size);
     for (size_t channel = 0; channel < num_channels_; ++channel) {
       channels_[channel]->Extend(extend_length);
     }
@@ -216,4 +236,26 @@ AudioVector& AudioMultiVector::operator[](size_t index) {
   return *(channels_[index]);
 }
 
+void AudioMultiVector::Reserve(size_t n) {
+  // Like AudioVector::Reserve(), leave room for a quarter of |n| to be pushed
+  // after the samples, so that the channels can move their samples to the
+  // front of their part of |storage_| instead of growing.
+  if (n + n / 4 <= channel_capacity_) {
+    return;
+  }
+  size_t new_capacity = n;
+  for (size_t i = 0; i < num_channels_; ++i) {
+    new_capacity = std::max(new_capacity, channels_[i]->Size());
+  }
+  new_capacity += new_capacity / 2;
+  rtc::scoped_ptr<int16_t[]> new_storage(
+      new int16_t[num_channels_ * new_capacity]);
+  for (size_t i = 0; i < num_channels_; ++i) {
+    channels_[i]->UseStorage(new_storage.get() + i * new_capacity,
+                             new_capacity);
+  }
+  storage_.swap(new_storage);
+  channel_capacity_ = new_capacity;
+}
+
 }  // namespace webrtc
@@ -16,11 +16,14 @@
 #include <vector>
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/audio_coding/neteq/audio_vector.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
+// The samples of all channels are kept in one allocation, where each channel
+// has a contiguous part of its own.
 class AudioMultiVector {
  public:
   // Creates an empty AudioMultiVector with |N| audio channels. |N| must be
@@ -128,10 +131,17 @@ class AudioMultiVector {
   AudioVector& operator[](size_t index);
 
  protected:
+  // Makes room for |n| samples in each channel. Methods which add samples must
+  // call this first, so that the channels stay in |storage_|.
+  void Reserve(size_t n);
+
   std::vector<AudioVector*> channels_;
   size_t num_channels_;
 
  private:
+  rtc::scoped_ptr<int16_t[]> storage_;
+  size_t channel_capacity_;  // Number of samples in |storage_| per channel.
+
   DISALLOW_COPY_AND_ASSIGN(AudioMultiVector);
 };
 
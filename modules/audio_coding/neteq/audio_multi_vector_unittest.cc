@@ -325,6 +325,52 @@ TEST_P(AudioMultiVectorTest, CopyChannel) {
   }
 }
 
+// Push interleaved samples at the back and pop them at the front many times, as
+// the SyncBuffer does, and verify that all channels keep their samples.
+TEST_P(AudioMultiVectorTest, PushBackAndPopFront) {
+  static const size_t kLength = 50;
+  AudioMultiVector vec(num_channels_, kLength);
+  for (int n = 0; n < 100; ++n) {
+    vec.PushBackInterleaved(array_interleaved_, interleaved_length_);
+    vec.PopFront(array_length());
+    ASSERT_EQ(kLength, vec.Size());
+  }
+  // The last |kLength| samples are the last copies of |array_interleaved_|.
+  for (size_t channel = 0; channel < num_channels_; ++channel) {
+    for (size_t i = 0; i < kLength; ++i) {
+      EXPECT_EQ(static_cast<int16_t>((channel + 1) * 100 +
+                                     i % array_length()),
+                vec[channel][i]);
+    }
+  }
+  int16_t* output = new int16_t[interleaved_length_];
+  EXPECT_EQ(interleaved_length_,
+            vec.ReadInterleavedFromEnd(array_length(), output));
+  for (size_t i = 0; i < interleaved_length_; ++i) {
+    EXPECT_EQ(array_interleaved_[i], output[i]);
+  }
+  delete [] output;
+}
+
+// Grow a channel through its AudioVector interface, which makes it leave the
+// storage shared by the channels, and verify that the AudioMultiVector still
+// works.
+TEST_P(AudioMultiVectorTest, GrowChannelDirectly) {
+  AudioMultiVector vec(num_channels_);
+  for (size_t channel = 0; channel < num_channels_; ++channel) {
+    vec[channel].PushBack(array_, array_length());
+  }
+  vec.PushBackInterleaved(array_interleaved_, interleaved_length_);
+  ASSERT_EQ(2 * array_length(), vec.Size());
+  for (size_t channel = 0; channel < num_channels_; ++channel) {
+    for (size_t i = 0; i < array_length(); ++i) {
+      EXPECT_EQ(array_[i], vec[channel][i]);
+      EXPECT_EQ(static_cast<int16_t>((channel + 1) * 100 + i),
+                vec[channel][array_length() + i]);
+    }
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(TestNumChannels,
                         AudioMultiVectorTest,
                         ::testing::Values(static_cast<size_t>(1),
@@ -19,24 +19,23 @@
 namespace webrtc {
 
 void AudioVector::Clear() {
-  first_free_ix_ = 0;
+  begin_ix_ = 0;
+  end_ix_ = 0;
 }
 
 void AudioVector::CopyTo(AudioVector* copy_to) const {
-  if (copy_to) {
+  if (copy_to && copy_to != this) {
+    copy_to->Clear();
     copy_to->Reserve(Size());
     assert(copy_to->capacity_ >= Size());
-    memcpy(copy_to->array_.get(), array_.get(), Size() * sizeof(int16_t));
-    copy_to->first_free_ix_ = first_free_ix_;
+    memcpy(copy_to->array_, &array_[begin_ix_], Size() * sizeof(int16_t));
+    copy_to->end_ix_ = Size();
   }
 }
 
 void AudioVector::PushFront(const AudioVector& prepend_this) {
-  size_t insert_length = prepend_this.Size();
-  Reserve(Size() + insert_length);
-  memmove(&array_[insert_length], &array_[0], Size() * sizeof(int16_t));
-  memcpy(&array_[0], &prepend_this.array_[0], insert_length * sizeof(int16_t));
-  first_free_ix_ += insert_length;
+  InsertAt(&prepend_this.array_[prepend_this.begin_ix_], prepend_this.Size(),
+           0);
 }
 
 void AudioVector::PushFront(const int16_t* prepend_this, size_t length) {
@@ -45,13 +44,11 @@ void AudioVector::PushFront(const int16_t* prepend_this, size_t length) {
 }
 
 void AudioVector::PushBack(const AudioVector& append_this) {
-  PushBack(append_this.array_.get(), append_this.Size());
+  PushBack(&append_this.array_[append_this.begin_ix_], append_this.Size());
 }
 
 void AudioVector::PushBack(const int16_t* append_this, size_t length) {
-  Reserve(Size() + length);
-  memcpy(&array_[first_free_ix_], append_this, length * sizeof(int16_t));
-  first_free_ix_ += length;
+  memcpy(GrowBack(length), append_this, length * sizeof(int16_t));
 }
 
 void AudioVector::PopFront(size_t length) {
@@ -59,37 +56,41 @@ void AudioVector::PopFront(size_t length) {
     // Remove all elements.
     Clear();
   } else {
-    size_t remaining_samples = Size() - length;
-    memmove(&array_[0], &array_[length], remaining_samples * sizeof(int16_t));
-    first_free_ix_ -= length;
+    // The samples are moved to the front of the array only when the space is
+    // needed; see Reserve().
+    begin_ix_ += length;
   }
 }
 
 void AudioVector::PopBack(size_t length) {
   // Never remove more than what is in the array.
   length = std::min(length, Size());
-  first_free_ix_ -= length;
+  end_ix_ -= length;
 }
 
 void AudioVector::Extend(size_t extra_length) {
-  Reserve(Size() + extra_length);
-  memset(&array_[first_free_ix_], 0, extra_length * sizeof(int16_t));
-  first_free_ix_ += extra_length;
+  memset(GrowBack(extra_length), 0, extra_length * sizeof(int16_t));
 }
 
 void AudioVector::InsertAt(const int16_t* insert_this,
                            size_t length,
                            size_t position) {
-  Reserve(Size() + length);
   // Cap the position at the current vector length, to be sure the iterator
   // does not extend beyond the end of the vector.
   position = std::min(Size(), position);
-  int16_t* insert_position_ptr = &array_[position];
+  if (position == 0 && begin_ix_ >= length) {
+    // Prepend into the space left by PopFront().
+    begin_ix_ -= length;
+    memcpy(&array_[begin_ix_], insert_this, length * sizeof(int16_t));
+    return;
+  }
+  Reserve(Size() + length);
+  int16_t* insert_position_ptr = &array_[begin_ix_ + position];
   size_t samples_to_move = Size() - position;
   memmove(insert_position_ptr + length, insert_position_ptr,
           samples_to_move * sizeof(int16_t));
   memcpy(insert_position_ptr, insert_this, length * sizeof(int16_t));
-  first_free_ix_ += length;
+  end_ix_ += length;
 }
 
 void AudioVector::InsertZerosAt(size_t length,
@@ -97,13 +98,13 @@ void AudioVector::InsertZerosAt(size_t length,
   Reserve(Size() + length);
   // Cap the position at the current vector length, to be sure the iterator
   // does not extend beyond the end of the vector.
-  position = std::min(capacity_, position);
-  int16_t* insert_position_ptr = &array_[position];
+  position = std::min(Size(), position);
+  int16_t* insert_position_ptr = &array_[begin_ix_ + position];
   size_t samples_to_move = Size() - position;
   memmove(insert_position_ptr + length, insert_position_ptr,
           samples_to_move * sizeof(int16_t));
   memset(insert_position_ptr, 0, length * sizeof(int16_t));
-  first_free_ix_ += length;
+  end_ix_ += length;
 }
 
 void AudioVector::OverwriteAt(const int16_t* insert_this,
@@ -112,10 +113,11 @@ void AudioVector::OverwriteAt(const int16_t* insert_this,
   // Cap the insert position at the current array length.
   position = std::min(Size(), position);
   Reserve(position + length);
-  memcpy(&array_[position], insert_this, length * sizeof(int16_t));
+  memcpy(&array_[begin_ix_ + position], insert_this,
+         length * sizeof(int16_t));
   if (position + length > Size()) {
     // Array was expanded.
-    first_free_ix_ += position + length - Size();
+    end_ix_ = begin_ix_ + position + length;
   }
 }
 
@@ -126,7 +128,8 @@ void AudioVector::CrossFade(const AudioVector& append_this,
   assert(fade_length <= append_this.Size());
   fade_length = std::min(fade_length, Size());
   fade_length = std::min(fade_length, append_this.Size());
-  size_t position = Size() - fade_length;
+  int16_t* fade_ptr = &array_[end_ix_ - fade_length];
+  const int16_t* append_ptr = &append_this.array_[append_this.begin_ix_];
   // Cross fade the overlapping regions.
   // |alpha| is the mixing factor in Q14.
   // TODO(hlundin): Consider skipping +1 in the denominator to produce a
@@ -135,31 +138,63 @@ void AudioVector::CrossFade(const AudioVector& append_this,
   int alpha = 16384;
   for (size_t i = 0; i < fade_length; ++i) {
     alpha -= alpha_step;
-    array_[position + i] = (alpha * array_[position + i] +
-        (16384 - alpha) * append_this[i] + 8192) >> 14;
+    fade_ptr[i] = (alpha * fade_ptr[i] + (16384 - alpha) * append_ptr[i] +
+        8192) >> 14;
   }
   assert(alpha >= 0);  // Verify that the slope was correct.
   // Append what is left of |append_this|.
   size_t samples_to_push_back = append_this.Size() - fade_length;
   if (samples_to_push_back > 0)
-    PushBack(&append_this[fade_length], samples_to_push_back);
+    PushBack(&append_ptr[fade_length], samples_to_push_back);
 }
 
 const int16_t& AudioVector::operator[](size_t index) const {
-  return array_[index];
+  return array_[begin_ix_ + index];
 }
 
 int16_t& AudioVector::operator[](size_t index) {
-  return array_[index];
+  return array_[begin_ix_ + index];
+}
+
+void AudioVector::UseStorage(int16_t* storage, size_t capacity) {
+  assert(capacity >= Size());
+  memmove(storage, &array_[begin_ix_], Size() * sizeof(int16_t));
+  owned_array_.reset();
+  array_ = storage;
+  end_ix_ = Size();
+  begin_ix_ = 0;
+  capacity_ = capacity;
+}
+
+int16_t* AudioVector::GrowBack(size_t length) {
+  Reserve(Size() + length);
+  int16_t* new_samples = &array_[end_ix_];
+  end_ix_ += length;
+  return new_samples;
 }
 
 void AudioVector::Reserve(size_t n) {
-  if (capacity_ < n) {
-    rtc::scoped_ptr<int16_t[]> temp_array(new int16_t[n]);
-    memcpy(temp_array.get(), array_.get(), Size() * sizeof(int16_t));
-    array_.swap(temp_array);
-    capacity_ = n;
+  if (begin_ix_ + n <= capacity_) {
+    return;
+  }
+  // Move the samples to the front of the array if that leaves room for
+  // a quarter of |n| to be pushed after them, so that the cost of moving is
+  // amortized when samples are pushed at the back and popped at the front. A
+  // borrowed array cannot grow, and its owner is responsible for the room.
+  if (n + n / 4 <= capacity_ || (!owned_array_ && n <= capacity_)) {
+    memmove(array_, &array_[begin_ix_], Size() * sizeof(int16_t));
+    end_ix_ -= begin_ix_;
+    begin_ix_ = 0;
+    return;
   }
+  size_t new_capacity = n + n / 2;
+  rtc::scoped_ptr<int16_t[]> temp_array(new int16_t[new_capacity]);
+  memcpy(temp_array.get(), &array_[begin_ix_], Size() * sizeof(int16_t));
+  owned_array_.swap(temp_array);
+  array_ = owned_array_.get();
+  end_ix_ = Size();
+  begin_ix_ = 0;
+  capacity_ = new_capacity;
 }
 
 }  // namespace webrtc
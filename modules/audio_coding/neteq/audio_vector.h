@@ -23,16 +23,20 @@ class AudioVector {
  public:
   // Creates an empty AudioVector.
   AudioVector()
-      : array_(new int16_t[kDefaultInitialSize]),
-        first_free_ix_(0),
+      : owned_array_(new int16_t[kDefaultInitialSize]),
+        array_(owned_array_.get()),
+        begin_ix_(0),
+        end_ix_(0),
         capacity_(kDefaultInitialSize) {}
 
   // Creates an AudioVector with an initial size.
   explicit AudioVector(size_t initial_size)
-      : array_(new int16_t[initial_size]),
-        first_free_ix_(initial_size),
+      : owned_array_(new int16_t[initial_size]),
+        array_(owned_array_.get()),
+        begin_ix_(0),
+        end_ix_(initial_size),
         capacity_(initial_size) {
-    memset(array_.get(), 0, initial_size * sizeof(int16_t));
+    memset(array_, 0, initial_size * sizeof(int16_t));
   }
 
   virtual ~AudioVector() {}
@@ -94,23 +98,51 @@ class AudioVector {
   virtual void CrossFade(const AudioVector& append_this, size_t fade_length);
 
   // Returns the number of elements in this AudioVector.
-  virtual size_t Size() const { return first_free_ix_; }
+  virtual size_t Size() const { return end_ix_ - begin_ix_; }
 
   // Returns true if this AudioVector is empty.
-  virtual bool Empty() const { return (first_free_ix_ == 0); }
+  virtual bool Empty() const { return (end_ix_ == begin_ix_); }
 
-  // Accesses and modifies an element of AudioVector.
+  // Accesses and modifies an element of AudioVector. The elements are stored
+  // contiguously, so that a pointer to an element can be used to access the
+  // elements following it.
   const int16_t& operator[](size_t index) const;
   int16_t& operator[](size_t index);
 
  private:
+  // AudioMultiVector keeps the samples of all its channels in one allocation,
+  // and lends each channel a part of it.
+  friend class AudioMultiVector;
+
   static const size_t kDefaultInitialSize = 10;
 
+  // Creates an empty AudioVector which stores its samples in the |capacity|
+  // samples at |storage|, which is owned by the caller.
+  AudioVector(int16_t* storage, size_t capacity)
+      : array_(storage),
+        begin_ix_(0),
+        end_ix_(0),
+        capacity_(capacity) {}
+
+  // Moves the samples to the |capacity| samples at |storage|, which is owned
+  // by the caller, and releases the array owned by this object, if any.
+  // |capacity| must be at least Size().
+  void UseStorage(int16_t* storage, size_t capacity);
+
+  // Increases the size by |length| samples, and returns a pointer to the first
+  // of the new samples, which are not initialized.
+  int16_t* GrowBack(size_t length);
+
+  // Makes room for |n| samples from the beginning of the array, either by
+  // moving the samples to the front of the array, or by allocating a larger
+  // array, which this object then owns.
   void Reserve(size_t n);
 
-  rtc::scoped_ptr<int16_t[]> array_;
-  size_t first_free_ix_;  // The first index after the last sample in array_.
-                          // Note that this index may point outside of array_.
+  rtc::scoped_ptr<int16_t[]> owned_array_;  // NULL if the array is borrowed.
+  int16_t* array_;
+  size_t begin_ix_;  // Index of the first sample in |array_|. Samples are
+                     // popped from the front by increasing this index.
+  size_t end_ix_;  // The first index after the last sample in |array_|.
   size_t capacity_;  // Allocated number of samples in the array.
 
   DISALLOW_COPY_AND_ASSIGN(AudioVector);
@@ -391,4 +391,39 @@ TEST_F(AudioVectorTest, CrossFade) {
   }
 }
 
+// Push samples at the back and pop them at the front many times, as the
+// SyncBuffer does, and verify that the samples stay in order and contiguous
+// while the vector moves them to the front of its array.
+TEST_F(AudioVectorTest, PushBackAndPopFront) {
+  static const size_t kLength = 100;
+  static const size_t kBlockLength = 7;
+  AudioVector vec(kLength);
+  int16_t next_value = 0;
+  for (size_t i = 0; i < kLength; ++i) {
+    vec[i] = next_value++;
+  }
+  int16_t block[kBlockLength];
+  for (int n = 0; n < 200; ++n) {
+    for (size_t i = 0; i < kBlockLength; ++i) {
+      block[i] = next_value++;
+    }
+    vec.PushBack(block, kBlockLength);
+    vec.PopFront(kBlockLength);
+    ASSERT_EQ(kLength, vec.Size());
+    const int16_t* first = &vec[0];
+    for (size_t i = 0; i < kLength; ++i) {
+      EXPECT_EQ(next_value - static_cast<int16_t>(kLength - i), first[i]);
+    }
+  }
+  // Prepend to the space left by the popped samples.
+  vec.PopFront(kBlockLength);
+  vec.PushFront(array_, array_length());
+  ASSERT_EQ(kLength - kBlockLength + array_length(), vec.Size());
+  for (size_t i = 0; i < array_length(); ++i) {
+    EXPECT_EQ(array_[i], vec[i]);
+  }
+  EXPECT_EQ(next_value - static_cast<int16_t>(kLength - kBlockLength),
+            vec[array_length()]);
+}
+
 }  // namespace webrtc
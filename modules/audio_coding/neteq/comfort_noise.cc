@@ -31,8 +31,7 @@ int ComfortNoise::UpdateParameters(Packet* packet) {
   AudioDecoder* cng_decoder = decoder_database_->GetDecoder(
       packet->header.payloadType);
   if (!cng_decoder) {
-    delete [] packet->payload;
-    delete packet;
+    DeletePacket(packet);
     return kUnknownPayloadType;
   }
   decoder_database_->SetActiveCngDecoder(packet->header.payloadType);
@@ -40,8 +39,7 @@ int ComfortNoise::UpdateParameters(Packet* packet) {
   int16_t ret = WebRtcCng_UpdateSid(cng_inst,
                                     packet->payload,
                                     packet->payload_length);
-  delete [] packet->payload;
-  delete packet;
+  DeletePacket(packet);
   if (ret < 0) {
     internal_error_code_ = WebRtcCng_GetErrorCodeDec(cng_inst);
     return kInternalError;
@@ -79,7 +79,8 @@ class NetEq {
           // |max_delay_ms| has the same effect as calling SetMaximumDelay().
           max_delay_ms(2000),
           background_noise_mode(kBgnOff),
-          playout_mode(kPlayoutOn) {}
+          playout_mode(kPlayoutOn),
+          enable_fast_path(false) {}
 
     int sample_rate_hz;  // Initial vale. Will change with input data.
     bool enable_audio_classifier;
@@ -87,6 +88,13 @@ class NetEq {
     int max_delay_ms;
     BackgroundNoiseMode background_noise_mode;
     NetEqPlayoutMode playout_mode;
+    // When the jitter buffer is steady, i.e., when a normal operation follows
+    // a normal operation without any muting, DTMF or comfort noise, the
+    // decoded audio is written straight to the sync buffer. The post-decode
+    // VAD and the background noise estimate are not updated for such blocks,
+    // which mainly matters for the quality of long concealments. This saves
+    // most of the processing for cheap codecs such as G.711 and PCM16.
+    bool enable_fast_path;
   };
 
   enum ReturnCodes {
@@ -163,6 +171,43 @@ class NetEq {
                        int* samples_per_channel, int* num_channels,
                        NetEqOutputType* type) = 0;
 
+  // A packet for GetAudioBatch(). |arrival_time_ms| is the simulated arrival
+  // time of the packet, relative to the start of the GetAudioBatch() call.
+  // The other members are as for InsertPacket().
+  struct BatchPacket {
+    const WebRtcRTPHeader* rtp_header;
+    const uint8_t* payload;
+    size_t length_bytes;
+    uint32_t receive_timestamp;
+    int arrival_time_ms;
+  };
+
+  // What a GetAudioBatch() call has done.
+  struct BatchResult {
+    size_t packets_inserted;  // The first |packets_inserted| |packets|.
+    int num_blocks;  // Number of 10 ms blocks written to |output_audio|.
+    int samples_per_channel;  // Total, over all blocks.
+    int num_channels;
+  };
+
+  // Offline equivalent of alternating InsertPacket() and GetAudio() calls, for
+  // decoding recorded streams faster than real time. Plays out |duration_ms|
+  // of audio, starting at time 0: before each 10 ms block, the |packets| that
+  // have arrived by then are inserted, in order, so |packets| must be sorted
+  // by |arrival_time_ms|. The blocks are written back to back, interleaved as
+  // for GetAudio(), to |output_audio|, which can hold |max_length| elements.
+  // The call ends early if |output_audio| is full or if the sample rate or
+  // the number of channels changes. The block that did not fit is then
+  // delivered first by the next GetAudioBatch() or GetAudio() call, before
+  // simulated time starts. Returns kOK on success, or kFail in case of an
+  // error, with |result| describing what was done before it.
+  virtual int GetAudioBatch(const BatchPacket* packets,
+                            size_t num_packets,
+                            int duration_ms,
+                            size_t max_length,
+                            int16_t* output_audio,
+                            BatchResult* result) = 0;
+
   // Associates |rtp_payload_type| with |codec| and stores the information in
   // the codec database. Returns 0 on success, -1 on failure.
   virtual int RegisterPayloadType(enum NetEqDecoder codec,
@@ -20,6 +20,7 @@
 #include "webrtc/modules/audio_coding/neteq/expand.h"
 #include "webrtc/modules/audio_coding/neteq/neteq_impl.h"
 #include "webrtc/modules/audio_coding/neteq/packet_buffer.h"
+#include "webrtc/modules/audio_coding/neteq/packet_pool.h"
 #include "webrtc/modules/audio_coding/neteq/payload_splitter.h"
 #include "webrtc/modules/audio_coding/neteq/preemptive_expand.h"
 #include "webrtc/modules/audio_coding/neteq/timestamp_scaler.h"
@@ -37,8 +38,9 @@ NetEq* NetEq::Create(const NetEq::Config& config) {
   delay_manager->SetMaximumDelay(config.max_delay_ms);
   DtmfBuffer* dtmf_buffer = new DtmfBuffer(config.sample_rate_hz);
   DtmfToneGenerator* dtmf_tone_generator = new DtmfToneGenerator;
+  PacketPool* packet_pool = new PacketPool;
   PacketBuffer* packet_buffer = new PacketBuffer(config.max_packets_in_buffer);
-  PayloadSplitter* payload_splitter = new PayloadSplitter;
+  PayloadSplitter* payload_splitter = new PayloadSplitter(packet_pool);
   TimestampScaler* timestamp_scaler = new TimestampScaler(*decoder_database);
   AccelerateFactory* accelerate_factory = new AccelerateFactory;
   ExpandFactory* expand_factory = new ExpandFactory;
@@ -51,6 +53,7 @@ NetEq* NetEq::Create(const NetEq::Config& config) {
                        delay_peak_detector,
                        dtmf_buffer,
                        dtmf_tone_generator,
+                       packet_pool,
                        packet_buffer,
                        payload_splitter,
                        timestamp_scaler,
@@ -33,6 +33,7 @@
 #include "webrtc/modules/audio_coding/neteq/normal.h"
 #include "webrtc/modules/audio_coding/neteq/packet_buffer.h"
 #include "webrtc/modules/audio_coding/neteq/packet.h"
+#include "webrtc/modules/audio_coding/neteq/packet_pool.h"
 #include "webrtc/modules/audio_coding/neteq/payload_splitter.h"
 #include "webrtc/modules/audio_coding/neteq/post_decode_vad.h"
 #include "webrtc/modules/audio_coding/neteq/preemptive_expand.h"
@@ -56,6 +57,7 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
                      DelayPeakDetector* delay_peak_detector,
                      DtmfBuffer* dtmf_buffer,
                      DtmfToneGenerator* dtmf_tone_generator,
+                     PacketPool* packet_pool,
                      PacketBuffer* packet_buffer,
                      PayloadSplitter* payload_splitter,
                      TimestampScaler* timestamp_scaler,
@@ -70,6 +72,7 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
       delay_peak_detector_(delay_peak_detector),
       dtmf_buffer_(dtmf_buffer),
       dtmf_tone_generator_(dtmf_tone_generator),
+      packet_pool_(packet_pool),
       packet_buffer_(packet_buffer),
       payload_splitter_(payload_splitter),
       timestamp_scaler_(timestamp_scaler),
@@ -92,8 +95,12 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
       decoder_error_code_(0),
       background_noise_mode_(config.background_noise_mode),
       playout_mode_(config.playout_mode),
+      enable_fast_path_(config.enable_fast_path),
+      fast_path_blocks_(0),
       decoded_packet_sequence_number_(-1),
-      decoded_packet_timestamp_(0) {
+      decoded_packet_timestamp_(0),
+      pending_samples_per_channel_(0),
+      pending_num_channels_(0) {
   int fs = config.sample_rate_hz;
   if (fs != 8000 && fs != 16000 && fs != 32000 && fs != 48000) {
     LOG(LS_ERROR) << "Sample rate " << fs << " Hz not supported. " <<
@@ -161,6 +168,24 @@ int NetEqImpl::GetAudio(size_t max_length, int16_t* output_audio,
                         NetEqOutputType* type) {
   CriticalSectionScoped lock(crit_sect_.get());
   LOG(LS_VERBOSE) << "GetAudio";
+  if (!pending_output_.empty()) {
+    // Deliver the block left over by GetAudioBatch().
+    size_t length = pending_output_.size();
+    *samples_per_channel = pending_samples_per_channel_;
+    *num_channels = pending_num_channels_;
+    if (length > max_length) {
+      LOG(LS_WARNING) << "Output array is too short. " << max_length <<
+          " < " << length;
+      *samples_per_channel = static_cast<int>(max_length / *num_channels);
+      length = *samples_per_channel * *num_channels;
+    }
+    memcpy(output_audio, &pending_output_[0], length * sizeof(output_audio[0]));
+    pending_output_.clear();
+    if (type) {
+      *type = LastOutputType();
+    }
+    return kOK;
+  }
   int error = GetAudioInternal(max_length, output_audio, samples_per_channel,
                                num_channels);
   LOG(LS_VERBOSE) << "Produced " << *samples_per_channel <<
@@ -176,6 +201,112 @@ int NetEqImpl::GetAudio(size_t max_length, int16_t* output_audio,
   return kOK;
 }
 
+int NetEqImpl::GetAudioBatch(const BatchPacket* packets,
+                             size_t num_packets,
+                             int duration_ms,
+                             size_t max_length,
+                             int16_t* output_audio,
+                             BatchResult* result) {
+  CriticalSectionScoped lock(crit_sect_.get());
+  LOG(LS_VERBOSE) << "GetAudioBatch: " << num_packets << " packets, " <<
+      duration_ms << " ms";
+  result->packets_inserted = 0;
+  result->num_blocks = 0;
+  result->samples_per_channel = 0;
+  result->num_channels = 0;
+  // Blocks are produced straight into |output_audio| while there is room for
+  // any block, and into |block| otherwise. A block which does not belong in
+  // |output_audio| is kept for the next call.
+  std::vector<int16_t> block;
+  size_t next_packet = 0;
+  size_t output_length = 0;
+  int time_ms = 0;
+  while (true) {
+    const bool pending = !pending_output_.empty();
+    if (!pending) {
+      if (time_ms >= duration_ms)
+        break;
+      for (; next_packet < num_packets &&
+                 packets[next_packet].arrival_time_ms <= time_ms;
+           ++next_packet) {
+        const BatchPacket& packet = packets[next_packet];
+        int error = InsertPacketInternal(*packet.rtp_header, packet.payload,
+                                         packet.length_bytes,
+                                         packet.receive_timestamp, false);
+        if (error != 0) {
+          LOG_FERR1(LS_WARNING, InsertPacketInternal, error);
+          error_code_ = error;
+          return kFail;
+        }
+        ++result->packets_inserted;
+      }
+    }
+    // Like |decoded_buffer_|, a new block can hold kMaxFrameSize samples per
+    // channel, for the current number of channels or for the one of the next
+    // packet, if decoding it changes the number of channels.
+    size_t max_block_length = pending_output_.size();
+    if (!pending) {
+      size_t channels = sync_buffer_->Channels();
+      const RTPHeader* next_header = packet_buffer_->NextRtpHeader();
+      const AudioDecoder* next_decoder =
+          next_header ? decoder_database_->GetDecoder(next_header->payloadType)
+                      : NULL;
+      if (next_decoder)
+        channels = std::max(channels, next_decoder->Channels());
+      max_block_length = kMaxFrameSize * channels;
+    }
+    int16_t* destination;
+    if (output_length + max_block_length <= max_length) {
+      destination = &output_audio[output_length];
+    } else {
+      block.resize(max_block_length);
+      destination = &block[0];
+    }
+    int block_samples_per_channel = 0;
+    int block_num_channels = 0;
+    if (pending) {
+      memcpy(destination, &pending_output_[0],
+             pending_output_.size() * sizeof(destination[0]));
+      block_samples_per_channel = pending_samples_per_channel_;
+      block_num_channels = pending_num_channels_;
+      pending_output_.clear();
+    } else {
+      int error = GetAudioInternal(max_block_length, destination,
+                                   &block_samples_per_channel,
+                                   &block_num_channels);
+      if (error != 0) {
+        LOG_FERR1(LS_WARNING, GetAudioInternal, error);
+        error_code_ = error;
+        return kFail;
+      }
+      time_ms += kOutputSizeMs;
+    }
+    const size_t block_length =
+        static_cast<size_t>(block_samples_per_channel) * block_num_channels;
+
+    const bool format_changed =
+        result->num_blocks > 0 &&
+        (block_num_channels != result->num_channels ||
+         block_samples_per_channel * result->num_blocks !=
+             result->samples_per_channel);
+    if (format_changed || output_length + block_length > max_length) {
+      pending_output_.assign(destination, destination + block_length);
+      pending_samples_per_channel_ = block_samples_per_channel;
+      pending_num_channels_ = block_num_channels;
+      break;
+    }
+    if (destination != &output_audio[output_length]) {
+      memcpy(&output_audio[output_length], destination,
+             block_length * sizeof(destination[0]));
+    }
+    output_length += block_length;
+    ++result->num_blocks;
+    result->samples_per_channel += block_samples_per_channel;
+    result->num_channels = block_num_channels;
+  }
+  return kOK;
+}
+
 int NetEqImpl::RegisterPayloadType(enum NetEqDecoder codec,
                                    uint8_t rtp_payload_type) {
   CriticalSectionScoped lock(crit_sect_.get());
@@ -373,6 +504,7 @@ void NetEqImpl::FlushBuffers() {
   sync_buffer_->Flush();
   sync_buffer_->set_next_index(sync_buffer_->next_index() -
                                expand_->overlap_length());
+  pending_output_.clear();
   // Set to wait for new codec.
   first_packet_ = true;
 }
@@ -397,6 +529,11 @@ const SyncBuffer* NetEqImpl::sync_buffer_for_test() const {
   return sync_buffer_.get();
 }
 
+int NetEqImpl::fast_path_blocks_for_test() const {
+  CriticalSectionScoped lock(crit_sect_.get());
+  return fast_path_blocks_;
+}
+
 // Methods below this line are private.
 
 int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
@@ -434,21 +571,16 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
     // Create |packet| within this separate scope, since it should not be used
     // directly once it's been inserted in the packet list. This way, |packet|
     // is not defined outside of this block.
-    Packet* packet = new Packet;
+    Packet* packet = packet_pool_->Allocate(length_bytes);
     packet->header.markerBit = false;
     packet->header.payloadType = rtp_header.header.payloadType;
     packet->header.sequenceNumber = rtp_header.header.sequenceNumber;
     packet->header.timestamp = rtp_header.header.timestamp;
     packet->header.ssrc = rtp_header.header.ssrc;
     packet->header.numCSRCs = 0;
-    packet->payload_length = length_bytes;
     packet->primary = true;
     packet->waiting_time = 0;
-    packet->payload = new uint8_t[packet->payload_length];
     packet->sync_packet = is_sync_packet;
-    if (!packet->payload) {
-      LOG_F(LS_ERROR) << "Payload pointer is NULL.";
-    }
     assert(payload);  // Already checked above.
     memcpy(packet->payload, payload, packet->payload_length);
     // Insert packet in a packet list.
@@ -543,10 +675,8 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
         PacketBuffer::DeleteAllPackets(&packet_list);
         return kDtmfInsertError;
       }
-      // TODO(hlundin): Let the destructor of Packet handle the payload.
-      delete [] current_packet->payload;
-      delete current_packet;
       it = packet_list.erase(it);
+      DeletePacket(current_packet);
     } else {
       ++it;
     }
@@ -704,16 +834,24 @@ int NetEqImpl::GetAudioInternal(size_t max_length, int16_t* output,
   int decode_return_value = Decode(&packet_list, &operation,
                                    &length, &speech_type);
 
-  assert(vad_.get());
-  bool sid_frame_available =
-      (operation == kRfc3389Cng && !packet_list.empty());
-  vad_->Update(decoded_buffer_.get(), length, speech_type,
-               sid_frame_available, fs_hz_);
+  const bool fast_path =
+      CanUseFastPath(operation, length, speech_type, play_dtmf);
+  if (!fast_path) {
+    assert(vad_.get());
+    bool sid_frame_available =
+        (operation == kRfc3389Cng && !packet_list.empty());
+    vad_->Update(decoded_buffer_.get(), length, speech_type,
+                 sid_frame_available, fs_hz_);
+  }
 
   algorithm_buffer_->Clear();
   switch (operation) {
     case kNormal: {
-      DoNormal(decoded_buffer_.get(), length, speech_type, play_dtmf);
+      if (fast_path) {
+        DoNormalFastPath(decoded_buffer_.get(), length);
+      } else {
+        DoNormal(decoded_buffer_.get(), length, speech_type, play_dtmf);
+      }
       break;
     }
     case kMerge: {
@@ -831,11 +969,13 @@ int NetEqImpl::GetAudioInternal(size_t max_length, int16_t* output,
   // Update the background noise parameters if last operation wrote data
   // straight from the decoder to the |sync_buffer_|. That is, none of the
   // operations that modify the signal can be followed by a parameter update.
-  if ((last_mode_ == kModeNormal) ||
-      (last_mode_ == kModeAccelerateFail) ||
-      (last_mode_ == kModePreemptiveExpandFail) ||
-      (last_mode_ == kModeRfc3389Cng) ||
-      (last_mode_ == kModeCodecInternalCng)) {
+  // The fast path skips the update to save the processing.
+  if (!fast_path &&
+      ((last_mode_ == kModeNormal) ||
+       (last_mode_ == kModeAccelerateFail) ||
+       (last_mode_ == kModePreemptiveExpandFail) ||
+       (last_mode_ == kModeRfc3389Cng) ||
+       (last_mode_ == kModeCodecInternalCng))) {
     background_noise_->Update(*sync_buffer_, *vad_.get());
   }
 
@@ -1283,8 +1423,7 @@ int NetEqImpl::DecodeLoop(PacketList* packet_list, Operations* operation,
               &decoded_buffer_[*decoded_length], speech_type);
     }
 
-    delete[] packet->payload;
-    delete packet;
+    DeletePacket(packet);
     packet = NULL;
     if (decode_length > 0) {
       *decoded_length += decode_length;
@@ -1322,6 +1461,35 @@ int NetEqImpl::DecodeLoop(PacketList* packet_list, Operations* operation,
   return 0;
 }
 
+bool NetEqImpl::CanUseFastPath(Operations operation,
+                               int decoded_length,
+                               AudioDecoder::SpeechType speech_type,
+                               bool play_dtmf) const {
+  // A block which only plays out samples decoded earlier is included.
+  if (!enable_fast_path_ || operation != kNormal || decoded_length < 0 ||
+      speech_type != AudioDecoder::kSpeech || play_dtmf ||
+      last_mode_ != kModeNormal) {
+    return false;
+  }
+  // The Normal class only ramps up the volume after a muting, and leaves the
+  // signal unchanged otherwise.
+  for (size_t i = 0; i < sync_buffer_->Channels(); ++i) {
+    if (mute_factor_array_[i] < 16384)
+      return false;
+  }
+  return decoded_length % sync_buffer_->Channels() == 0;
+}
+
+void NetEqImpl::DoNormalFastPath(const int16_t* decoded_buffer,
+                                 size_t decoded_length) {
+  // |algorithm_buffer_| is left empty, so nothing more is added to
+  // |sync_buffer_| after the operation.
+  if (decoded_length > 0)
+    sync_buffer_->PushBackInterleaved(decoded_buffer, decoded_length);
+  dtmf_tone_generator_->Reset();
+  ++fast_path_blocks_;
+}
+
 void NetEqImpl::DoNormal(const int16_t* decoded_buffer, size_t decoded_length,
                          AudioDecoder::SpeechType speech_type, bool play_dtmf) {
   assert(normal_.get());
@@ -43,6 +43,7 @@ class Expand;
 class Merge;
 class Normal;
 class PacketBuffer;
+class PacketPool;
 class PayloadSplitter;
 class PostDecodeVad;
 class PreemptiveExpand;
@@ -65,6 +66,7 @@ class NetEqImpl : public webrtc::NetEq {
             DelayPeakDetector* delay_peak_detector,
             DtmfBuffer* dtmf_buffer,
             DtmfToneGenerator* dtmf_tone_generator,
+            PacketPool* packet_pool,
             PacketBuffer* packet_buffer,
             PayloadSplitter* payload_splitter,
             TimestampScaler* timestamp_scaler,
@@ -110,6 +112,13 @@ class NetEqImpl : public webrtc::NetEq {
                int* num_channels,
                NetEqOutputType* type) override;
 
+  int GetAudioBatch(const BatchPacket* packets,
+                    size_t num_packets,
+                    int duration_ms,
+                    size_t max_length,
+                    int16_t* output_audio,
+                    BatchResult* result) override;
+
   // Associates |rtp_payload_type| with |codec| and stores the information in
   // the codec database. Returns kOK on success, kFail on failure.
   int RegisterPayloadType(enum NetEqDecoder codec,
@@ -200,6 +209,10 @@ class NetEqImpl : public webrtc::NetEq {
   // This accessor method is only intended for testing purposes.
   const SyncBuffer* sync_buffer_for_test() const;
 
+  // Returns the number of blocks produced through the fast path. This
+  // accessor method is only intended for testing purposes.
+  int fast_path_blocks_for_test() const;
+
  protected:
   static const int kOutputSizeMs = 10;
   static const int kMaxFrameSize = 2880;  // 60 ms @ 48 kHz.
@@ -257,6 +270,19 @@ class NetEqImpl : public webrtc::NetEq {
                  AudioDecoder::SpeechType* speech_type)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
+  // Returns true if the normal operation on |decoded_length| samples of type
+  // |speech_type| can write the samples straight to |sync_buffer_|, since
+  // the Normal class would leave them unchanged.
+  bool CanUseFastPath(Operations operation,
+                      int decoded_length,
+                      AudioDecoder::SpeechType speech_type,
+                      bool play_dtmf) const
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+
+  // Sub-method which performs the normal operation through the fast path.
+  void DoNormalFastPath(const int16_t* decoded_buffer, size_t decoded_length)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+
   // Sub-method which calls the Normal class to perform the normal operation.
   void DoNormal(const int16_t* decoded_buffer,
                 size_t decoded_length,
@@ -346,6 +372,8 @@ class NetEqImpl : public webrtc::NetEq {
   const rtc::scoped_ptr<DtmfBuffer> dtmf_buffer_ GUARDED_BY(crit_sect_);
   const rtc::scoped_ptr<DtmfToneGenerator> dtmf_tone_generator_
       GUARDED_BY(crit_sect_);
+  // Declared before all users, so that it is destroyed after them.
+  const rtc::scoped_ptr<PacketPool> packet_pool_ GUARDED_BY(crit_sect_);
   const rtc::scoped_ptr<PacketBuffer> packet_buffer_ GUARDED_BY(crit_sect_);
   const rtc::scoped_ptr<PayloadSplitter> payload_splitter_
       GUARDED_BY(crit_sect_);
@@ -391,6 +419,8 @@ class NetEqImpl : public webrtc::NetEq {
   int decoder_error_code_ GUARDED_BY(crit_sect_);
   const BackgroundNoiseMode background_noise_mode_ GUARDED_BY(crit_sect_);
   NetEqPlayoutMode playout_mode_ GUARDED_BY(crit_sect_);
+  const bool enable_fast_path_ GUARDED_BY(crit_sect_);
+  int fast_path_blocks_ GUARDED_BY(crit_sect_);
 
   // These values are used by NACK module to estimate time-to-play of
   // a missing packet. Occasionally, NetEq might decide to decode more
@@ -402,6 +432,13 @@ class NetEqImpl : public webrtc::NetEq {
   int decoded_packet_sequence_number_ GUARDED_BY(crit_sect_);
   uint32_t decoded_packet_timestamp_ GUARDED_BY(crit_sect_);
 
+  // A block produced by GetAudioBatch() that did not fit in its output, to
+  // be delivered by the next GetAudioBatch() or GetAudio() call. Empty if
+  // there is none.
+  std::vector<int16_t> pending_output_ GUARDED_BY(crit_sect_);
+  int pending_samples_per_channel_ GUARDED_BY(crit_sect_);
+  int pending_num_channels_ GUARDED_BY(crit_sect_);
+
  private:
   DISALLOW_COPY_AND_ASSIGN(NetEqImpl);
 };
@@ -11,8 +11,11 @@
 #include "webrtc/modules/audio_coding/neteq/interface/neteq.h"
 #include "webrtc/modules/audio_coding/neteq/neteq_impl.h"
 
+#include <vector>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/audio_coding/neteq/accelerate.h"
 #include "webrtc/modules/audio_coding/neteq/expand.h"
 #include "webrtc/modules/audio_coding/neteq/mock/mock_audio_decoder.h"
@@ -24,6 +27,7 @@
 #include "webrtc/modules/audio_coding/neteq/mock/mock_dtmf_tone_generator.h"
 #include "webrtc/modules/audio_coding/neteq/mock/mock_packet_buffer.h"
 #include "webrtc/modules/audio_coding/neteq/mock/mock_payload_splitter.h"
+#include "webrtc/modules/audio_coding/neteq/packet_pool.h"
 #include "webrtc/modules/audio_coding/neteq/preemptive_expand.h"
 #include "webrtc/modules/audio_coding/neteq/sync_buffer.h"
 #include "webrtc/modules/audio_coding/neteq/timestamp_scaler.h"
@@ -73,6 +77,7 @@ class NetEqImplTest : public ::testing::Test {
         mock_dtmf_tone_generator_(NULL),
         dtmf_tone_generator_(NULL),
         use_mock_dtmf_tone_generator_(true),
+        packet_pool_(NULL),
         mock_packet_buffer_(NULL),
         packet_buffer_(NULL),
         use_mock_packet_buffer_(true),
@@ -126,6 +131,7 @@ class NetEqImplTest : public ::testing::Test {
     } else {
       dtmf_tone_generator_ = new DtmfToneGenerator;
     }
+    packet_pool_ = new PacketPool;
     if (use_mock_packet_buffer_) {
       mock_packet_buffer_ = new MockPacketBuffer(config_.max_packets_in_buffer);
       packet_buffer_ = mock_packet_buffer_;
@@ -136,7 +142,7 @@ class NetEqImplTest : public ::testing::Test {
       mock_payload_splitter_ = new MockPayloadSplitter;
       payload_splitter_ = mock_payload_splitter_;
     } else {
-      payload_splitter_ = new PayloadSplitter;
+      payload_splitter_ = new PayloadSplitter(packet_pool_);
     }
     timestamp_scaler_ = new TimestampScaler(*decoder_database_);
     AccelerateFactory* accelerate_factory = new AccelerateFactory;
@@ -151,6 +157,7 @@ class NetEqImplTest : public ::testing::Test {
                            delay_peak_detector_,
                            dtmf_buffer_,
                            dtmf_tone_generator_,
+                           packet_pool_,
                            packet_buffer_,
                            payload_splitter_,
                            timestamp_scaler_,
@@ -217,6 +224,7 @@ class NetEqImplTest : public ::testing::Test {
   MockDtmfToneGenerator* mock_dtmf_tone_generator_;
   DtmfToneGenerator* dtmf_tone_generator_;
   bool use_mock_dtmf_tone_generator_;
+  PacketPool* packet_pool_;
   MockPacketBuffer* mock_packet_buffer_;
   PacketBuffer* packet_buffer_;
   bool use_mock_packet_buffer_;
@@ -898,4 +906,330 @@ TEST_F(NetEqImplTest, UnsupportedDecoder) {
   EXPECT_EQ(kChannles, num_channels);
 }
 
+// Verifies that GetAudioBatch() produces the same audio as inserting the same
+// packets at their arrival times between GetAudio() calls, and that a block
+// which does not fit in the output is delivered by the next call.
+TEST_F(NetEqImplTest, GetAudioBatch) {
+  UseNoMocks();
+  CreateInstance();
+  rtc::scoped_ptr<NetEq> reference(NetEq::Create(config_));
+
+  const uint8_t kPayloadType = 17;  // Just an arbitrary number.
+  const int kSampleRateHz = 8000;
+  const int kPayloadLengthSamples = 20 * kSampleRateHz / 1000;  // 20 ms.
+  const size_t kPayloadLengthBytes = 2 * kPayloadLengthSamples;
+  const int kNumPackets = 50;
+  const int kLostPacket = 17;
+  const int kDurationMs = 1200;
+  const int kBlockLength = 10 * kSampleRateHz / 1000;
+  EXPECT_EQ(NetEq::kOK,
+            neteq_->RegisterPayloadType(kDecoderPCM16B, kPayloadType));
+  EXPECT_EQ(NetEq::kOK,
+            reference->RegisterPayloadType(kDecoderPCM16B, kPayloadType));
+
+  // Packets with some jitter and one loss, to exercise Expand and Merge too.
+  std::vector<WebRtcRTPHeader> headers(kNumPackets);
+  std::vector<uint8_t> payloads(kNumPackets * kPayloadLengthBytes);
+  std::vector<NetEq::BatchPacket> packets;
+  for (int i = 0; i < kNumPackets; ++i) {
+    headers[i].header.payloadType = kPayloadType;
+    headers[i].header.sequenceNumber = 0x1234 + i;
+    headers[i].header.timestamp = 0x12345678 + i * kPayloadLengthSamples;
+    headers[i].header.ssrc = 0x87654321;
+    for (size_t j = 0; j < kPayloadLengthBytes; ++j)
+      payloads[i * kPayloadLengthBytes + j] = static_cast<uint8_t>(i * 7 + j);
+    if (i == kLostPacket)
+      continue;
+    NetEq::BatchPacket packet;
+    packet.rtp_header = &headers[i];
+    packet.payload = &payloads[i * kPayloadLengthBytes];
+    packet.length_bytes = kPayloadLengthBytes;
+    packet.arrival_time_ms = i * 20 + (i % 3) * 7;
+    packet.receive_timestamp = packet.arrival_time_ms * kSampleRateHz / 1000;
+    packets.push_back(packet);
+  }
+
+  std::vector<int16_t> expected;
+  size_t next_packet = 0;
+  for (int time_ms = 0; time_ms < kDurationMs; time_ms += 10) {
+    for (; next_packet < packets.size() &&
+               packets[next_packet].arrival_time_ms <= time_ms;
+         ++next_packet) {
+      const NetEq::BatchPacket& packet = packets[next_packet];
+      ASSERT_EQ(NetEq::kOK,
+                reference->InsertPacket(*packet.rtp_header, packet.payload,
+                                        packet.length_bytes,
+                                        packet.receive_timestamp));
+    }
+    int16_t output[kBlockLength];
+    int samples_per_channel;
+    int num_channels;
+    ASSERT_EQ(NetEq::kOK,
+              reference->GetAudio(kBlockLength, output, &samples_per_channel,
+                                  &num_channels, NULL));
+    ASSERT_EQ(kBlockLength, samples_per_channel);
+    ASSERT_EQ(1, num_channels);
+    expected.insert(expected.end(), output, output + kBlockLength);
+  }
+
+  // Room for all but one and a half blocks.
+  std::vector<int16_t> output(expected.size() - 3 * kBlockLength / 2);
+  NetEq::BatchResult result;
+  EXPECT_EQ(NetEq::kOK,
+            neteq_->GetAudioBatch(&packets[0], packets.size(), kDurationMs,
+                                  output.size(), &output[0], &result));
+  EXPECT_EQ(packets.size(), result.packets_inserted);
+  EXPECT_EQ(kDurationMs / 10 - 2, result.num_blocks);
+  EXPECT_EQ(result.num_blocks * kBlockLength, result.samples_per_channel);
+  EXPECT_EQ(1, result.num_channels);
+  output.resize(result.samples_per_channel);
+
+  // The second to last block was kept, and GetAudio() delivers it before
+  // producing the last one.
+  for (int i = 0; i < 2; ++i) {
+    int16_t block[kBlockLength];
+    int samples_per_channel;
+    int num_channels;
+    EXPECT_EQ(NetEq::kOK,
+              neteq_->GetAudio(kBlockLength, block, &samples_per_channel,
+                               &num_channels, NULL));
+    EXPECT_EQ(kBlockLength, samples_per_channel);
+    output.insert(output.end(), block, block + kBlockLength);
+  }
+  EXPECT_TRUE(expected == output);
+}
+
+// Verifies that GetAudioBatch() handles 10 ms blocks of 48 kHz audio with
+// eight channels, which are larger than one 60 ms frame of mono audio.
+TEST_F(NetEqImplTest, GetAudioBatchMultichannel) {
+  UseNoMocks();
+  CreateInstance();
+  rtc::scoped_ptr<NetEq> reference(NetEq::Create(config_));
+
+  const uint8_t kPayloadType = 17;  // Just an arbitrary number.
+  const int kSampleRateHz = 48000;
+  const int kChannels = 8;
+  const int kPayloadLengthSamples = 10 * kSampleRateHz / 1000;  // 10 ms.
+  const size_t kPayloadLengthBytes = 2 * kPayloadLengthSamples * kChannels;
+  const int kNumPackets = 20;
+  const int kDurationMs = 200;
+  const int kBlockLength = 10 * kSampleRateHz / 1000 * kChannels;
+
+  // Decodes interleaved 16-bit samples in host byte order.
+  class RawDecoder : public AudioDecoder {
+   public:
+    int Decode(const uint8_t* encoded,
+               size_t encoded_len,
+               int /* sample_rate_hz */,
+               size_t /* max_decoded_bytes */,
+               int16_t* decoded,
+               SpeechType* speech_type) override {
+      memcpy(decoded, encoded, encoded_len);
+      *speech_type = kSpeech;
+      return static_cast<int>(encoded_len / 2);
+    }
+    int PacketDuration(const uint8_t* encoded,
+                       size_t encoded_len) const override {
+      return static_cast<int>(encoded_len / (2 * kChannels));
+    }
+    int Init() override { return 0; }
+    size_t Channels() const override { return kChannels; }
+  } decoder, reference_decoder;
+  EXPECT_EQ(NetEq::kOK,
+            neteq_->RegisterExternalDecoder(&decoder, kDecoderOpus_8ch,
+                                            kPayloadType));
+  EXPECT_EQ(NetEq::kOK,
+            reference->RegisterExternalDecoder(&reference_decoder,
+                                               kDecoderOpus_8ch,
+                                               kPayloadType));
+
+  // A different level in every channel.
+  std::vector<WebRtcRTPHeader> headers(kNumPackets);
+  std::vector<int16_t> payloads(kNumPackets * kPayloadLengthSamples *
+                                kChannels);
+  std::vector<NetEq::BatchPacket> packets(kNumPackets);
+  for (int i = 0; i < kNumPackets; ++i) {
+    headers[i].header.payloadType = kPayloadType;
+    headers[i].header.sequenceNumber = 0x1234 + i;
+    headers[i].header.timestamp = 0x12345678 + i * kPayloadLengthSamples;
+    headers[i].header.ssrc = 0x87654321;
+    int16_t* payload = &payloads[i * kPayloadLengthSamples * kChannels];
+    for (int j = 0; j < kPayloadLengthSamples * kChannels; ++j)
+      payload[j] = static_cast<int16_t>(1000 * (j % kChannels + 1) + i);
+    packets[i].rtp_header = &headers[i];
+    packets[i].payload = reinterpret_cast<const uint8_t*>(payload);
+    packets[i].length_bytes = kPayloadLengthBytes;
+    packets[i].arrival_time_ms = i * 10;
+    packets[i].receive_timestamp = i * kPayloadLengthSamples;
+  }
+
+  std::vector<int16_t> expected;
+  for (int i = 0; i < kDurationMs / 10; ++i) {
+    const NetEq::BatchPacket& packet = packets[i];
+    ASSERT_EQ(NetEq::kOK,
+              reference->InsertPacket(*packet.rtp_header, packet.payload,
+                                      packet.length_bytes,
+                                      packet.receive_timestamp));
+    int16_t output[kBlockLength];
+    int samples_per_channel;
+    int num_channels;
+    ASSERT_EQ(NetEq::kOK,
+              reference->GetAudio(kBlockLength, output, &samples_per_channel,
+                                  &num_channels, NULL));
+    ASSERT_EQ(kBlockLength / kChannels, samples_per_channel);
+    ASSERT_EQ(kChannels, num_channels);
+    expected.insert(expected.end(), output, output + kBlockLength);
+  }
+
+  // Room for all but half a block.
+  std::vector<int16_t> output(expected.size() - kBlockLength / 2);
+  NetEq::BatchResult result;
+  EXPECT_EQ(NetEq::kOK,
+            neteq_->GetAudioBatch(&packets[0], packets.size(), kDurationMs,
+                                  output.size(), &output[0], &result));
+  EXPECT_EQ(packets.size(), result.packets_inserted);
+  EXPECT_EQ(kDurationMs / 10 - 1, result.num_blocks);
+  EXPECT_EQ(result.num_blocks * kBlockLength / kChannels,
+            result.samples_per_channel);
+  EXPECT_EQ(kChannels, result.num_channels);
+  output.resize(result.samples_per_channel * kChannels);
+
+  // The last block was kept for GetAudio().
+  int16_t block[kBlockLength];
+  int samples_per_channel;
+  int num_channels;
+  EXPECT_EQ(NetEq::kOK,
+            neteq_->GetAudio(kBlockLength, block, &samples_per_channel,
+                             &num_channels, NULL));
+  EXPECT_EQ(kBlockLength / kChannels, samples_per_channel);
+  EXPECT_EQ(kChannels, num_channels);
+  output.insert(output.end(), block, block + kBlockLength);
+  EXPECT_TRUE(expected == output);
+}
+
+// Verifies that inserting packets and getting audio takes all packets from the
+// pool once NetEq has reached a steady state. This only covers the packets and
+// their payloads; PacketList nodes are still allocated per packet.
+TEST_F(NetEqImplTest, PacketPoolIsReusedInSteadyState) {
+  UseNoMocks();
+  CreateInstance();
+
+  const uint8_t kPayloadType = 17;  // Just an arbitrary number.
+  const int kSampleRateHz = 8000;
+  const int kPayloadLengthSamples = 60 * kSampleRateHz / 1000;  // 60 ms.
+  const size_t kPayloadLengthBytes = 2 * kPayloadLengthSamples;
+  const int kOutputLengthSamples = 10 * kSampleRateHz / 1000;
+  uint8_t payload[kPayloadLengthBytes] = {0};
+  WebRtcRTPHeader rtp_header;
+  rtp_header.header.payloadType = kPayloadType;
+  rtp_header.header.sequenceNumber = 0x1234;
+  rtp_header.header.timestamp = 0x12345678;
+  rtp_header.header.ssrc = 0x87654321;
+  EXPECT_EQ(NetEq::kOK,
+            neteq_->RegisterPayloadType(kDecoderPCM16B, kPayloadType));
+
+  // Each packet is split into two 30 ms packets on insertion, and
+  // the larger original does not fit a slot of the pool.
+  int num_allocations = 0;
+  for (int i = 0; i < 100; ++i) {
+    if (i == 50)
+      num_allocations = packet_pool_->num_allocations();
+    ASSERT_EQ(NetEq::kOK,
+              neteq_->InsertPacket(rtp_header, payload, kPayloadLengthBytes,
+                                   rtp_header.header.timestamp));
+    rtp_header.header.timestamp += kPayloadLengthSamples;
+    rtp_header.header.sequenceNumber += 1;
+    for (int j = 0; j < 6; ++j) {
+      int16_t output[kOutputLengthSamples];
+      int samples_per_channel;
+      int num_channels;
+      ASSERT_EQ(NetEq::kOK,
+                neteq_->GetAudio(kOutputLengthSamples, output,
+                                 &samples_per_channel, &num_channels, NULL));
+    }
+    EXPECT_EQ(packet_buffer_->NumPacketsInBuffer(),
+              packet_pool_->num_outstanding_packets());
+  }
+  EXPECT_GT(num_allocations, 0);
+  EXPECT_EQ(num_allocations, packet_pool_->num_allocations());
+}
+
+// Verifies that the fast path produces the same audio as the full processing
+// while the stream is steady, and that it is left and resumed around a loss.
+TEST_F(NetEqImplTest, FastPath) {
+  config_.enable_fast_path = true;
+  UseNoMocks();
+  CreateInstance();
+  NetEq::Config reference_config = config_;
+  reference_config.enable_fast_path = false;
+  rtc::scoped_ptr<NetEq> reference(NetEq::Create(reference_config));
+
+  const uint8_t kPayloadType = 17;  // Just an arbitrary number.
+  const int kSampleRateHz = 8000;
+  const int kPayloadLengthSamples = 20 * kSampleRateHz / 1000;  // 20 ms.
+  const size_t kPayloadLengthBytes = 2 * kPayloadLengthSamples;
+  const int kBlockLength = 10 * kSampleRateHz / 1000;
+  const int kNumPackets = 100;
+  const int kLostPacket = 50;
+  const int kPrefillPackets = 1;
+  EXPECT_EQ(NetEq::kOK,
+            neteq_->RegisterPayloadType(kDecoderPCM16B, kPayloadType));
+  EXPECT_EQ(NetEq::kOK,
+            reference->RegisterPayloadType(kDecoderPCM16B, kPayloadType));
+
+  WebRtcRTPHeader rtp_header;
+  rtp_header.header.payloadType = kPayloadType;
+  rtp_header.header.ssrc = 0x87654321;
+  uint8_t payload[kPayloadLengthBytes];
+  int fast_path_blocks_before_loss = 0;
+  for (int i = 0; i < kNumPackets; ++i) {
+    rtp_header.header.sequenceNumber = 0x1234 + i;
+    rtp_header.header.timestamp = 0x12345678 + i * kPayloadLengthSamples;
+    for (size_t j = 0; j < kPayloadLengthBytes; ++j)
+      payload[j] = static_cast<uint8_t>(i * 7 + j);
+    if (i != kLostPacket) {
+      ASSERT_EQ(NetEq::kOK,
+                neteq_->InsertPacket(rtp_header, payload, kPayloadLengthBytes,
+                                     rtp_header.header.timestamp));
+      ASSERT_EQ(NetEq::kOK,
+                reference->InsertPacket(rtp_header, payload,
+                                        kPayloadLengthBytes,
+                                        rtp_header.header.timestamp));
+    }
+    // Keep |kPrefillPackets| packets in the buffer, so that the buffer level
+    // is steady.
+    if (i < kPrefillPackets)
+      continue;
+    if (i == kLostPacket)
+      fast_path_blocks_before_loss = neteq_->fast_path_blocks_for_test();
+    for (int j = 0; j < 2; ++j) {
+      int16_t output[kBlockLength];
+      int16_t expected[kBlockLength];
+      int samples_per_channel;
+      int num_channels;
+      ASSERT_EQ(NetEq::kOK,
+                neteq_->GetAudio(kBlockLength, output, &samples_per_channel,
+                                 &num_channels, NULL));
+      ASSERT_EQ(kBlockLength, samples_per_channel);
+      ASSERT_EQ(NetEq::kOK,
+                reference->GetAudio(kBlockLength, expected,
+                                    &samples_per_channel, &num_channels,
+                                    NULL));
+      // The concealment of the loss may differ, since the background noise
+      // estimate is not updated by the fast path.
+      if (i < kLostPacket) {
+        ASSERT_EQ(0, memcmp(expected, output, sizeof(output)))
+            << "Packet " << i << ", block " << j;
+      }
+    }
+  }
+  // Once the buffer level has settled, the blocks are produced through the
+  // fast path, both before the loss and after the audio has been unmuted.
+  const int kNumBlocks = 2 * (kNumPackets - kPrefillPackets);
+  EXPECT_GT(fast_path_blocks_before_loss, kLostPacket);
+  EXPECT_GT(neteq_->fast_path_blocks_for_test(),
+            fast_path_blocks_before_loss + kNumPackets - kLostPacket);
+  EXPECT_LT(neteq_->fast_path_blocks_for_test(), kNumBlocks);
+}
+
 }  // namespace webrtc
@@ -0,0 +1,26 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/packet.h"
+
+#include "webrtc/modules/audio_coding/neteq/packet_pool.h"
+
+namespace webrtc {
+
+void DeletePacket(Packet* packet) {
+  if (packet->pool) {
+    packet->pool->Free(packet);
+  } else {
+    delete [] packet->payload;
+    delete packet;
+  }
+}
+
+}  // namespace webrtc
@@ -18,6 +18,8 @@
 
 namespace webrtc {
 
+class PacketPool;
+
 // Struct for holding RTP packets.
 struct Packet {
   RTPHeader header;
@@ -26,6 +28,9 @@ struct Packet {
   bool primary;  // Primary, i.e., not redundant payload.
   int waiting_time;
   bool sync_packet;
+  // The pool that the packet and its payload were taken from, or NULL if they
+  // were allocated with new and new[].
+  PacketPool* pool;
 
   // Constructor.
   Packet()
@@ -33,7 +38,8 @@ struct Packet {
         payload_length(0),
         primary(true),
         waiting_time(0),
-        sync_packet(false) {
+        sync_packet(false),
+        pool(NULL) {
   }
 
   // Comparison operators. Establish a packet ordering based on (1) timestamp,
@@ -81,6 +87,9 @@ struct Packet {
   bool operator>=(const Packet& rhs) const { return !operator<(rhs); }
 };
 
+// Deletes |packet| and its payload, or returns them to their pool.
+void DeletePacket(Packet* packet);
+
 // A list of packets.
 typedef std::list<Packet*> PacketList;
 
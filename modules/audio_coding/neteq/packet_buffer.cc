@@ -52,7 +52,7 @@ void PacketBuffer::Flush() {
 int PacketBuffer::InsertPacket(Packet* packet) {
   if (!packet || !packet->payload) {
     if (packet) {
-      delete packet;
+      DeletePacket(packet);
     }
     return kInvalidPacket;
   }
@@ -77,8 +77,7 @@ int PacketBuffer::InsertPacket(Packet* packet) {
   // packet to list.
   if (rit != buffer_.rend() &&
       packet->header.timestamp == (*rit)->header.timestamp) {
-    delete [] packet->payload;
-    delete packet;
+    DeletePacket(packet);
     return return_val;
   }
 
@@ -88,8 +87,7 @@ int PacketBuffer::InsertPacket(Packet* packet) {
   PacketList::iterator it = rit.base();
   if (it != buffer_.end() &&
       packet->header.timestamp == (*it)->header.timestamp) {
-    delete [] (*it)->payload;
-    delete *it;
+    DeletePacket(*it);
     it = buffer_.erase(it);
   }
   buffer_.insert(it, packet);  // Insert the packet at that position.
@@ -269,8 +267,7 @@ bool PacketBuffer::DeleteFirstPacket(PacketList* packet_list) {
     return false;
   }
   Packet* first_packet = packet_list->front();
-  delete [] first_packet->payload;
-  delete first_packet;
+  DeletePacket(first_packet);
   packet_list->pop_front();
   return true;
 }
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/packet_pool.h"
+
+#include <assert.h>
+
+namespace webrtc {
+
+struct PacketPool::Slab {
+  PooledPacket packets[kPacketsPerSlab];
+  uint8_t payloads[kPacketsPerSlab][kPayloadSlotBytes];
+};
+
+PacketPool::PacketPool()
+    : free_list_(NULL),
+      num_allocations_(0),
+      num_outstanding_packets_(0) {
+}
+
+PacketPool::~PacketPool() {
+  assert(num_outstanding_packets_ == 0);
+  for (size_t i = 0; i < slabs_.size(); ++i) {
+    for (size_t j = 0; j < kPacketsPerSlab; ++j)
+      delete [] slabs_[i]->packets[j].large_payload;
+    delete slabs_[i];
+  }
+}
+
+Packet* PacketPool::Allocate(size_t payload_length) {
+  if (!free_list_)
+    AddSlab();
+  PooledPacket* packet = free_list_;
+  free_list_ = packet->next_free;
+  ++num_outstanding_packets_;
+
+  *static_cast<Packet*>(packet) = Packet();
+  packet->pool = this;
+  packet->payload_length = payload_length;
+  if (payload_length <= kPayloadSlotBytes) {
+    packet->payload = packet->slot;
+    return packet;
+  }
+  if (packet->large_capacity < payload_length) {
+    delete [] packet->large_payload;
+    packet->large_payload = new uint8_t[payload_length];
+    packet->large_capacity = payload_length;
+    ++num_allocations_;
+  }
+  packet->payload = packet->large_payload;
+  return packet;
+}
+
+void PacketPool::Free(Packet* packet) {
+  assert(packet->pool == this);
+  PooledPacket* pooled_packet = static_cast<PooledPacket*>(packet);
+  assert(packet->payload == pooled_packet->slot ||
+         packet->payload == pooled_packet->large_payload);
+  pooled_packet->next_free = free_list_;
+  free_list_ = pooled_packet;
+  --num_outstanding_packets_;
+}
+
+void PacketPool::AddSlab() {
+  Slab* slab = new Slab;
+  slabs_.push_back(slab);
+  ++num_allocations_;
+  // Hand out the packets of the new slab in order.
+  for (size_t i = kPacketsPerSlab; i-- > 0;) {
+    PooledPacket* packet = &slab->packets[i];
+    packet->slot = slab->payloads[i];
+    packet->next_free = free_list_;
+    free_list_ = packet;
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_PACKET_POOL_H_
+#define WEBRTC_MODULES_AUDIO_CODING_NETEQ_PACKET_POOL_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/audio_coding/neteq/packet.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Recycles packets and their payload arrays, so that NetEq does not allocate
+// them per packet once the pool has grown to the number of packets in flight.
+// The nodes of the std::list based PacketLists holding them are still
+// allocated per packet. Packets are allocated in slabs, where each packet has
+// a payload slot of kPayloadSlotBytes. A larger payload gets an array of its
+// own, which stays with the packet when it is returned to the pool. The pool
+// is not thread-safe, and must outlive the packets taken from it.
+class PacketPool {
+ public:
+  // Room for 20 ms of 16-bit 16 kHz audio, and for most compressed frames.
+  static const size_t kPayloadSlotBytes = 640;
+  static const size_t kPacketsPerSlab = 16;
+
+  PacketPool();
+  ~PacketPool();
+
+  // Returns a default constructed packet with a |payload| of |payload_length|
+  // bytes, which is also stored in |payload_length|. The packet is returned
+  // to the pool by Free(), or by DeletePacket().
+  Packet* Allocate(size_t payload_length);
+
+  // Returns |packet|, which must have been taken from this pool, to the pool.
+  void Free(Packet* packet);
+
+  // Returns the number of memory allocations made by the pool, for slabs and
+  // for payloads which do not fit a slot.
+  int num_allocations() const { return num_allocations_; }
+
+  // Returns the number of packets taken from the pool and not yet returned.
+  int num_outstanding_packets() const { return num_outstanding_packets_; }
+
+ private:
+  struct PooledPacket : public Packet {
+    PooledPacket() : slot(NULL), large_payload(NULL), large_capacity(0),
+                     next_free(NULL) {}
+
+    uint8_t* slot;  // kPayloadSlotBytes in the slab.
+    uint8_t* large_payload;  // Used when the payload does not fit |slot|.
+    size_t large_capacity;
+    PooledPacket* next_free;
+  };
+  struct Slab;
+
+  void AddSlab();
+
+  std::vector<Slab*> slabs_;
+  PooledPacket* free_list_;
+  int num_allocations_;
+  int num_outstanding_packets_;
+
+  DISALLOW_COPY_AND_ASSIGN(PacketPool);
+};
+
+}  // namespace webrtc
+#endif  // WEBRTC_MODULES_AUDIO_CODING_NETEQ_PACKET_POOL_H_
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Unit tests for PacketPool class.
+
+#include "webrtc/modules/audio_coding/neteq/packet_pool.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_coding/neteq/packet.h"
+
+namespace webrtc {
+
+TEST(PacketPool, AllocateAndFree) {
+  PacketPool pool;
+  Packet* packet = pool.Allocate(100);
+  ASSERT_TRUE(packet != NULL);
+  EXPECT_EQ(&pool, packet->pool);
+  EXPECT_EQ(100u, packet->payload_length);
+  EXPECT_TRUE(packet->primary);
+  EXPECT_FALSE(packet->sync_packet);
+  EXPECT_EQ(0, packet->waiting_time);
+  ASSERT_TRUE(packet->payload != NULL);
+  memset(packet->payload, 0xAB, packet->payload_length);
+  EXPECT_EQ(1, pool.num_outstanding_packets());
+  DeletePacket(packet);
+  EXPECT_EQ(0, pool.num_outstanding_packets());
+}
+
+TEST(PacketPool, ReusesMemory) {
+  PacketPool pool;
+  const size_t kLargePayload = 2 * PacketPool::kPayloadSlotBytes;
+  std::vector<Packet*> packets;
+  for (size_t i = 0; i < 2 * PacketPool::kPacketsPerSlab; ++i)
+    packets.push_back(pool.Allocate(i == 0 ? kLargePayload : 10));
+  // Two slabs, and the array for the large payload.
+  EXPECT_EQ(3, pool.num_allocations());
+  for (size_t i = 0; i < packets.size(); ++i)
+    pool.Free(packets[i]);
+
+  // The first packet out is the last one freed.
+  for (int i = 0; i < 10; ++i) {
+    Packet* small_packet = pool.Allocate(PacketPool::kPayloadSlotBytes);
+    EXPECT_EQ(packets.back(), small_packet);
+    // The array of the large payload is kept with its packet.
+    Packet* large_packet = pool.Allocate(kLargePayload);
+    pool.Free(large_packet);
+    pool.Free(small_packet);
+  }
+  EXPECT_EQ(4, pool.num_allocations());
+}
+
+TEST(PacketPool, MixesWithHeapPackets) {
+  PacketPool pool;
+  PacketList list;
+  list.push_back(pool.Allocate(10));
+  Packet* heap_packet = new Packet;
+  heap_packet->payload = new uint8_t[10];
+  heap_packet->payload_length = 10;
+  list.push_back(heap_packet);
+  while (!list.empty()) {
+    Packet* packet = list.front();
+    list.pop_front();
+    DeletePacket(packet);
+  }
+  EXPECT_EQ(0, pool.num_outstanding_packets());
+}
+
+}  // namespace webrtc
@@ -13,6 +13,7 @@
 #include <assert.h>
 
 #include "webrtc/modules/audio_coding/neteq/decoder_database.h"
+#include "webrtc/modules/audio_coding/neteq/packet_pool.h"
 
 namespace webrtc {
 
@@ -45,61 +46,52 @@ int PayloadSplitter::SplitRed(PacketList* packet_list) {
     //   |0|   Block PT  |
     //   +-+-+-+-+-+-+-+-+
 
+    // Find the first payload byte, which follows the last RED header.
+    const uint8_t* payload_end =
+        red_packet->payload + red_packet->payload_length;
+    const uint8_t* block_ptr = red_packet->payload;
+    while (*block_ptr & 0x80)
+      block_ptr += 4;
+    ++block_ptr;
+
     bool last_block = false;
-    size_t sum_length = 0;
     while (!last_block) {
-      Packet* new_packet = new Packet;
-      new_packet->header = red_packet->header;
       // Check the F bit. If F == 0, this was the last block.
       last_block = ((*payload_ptr & 0x80) == 0);
       // Bits 1 through 7 are payload type.
-      new_packet->header.payloadType = payload_ptr[0] & 0x7F;
+      uint8_t payload_type = payload_ptr[0] & 0x7F;
+      uint32_t timestamp = red_packet->header.timestamp;
+      size_t payload_length;
       if (last_block) {
-        // No more header data to read.
-        ++sum_length;  // Account for RED header size of 1 byte.
-        new_packet->payload_length = red_packet->payload_length - sum_length;
-        new_packet->primary = true;  // Last block is always primary.
+        // No more header data to read. The last block fills the rest of the
+        // packet.
+        payload_length = block_ptr <= payload_end ? payload_end - block_ptr : 0;
         payload_ptr += 1;  // Advance to first payload byte.
       } else {
         // Bits 8 through 21 are timestamp offset.
         int timestamp_offset = (payload_ptr[1] << 6) +
             ((payload_ptr[2] & 0xFC) >> 2);
-        new_packet->header.timestamp = red_packet->header.timestamp -
-            timestamp_offset;
+        timestamp -= timestamp_offset;
         // Bits 22 through 31 are payload length.
-        new_packet->payload_length = ((payload_ptr[2] & 0x03) << 8) +
-            payload_ptr[3];
-        new_packet->primary = false;
+        payload_length = ((payload_ptr[2] & 0x03) << 8) + payload_ptr[3];
         payload_ptr += 4;  // Advance to next RED header.
       }
-      sum_length += new_packet->payload_length;
-      sum_length += 4;  // Account for RED header size of 4 bytes.
-      // Store in new list of packets.
-      new_packets.push_back(new_packet);
-    }
-
-    // Populate the new packets with payload data.
-    // |payload_ptr| now points at the first payload byte.
-    PacketList::iterator new_it;
-    for (new_it = new_packets.begin(); new_it != new_packets.end(); ++new_it) {
-      size_t payload_length = (*new_it)->payload_length;
-      if (payload_ptr + payload_length >
-          red_packet->payload + red_packet->payload_length) {
+      if (block_ptr + payload_length > payload_end) {
         // The block lengths in the RED headers do not match the overall packet
         // length. Something is corrupt. Discard this and the remaining
         // payloads from this packet.
-        while (new_it != new_packets.end()) {
-          // Payload should not have been allocated yet.
-          assert(!(*new_it)->payload);
-          delete (*new_it);
-          new_it = new_packets.erase(new_it);
-        }
         ret = kRedLengthMismatch;
         break;
       }
-      (*new_it)->payload = new uint8_t[payload_length];
-      memcpy((*new_it)->payload, payload_ptr, payload_length);
-      payload_ptr += payload_length;
+      Packet* new_packet = NewPacket(payload_length);
+      new_packet->header = red_packet->header;
+      new_packet->header.payloadType = payload_type;
+      new_packet->header.timestamp = timestamp;
+      new_packet->primary = last_block;  // Last block is always primary.
+      memcpy(new_packet->payload, block_ptr, payload_length);
+      block_ptr += payload_length;
+      // Store in new list of packets.
+      new_packets.push_back(new_packet);
     }
     // Reverse the order of the new packets, so that the primary payload is
     // always first.
@@ -108,13 +100,12 @@ int PayloadSplitter::SplitRed(PacketList* packet_list) {
     // iterator |it|.
     packet_list->splice(it, new_packets, new_packets.begin(),
                         new_packets.end());
-    // Delete old packet payload.
-    delete [] (*it)->payload;
-    delete (*it);
     // Remove |it| from the packet list. This operation effectively moves the
     // iterator |it| to the next packet in the list. Thus, we do not have to
     // increment it manually.
     it = packet_list->erase(it);
+    // Delete old packet.
+    DeletePacket(red_packet);
   }
   return ret;
 }
@@ -155,14 +146,12 @@ int PayloadSplitter::SplitFec(PacketList* packet_list,
         // payload, even if it comes as a secondary payload in a RED packet.
         packet->primary = true;
 
-        Packet* new_packet = new Packet;
+        Packet* new_packet = NewPacket(packet->payload_length);
         new_packet->header = packet->header;
         int duration = decoder->
             PacketDurationRedundant(packet->payload, packet->payload_length);
         new_packet->header.timestamp -= duration;
-        new_packet->payload = new uint8_t[packet->payload_length];
         memcpy(new_packet->payload, packet->payload, packet->payload_length);
-        new_packet->payload_length = packet->payload_length;
         new_packet->primary = false;
         new_packet->waiting_time = packet->waiting_time;
         new_packet->sync_packet = packet->sync_packet;
@@ -196,12 +185,12 @@ int PayloadSplitter::CheckRedPayloads(PacketList* packet_list,
         if (this_payload_type != main_payload_type) {
           // We do not allow redundant payloads of a different type.
           // Discard this payload.
-          delete [] (*it)->payload;
-          delete (*it);
+          Packet* discarded_packet = *it;
           // Remove |it| from the packet list. This operation effectively
           // moves the iterator |it| to the next packet in the list. Thus, we
           // do not have to increment it manually.
           it = packet_list->erase(it);
+          DeletePacket(discarded_packet);
           ++num_deleted_packets;
           continue;
         }
@@ -337,13 +326,12 @@ int PayloadSplitter::SplitAudio(PacketList* packet_list,
     // iterator |it|.
     packet_list->splice(it, new_packets, new_packets.begin(),
                         new_packets.end());
-    // Delete old packet payload.
-    delete [] (*it)->payload;
-    delete (*it);
     // Remove |it| from the packet list. This operation effectively moves the
     // iterator |it| to the next packet in the list. Thus, we do not have to
     // increment it manually.
     it = packet_list->erase(it);
+    // Delete old packet.
+    DeletePacket(packet);
   }
   return kOK;
 }
@@ -372,13 +360,11 @@ void PayloadSplitter::SplitBySamples(const Packet* packet,
   uint8_t* payload_ptr = packet->payload;
   size_t len = packet->payload_length;
   while (len >= (2 * split_size_bytes)) {
-    Packet* new_packet = new Packet;
-    new_packet->payload_length = split_size_bytes;
+    Packet* new_packet = NewPacket(split_size_bytes);
     new_packet->header = packet->header;
     new_packet->header.timestamp = timestamp;
     timestamp += timestamps_per_chunk;
     new_packet->primary = packet->primary;
-    new_packet->payload = new uint8_t[split_size_bytes];
     memcpy(new_packet->payload, payload_ptr, split_size_bytes);
     payload_ptr += split_size_bytes;
     new_packets->push_back(new_packet);
@@ -386,12 +372,10 @@ void PayloadSplitter::SplitBySamples(const Packet* packet,
   }
 
   if (len > 0) {
-    Packet* new_packet = new Packet;
-    new_packet->payload_length = len;
+    Packet* new_packet = NewPacket(len);
     new_packet->header = packet->header;
     new_packet->header.timestamp = timestamp;
     new_packet->primary = packet->primary;
-    new_packet->payload = new uint8_t[len];
     memcpy(new_packet->payload, payload_ptr, len);
     new_packets->push_back(new_packet);
   }
@@ -415,13 +399,11 @@ int PayloadSplitter::SplitByFrames(const Packet* packet,
   size_t len = packet->payload_length;
   while (len > 0) {
     assert(len >= bytes_per_frame);
-    Packet* new_packet = new Packet;
-    new_packet->payload_length = bytes_per_frame;
+    Packet* new_packet = NewPacket(bytes_per_frame);
     new_packet->header = packet->header;
     new_packet->header.timestamp = timestamp;
     timestamp += timestamps_per_frame;
     new_packet->primary = packet->primary;
-    new_packet->payload = new uint8_t[bytes_per_frame];
     memcpy(new_packet->payload, payload_ptr, bytes_per_frame);
     payload_ptr += bytes_per_frame;
     new_packets->push_back(new_packet);
@@ -430,4 +412,13 @@ int PayloadSplitter::SplitByFrames(const Packet* packet,
   return kOK;
 }
 
+Packet* PayloadSplitter::NewPacket(size_t payload_length) {
+  if (packet_pool_)
+    return packet_pool_->Allocate(payload_length);
+  Packet* packet = new Packet;
+  packet->payload = new uint8_t[payload_length];
+  packet->payload_length = payload_length;
+  return packet;
+}
+
 }  // namespace webrtc
@@ -18,12 +18,13 @@ namespace webrtc {
 
 // Forward declarations.
 class DecoderDatabase;
+class PacketPool;
 
 // This class handles splitting of payloads into smaller parts.
-// The class does not have any member variables, and the methods could have
-// been made static. The reason for not making them static is testability.
-// With this design, the splitting functionality can be mocked during testing
-// of the NetEqImpl class.
+// The only member variable is the pool that new packets are taken from, and
+// the methods could otherwise have been made static. The reason for not making
+// them static is testability. With this design, the splitting functionality
+// can be mocked during testing of the NetEqImpl class.
 class PayloadSplitter {
  public:
   enum SplitterReturnCodes {
@@ -36,7 +37,12 @@ class PayloadSplitter {
     kFecSplitError = -5,
   };
 
-  PayloadSplitter() {}
+  // New packets are allocated with new.
+  PayloadSplitter() : packet_pool_(NULL) {}
+
+  // New packets are taken from |packet_pool|, which must outlive them.
+  explicit PayloadSplitter(PacketPool* packet_pool)
+      : packet_pool_(packet_pool) {}
 
   virtual ~PayloadSplitter() {}
 
@@ -83,6 +89,11 @@ class PayloadSplitter {
                             uint32_t timestamps_per_frame,
                             PacketList* new_packets);
 
+  // Returns a new packet with a payload of |payload_length| bytes.
+  Packet* NewPacket(size_t payload_length);
+
+  PacketPool* const packet_pool_;
+
   DISALLOW_COPY_AND_ASSIGN(PayloadSplitter);
 };
 
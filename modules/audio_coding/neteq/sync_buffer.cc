@@ -23,6 +23,16 @@ size_t SyncBuffer::FutureLength() const {
 void SyncBuffer::PushBack(const AudioMultiVector& append_this) {
   size_t samples_added = append_this.Size();
   AudioMultiVector::PushBack(append_this);
+  PopFrontAfterPushBack(samples_added);
+}
+
+void SyncBuffer::PushBackInterleaved(const int16_t* append_this,
+                                     size_t length) {
+  AudioMultiVector::PushBackInterleaved(append_this, length);
+  PopFrontAfterPushBack(length / Channels());
+}
+
+void SyncBuffer::PopFrontAfterPushBack(size_t samples_added) {
   AudioMultiVector::PopFront(samples_added);
   if (samples_added <= next_index_) {
     next_index_ -= samples_added;
@@ -36,6 +36,10 @@ class SyncBuffer : public AudioMultiVector {
   // the move of the beginning of "future" data.
   void PushBack(const AudioMultiVector& append_this);
 
+  // Same as PushBack(), but appends |length| interleaved samples from
+  // |append_this|.
+  void PushBackInterleaved(const int16_t* append_this, size_t length);
+
   // Adds |length| zeros to the beginning of each channel. Removes
   // the same number of samples from the end of the SyncBuffer, to
   // maintain a constant buffer size. The |next_index_| is updated to reflect
@@ -90,6 +94,10 @@ class SyncBuffer : public AudioMultiVector {
   void set_dtmf_index(size_t value);
 
  private:
+  // Removes |samples_added| samples from the beginning of the buffer after
+  // they were added to the end, and moves the indices accordingly.
+  void PopFrontAfterPushBack(size_t samples_added);
+
   size_t next_index_;
   uint32_t end_timestamp_;  // The timestamp of the last sample in the buffer.
   size_t dtmf_index_;  // Index to the first non-DTMF sample in the buffer.
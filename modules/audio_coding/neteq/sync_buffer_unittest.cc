@@ -87,6 +87,32 @@ TEST(SyncBuffer, PushBackAndFlush) {
   }
 }
 
+TEST(SyncBuffer, PushBackInterleaved) {
+  // Create a SyncBuffer with two channels and 100 samples each.
+  static const size_t kLen = 100;
+  static const size_t kChannels = 2;
+  SyncBuffer sync_buffer(kChannels, kLen);
+  static const size_t kNewLen = 10;
+  int16_t new_data[kChannels * kNewLen];
+  // Populate |new_data| with the sample index in the first channel, and its
+  // negation in the second.
+  for (size_t i = 0; i < kNewLen; ++i) {
+    new_data[kChannels * i] = static_cast<int16_t>(i);
+    new_data[kChannels * i + 1] = -static_cast<int16_t>(i);
+  }
+  // Like PushBack(), this should keep the size of the buffer, and move
+  // |next_index_| by the number of samples per channel.
+  sync_buffer.PushBackInterleaved(new_data, kChannels * kNewLen);
+  ASSERT_EQ(kLen, sync_buffer.Size());
+  EXPECT_EQ(kLen - kNewLen, sync_buffer.next_index());
+  for (size_t i = 0; i < kNewLen; ++i) {
+    EXPECT_EQ(static_cast<int16_t>(i),
+              sync_buffer[0][sync_buffer.next_index() + i]);
+    EXPECT_EQ(-static_cast<int16_t>(i),
+              sync_buffer[1][sync_buffer.next_index() + i]);
+  }
+}
+
 TEST(SyncBuffer, PushFrontZeros) {
   // Create a SyncBuffer with two channels and 100 samples each.
   static const size_t kLen = 100;
@@ -39,3 +39,66 @@ TEST(NetEqPerformanceTest, RunClean) {
   webrtc::test::PrintResult(
       "neteq_performance", "", "0_pl_0_drift", runtime, "ms", true);
 }
+
+// Runs a test with 30% clock drift and no losses, so that a large part of the
+// audio goes through PreemptiveExpand (first half) and Accelerate (second
+// half).
+TEST(NetEqPerformanceTest, RunTimeStretch) {
+  const int kSimulationTimeMs = 10000000;
+  const int kLossPeriod = 0;  // No losses.
+  const double kDriftFactor = 0.3;
+  int64_t runtime = webrtc::test::NetEqPerformanceTest::Run(
+      kSimulationTimeMs, kLossPeriod, kDriftFactor);
+  ASSERT_GT(runtime, 0);
+  webrtc::test::PrintResult(
+      "neteq_performance", "", "0_pl_30_drift", runtime, "ms", true);
+}
+
+// Runs a test where every third packet is lost, to put emphasis on Expand and
+// Merge.
+TEST(NetEqPerformanceTest, RunExpand) {
+  const int kSimulationTimeMs = 10000000;
+  const int kLossPeriod = 3;  // Drop every 3rd packet.
+  const double kDriftFactor = 0.0;  // No clock drift.
+  int64_t runtime = webrtc::test::NetEqPerformanceTest::Run(
+      kSimulationTimeMs, kLossPeriod, kDriftFactor);
+  ASSERT_GT(runtime, 0);
+  webrtc::test::PrintResult(
+      "neteq_performance", "", "33_pl_0_drift", runtime, "ms", true);
+}
+
+// Runs a G.711 stream with neither packet losses nor clock drift, first with
+// the full processing and then through NetEq's fast path.
+TEST(NetEqPerformanceTest, RunPcmuClean) {
+  const int kSimulationTimeMs = 10000000;
+  const int kLossPeriod = 0;  // No losses.
+  const double kDriftFactor = 0.0;  // No clock drift.
+  int64_t runtime = webrtc::test::NetEqPerformanceTest::RunPcmu(
+      kSimulationTimeMs, kLossPeriod, kDriftFactor, false);
+  ASSERT_GT(runtime, 0);
+  webrtc::test::PrintResult(
+      "neteq_performance", "", "pcmu_0_pl_0_drift", runtime, "ms", true);
+  runtime = webrtc::test::NetEqPerformanceTest::RunPcmu(
+      kSimulationTimeMs, kLossPeriod, kDriftFactor, true);
+  ASSERT_GT(runtime, 0);
+  webrtc::test::PrintResult("neteq_performance", "",
+                            "pcmu_0_pl_0_drift_fast_path", runtime, "ms",
+                            true);
+}
+
+// Runs the same test as Run, decoding through NetEq::GetAudioBatch(), and
+// reports how many times faster than real time it is.
+TEST(NetEqPerformanceTest, RunBatch) {
+  const int kSimulationTimeMs = 10000000;
+  const int kLossPeriod = 10;  // Drop every 10th packet.
+  const double kDriftFactor = 0.1;
+  int64_t runtime = webrtc::test::NetEqPerformanceTest::RunBatch(
+      kSimulationTimeMs, kLossPeriod, kDriftFactor);
+  ASSERT_GT(runtime, 0);
+  webrtc::test::PrintResult(
+      "neteq_performance", "", "10_pl_10_drift_batch", runtime, "ms", true);
+  webrtc::test::PrintResult("neteq_performance", "",
+                            "10_pl_10_drift_batch_realtime_factor",
+                            static_cast<size_t>(kSimulationTimeMs / runtime),
+                            "x", true);
+}
@@ -48,6 +48,11 @@ DEFINE_double(drift, 0.1,
              "Clockdrift factor.");
 static const bool drift_dummy =
     google::RegisterFlagValidator(&FLAGS_drift, &ValidateDriftfactor);
+DEFINE_bool(batch, false,
+            "Decode one second at a time with NetEq::GetAudioBatch().");
+DEFINE_bool(pcmu, false, "Use G.711 mu-law at 8 kHz instead of PCM16.");
+DEFINE_bool(fast_path, false,
+            "Enable NetEq's fast path. Only used together with --pcmu.");
 
 int main(int argc, char* argv[]) {
   std::string program_name = argv[0];
@@ -56,7 +61,10 @@ int main(int argc, char* argv[]) {
       "  --runtime_ms=N         runtime in ms; default is 10000 ms\n"
       "  --lossrate=N           drop every N packets; default is 10\n"
       "  --drift=F              clockdrift factor between 0.0 and 1.0; "
-      "default is 0.1\n";
+      "default is 0.1\n"
+      "  --batch                decode through NetEq::GetAudioBatch()\n"
+      "  --pcmu                 use G.711 mu-law instead of PCM16\n"
+      "  --fast_path            enable NetEq's fast path (with --pcmu)\n";
   google::SetUsageMessage(usage);
   google::ParseCommandLineFlags(&argc, &argv, true);
 
@@ -66,9 +74,17 @@ int main(int argc, char* argv[]) {
     return 0;
   }
 
-  int64_t result =
-      webrtc::test::NetEqPerformanceTest::Run(FLAGS_runtime_ms, FLAGS_lossrate,
-                                              FLAGS_drift);
+  int64_t result;
+  if (FLAGS_batch) {
+    result = webrtc::test::NetEqPerformanceTest::RunBatch(
+        FLAGS_runtime_ms, FLAGS_lossrate, FLAGS_drift);
+  } else if (FLAGS_pcmu) {
+    result = webrtc::test::NetEqPerformanceTest::RunPcmu(
+        FLAGS_runtime_ms, FLAGS_lossrate, FLAGS_drift, FLAGS_fast_path);
+  } else {
+    result = webrtc::test::NetEqPerformanceTest::Run(
+        FLAGS_runtime_ms, FLAGS_lossrate, FLAGS_drift);
+  }
   if (result <= 0) {
     std::cout << "There was an error" << std::endl;
     return -1;
@@ -76,5 +92,7 @@ int main(int argc, char* argv[]) {
 
   std::cout << "Simulation done" << std::endl;
   std::cout << "Runtime = " << result << " ms" << std::endl;
+  std::cout << "Realtime factor = " <<
+      static_cast<double>(FLAGS_runtime_ms) / result << std::endl;
   return 0;
 }
@@ -10,6 +10,10 @@
 
 #include "webrtc/modules/audio_coding/neteq/tools/neteq_performance_test.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "webrtc/modules/audio_coding/codecs/g711/include/g711_interface.h"
 #include "webrtc/modules/audio_coding/codecs/pcm16b/include/pcm16b.h"
 #include "webrtc/modules/audio_coding/neteq/interface/neteq.h"
 #include "webrtc/modules/audio_coding/neteq/tools/audio_loop.h"
@@ -26,18 +30,46 @@ using webrtc::WebRtcRTPHeader;
 namespace webrtc {
 namespace test {
 
-int64_t NetEqPerformanceTest::Run(int runtime_ms,
-                                  int lossrate,
-                                  double drift_factor) {
+namespace {
+
+// The codec of the simulated stream.
+struct Codec {
+  NetEqDecoder decoder_type;
+  int payload_type;
+  int sample_rate_hz;
+  // Encodes |length| samples into |payload|, and returns the number of bytes.
+  size_t (*encode)(const int16_t* samples, size_t length, uint8_t* payload);
+};
+
+size_t EncodePcm16b(const int16_t* samples, size_t length, uint8_t* payload) {
+  return WebRtcPcm16b_Encode(samples, static_cast<int16_t>(length), payload);
+}
+
+size_t EncodePcmu(const int16_t* samples, size_t length, uint8_t* payload) {
+  return WebRtcG711_EncodeU(samples, static_cast<int16_t>(length), payload);
+}
+
+const Codec kPcm16bSwb32kHz = {kDecoderPCM16Bswb32kHz, 95, 32000,
+                               &EncodePcm16b};
+const Codec kPcmu = {kDecoderPCMu, 0, 8000, &EncodePcmu};
+
+// Runs the test of NetEqPerformanceTest::Run() with |codec|. The input file
+// is read as if it had the sample rate of |codec|.
+int64_t RunWithCodec(const Codec& codec,
+                     bool enable_fast_path,
+                     int runtime_ms,
+                     int lossrate,
+                     double drift_factor) {
   const std::string kInputFileName =
       webrtc::test::ResourcePath("audio_coding/testfile32kHz", "pcm");
-  const int kSampRateHz = 32000;
-  const webrtc::NetEqDecoder kDecoderType = webrtc::kDecoderPCM16Bswb32kHz;
-  const int kPayloadType = 95;
+  const int kSampRateHz = codec.sample_rate_hz;
+  const webrtc::NetEqDecoder kDecoderType = codec.decoder_type;
+  const int kPayloadType = codec.payload_type;
 
   // Initialize NetEq instance.
   NetEq::Config config;
   config.sample_rate_hz = kSampRateHz;
+  config.enable_fast_path = enable_fast_path;
   NetEq* neteq = NetEq::Create(config);
   // Register decoder in |neteq|.
   if (neteq->RegisterPayloadType(kDecoderType, kPayloadType) != 0)
@@ -63,10 +95,11 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
       rtp_gen.GetRtpHeader(kPayloadType, kInputBlockSizeSamples, &rtp_header);
   const int16_t* input_samples = audio_loop.GetNextBlock();
   if (!input_samples) exit(1);
-  uint8_t input_payload[kInputBlockSizeSamples * sizeof(int16_t)];
+  // Large enough for any of the codecs.
+  std::vector<uint8_t> input_payload(kInputBlockSizeSamples * sizeof(int16_t));
   size_t payload_len =
-      WebRtcPcm16b_Encode(input_samples, kInputBlockSizeSamples, input_payload);
-  assert(payload_len == kInputBlockSizeSamples * sizeof(int16_t));
+      codec.encode(input_samples, kInputBlockSizeSamples, &input_payload[0]);
+  assert(payload_len > 0);
 
   // Main loop.
   webrtc::Clock* clock = webrtc::Clock::GetRealTimeClock();
@@ -81,7 +114,7 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
       if (!lost) {
         // Insert packet.
         int error = neteq->InsertPacket(
-            rtp_header, input_payload, payload_len,
+            rtp_header, &input_payload[0], payload_len,
             packet_input_time_ms * kSampRateHz / 1000);
         if (error != NetEq::kOK)
           return -1;
@@ -93,10 +126,9 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
                                                   &rtp_header);
       input_samples = audio_loop.GetNextBlock();
       if (!input_samples) return -1;
-      payload_len = WebRtcPcm16b_Encode(const_cast<int16_t*>(input_samples),
-                                        kInputBlockSizeSamples,
-                                        input_payload);
-      assert(payload_len == kInputBlockSizeSamples * sizeof(int16_t));
+      payload_len = codec.encode(input_samples, kInputBlockSizeSamples,
+                                 &input_payload[0]);
+      assert(payload_len > 0);
     }
 
     // Get output audio, but don't do anything with it.
@@ -127,5 +159,132 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
   return end_time_ms - start_time_ms;
 }
 
+}  // namespace
+
+int64_t NetEqPerformanceTest::Run(int runtime_ms,
+                                  int lossrate,
+                                  double drift_factor) {
+  return RunWithCodec(kPcm16bSwb32kHz, false, runtime_ms, lossrate,
+                      drift_factor);
+}
+
+int64_t NetEqPerformanceTest::RunPcmu(int runtime_ms,
+                                      int lossrate,
+                                      double drift_factor,
+                                      bool enable_fast_path) {
+  return RunWithCodec(kPcmu, enable_fast_path, runtime_ms, lossrate,
+                      drift_factor);
+}
+
+int64_t NetEqPerformanceTest::RunBatch(int runtime_ms,
+                                       int lossrate,
+                                       double drift_factor) {
+  const std::string kInputFileName =
+      webrtc::test::ResourcePath("audio_coding/testfile32kHz", "pcm");
+  const int kSampRateHz = 32000;
+  const webrtc::NetEqDecoder kDecoderType = webrtc::kDecoderPCM16Bswb32kHz;
+  const int kPayloadType = 95;
+  const int kChunkSizeMs = 1000;
+  const int kOutputBlockSizeMs = 10;
+
+  // Initialize NetEq instance.
+  NetEq::Config config;
+  config.sample_rate_hz = kSampRateHz;
+  NetEq* neteq = NetEq::Create(config);
+  // Register decoder in |neteq|.
+  if (neteq->RegisterPayloadType(kDecoderType, kPayloadType) != 0)
+    return -1;
+
+  // Set up AudioLoop object.
+  AudioLoop audio_loop;
+  const size_t kMaxLoopLengthSamples = kSampRateHz * 10;  // 10 second loop.
+  const size_t kInputBlockSizeSamples = 60 * kSampRateHz / 1000;  // 60 ms.
+  const size_t kPayloadBytes = kInputBlockSizeSamples * sizeof(int16_t);
+  if (!audio_loop.Init(kInputFileName, kMaxLoopLengthSamples,
+                       kInputBlockSizeSamples))
+    return -1;
+
+  WebRtcRTPHeader rtp_header;
+  RtpGenerator rtp_gen(kSampRateHz / 1000);
+  // Start with positive drift first half of simulation.
+  rtp_gen.set_drift_factor(drift_factor);
+  bool drift_flipped = false;
+  int32_t packet_input_time_ms =
+      rtp_gen.GetRtpHeader(kPayloadType, kInputBlockSizeSamples, &rtp_header);
+
+  // The packets of the current chunk.
+  std::vector<WebRtcRTPHeader> headers;
+  std::vector<uint8_t> payloads;
+  std::vector<int32_t> arrival_times_ms;
+  std::vector<NetEq::BatchPacket> packets;
+  std::vector<int16_t> out_data(kChunkSizeMs * kSampRateHz / 1000);
+
+  // Main loop.
+  webrtc::Clock* clock = webrtc::Clock::GetRealTimeClock();
+  int64_t start_time_ms = clock->TimeInMilliseconds();
+  for (int32_t chunk_start_ms = 0; chunk_start_ms < runtime_ms;
+       chunk_start_ms += kChunkSizeMs) {
+    if (chunk_start_ms >= runtime_ms / 2 && !drift_flipped) {
+      // Apply negative drift second half of simulation.
+      rtp_gen.set_drift_factor(-drift_factor);
+      drift_flipped = true;
+    }
+    const int chunk_size_ms =
+        std::min(kChunkSizeMs, runtime_ms - chunk_start_ms);
+    headers.clear();
+    payloads.clear();
+    arrival_times_ms.clear();
+    packets.clear();
+    // The packets that arrive by the time of the last block in the chunk.
+    while (packet_input_time_ms <=
+           chunk_start_ms + chunk_size_ms - kOutputBlockSizeMs) {
+      const int16_t* input_samples = audio_loop.GetNextBlock();
+      if (!input_samples) return -1;
+      // Drop every N packets, where N = FLAGS_lossrate.
+      bool lost = false;
+      if (lossrate > 0) {
+        lost = ((rtp_header.header.sequenceNumber - 1) % lossrate) == 0;
+      }
+      if (!lost) {
+        headers.push_back(rtp_header);
+        arrival_times_ms.push_back(packet_input_time_ms);
+        payloads.resize(payloads.size() + kPayloadBytes);
+        size_t payload_len = WebRtcPcm16b_Encode(
+            const_cast<int16_t*>(input_samples), kInputBlockSizeSamples,
+            &payloads[payloads.size() - kPayloadBytes]);
+        assert(payload_len == kPayloadBytes);
+      }
+      // Get next packet.
+      packet_input_time_ms = rtp_gen.GetRtpHeader(kPayloadType,
+                                                  kInputBlockSizeSamples,
+                                                  &rtp_header);
+    }
+    // |headers| and |payloads| are complete, so pointers into them are stable.
+    for (size_t i = 0; i < headers.size(); ++i) {
+      NetEq::BatchPacket packet;
+      packet.rtp_header = &headers[i];
+      packet.payload = &payloads[i * kPayloadBytes];
+      packet.length_bytes = kPayloadBytes;
+      packet.receive_timestamp = arrival_times_ms[i] * kSampRateHz / 1000;
+      packet.arrival_time_ms = arrival_times_ms[i] - chunk_start_ms;
+      packets.push_back(packet);
+    }
+
+    // Get output audio, but don't do anything with it.
+    NetEq::BatchResult result;
+    int error = neteq->GetAudioBatch(packets.empty() ? NULL : &packets[0],
+                                     packets.size(), chunk_size_ms,
+                                     out_data.size(), &out_data[0], &result);
+    if (error != NetEq::kOK)
+      return -1;
+    assert(result.packets_inserted == packets.size());
+    assert(result.samples_per_channel ==
+           chunk_size_ms * kSampRateHz / 1000);
+  }
+  int64_t end_time_ms = clock->TimeInMilliseconds();
+  delete neteq;
+  return end_time_ms - start_time_ms;
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -24,6 +24,18 @@ class NetEqPerformanceTest {
   //   |drift_factor|: clock drift in [0, 1].
   // Returns the runtime in ms.
   static int64_t Run(int runtime_ms, int lossrate, double drift_factor);
+
+  // Same as Run(), but with G.711 mu-law at 8 kHz instead of PCM16 at
+  // 32 kHz, and with NetEq::Config::enable_fast_path set to
+  // |enable_fast_path|.
+  static int64_t RunPcmu(int runtime_ms,
+                         int lossrate,
+                         double drift_factor,
+                         bool enable_fast_path);
+
+  // Same as Run(), but decodes the stream one second at a time through
+  // NetEq::GetAudioBatch(). Returns the runtime in ms.
+  static int64_t RunBatch(int runtime_ms, int lossrate, double drift_factor);
 };
 
 }  // namespace test
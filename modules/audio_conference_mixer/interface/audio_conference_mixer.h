@@ -37,6 +37,10 @@ public:
 
     // Factory method. Constructor disabled.
     static AudioConferenceMixer* Create(int id);
+    // As above, but mixes the |maxMixedParticipants| loudest participants
+    // instead of kMaximumAmountOfMixedParticipants. Anonymous participants
+    // are always mixed and do not count toward this limit.
+    static AudioConferenceMixer* Create(int id, size_t maxMixedParticipants);
     virtual ~AudioConferenceMixer() {}
 
     // Module functions
@@ -76,6 +80,13 @@ public:
     // downsampling of audio contributing to the mixed audio.
     virtual int32_t SetMinimumMixingFrequency(Frequency freq) = 0;
 
+    // Pull the audio of the participants on numThreads worker threads in
+    // addition to the thread calling Process(). GetAudioFrame() of different
+    // participants may then run concurrently, and on any of these threads.
+    // The mixed audio is the same as when pulling one participant at a time,
+    // which is what happens with numThreads set to 0, the default.
+    virtual int32_t SetParallelPullThreads(size_t numThreads) = 0;
+
 protected:
     AudioConferenceMixer() {}
 };
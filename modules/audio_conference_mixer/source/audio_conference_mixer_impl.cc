@@ -8,23 +8,66 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+
 #include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer_defines.h"
 #include "webrtc/modules/audio_conference_mixer/source/audio_conference_mixer_impl.h"
 #include "webrtc/modules/audio_conference_mixer/source/audio_frame_manipulator.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/modules/utility/interface/audio_frame_operations.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 
 namespace webrtc {
 namespace {
 
-struct ParticipantFramePair {
-  MixerParticipant* participant;
-  AudioFrame* audioFrame;
+// The participants to pull a frame from, and where to put the frames.
+struct PullFramesJob {
+  int32_t id;
+  MixerParticipant* const* participants;
+  AudioFrame* const* frames;
+  int32_t* results;
 };
 
-typedef std::list<ParticipantFramePair*> ParticipantFramePairList;
+// WorkerPool::TaskFunction that pulls the frame of participant |index|.
+void PullFrame(void* obj, size_t index) {
+  const PullFramesJob* job = static_cast<const PullFramesJob*>(obj);
+  job->results[index] =
+      job->participants[index]->GetAudioFrame(job->id, *job->frames[index]);
+}
+
+// Orders ParticipantFramePairs such that the std heap functions keep the one
+// with the lowest energy at the front.
+bool HigherEnergy(const ParticipantFramePair& a,
+                  const ParticipantFramePair& b) {
+  return a.audioFrame->energy_ > b.audioFrame->energy_;
+}
+
+// Equivalent to |*mixed_frame += frame|, but sums the samples with
+// |add_samples|.
+void AddFrame(AudioFrame* mixed_frame, const AudioFrame& frame,
+              AddSamplesProc add_samples) {
+  if (mixed_frame->num_channels_ != frame.num_channels_ ||
+      mixed_frame->samples_per_channel_ != frame.samples_per_channel_) {
+    // Let AudioFrame deal with the first frame and mismatching formats.
+    *mixed_frame += frame;
+    return;
+  }
+  if (mixed_frame->vad_activity_ == AudioFrame::kVadActive ||
+      frame.vad_activity_ == AudioFrame::kVadActive) {
+    mixed_frame->vad_activity_ = AudioFrame::kVadActive;
+  } else if (mixed_frame->vad_activity_ == AudioFrame::kVadUnknown ||
+             frame.vad_activity_ == AudioFrame::kVadUnknown) {
+    mixed_frame->vad_activity_ = AudioFrame::kVadUnknown;
+  }
+  if (mixed_frame->speech_type_ != frame.speech_type_)
+    mixed_frame->speech_type_ = AudioFrame::kUndefined;
+  add_samples(frame.data_,
+              frame.samples_per_channel_ * frame.num_channels_,
+              mixed_frame->data_);
+  mixed_frame->energy_ = 0xffffffff;
+}
 
 // Mix |frame| into |mixed_frame|, with saturation protection and upmixing.
 // These effects are applied to |frame| itself prior to mixing. Assumes that
@@ -32,7 +75,8 @@ typedef std::list<ParticipantFramePair*> ParticipantFramePairList;
 // stereo at most.
 //
 // TODO(andrew): consider not modifying |frame| here.
-void MixFrames(AudioFrame* mixed_frame, AudioFrame* frame, bool use_limiter) {
+void MixFrames(AudioFrame* mixed_frame, AudioFrame* frame, bool use_limiter,
+               AddSamplesProc add_samples) {
   assert(mixed_frame->num_channels_ >= frame->num_channels_);
   if (use_limiter) {
     // Divide by two to avoid saturation in the mixing.
@@ -46,7 +90,7 @@ void MixFrames(AudioFrame* mixed_frame, AudioFrame* frame, bool use_limiter) {
     AudioFrameOperations::MonoToStereo(frame);
   }
 
-  *mixed_frame += *frame;
+  AddFrame(mixed_frame, *frame, add_samples);
 }
 
 // Return the max number of channels from a |list| composed of AudioFrames.
@@ -108,7 +152,17 @@ void MixHistory::ResetMixedStatus() {
 }
 
 AudioConferenceMixer* AudioConferenceMixer::Create(int id) {
-    AudioConferenceMixerImpl* mixer = new AudioConferenceMixerImpl(id);
+    return Create(id, kMaximumAmountOfMixedParticipants);
+}
+
+AudioConferenceMixer* AudioConferenceMixer::Create(
+    int id,
+    size_t maxMixedParticipants) {
+    if(maxMixedParticipants == 0) {
+        return NULL;
+    }
+    AudioConferenceMixerImpl* mixer =
+        new AudioConferenceMixerImpl(id, maxMixedParticipants);
     if(!mixer->Init()) {
         delete mixer;
         return NULL;
@@ -116,11 +170,14 @@ AudioConferenceMixer* AudioConferenceMixer::Create(int id) {
     return mixer;
 }
 
-AudioConferenceMixerImpl::AudioConferenceMixerImpl(int id)
-    : _scratchParticipantsToMixAmount(0),
-      _scratchMixedParticipants(),
+AudioConferenceMixerImpl::AudioConferenceMixerImpl(int id,
+                                                   size_t maxMixedParticipants)
+    : _maxMixedParticipants(maxMixedParticipants),
+      _addSamples(AddSamples_C),
+      _scratchParticipantsToMixAmount(0),
+      _scratchMixedParticipants(maxMixedParticipants),
       _scratchVadPositiveParticipantsAmount(0),
-      _scratchVadPositiveParticipants(),
+      _scratchVadPositiveParticipants(maxMixedParticipants),
       _id(id),
       _minimumMixingFreq(kLowestPossible),
       _mixReceiver(NULL),
@@ -138,7 +195,21 @@ AudioConferenceMixerImpl::AudioConferenceMixerImpl(int id)
       _timeStamp(0),
       _timeScheduler(kProcessPeriodicityInMs),
       _mixedAudioLevel(),
-      _processCalls(0) {}
+      _processCalls(0) {
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+    _addSamples = AddSamples_SSE2;
+#else
+    if(WebRtc_GetCPUInfo(kSSE2))
+        _addSamples = AddSamples_SSE2;
+#endif
+#endif
+    _scratchMixList.reserve(maxMixedParticipants);
+    _scratchRampOutList.reserve(maxMixedParticipants);
+    _scratchMixedParticipantsList.reserve(maxMixedParticipants);
+    _scratchActiveList.reserve(maxMixedParticipants);
+}
 
 bool AudioConferenceMixerImpl::Init() {
     _crit.reset(CriticalSectionWrapper::CreateCriticalSection());
@@ -206,8 +277,7 @@ int64_t AudioConferenceMixerImpl::TimeUntilNextProcess() {
 }
 
 int32_t AudioConferenceMixerImpl::Process() {
-    size_t remainingParticipantsAllowedToMix =
-        kMaximumAmountOfMixedParticipants;
+    size_t remainingParticipantsAllowedToMix = _maxMixedParticipants;
     {
         CriticalSectionScoped cs(_crit.get());
         assert(_processCalls == 0);
@@ -217,10 +287,12 @@ int32_t AudioConferenceMixerImpl::Process() {
         _timeScheduler.UpdateScheduler();
     }
 
-    AudioFrameList mixList;
-    AudioFrameList rampOutList;
-    AudioFrameList additionalFramesList;
-    std::map<int, MixerParticipant*> mixedParticipantsMap;
+    AudioFrameList& mixList = _scratchMixList;
+    AudioFrameList& rampOutList = _scratchRampOutList;
+    AudioFrameList& additionalFramesList = _scratchAdditionalFramesList;
+    MixerParticipantList& mixedParticipantsList =
+        _scratchMixedParticipantsList;
+    mixedParticipantsList.clear();
     {
         CriticalSectionScoped cs(_cbCrit.get());
 
@@ -270,12 +342,12 @@ int32_t AudioConferenceMixerImpl::Process() {
             }
         }
 
-        UpdateToMix(&mixList, &rampOutList, &mixedParticipantsMap,
+        UpdateToMix(&mixList, &rampOutList, &mixedParticipantsList,
                     remainingParticipantsAllowedToMix);
 
         GetAdditionalAudio(&additionalFramesList);
-        UpdateMixedStatus(mixedParticipantsMap);
-        _scratchParticipantsToMixAmount = mixedParticipantsMap.size();
+        UpdateMixedStatus(&mixedParticipantsList);
+        _scratchParticipantsToMixAmount = mixedParticipantsList.size();
     }
 
     // Get an AudioFrame for mixing from the memory pool.
@@ -354,12 +426,12 @@ int32_t AudioConferenceMixerImpl::Process() {
             timeForMixerCallback) {
             _mixerStatusCallback->MixedParticipants(
                 _id,
-                _scratchMixedParticipants,
+                &_scratchMixedParticipants[0],
                 static_cast<uint32_t>(_scratchParticipantsToMixAmount));
 
             _mixerStatusCallback->VADPositiveParticipants(
                 _id,
-                _scratchVadPositiveParticipants,
+                &_scratchVadPositiveParticipants[0],
                 _scratchVadPositiveParticipantsAmount);
             _mixerStatusCallback->MixedAudioLevel(_id,audioLevel);
         }
@@ -494,8 +566,8 @@ int32_t AudioConferenceMixerImpl::SetMixabilityStatus(
         }
 
         size_t numMixedNonAnonymous = _participantList.size();
-        if (numMixedNonAnonymous > kMaximumAmountOfMixedParticipants) {
-            numMixedNonAnonymous = kMaximumAmountOfMixedParticipants;
+        if (numMixedNonAnonymous > _maxMixedParticipants) {
+            numMixedNonAnonymous = _maxMixedParticipants;
         }
         numMixedParticipants =
             numMixedNonAnonymous + _additionalParticipantList.size();
@@ -559,6 +631,23 @@ int32_t AudioConferenceMixerImpl::AnonymousMixabilityStatus(
     return 0;
 }
 
+int32_t AudioConferenceMixerImpl::SetParallelPullThreads(size_t numThreads) {
+    CriticalSectionScoped cs(_cbCrit.get());
+    _framePuller.reset(NULL);
+    if(numThreads == 0) {
+        return 0;
+    }
+    _framePuller.reset(new WorkerPool(numThreads, "MixerFramePuller"));
+    if(_framePuller->num_threads() != numThreads) {
+        WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
+                     "failed to start %d frame puller threads",
+                     static_cast<int>(numThreads));
+        _framePuller.reset(NULL);
+        return -1;
+    }
+    return 0;
+}
+
 int32_t AudioConferenceMixerImpl::SetMinimumMixingFrequency(
     Frequency freq) {
     // Make sure that only allowed sampling frequencies are used. Use closest
@@ -617,20 +706,33 @@ int32_t AudioConferenceMixerImpl::GetLowestMixingFrequencyFromList(
 void AudioConferenceMixerImpl::UpdateToMix(
     AudioFrameList* mixList,
     AudioFrameList* rampOutList,
-    std::map<int, MixerParticipant*>* mixParticipantList,
+    MixerParticipantList* mixParticipantList,
     size_t& maxAudioFrameCounter) {
     WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
                  "UpdateToMix(mixList,rampOutList,mixParticipantList,%d)",
                  maxAudioFrameCounter);
     const size_t mixListStartSize = mixList->size();
-    AudioFrameList activeList;
-    // Struct needed by the passive lists to keep track of which AudioFrame
-    // belongs to which MixerParticipant.
-    ParticipantFramePairList passiveWasNotMixedList;
-    ParticipantFramePairList passiveWasMixedList;
-    for (MixerParticipantList::iterator participant = _participantList.begin();
-         participant != _participantList.end();
-         ++participant) {
+    // The active participants with the highest energy so far, as a min-heap
+    // such that the one to replace is always at the front.
+    ParticipantFramePairList& activeList = _scratchActiveList;
+    // Needed by the passive lists to keep track of which AudioFrame belongs to
+    // which MixerParticipant.
+    ParticipantFramePairList& passiveWasNotMixedList =
+        _scratchPassiveWasNotMixedList;
+    ParticipantFramePairList& passiveWasMixedList =
+        _scratchPassiveWasMixedList;
+    activeList.clear();
+    passiveWasNotMixedList.clear();
+    passiveWasMixedList.clear();
+    // Without pull threads, pull one frame at a time so that frames that
+    // are not mixed go straight back to the pool and are reused while hot.
+    const bool pullInParallel = _framePuller.get() != NULL;
+    AudioFrameList& audioFrames = _scratchPulledFrames;
+    if(pullInParallel) {
+        GetAudioFrames(_participantList, &audioFrames);
+    }
+    for (size_t i = 0; i < _participantList.size(); ++i) {
+        MixerParticipant* participant = _participantList[i];
         // Stop keeping track of passive participants if there are already
         // enough participants available (they wont be mixed anyway).
         bool mustAddToPassiveList = (maxAudioFrameCounter >
@@ -639,20 +741,10 @@ void AudioConferenceMixerImpl::UpdateToMix(
                                      passiveWasNotMixedList.size()));
 
         bool wasMixed = false;
-        (*participant)->_mixHistory->WasMixed(wasMixed);
-        AudioFrame* audioFrame = NULL;
-        if(_audioFramePool->PopMemory(audioFrame) == -1) {
-            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
-                         "failed PopMemory() call");
-            assert(false);
-            return;
-        }
-        audioFrame->sample_rate_hz_ = _outputFrequency;
-
-        if((*participant)->GetAudioFrame(_id,*audioFrame) != 0) {
-            WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
-                         "failed to GetAudioFrame() from participant");
-            _audioFramePool->PushMemory(audioFrame);
+        participant->_mixHistory->WasMixed(wasMixed);
+        AudioFrame* audioFrame = pullInParallel ?
+            audioFrames[i] : GetAudioFrame(*participant);
+        if(audioFrame == NULL) {
             continue;
         }
         if (_participantList.size() != 1) {
@@ -669,85 +761,47 @@ void AudioConferenceMixerImpl::UpdateToMix(
                          "invalid VAD state from participant");
         }
 
+        ParticipantFramePair pair;
+        pair.audioFrame  = audioFrame;
+        pair.participant = participant;
         if(audioFrame->vad_activity_ == AudioFrame::kVadActive) {
             if(!wasMixed) {
                 RampIn(*audioFrame);
             }
+            CalculateEnergy(*audioFrame);
 
-            if(activeList.size() >= maxAudioFrameCounter) {
-                // There are already more active participants than should be
-                // mixed. Only keep the ones with the highest energy.
-                AudioFrameList::iterator replaceItem;
-                CalculateEnergy(*audioFrame);
-                uint32_t lowestEnergy = audioFrame->energy_;
-
-                bool found_replace_item = false;
-                for (AudioFrameList::iterator iter = activeList.begin();
-                     iter != activeList.end();
-                     ++iter) {
-                    CalculateEnergy(**iter);
-                    if((*iter)->energy_ < lowestEnergy) {
-                        replaceItem = iter;
-                        lowestEnergy = (*iter)->energy_;
-                        found_replace_item = true;
-                    }
-                }
-                if(found_replace_item) {
-                    AudioFrame* replaceFrame = *replaceItem;
-
-                    bool replaceWasMixed = false;
-                    std::map<int, MixerParticipant*>::iterator it =
-                        mixParticipantList->find(replaceFrame->id_);
-
-                    // When a frame is pushed to |activeList| it is also pushed
-                    // to mixParticipantList with the frame's id. This means
-                    // that the Find call above should never fail.
-                    assert(it != mixParticipantList->end());
-                    it->second->_mixHistory->WasMixed(replaceWasMixed);
-
-                    mixParticipantList->erase(replaceFrame->id_);
-                    activeList.erase(replaceItem);
-
-                    activeList.push_front(audioFrame);
-                    (*mixParticipantList)[audioFrame->id_] = *participant;
-                    assert(mixParticipantList->size() <=
-                           kMaximumAmountOfMixedParticipants);
-
-                    if (replaceWasMixed) {
-                      RampOut(*replaceFrame);
-                      rampOutList->push_back(replaceFrame);
-                      assert(rampOutList->size() <=
-                             kMaximumAmountOfMixedParticipants);
-                    } else {
-                      _audioFramePool->PushMemory(replaceFrame);
-                    }
-                } else {
-                    if(wasMixed) {
-                        RampOut(*audioFrame);
-                        rampOutList->push_back(audioFrame);
-                        assert(rampOutList->size() <=
-                               kMaximumAmountOfMixedParticipants);
-                    } else {
-                        _audioFramePool->PushMemory(audioFrame);
-                    }
-                }
+            if(activeList.size() < maxAudioFrameCounter) {
+                activeList.push_back(pair);
+                std::push_heap(activeList.begin(), activeList.end(),
+                               HigherEnergy);
+                continue;
+            }
+            // There are already more active participants than should be
+            // mixed. Only keep the ones with the highest energy.
+            ParticipantFramePair removed = pair;
+            bool removedWasMixed = wasMixed;
+            if(!activeList.empty() &&
+               activeList.front().audioFrame->energy_ < audioFrame->energy_) {
+                std::pop_heap(activeList.begin(), activeList.end(),
+                              HigherEnergy);
+                removed = activeList.back();
+                activeList.back() = pair;
+                std::push_heap(activeList.begin(), activeList.end(),
+                               HigherEnergy);
+                removed.participant->_mixHistory->WasMixed(removedWasMixed);
+            }
+            if(removedWasMixed) {
+                RampOut(*removed.audioFrame);
+                rampOutList->push_back(removed.audioFrame);
+                assert(rampOutList->size() <= _maxMixedParticipants);
             } else {
-                activeList.push_front(audioFrame);
-                (*mixParticipantList)[audioFrame->id_] = *participant;
-                assert(mixParticipantList->size() <=
-                       kMaximumAmountOfMixedParticipants);
+                _audioFramePool->PushMemory(removed.audioFrame);
             }
         } else {
             if(wasMixed) {
-                ParticipantFramePair* pair = new ParticipantFramePair;
-                pair->audioFrame  = audioFrame;
-                pair->participant = *participant;
                 passiveWasMixedList.push_back(pair);
             } else if(mustAddToPassiveList) {
                 RampIn(*audioFrame);
-                ParticipantFramePair* pair = new ParticipantFramePair;
-                pair->audioFrame  = audioFrame;
-                pair->participant = *participant;
                 passiveWasNotMixedList.push_back(pair);
             } else {
                 _audioFramePool->PushMemory(audioFrame);
@@ -757,10 +811,11 @@ void AudioConferenceMixerImpl::UpdateToMix(
     assert(activeList.size() <= maxAudioFrameCounter);
     // At this point it is known which participants should be mixed. Transfer
     // this information to this functions output parameters.
-    for (AudioFrameList::iterator iter = activeList.begin();
+    for (ParticipantFramePairList::iterator iter = activeList.begin();
          iter != activeList.end();
          ++iter) {
-        mixList->push_back(*iter);
+        mixList->push_back(iter->audioFrame);
+        mixParticipantList->push_back(iter->participant);
     }
     activeList.clear();
     // Always mix a constant number of AudioFrames. If there aren't enough
@@ -770,32 +825,27 @@ void AudioConferenceMixerImpl::UpdateToMix(
          iter != passiveWasMixedList.end();
          ++iter) {
         if(mixList->size() < maxAudioFrameCounter + mixListStartSize) {
-            mixList->push_back((*iter)->audioFrame);
-            (*mixParticipantList)[(*iter)->audioFrame->id_] =
-                (*iter)->participant;
-            assert(mixParticipantList->size() <=
-                   kMaximumAmountOfMixedParticipants);
+            mixList->push_back(iter->audioFrame);
+            mixParticipantList->push_back(iter->participant);
         } else {
-            _audioFramePool->PushMemory((*iter)->audioFrame);
+            _audioFramePool->PushMemory(iter->audioFrame);
         }
-        delete *iter;
     }
+    passiveWasMixedList.clear();
     // And finally the ones that have not been mixed for a while.
     for (ParticipantFramePairList::iterator iter =
              passiveWasNotMixedList.begin();
          iter != passiveWasNotMixedList.end();
          ++iter) {
         if(mixList->size() <  maxAudioFrameCounter + mixListStartSize) {
-          mixList->push_back((*iter)->audioFrame);
-            (*mixParticipantList)[(*iter)->audioFrame->id_] =
-                (*iter)->participant;
-            assert(mixParticipantList->size() <=
-                   kMaximumAmountOfMixedParticipants);
+            mixList->push_back(iter->audioFrame);
+            mixParticipantList->push_back(iter->participant);
         } else {
-            _audioFramePool->PushMemory((*iter)->audioFrame);
+            _audioFramePool->PushMemory(iter->audioFrame);
         }
-        delete *iter;
     }
+    passiveWasNotMixedList.clear();
+    assert(mixParticipantList->size() <= _maxMixedParticipants);
     assert(maxAudioFrameCounter + mixListStartSize >= mixList->size());
     maxAudioFrameCounter += mixListStartSize - mixList->size();
 }
@@ -808,27 +858,18 @@ void AudioConferenceMixerImpl::GetAdditionalAudio(
     // from additionalParticipantList_. If that happens it will invalidate any
     // iterators. Create a copy of the participants list such that the list of
     // participants can be traversed safely.
-    MixerParticipantList additionalParticipantList;
-    additionalParticipantList.insert(additionalParticipantList.begin(),
-                                     _additionalParticipantList.begin(),
+    MixerParticipantList& additionalParticipantList =
+        _scratchAdditionalParticipantList;
+    additionalParticipantList.assign(_additionalParticipantList.begin(),
                                      _additionalParticipantList.end());
 
-    for (MixerParticipantList::iterator participant =
-             additionalParticipantList.begin();
-         participant != additionalParticipantList.end();
-         ++participant) {
-        AudioFrame* audioFrame = NULL;
-        if(_audioFramePool->PopMemory(audioFrame) == -1) {
-            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
-                         "failed PopMemory() call");
-            assert(false);
-            return;
-        }
-        audioFrame->sample_rate_hz_ = _outputFrequency;
-        if((*participant)->GetAudioFrame(_id, *audioFrame) != 0) {
-            WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
-                         "failed to GetAudioFrame() from participant");
-            _audioFramePool->PushMemory(audioFrame);
+    AudioFrameList& audioFrames = _scratchPulledFrames;
+    GetAudioFrames(additionalParticipantList, &audioFrames);
+    for (AudioFrameList::iterator iter = audioFrames.begin();
+         iter != audioFrames.end();
+         ++iter) {
+        AudioFrame* audioFrame = *iter;
+        if(audioFrame == NULL) {
             continue;
         }
         if(audioFrame->samples_per_channel_ == 0) {
@@ -840,27 +881,76 @@ void AudioConferenceMixerImpl::GetAdditionalAudio(
     }
 }
 
+AudioFrame* AudioConferenceMixerImpl::GetAudioFrame(
+    MixerParticipant& participant) {
+    AudioFrame* audioFrame = NULL;
+    if(_audioFramePool->PopMemory(audioFrame) == -1) {
+        WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                     "failed PopMemory() call");
+        assert(false);
+        return NULL;
+    }
+    audioFrame->sample_rate_hz_ = _outputFrequency;
+    if(participant.GetAudioFrame(_id, *audioFrame) != 0) {
+        WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
+                     "failed to GetAudioFrame() from participant");
+        _audioFramePool->PushMemory(audioFrame);
+        return NULL;
+    }
+    return audioFrame;
+}
+
+void AudioConferenceMixerImpl::GetAudioFrames(
+    const MixerParticipantList& participants,
+    AudioFrameList* audioFrames) {
+    audioFrames->assign(participants.size(), NULL);
+    if(_framePuller.get() == NULL || participants.size() < 2) {
+        for (size_t i = 0; i < participants.size(); ++i) {
+            (*audioFrames)[i] = GetAudioFrame(*participants[i]);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < participants.size(); ++i) {
+        if(_audioFramePool->PopMemory((*audioFrames)[i]) == -1) {
+            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                         "failed PopMemory() call");
+            assert(false);
+            ClearAudioFrameList(audioFrames);
+            audioFrames->assign(participants.size(), NULL);
+            return;
+        }
+        (*audioFrames)[i]->sample_rate_hz_ = _outputFrequency;
+    }
+    std::vector<int32_t>& results = _scratchPullResults;
+    results.resize(participants.size());
+    PullFramesJob job = {_id, &participants[0], &(*audioFrames)[0],
+                         &results[0]};
+    _framePuller->RunTasks(PullFrame, &job, participants.size());
+    for (size_t i = 0; i < participants.size(); ++i) {
+        if(results[i] != 0) {
+            WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
+                         "failed to GetAudioFrame() from participant");
+            _audioFramePool->PushMemory((*audioFrames)[i]);
+        }
+    }
+}
+
 void AudioConferenceMixerImpl::UpdateMixedStatus(
-    std::map<int, MixerParticipant*>& mixedParticipantsMap) {
+    MixerParticipantList* mixedParticipantsList) {
     WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
-                 "UpdateMixedStatus(mixedParticipantsMap)");
-    assert(mixedParticipantsMap.size() <= kMaximumAmountOfMixedParticipants);
+                 "UpdateMixedStatus(mixedParticipantsList)");
+    assert(mixedParticipantsList->size() <= _maxMixedParticipants);
 
-    // Loop through all participants. If they are in the mix map they
+    // Loop through all participants. If they are in the mixed list they
     // were mixed.
+    std::sort(mixedParticipantsList->begin(), mixedParticipantsList->end());
     for (MixerParticipantList::iterator participant = _participantList.begin();
          participant != _participantList.end();
          ++participant) {
-        bool isMixed = false;
-        for (std::map<int, MixerParticipant*>::iterator it =
-                 mixedParticipantsMap.begin();
-             it != mixedParticipantsMap.end();
-             ++it) {
-          if (it->second == *participant) {
-            isMixed = true;
-            break;
-          }
-        }
+        const bool isMixed = std::binary_search(mixedParticipantsList->begin(),
+                                                mixedParticipantsList->end(),
+                                                *participant);
         (*participant)->_mixHistory->SetIsMixed(isMixed);
     }
 }
@@ -964,18 +1054,18 @@ int32_t AudioConferenceMixerImpl::MixFromList(
     for (AudioFrameList::const_iterator iter = audioFrameList->begin();
          iter != audioFrameList->end();
          ++iter) {
-        if(position >= kMaximumAmountOfMixedParticipants) {
+        if(position >= _maxMixedParticipants) {
             WEBRTC_TRACE(
                 kTraceMemory,
                 kTraceAudioMixerServer,
                 _id,
                 "Trying to mix more than max amount of mixed participants:%d!",
-                kMaximumAmountOfMixedParticipants);
+                static_cast<int>(_maxMixedParticipants));
             // Assert and avoid crash
             assert(false);
             position = 0;
         }
-        MixFrames(&mixedAudio, (*iter), use_limiter_);
+        MixFrames(&mixedAudio, (*iter), use_limiter_, _addSamples);
 
         SetParticipantStatistics(&_scratchMixedParticipants[position],
                                  **iter);
@@ -998,7 +1088,7 @@ int32_t AudioConferenceMixerImpl::MixAnonomouslyFromList(
     for (AudioFrameList::const_iterator iter = audioFrameList->begin();
          iter != audioFrameList->end();
          ++iter) {
-        MixFrames(&mixedAudio, *iter, use_limiter_);
+        MixFrames(&mixedAudio, *iter, use_limiter_, _addSamples);
     }
     return 0;
 }
@@ -1021,7 +1111,7 @@ bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame& mixedAudio) {
     //
     // Instead we double the frame (with addition since left-shifting a
     // negative value is undefined).
-    mixedAudio += mixedAudio;
+    AddFrame(&mixedAudio, mixedAudio, _addSamples);
 
     if(error != _limiter->kNoError) {
         WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
@@ -11,23 +11,33 @@
 #ifndef WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_CONFERENCE_MIXER_IMPL_H_
 #define WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_CONFERENCE_MIXER_IMPL_H_
 
-#include <list>
-#include <map>
+#include <vector>
 
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/engine_configurations.h"
 #include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer.h"
+#include "webrtc/modules/audio_conference_mixer/source/audio_frame_manipulator.h"
 #include "webrtc/modules/audio_conference_mixer/source/level_indicator.h"
 #include "webrtc/modules/audio_conference_mixer/source/memory_pool.h"
 #include "webrtc/modules/audio_conference_mixer/source/time_scheduler.h"
 #include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
 
 namespace webrtc {
 class AudioProcessing;
 class CriticalSectionWrapper;
 
-typedef std::list<AudioFrame*> AudioFrameList;
-typedef std::list<MixerParticipant*> MixerParticipantList;
+typedef std::vector<AudioFrame*> AudioFrameList;
+typedef std::vector<MixerParticipant*> MixerParticipantList;
+
+// Keeps track of which AudioFrame belongs to which MixerParticipant while
+// selecting the participants to mix.
+struct ParticipantFramePair {
+  MixerParticipant* participant;
+  AudioFrame* audioFrame;
+};
+
+typedef std::vector<ParticipantFramePair> ParticipantFramePairList;
 
 // Cheshire cat implementation of MixerParticipant's non virtual functions.
 class MixHistory
@@ -57,7 +67,7 @@ public:
     // AudioProcessing only accepts 10 ms frames.
     enum {kProcessPeriodicityInMs = 10};
 
-    AudioConferenceMixerImpl(int id);
+    AudioConferenceMixerImpl(int id, size_t maxMixedParticipants);
     ~AudioConferenceMixerImpl();
 
     // Must be called after ctor.
@@ -84,6 +94,7 @@ public:
                                          const bool mixable) override;
     int32_t AnonymousMixabilityStatus(MixerParticipant& participant,
                                       bool& mixable) override;
+    int32_t SetParallelPullThreads(size_t numThreads) override;
 
 private:
     enum{DEFAULT_AUDIO_FRAME_POOLSIZE = 50};
@@ -93,8 +104,10 @@ private:
     Frequency OutputFrequency() const;
 
     // Fills mixList with the AudioFrames pointers that should be used when
-    // mixing. Fills mixParticipantList with ParticipantStatistics for the
-    // participants who's AudioFrames are inside mixList.
+    // mixing. Fills mixParticipantList with the participants who's AudioFrames
+    // are inside mixList. Of the active participants, the
+    // maxAudioFrameCounter ones with the highest energy are kept, which takes
+    // O(N log K) time for N participants and K mixed ones.
     // maxAudioFrameCounter both input and output specifies how many more
     // AudioFrames that are allowed to be mixed.
     // rampOutList contain AudioFrames corresponding to an audio stream that
@@ -103,7 +116,7 @@ private:
     void UpdateToMix(
         AudioFrameList* mixList,
         AudioFrameList* rampOutList,
-        std::map<int, MixerParticipant*>* mixParticipantList,
+        MixerParticipantList* mixParticipantList,
         size_t& maxAudioFrameCounter);
 
     // Return the lowest mixing frequency that can be used without having to
@@ -111,13 +124,23 @@ private:
     int32_t GetLowestMixingFrequency();
     int32_t GetLowestMixingFrequencyFromList(MixerParticipantList* mixList);
 
+    // Returns a new AudioFrame from participant, or NULL if it failed to
+    // deliver one.
+    AudioFrame* GetAudioFrame(MixerParticipant& participant);
+
+    // Fills audioFrames with a new AudioFrame from each of participants, in
+    // the same order, pulling them in parallel if enabled. The entries of
+    // participants that failed to deliver a frame are NULL.
+    void GetAudioFrames(const MixerParticipantList& participants,
+                        AudioFrameList* audioFrames);
+
     // Return the AudioFrames that should be mixed anonymously.
     void GetAdditionalAudio(AudioFrameList* additionalFramesList);
 
     // Update the MixHistory of all MixerParticipants. mixedParticipantsList
-    // should contain a map of MixerParticipants that have been mixed.
-    void UpdateMixedStatus(
-        std::map<int, MixerParticipant*>& mixedParticipantsList);
+    // should contain the MixerParticipants that have been mixed. It is sorted
+    // by this function.
+    void UpdateMixedStatus(MixerParticipantList* mixedParticipantsList);
 
     // Clears audioFrameList and reclaims all memory associated with it.
     void ClearAudioFrameList(AudioFrameList* audioFrameList);
@@ -154,15 +177,33 @@ private:
 
     bool LimitMixedAudio(AudioFrame& mixedAudio);
 
+    // The number of non-anonymous participants that are mixed at most.
+    const size_t _maxMixedParticipants;
+
+    // Saturating sample adder, selected for the CPU at construction.
+    AddSamplesProc _addSamples;
+
     // Scratch memory
     // Note that the scratch memory may only be touched in the scope of
-    // Process().
+    // Process(). The lists are kept between calls to avoid reallocating them
+    // every iteration.
     size_t         _scratchParticipantsToMixAmount;
-    ParticipantStatistics  _scratchMixedParticipants[
-        kMaximumAmountOfMixedParticipants];
+    std::vector<ParticipantStatistics> _scratchMixedParticipants;
     uint32_t         _scratchVadPositiveParticipantsAmount;
-    ParticipantStatistics  _scratchVadPositiveParticipants[
-        kMaximumAmountOfMixedParticipants];
+    std::vector<ParticipantStatistics> _scratchVadPositiveParticipants;
+    AudioFrameList _scratchMixList;
+    AudioFrameList _scratchRampOutList;
+    AudioFrameList _scratchAdditionalFramesList;
+    MixerParticipantList _scratchMixedParticipantsList;
+    MixerParticipantList _scratchAdditionalParticipantList;
+    // Candidates for mixing in UpdateToMix(). The active ones are kept as a
+    // min-heap on energy.
+    ParticipantFramePairList _scratchActiveList;
+    ParticipantFramePairList _scratchPassiveWasMixedList;
+    ParticipantFramePairList _scratchPassiveWasNotMixedList;
+    // The result of GetAudioFrames().
+    AudioFrameList _scratchPulledFrames;
+    std::vector<int32_t> _scratchPullResults;
 
     rtc::scoped_ptr<CriticalSectionWrapper> _crit;
     rtc::scoped_ptr<CriticalSectionWrapper> _cbCrit;
@@ -210,6 +251,9 @@ private:
 
     // Used for inhibiting saturation in mixing.
     rtc::scoped_ptr<AudioProcessing> _limiter;
+
+    // Pulls the participants' audio in parallel if set. Protected by _cbCrit.
+    rtc::scoped_ptr<WorkerPool> _framePuller;
 };
 }  // namespace webrtc
 
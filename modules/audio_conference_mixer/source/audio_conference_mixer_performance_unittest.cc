@@ -0,0 +1,150 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <sstream>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer.h"
+#include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer_defines.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 16000;
+const int kSamplesPerChannel = kSampleRateHz / 100;
+
+// Produces a square wave of a fixed amplitude every 10 ms, after spending
+// |decode_work| iterations on a stand-in for decoding.
+class FakeParticipant : public MixerParticipant {
+ public:
+  FakeParticipant(int id, int16_t amplitude)
+      : id_(id),
+        amplitude_(amplitude),
+        vad_(AudioFrame::kVadActive),
+        decode_work_(0),
+        seed_(static_cast<uint32_t>(id)) {}
+
+  int32_t GetAudioFrame(const int32_t id, AudioFrame& audio_frame) override {
+    for (int i = 0; i < decode_work_; ++i)
+      seed_ = seed_ * 1664525 + 1013904223;
+    int16_t samples[kSamplesPerChannel];
+    for (int i = 0; i < kSamplesPerChannel; ++i)
+      samples[i] = (i & 8) ? amplitude_ : -amplitude_;
+    audio_frame.UpdateFrame(id_, 0, samples, kSamplesPerChannel,
+                            kSampleRateHz, AudioFrame::kNormalSpeech, vad_, 1);
+    return 0;
+  }
+
+  int32_t NeededFrequency(const int32_t id) override { return kSampleRateHz; }
+
+  void set_vad(AudioFrame::VADActivity vad) { vad_ = vad; }
+  void set_decode_work(int decode_work) { decode_work_ = decode_work; }
+
+ private:
+  const int id_;
+  const int16_t amplitude_;
+  AudioFrame::VADActivity vad_;
+  int decode_work_;
+  uint32_t seed_;
+};
+
+// Adds |num_participants| of increasing loudness to |mixer|, shuffled so that
+// the loudest are not registered last.
+void AddParticipants(AudioConferenceMixer* mixer,
+                     int num_participants,
+                     ScopedVector<FakeParticipant>* participants) {
+  for (int i = 0; i < num_participants; ++i) {
+    const int rank = (i * 7) % num_participants;
+    participants->push_back(
+        new FakeParticipant(rank, static_cast<int16_t>(10 * (rank + 1))));
+    ASSERT_EQ(0, mixer->SetMixabilityStatus(*participants->back(), true));
+  }
+}
+
+}  // namespace
+
+// Reports the CPU time of a 10 ms mixing iteration for growing rooms.
+TEST(AudioConferenceMixerPerformanceTest, Process) {
+  const int kNumParticipants[] = {10, 50, 200};
+  const size_t kMaxMixed[] = {3, 10};
+  const int kNumIterations = 500;
+  for (size_t max_mixed : kMaxMixed) {
+    for (int num_participants : kNumParticipants) {
+      rtc::scoped_ptr<AudioConferenceMixer> mixer(
+          AudioConferenceMixer::Create(0, max_mixed));
+      ASSERT_TRUE(mixer.get() != NULL);
+      ScopedVector<FakeParticipant> participants;
+      AddParticipants(mixer.get(), num_participants, &participants);
+
+      const int64_t start_us = TickTime::MicrosecondTimestamp();
+      for (int i = 0; i < kNumIterations; ++i)
+        EXPECT_EQ(0, mixer->Process());
+      const int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+
+      for (FakeParticipant* participant : participants)
+        EXPECT_EQ(0, mixer->SetMixabilityStatus(*participant, false));
+
+      std::ostringstream trace;
+      trace << num_participants << "_participants_" << max_mixed << "_mixed";
+      webrtc::test::PrintResult("audio_conference_mixer_process", "",
+                                trace.str(),
+                                static_cast<size_t>(elapsed_us /
+                                                    kNumIterations),
+                                "us", false);
+    }
+  }
+}
+
+// Reports the wall time of a 10 ms mixing iteration when the participants
+// are pulled in parallel, with about 20 us of decoding per participant.
+TEST(AudioConferenceMixerPerformanceTest, ParallelPull) {
+  const int kNumParticipants[] = {10, 50, 200};
+  const size_t kNumThreads[] = {0, 1, 3};
+  const int kDecodeWork = 20000;
+  const int kNumTicks = 50;
+  for (int num_participants : kNumParticipants) {
+    for (size_t num_threads : kNumThreads) {
+      rtc::scoped_ptr<AudioConferenceMixer> mixer(
+          AudioConferenceMixer::Create(0, 4));
+      ASSERT_TRUE(mixer.get() != NULL);
+      EXPECT_EQ(0, mixer->SetParallelPullThreads(num_threads));
+      ScopedVector<FakeParticipant> participants;
+      AddParticipants(mixer.get(), num_participants, &participants);
+      for (size_t i = 0; i < participants.size(); ++i) {
+        participants[i]->set_decode_work(kDecodeWork);
+        // Keep a few of them silent, to exercise the passive lists.
+        if (i % 5 == 0)
+          participants[i]->set_vad(AudioFrame::kVadPassive);
+      }
+
+      const int64_t start_us = TickTime::MicrosecondTimestamp();
+      for (int i = 0; i < kNumTicks; ++i)
+        EXPECT_EQ(0, mixer->Process());
+      const int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+
+      for (FakeParticipant* participant : participants)
+        EXPECT_EQ(0, mixer->SetMixabilityStatus(*participant, false));
+
+      std::ostringstream trace;
+      trace << num_participants << "_participants_" << num_threads
+            << "_pull_threads";
+      webrtc::test::PrintResult("audio_conference_mixer_parallel_pull", "",
+                                trace.str(),
+                                static_cast<size_t>(elapsed_us / kNumTicks),
+                                "us", false);
+    }
+  }
+}
+
+}  // namespace webrtc
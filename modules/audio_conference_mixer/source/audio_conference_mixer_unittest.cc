@@ -0,0 +1,231 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer.h"
+#include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer_defines.h"
+#include "webrtc/modules/audio_conference_mixer/source/audio_frame_manipulator.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 16000;
+const int kSamplesPerChannel = kSampleRateHz / 100;
+
+// Produces a square wave of a fixed amplitude every 10 ms, with a bit of
+// noise that differs between calls.
+class FakeParticipant : public MixerParticipant {
+ public:
+  FakeParticipant(int id, int16_t amplitude)
+      : id_(id),
+        amplitude_(amplitude),
+        vad_(AudioFrame::kVadActive),
+        seed_(static_cast<uint32_t>(id)) {}
+
+  int32_t GetAudioFrame(const int32_t id, AudioFrame& audio_frame) override {
+    int16_t samples[kSamplesPerChannel];
+    for (int i = 0; i < kSamplesPerChannel; ++i) {
+      seed_ = seed_ * 1664525 + 1013904223;
+      samples[i] = static_cast<int16_t>(((i & 8) ? amplitude_ : -amplitude_) +
+                                        static_cast<int16_t>(seed_ >> 29));
+    }
+    audio_frame.UpdateFrame(id_, 0, samples, kSamplesPerChannel,
+                            kSampleRateHz, AudioFrame::kNormalSpeech, vad_, 1);
+    return 0;
+  }
+
+  int32_t NeededFrequency(const int32_t id) override { return kSampleRateHz; }
+
+  void set_vad(AudioFrame::VADActivity vad) { vad_ = vad; }
+
+  bool IsMixed() const {
+    bool mixed = false;
+    MixerParticipant::IsMixed(mixed);
+    return mixed;
+  }
+
+ private:
+  const int id_;
+  const int16_t amplitude_;
+  AudioFrame::VADActivity vad_;
+  uint32_t seed_;
+};
+
+// Keeps a copy of all mixed audio.
+class MixedAudioRecorder : public AudioMixerOutputReceiver {
+ public:
+  void NewMixedAudio(const int32_t id,
+                     const AudioFrame& general_audio_frame,
+                     const AudioFrame** unique_audio_frames,
+                     const uint32_t size) override {
+    const int16_t* data = general_audio_frame.data_;
+    samples_.insert(samples_.end(), data,
+                    data + general_audio_frame.samples_per_channel_ *
+                               general_audio_frame.num_channels_);
+  }
+
+  const std::vector<int16_t>& samples() const { return samples_; }
+
+ private:
+  std::vector<int16_t> samples_;
+};
+
+class MixedParticipantsCounter : public AudioMixerStatusReceiver {
+ public:
+  MixedParticipantsCounter() : mixed_(0) {}
+
+  void MixedParticipants(const int32_t id,
+                         const ParticipantStatistics* participant_statistics,
+                         const uint32_t size) override {
+    mixed_ = size;
+  }
+  void VADPositiveParticipants(
+      const int32_t id,
+      const ParticipantStatistics* participant_statistics,
+      const uint32_t size) override {}
+  void MixedAudioLevel(const int32_t id, const uint32_t level) override {}
+
+  uint32_t mixed() const { return mixed_; }
+
+ private:
+  uint32_t mixed_;
+};
+
+// Adds |num_participants| to |mixer|, where participant i has amplitude
+// |10 * (i + 1)|, shuffled so that the loudest are not registered last.
+void AddParticipants(AudioConferenceMixer* mixer,
+                     int num_participants,
+                     ScopedVector<FakeParticipant>* participants) {
+  for (int i = 0; i < num_participants; ++i) {
+    const int rank = (i * 7) % num_participants;
+    participants->push_back(
+        new FakeParticipant(rank, static_cast<int16_t>(10 * (rank + 1))));
+    ASSERT_EQ(0, mixer->SetMixabilityStatus(*participants->back(), true));
+  }
+}
+
+// Mixes |num_ticks| of |num_participants| with |num_threads| pull threads.
+void MixParticipants(int num_participants,
+                     size_t num_threads,
+                     int num_ticks,
+                     MixedAudioRecorder* recorder) {
+  rtc::scoped_ptr<AudioConferenceMixer> mixer(
+      AudioConferenceMixer::Create(0, 4));
+  EXPECT_TRUE(mixer.get() != NULL);
+  EXPECT_EQ(0, mixer->SetParallelPullThreads(num_threads));
+  EXPECT_EQ(0, mixer->RegisterMixedStreamCallback(*recorder));
+  ScopedVector<FakeParticipant> participants;
+  AddParticipants(mixer.get(), num_participants, &participants);
+  for (size_t i = 0; i < participants.size(); ++i) {
+    // Keep a few of them silent, to exercise the passive lists.
+    if (i % 5 == 0)
+      participants[i]->set_vad(AudioFrame::kVadPassive);
+  }
+
+  for (int i = 0; i < num_ticks; ++i)
+    EXPECT_EQ(0, mixer->Process());
+
+  for (size_t i = 0; i < participants.size(); ++i)
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(*participants[i], false));
+}
+
+}  // namespace
+
+TEST(AudioConferenceMixerTest, CreateRequiresParticipants) {
+  EXPECT_TRUE(AudioConferenceMixer::Create(0, 0) == NULL);
+}
+
+TEST(AudioConferenceMixerTest, MixesLoudestActiveParticipants) {
+  const size_t kMaxMixed = 5;
+  const int kNumParticipants = 23;
+  rtc::scoped_ptr<AudioConferenceMixer> mixer(
+      AudioConferenceMixer::Create(0, kMaxMixed));
+  ASSERT_TRUE(mixer.get() != NULL);
+  MixedParticipantsCounter counter;
+  ASSERT_EQ(0, mixer->RegisterMixerStatusCallback(counter, 1));
+  ScopedVector<FakeParticipant> participants;
+  AddParticipants(mixer.get(), kNumParticipants, &participants);
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(0, mixer->Process());
+    EXPECT_EQ(kMaxMixed, counter.mixed());
+    for (size_t j = 0; j < participants.size(); ++j) {
+      const int rank = (static_cast<int>(j) * 7) % kNumParticipants;
+      EXPECT_EQ(rank >= kNumParticipants - static_cast<int>(kMaxMixed),
+                participants[j]->IsMixed()) << "rank " << rank;
+    }
+  }
+
+  // Silenced participants are only mixed if there are too few active ones.
+  for (size_t j = 0; j < participants.size(); ++j)
+    participants[j]->set_vad(AudioFrame::kVadPassive);
+  participants[0]->set_vad(AudioFrame::kVadActive);
+  EXPECT_EQ(0, mixer->Process());
+  EXPECT_EQ(kMaxMixed, counter.mixed());
+  EXPECT_TRUE(participants[0]->IsMixed());
+
+  EXPECT_EQ(0, mixer->UnRegisterMixerStatusCallback());
+  for (size_t j = 0; j < participants.size(); ++j)
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(*participants[j], false));
+}
+
+TEST(AudioConferenceMixerTest, ParallelPullMixesSameAudio) {
+  const int kNumParticipants = 17;
+  const int kNumTicks = 20;
+  MixedAudioRecorder serial;
+  MixParticipants(kNumParticipants, 0, kNumTicks, &serial);
+  MixedAudioRecorder parallel;
+  MixParticipants(kNumParticipants, 3, kNumTicks, &parallel);
+  ASSERT_EQ(static_cast<size_t>(kNumTicks * kSamplesPerChannel),
+            serial.samples().size());
+  EXPECT_TRUE(serial.samples() == parallel.samples());
+}
+
+TEST(AudioConferenceMixerTest, SetParallelPullThreads) {
+  rtc::scoped_ptr<AudioConferenceMixer> mixer(AudioConferenceMixer::Create(0));
+  ASSERT_TRUE(mixer.get() != NULL);
+  EXPECT_EQ(0, mixer->SetParallelPullThreads(2));
+  EXPECT_EQ(0, mixer->SetParallelPullThreads(4));
+  EXPECT_EQ(0, mixer->SetParallelPullThreads(0));
+}
+
+TEST(AudioConferenceMixerTest, AddSamplesSaturates) {
+  const size_t kLength = 2 * kSamplesPerChannel + 5;
+  int16_t src[kLength];
+  int16_t dst[kLength];
+  int16_t expected[kLength];
+  for (size_t i = 0; i < kLength; ++i) {
+    src[i] = static_cast<int16_t>((i % 3 == 0 ? 30000 : -20000) + i);
+    dst[i] = static_cast<int16_t>((i % 2 == 0 ? 10000 : -15000) - i);
+    const int sum = src[i] + dst[i];
+    expected[i] = static_cast<int16_t>(
+        sum > 32767 ? 32767 : (sum < -32768 ? -32768 : sum));
+  }
+  int16_t result[kLength];
+  memcpy(result, dst, sizeof(dst));
+  AddSamples_C(src, kLength, result);
+  EXPECT_EQ(0, memcmp(expected, result, sizeof(result)));
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    memcpy(result, dst, sizeof(dst));
+    AddSamples_SSE2(src, kLength, result);
+    EXPECT_EQ(0, memcmp(expected, result, sizeof(result)));
+  }
+#endif
+}
+
+}  // namespace webrtc
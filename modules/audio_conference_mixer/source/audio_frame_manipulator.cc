@@ -74,4 +74,22 @@ void RampOut(AudioFrame& audioFrame)
            (audioFrame.samples_per_channel_ - rampSize) *
            sizeof(audioFrame.data_[0]));
 }
+
+void AddSamples_C(const int16_t* src, size_t length, int16_t* dst)
+{
+    for(size_t i = 0; i < length; i++)
+    {
+        const int32_t sum = static_cast<int32_t>(dst[i]) + src[i];
+        if(sum < -32768)
+        {
+            dst[i] = -32768;
+        } else if(sum > 32767)
+        {
+            dst[i] = 32767;
+        } else
+        {
+            dst[i] = static_cast<int16_t>(sum);
+        }
+    }
+}
 }  // namespace webrtc
@@ -11,6 +11,10 @@
 #ifndef WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_FRAME_MANIPULATOR_H_
 #define WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_FRAME_MANIPULATOR_H_
 
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
 namespace webrtc {
 class AudioFrame;
 
@@ -21,6 +25,15 @@ void CalculateEnergy(AudioFrame& audioFrame);
 void RampIn(AudioFrame& audioFrame);
 void RampOut(AudioFrame& audioFrame);
 
+// Adds |length| samples of |src| to |dst|, saturating to the int16_t range.
+// |src| and |dst| may be the same buffer.
+typedef void (*AddSamplesProc)(const int16_t* src, size_t length,
+                               int16_t* dst);
+void AddSamples_C(const int16_t* src, size_t length, int16_t* dst);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void AddSamples_SSE2(const int16_t* src, size_t length, int16_t* dst);
+#endif
+
 }  // namespace webrtc
 
 #endif // WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_FRAME_MANIPULATOR_H_
@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_conference_mixer/source/audio_frame_manipulator.h"
+
+#include <emmintrin.h>
+
+namespace webrtc {
+
+void AddSamples_SSE2(const int16_t* src, size_t length, int16_t* dst) {
+  size_t i = 0;
+  // 32 samples per iteration to hide the load latency.
+  for (; i + 32 <= length; i += 32) {
+    const __m128i* s = reinterpret_cast<const __m128i*>(&src[i]);
+    __m128i* d = reinterpret_cast<__m128i*>(&dst[i]);
+    __m128i d0 = _mm_adds_epi16(_mm_loadu_si128(d), _mm_loadu_si128(s));
+    __m128i d1 = _mm_adds_epi16(_mm_loadu_si128(d + 1),
+                                _mm_loadu_si128(s + 1));
+    __m128i d2 = _mm_adds_epi16(_mm_loadu_si128(d + 2),
+                                _mm_loadu_si128(s + 2));
+    __m128i d3 = _mm_adds_epi16(_mm_loadu_si128(d + 3),
+                                _mm_loadu_si128(s + 3));
+    _mm_storeu_si128(d, d0);
+    _mm_storeu_si128(d + 1, d1);
+    _mm_storeu_si128(d + 2, d2);
+    _mm_storeu_si128(d + 3, d3);
+  }
+  for (; i + 8 <= length; i += 8) {
+    const __m128i* s = reinterpret_cast<const __m128i*>(&src[i]);
+    __m128i* d = reinterpret_cast<__m128i*>(&dst[i]);
+    _mm_storeu_si128(d, _mm_adds_epi16(_mm_loadu_si128(d),
+                                       _mm_loadu_si128(s)));
+  }
+  AddSamples_C(&src[i], length - i, &dst[i]);
+}
+
+}  // namespace webrtc
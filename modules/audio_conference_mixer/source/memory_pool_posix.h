@@ -12,7 +12,7 @@
 #define WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_MEMORY_POOL_GENERIC_H_
 
 #include <assert.h>
-#include <list>
+#include <vector>
 
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/typedefs.h"
@@ -40,11 +40,22 @@ private:
 
     bool _terminate;
 
-    std::list<MemoryType*> _memoryPool;
+    // Used as a stack, so that the most recently returned memory is reused
+    // first.
+    std::vector<MemoryType*> _memoryPool;
 
     uint32_t _initialPoolSize;
     uint32_t _createdMemory;
     uint32_t _outstandingMemory;
+    // The highest _outstandingMemory in the previous window of
+    // kPeakDecayPeriod rounds, where a round ends whenever all memory has been
+    // returned. Memory is not reclaimed below this, so that a user that pops
+    // many items at once every iteration does not reallocate them every time,
+    // while a pool that once grew large still shrinks back.
+    enum { kPeakDecayPeriod = 100 };
+    uint32_t _peakOutstandingMemory;
+    uint32_t _windowPeakOutstandingMemory;
+    uint32_t _roundsInWindow;
 };
 
 template<class MemoryType>
@@ -53,7 +64,10 @@ MemoryPoolImpl<MemoryType>::MemoryPoolImpl(int32_t initialPoolSize)
       _terminate(false),
       _initialPoolSize(initialPoolSize),
       _createdMemory(0),
-      _outstandingMemory(0)
+      _outstandingMemory(0),
+      _peakOutstandingMemory(0),
+      _windowPeakOutstandingMemory(0),
+      _roundsInWindow(0)
 {
 }
 
@@ -84,9 +98,17 @@ int32_t MemoryPoolImpl<MemoryType>::PopMemory(MemoryType*& memory)
             return -1;
         }
     }
-    memory = _memoryPool.front();
-    _memoryPool.pop_front();
+    memory = _memoryPool.back();
+    _memoryPool.pop_back();
     _outstandingMemory++;
+    if(_outstandingMemory > _windowPeakOutstandingMemory)
+    {
+        _windowPeakOutstandingMemory = _outstandingMemory;
+    }
+    if(_outstandingMemory > _peakOutstandingMemory)
+    {
+        _peakOutstandingMemory = _outstandingMemory;
+    }
     return 0;
 }
 
@@ -99,7 +121,15 @@ int32_t MemoryPoolImpl<MemoryType>::PushMemory(MemoryType*& memory)
     }
     CriticalSectionScoped cs(_crit);
     _outstandingMemory--;
-    if(_memoryPool.size() > (_initialPoolSize << 1))
+    if(_outstandingMemory == 0 && ++_roundsInWindow >= kPeakDecayPeriod)
+    {
+        // Let the peak follow the usage of the last window.
+        _peakOutstandingMemory = _windowPeakOutstandingMemory;
+        _windowPeakOutstandingMemory = 0;
+        _roundsInWindow = 0;
+    }
+    if(_memoryPool.size() > (_initialPoolSize << 1) &&
+       _memoryPool.size() >= _peakOutstandingMemory)
     {
         // Reclaim memory if less than half of the pool is unused.
         _createdMemory--;
@@ -129,8 +159,8 @@ int32_t MemoryPoolImpl<MemoryType>::Terminate()
     // Reclaim all memory.
     while(_createdMemory > 0)
     {
-        MemoryType* memory = _memoryPool.front();
-        _memoryPool.pop_front();
+        MemoryType* memory = _memoryPool.back();
+        _memoryPool.pop_back();
         delete memory;
         _createdMemory--;
     }
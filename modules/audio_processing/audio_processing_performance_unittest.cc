@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common.h"
+#include "webrtc/common_audio/channel_buffer.h"
+#include "webrtc/modules/audio_processing/include/audio_processing.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+
+// Runs 48 kHz audio through the float interface with the usual components
+// enabled, and returns the time spent per 10 ms chunk.
+int ProcessStream48kHz(bool native) {
+  const int kSampleRateHz = AudioProcessing::kSampleRate48kHz;
+  const int kSamplesPerChannel = kSampleRateHz / 100;
+  const int kNumChunks = 1000;
+  Config config;
+  config.Set<AudioProcessing48kHzSupport>(
+      new AudioProcessing48kHzSupport(native));
+  rtc::scoped_ptr<AudioProcessing> apm(AudioProcessing::Create(config));
+  EXPECT_EQ(AudioProcessing::kNoError, apm->high_pass_filter()->Enable(true));
+  EXPECT_EQ(AudioProcessing::kNoError,
+            apm->echo_cancellation()->Enable(true));
+  EXPECT_EQ(AudioProcessing::kNoError,
+            apm->gain_control()->set_mode(GainControl::kAdaptiveDigital));
+  EXPECT_EQ(AudioProcessing::kNoError, apm->gain_control()->Enable(true));
+  EXPECT_EQ(AudioProcessing::kNoError,
+            apm->noise_suppression()->Enable(true));
+  EXPECT_EQ(AudioProcessing::kNoError, apm->voice_detection()->Enable(true));
+
+  ChannelBuffer<float> capture(kSamplesPerChannel, 1);
+  ChannelBuffer<float> render(kSamplesPerChannel, 1);
+  srand(1);
+  int64_t elapsed_us = 0;
+  for (int i = 0; i < kNumChunks; ++i) {
+    for (int j = 0; j < kSamplesPerChannel; ++j) {
+      capture.channels()[0][j] = (rand() % 2000 - 1000) / 32768.f;
+      render.channels()[0][j] = (rand() % 2000 - 1000) / 32768.f;
+    }
+    const int64_t start_us = TickTime::MicrosecondTimestamp();
+    EXPECT_EQ(AudioProcessing::kNoError,
+              apm->AnalyzeReverseStream(render.channels(), kSamplesPerChannel,
+                                        kSampleRateHz,
+                                        AudioProcessing::kMono));
+    EXPECT_EQ(AudioProcessing::kNoError, apm->set_stream_delay_ms(50));
+    EXPECT_EQ(AudioProcessing::kNoError,
+              apm->ProcessStream(capture.channels(), kSamplesPerChannel,
+                                 kSampleRateHz, AudioProcessing::kMono,
+                                 kSampleRateHz, AudioProcessing::kMono,
+                                 capture.channels()));
+    elapsed_us += TickTime::MicrosecondTimestamp() - start_us;
+  }
+  return static_cast<int>(elapsed_us / kNumChunks);
+}
+
+}  // namespace
+
+// Compares processing 48 kHz at 32 kHz with resampling, the default, with
+// processing it natively at 48 kHz.
+TEST(AudioProcessingPerformanceTest, ProcessStream48kHz) {
+  webrtc::test::PrintResult("audioproc_process_stream_48kHz", "",
+                            "resampled_to_32kHz", ProcessStream48kHz(false),
+                            "us", false);
+  webrtc::test::PrintResult("audioproc_process_stream_48kHz", "", "native",
+                            ProcessStream48kHz(true), "us", false);
+}
+
+}  // namespace webrtc
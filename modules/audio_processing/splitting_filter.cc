@@ -19,14 +19,10 @@ namespace webrtc {
 
 SplittingFilter::SplittingFilter(int channels)
     : channels_(channels),
-      two_bands_states_(new TwoBandsStates[channels]),
-      band1_states_(new TwoBandsStates[channels]),
-      band2_states_(new TwoBandsStates[channels]) {
+      two_bands_states_(new TwoBandsStates[channels]) {
   for (int i = 0; i < channels; ++i) {
-    analysis_resamplers_.push_back(new PushSincResampler(
-        kSamplesPer48kHzChannel, kSamplesPer64kHzChannel));
-    synthesis_resamplers_.push_back(new PushSincResampler(
-        kSamplesPer64kHzChannel, kSamplesPer48kHzChannel));
+    three_band_filter_banks_.push_back(
+        new ThreeBandFilterBank(kSamplesPer48kHzChannel));
   }
 }
 
@@ -82,82 +78,25 @@ void SplittingFilter::TwoBandsSynthesis(const IFChannelBuffer* bands,
   }
 }
 
-// This is a simple implementation using the existing code and will be replaced
-// by a proper 3 band filter bank.
-// It up-samples from 48kHz to 64kHz, splits twice into 2 bands and discards the
-// uppermost band, because it is empty anyway.
 void SplittingFilter::ThreeBandsAnalysis(const IFChannelBuffer* data,
                                          IFChannelBuffer* bands) {
   DCHECK_EQ(kSamplesPer48kHzChannel,
             data->num_frames());
-  InitBuffers();
   for (int i = 0; i < channels_; ++i) {
-    analysis_resamplers_[i]->Resample(data->ibuf_const()->channels()[i],
-                                      kSamplesPer48kHzChannel,
-                                      int_buffer_.get(),
-                                      kSamplesPer64kHzChannel);
-    WebRtcSpl_AnalysisQMF(int_buffer_.get(),
-                          kSamplesPer64kHzChannel,
-                          int_buffer_.get(),
-                          int_buffer_.get() + kSamplesPer32kHzChannel,
-                          two_bands_states_[i].analysis_state1,
-                          two_bands_states_[i].analysis_state2);
-    WebRtcSpl_AnalysisQMF(int_buffer_.get(),
-                          kSamplesPer32kHzChannel,
-                          bands->ibuf()->channels(0)[i],
-                          bands->ibuf()->channels(1)[i],
-                          band1_states_[i].analysis_state1,
-                          band1_states_[i].analysis_state2);
-    WebRtcSpl_AnalysisQMF(int_buffer_.get() + kSamplesPer32kHzChannel,
-                          kSamplesPer32kHzChannel,
-                          int_buffer_.get(),
-                          bands->ibuf()->channels(2)[i],
-                          band2_states_[i].analysis_state1,
-                          band2_states_[i].analysis_state2);
+    three_band_filter_banks_[i]->Analysis(data->fbuf_const()->channels()[i],
+                                          data->num_frames(),
+                                          bands->fbuf()->bands(i));
   }
 }
 
-// This is a simple implementation using the existing code and will be replaced
-// by a proper 3 band filter bank.
-// Using an empty uppermost band, it merges the 4 bands in 2 steps and
-// down-samples from 64kHz to 48kHz.
 void SplittingFilter::ThreeBandsSynthesis(const IFChannelBuffer* bands,
                                           IFChannelBuffer* data) {
   DCHECK_EQ(kSamplesPer48kHzChannel,
             data->num_frames());
-  InitBuffers();
   for (int i = 0; i < channels_; ++i) {
-    memset(int_buffer_.get(),
-           0,
-           kSamplesPer64kHzChannel * sizeof(int_buffer_[0]));
-    WebRtcSpl_SynthesisQMF(bands->ibuf_const()->channels(0)[i],
-                           bands->ibuf_const()->channels(1)[i],
-                           kSamplesPer16kHzChannel,
-                           int_buffer_.get(),
-                           band1_states_[i].synthesis_state1,
-                           band1_states_[i].synthesis_state2);
-    WebRtcSpl_SynthesisQMF(int_buffer_.get() + kSamplesPer32kHzChannel,
-                           bands->ibuf_const()->channels(2)[i],
-                           kSamplesPer16kHzChannel,
-                           int_buffer_.get() + kSamplesPer32kHzChannel,
-                           band2_states_[i].synthesis_state1,
-                           band2_states_[i].synthesis_state2);
-    WebRtcSpl_SynthesisQMF(int_buffer_.get(),
-                           int_buffer_.get() + kSamplesPer32kHzChannel,
-                           kSamplesPer32kHzChannel,
-                           int_buffer_.get(),
-                           two_bands_states_[i].synthesis_state1,
-                           two_bands_states_[i].synthesis_state2);
-    synthesis_resamplers_[i]->Resample(int_buffer_.get(),
-                                       kSamplesPer64kHzChannel,
-                                       data->ibuf()->channels()[i],
-                                       kSamplesPer48kHzChannel);
-  }
-}
-
-void SplittingFilter::InitBuffers() {
-  if (!int_buffer_) {
-    int_buffer_.reset(new int16_t[kSamplesPer64kHzChannel]);
+    three_band_filter_banks_[i]->Synthesis(bands->fbuf_const()->bands(i),
+                                           bands->num_frames_per_band(),
+                                           data->fbuf()->channels()[i]);
   }
 }
 
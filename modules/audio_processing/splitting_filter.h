@@ -14,7 +14,7 @@
 #include <string.h>
 
 #include "webrtc/base/scoped_ptr.h"
-#include "webrtc/common_audio/resampler/push_sinc_resampler.h"
+#include "webrtc/modules/audio_processing/three_band_filter_bank.h"
 #include "webrtc/system_wrappers/interface/scoped_vector.h"
 #include "webrtc/typedefs.h"
 
@@ -26,8 +26,7 @@ enum {
   kSamplesPer8kHzChannel = 80,
   kSamplesPer16kHzChannel = 160,
   kSamplesPer32kHzChannel = 320,
-  kSamplesPer48kHzChannel = 480,
-  kSamplesPer64kHzChannel = 640
+  kSamplesPer48kHzChannel = 480
 };
 
 struct TwoBandsStates {
@@ -66,15 +65,10 @@ class SplittingFilter {
   // These only work for 480 samples at the moment.
   void ThreeBandsAnalysis(const IFChannelBuffer* data, IFChannelBuffer* bands);
   void ThreeBandsSynthesis(const IFChannelBuffer* bands, IFChannelBuffer* data);
-  void InitBuffers();
 
   int channels_;
   rtc::scoped_ptr<TwoBandsStates[]> two_bands_states_;
-  rtc::scoped_ptr<TwoBandsStates[]> band1_states_;
-  rtc::scoped_ptr<TwoBandsStates[]> band2_states_;
-  ScopedVector<PushSincResampler> analysis_resamplers_;
-  ScopedVector<PushSincResampler> synthesis_resamplers_;
-  rtc::scoped_ptr<int16_t[]> int_buffer_;
+  ScopedVector<ThreeBandFilterBank> three_band_filter_banks_;
 };
 
 }  // namespace webrtc
@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_H_
+
+#include <vector>
+
+namespace webrtc {
+
+// An implementation of a 3-band FIR filter-bank with DCT modulation, similar to
+// the proposed in "Multirate Signal Processing for Communication Systems" by
+// Fredric J Harris.
+//
+// The low-pass prototype is a linear phase 48 tap FIR filter, split into 12
+// polyphase branches which run at the band rate. This filter bank does not
+// satisfy perfect reconstruction.
+class ThreeBandFilterBank {
+ public:
+  explicit ThreeBandFilterBank(int length);
+
+  // Splits |in| into 3 downsampled frequency bands in |out|.
+  // |length| is the |in| length. Each of the 3 bands of |out| has to have a
+  // length of |length| / 3.
+  void Analysis(const float* in, int length, float* const* out);
+
+  // Merges the 3 downsampled frequency bands in |in| into |out|.
+  // |split_length| is the length of each band of |in|. |out| has to have at
+  // least a length of 3 * |split_length|, and may overlap |in|.
+  void Synthesis(const float* const* in, int split_length, float* out);
+
+ private:
+  // One polyphase branch of the prototype filter. Its taps are spread
+  // |kSparsity| samples apart, starting at |offset|.
+  class SparseFilter {
+   public:
+    SparseFilter(const float* coefficients, int offset);
+
+    // Filters |length| samples of |in| into |out|, keeping the tail of |in| as
+    // history for the next call.
+    void Filter(const float* in, int length, float* out);
+
+   private:
+    const float* coefficients_;
+    int offset_;
+    // The last |history_.size()| input samples, oldest first.
+    std::vector<float> history_;
+  };
+
+  void DownModulate(const float* in,
+                    int split_length,
+                    int offset,
+                    float* const* out);
+  void UpModulate(const float* const* in,
+                  int split_length,
+                  int offset,
+                  float* out);
+
+  std::vector<float> in_buffer_;
+  std::vector<float> out_buffer_;
+  std::vector<float> synthesis_buffer_;
+  std::vector<SparseFilter> analysis_filters_;
+  std::vector<SparseFilter> synthesis_filters_;
+  std::vector<std::vector<float> > dct_modulation_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_H_
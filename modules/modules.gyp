@@ -57,6 +57,7 @@
             'acm_receive_test',
             'acm_send_test',
             'audio_coding_module',
+            'audio_conference_mixer',
             'audio_device'  ,
             'audio_processing',
             'bitrate_controller',
@@ -133,6 +134,7 @@
             'audio_coding/neteq/neteq_unittest.cc',
             'audio_coding/neteq/normal_unittest.cc',
             'audio_coding/neteq/packet_buffer_unittest.cc',
+            'audio_coding/neteq/packet_pool_unittest.cc',
             'audio_coding/neteq/payload_splitter_unittest.cc',
             'audio_coding/neteq/post_decode_vad_unittest.cc',
             'audio_coding/neteq/random_vector_unittest.cc',
@@ -153,6 +155,7 @@
             'audio_coding/neteq/mock/mock_payload_splitter.h',
             'audio_coding/neteq/tools/input_audio_file_unittest.cc',
             'audio_coding/neteq/tools/packet_unittest.cc',
+            'audio_conference_mixer/source/audio_conference_mixer_unittest.cc',
             'audio_processing/aec/echo_cancellation_unittest.cc',
             'audio_processing/aec/system_delay_unittest.cc',
             # TODO(ajm): Fix to match new interface.
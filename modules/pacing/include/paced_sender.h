@@ -28,6 +28,7 @@ namespace paced_sender {
 class IntervalBudget;
 struct Packet;
 class PacketQueue;
+class ProducerQueue;
 }  // namespace paced_sender
 
 class PacedSender : public Module {
@@ -103,6 +104,8 @@ class PacedSender : public Module {
 
   // Returns true if we send the packet now, else it will add the packet
   // information to the queue and call TimeToSendPacket when it's time to send.
+  // Does not take the pacer lock unless the calling thread's hand-off queue
+  // is full, so it does not block on a concurrent Process().
   virtual bool SendPacket(Priority priority,
                           uint32_t ssrc,
                           uint16_t sequence_number,
@@ -133,13 +136,23 @@ class PacedSender : public Module {
 
   bool SendPacket(const paced_sender::Packet& packet)
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+
+  // Returns the hand-off queue of the calling thread, registering one if
+  // needed. Returns NULL if all kMaxProducers queues are taken.
+  paced_sender::ProducerQueue* ProducerQueueForCurrentThread();
+
+  // Moves packets handed off by SendPacket() into |packets_|.
+  void DrainProducerQueues() EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  void EnqueuePacket(paced_sender::Packet* packet)
+      EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   void SendPadding(size_t padding_needed) EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
   Clock* const clock_;
   Callback* const callback_;
 
   rtc::scoped_ptr<CriticalSectionWrapper> critsect_;
-  bool enabled_ GUARDED_BY(critsect_);
+  // Written under |critsect_|, but read by SendPacket() without it.
+  volatile int enabled_;
   bool paused_ GUARDED_BY(critsect_);
   bool probing_enabled_;
   // This is the media budget, keeping track of how many bits of media
@@ -159,6 +172,14 @@ class PacedSender : public Module {
 
   rtc::scoped_ptr<paced_sender::PacketQueue> packets_ GUARDED_BY(critsect_);
   uint64_t packet_counter_;
+
+  // Lock-free single-producer queues through which SendPacket() hands
+  // packets to the lock holder, one per calling thread. They are registered
+  // under |critsect_| and kept until destruction; threads beyond
+  // kMaxProducers fall back to taking the lock.
+  static const int kMaxProducers = 8;
+  paced_sender::ProducerQueue* producers_[kMaxProducers];
+  volatile int num_producers_;
 };
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_PACING_INCLUDE_PACED_SENDER_H_
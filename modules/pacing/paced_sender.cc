@@ -12,10 +12,11 @@
 
 #include <assert.h>
 
-#include <map>
-#include <queue>
-#include <set>
+#include <algorithm>
+#include <vector>
 
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/thread_checker_impl.h"
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/modules/pacing/bitrate_prober.h"
 #include "webrtc/system_wrappers/interface/clock.h"
@@ -36,6 +37,7 @@ const int64_t kMaxIntervalTimeMs = 30;
 namespace webrtc {
 namespace paced_sender {
 struct Packet {
+  Packet() {}
   Packet(PacedSender::Priority priority,
          uint32_t ssrc,
          uint16_t seq_number,
@@ -51,7 +53,8 @@ struct Packet {
         enqueue_time_ms(enqueue_time_ms),
         bytes(length_in_bytes),
         retransmission(retransmission),
-        enqueue_order(enqueue_order) {}
+        enqueue_order(enqueue_order),
+        index(-1) {}
 
   PacedSender::Priority priority;
   uint32_t ssrc;
@@ -61,7 +64,7 @@ struct Packet {
   size_t bytes;
   bool retransmission;
   uint64_t enqueue_order;
-  std::list<Packet>::iterator this_it;
+  int index;  // Slot holding the packet in the PacketQueue.
 };
 
 // Used by priority queue to sort packets.
@@ -84,87 +87,262 @@ struct Comparator {
 };
 
 // Class encapsulating a priority queue with some extensions.
+//
+// Packets are stored in a flat array of slots which is only grown, never
+// shrunk, so a queue in steady state does not allocate. The priority queue is
+// a binary heap of slot indices, and the slots are also linked together in
+// enqueue order to find the oldest packet.
 class PacketQueue {
  public:
-  PacketQueue() : bytes_(0) {}
+  PacketQueue()
+      : slots_(kInitialCapacity),
+        free_head_(kNone),
+        oldest_(kNone),
+        newest_(kNone),
+        bytes_(0) {
+    heap_.reserve(kInitialCapacity);
+    AddFreeSlots(0);
+  }
   virtual ~PacketQueue() {}
 
   void Push(const Packet& packet) {
     if (!AddToDupeSet(packet)) {
       return;
     }
-    // Store packet in list, use pointers in priority queue for cheaper moves.
-    // Packets have a handle to its own iterator in the list, for easy removal
-    // when popping from queue.
-    packet_list_.push_front(packet);
-    std::list<Packet>::iterator it = packet_list_.begin();
-    it->this_it = it;          // Handle for direct removal from list.
-    prio_queue_.push(&(*it));  // Pointer into list.
+    int index = AllocateSlot();
+    Slot& slot = slots_[index];
+    slot.packet = packet;
+    slot.packet.index = index;
+    // Link in as the newest packet.
+    slot.prev = newest_;
+    slot.next = kNone;
+    if (newest_ != kNone)
+      slots_[newest_].next = index;
+    else
+      oldest_ = index;
+    newest_ = index;
+
+    heap_.push_back(index);
+    std::push_heap(heap_.begin(), heap_.end(), SlotComparator(&slots_));
     bytes_ += packet.bytes;
   }
 
-  const Packet& BeginPop() {
-    const Packet& packet = *prio_queue_.top();
-    prio_queue_.pop();
-    return packet;
+  // Returns a copy, since the slot storage may be reallocated by a Push()
+  // while the packet is being sent.
+  Packet BeginPop() {
+    std::pop_heap(heap_.begin(), heap_.end(), SlotComparator(&slots_));
+    int index = heap_.back();
+    heap_.pop_back();
+    return slots_[index].packet;
   }
 
-  void CancelPop(const Packet& packet) { prio_queue_.push(&(*packet.this_it)); }
+  void CancelPop(const Packet& packet) {
+    heap_.push_back(packet.index);
+    std::push_heap(heap_.begin(), heap_.end(), SlotComparator(&slots_));
+  }
 
   void FinalizePop(const Packet& packet) {
     RemoveFromDupeSet(packet);
     bytes_ -= packet.bytes;
-    packet_list_.erase(packet.this_it);
+    int index = packet.index;
+    Slot& slot = slots_[index];
+    if (slot.prev != kNone)
+      slots_[slot.prev].next = slot.next;
+    else
+      oldest_ = slot.next;
+    if (slot.next != kNone)
+      slots_[slot.next].prev = slot.prev;
+    else
+      newest_ = slot.prev;
+    slot.next = free_head_;
+    free_head_ = index;
   }
 
-  bool Empty() const { return prio_queue_.empty(); }
+  bool Empty() const { return heap_.empty(); }
 
-  size_t SizeInPackets() const { return prio_queue_.size(); }
+  size_t SizeInPackets() const { return heap_.size(); }
 
   uint64_t SizeInBytes() const { return bytes_; }
 
   int64_t OldestEnqueueTime() const {
-    std::list<Packet>::const_reverse_iterator it = packet_list_.rbegin();
-    if (it == packet_list_.rend())
+    if (oldest_ == kNone)
       return 0;
-    return it->enqueue_time_ms;
+    return slots_[oldest_].packet.enqueue_time_ms;
   }
 
  private:
+  static const int kInitialCapacity = 256;
+  static const int kNone = -1;
+  static const size_t kSeqNumBitmapWords = (1 << 16) / 32;
+
+  struct Slot {
+    Packet packet;
+    // Neighbours in enqueue order. |next| links the free list for free slots.
+    int prev;
+    int next;
+  };
+
+  // Orders slot indices by the packets they hold, as Comparator does.
+  class SlotComparator {
+   public:
+    explicit SlotComparator(const std::vector<Slot>* slots) : slots_(slots) {}
+    bool operator()(int first, int second) const {
+      return Comparator()(&(*slots_)[first].packet, &(*slots_)[second].packet);
+    }
+
+   private:
+    const std::vector<Slot>* slots_;
+  };
+
+  // Sequence numbers currently in the queue for one SSRC, one bit each.
+  struct SeqNumSet {
+    uint32_t ssrc;
+    size_t size;
+    std::vector<uint32_t> bits;
+  };
+
+  // Adds the slots from |first| to the end of |slots_| to the free list.
+  void AddFreeSlots(int first) {
+    for (int i = static_cast<int>(slots_.size()) - 1; i >= first; --i) {
+      slots_[i].next = free_head_;
+      free_head_ = i;
+    }
+  }
+
+  int AllocateSlot() {
+    if (free_head_ == kNone) {
+      int size = static_cast<int>(slots_.size());
+      slots_.resize(2 * size);
+      heap_.reserve(slots_.size());
+      AddFreeSlots(size);
+    }
+    int index = free_head_;
+    free_head_ = slots_[index].next;
+    return index;
+  }
+
+  // Returns the sequence number set for |ssrc|, or NULL if there is none.
+  SeqNumSet* FindSeqNumSet(uint32_t ssrc) {
+    for (size_t i = 0; i < seq_num_sets_.size(); ++i) {
+      if (seq_num_sets_[i].ssrc == ssrc)
+        return &seq_num_sets_[i];
+    }
+    return NULL;
+  }
+
   // Try to add a packet to the set of ssrc/seqno identifiers currently in the
   // queue. Return true if inserted, false if this is a duplicate.
   bool AddToDupeSet(const Packet& packet) {
-    SsrcSeqNoMap::iterator it = dupe_map_.find(packet.ssrc);
-    if (it == dupe_map_.end()) {
-      // First for this ssrc, just insert.
-      dupe_map_[packet.ssrc].insert(packet.sequence_number);
-      return true;
+    SeqNumSet* set = FindSeqNumSet(packet.ssrc);
+    if (set == NULL) {
+      // Reuse the bitmap of an SSRC which has no packets queued, if any.
+      for (size_t i = 0; i < seq_num_sets_.size() && set == NULL; ++i) {
+        if (seq_num_sets_[i].size == 0)
+          set = &seq_num_sets_[i];
+      }
+      if (set == NULL) {
+        seq_num_sets_.push_back(SeqNumSet());
+        set = &seq_num_sets_.back();
+        set->size = 0;
+        set->bits.resize(kSeqNumBitmapWords, 0);
+      }
+      set->ssrc = packet.ssrc;
     }
-
-    // Insert returns a pair, where second is a bool set to true if new element.
-    return it->second.insert(packet.sequence_number).second;
+    uint32_t& word = set->bits[packet.sequence_number >> 5];
+    const uint32_t mask = 1u << (packet.sequence_number & 31);
+    if (word & mask)
+      return false;
+    word |= mask;
+    ++set->size;
+    return true;
   }
 
   void RemoveFromDupeSet(const Packet& packet) {
-    SsrcSeqNoMap::iterator it = dupe_map_.find(packet.ssrc);
-    assert(it != dupe_map_.end());
-    it->second.erase(packet.sequence_number);
-    if (it->second.empty()) {
-      dupe_map_.erase(it);
-    }
+    SeqNumSet* set = FindSeqNumSet(packet.ssrc);
+    assert(set != NULL);
+    assert(set->size > 0);
+    set->bits[packet.sequence_number >> 5] &=
+        ~(1u << (packet.sequence_number & 31));
+    --set->size;
   }
 
-  // List of packets, in the order the were enqueued. Since dequeueing may
-  // occur out of order, use list instead of vector.
-  std::list<Packet> packet_list_;
+  std::vector<Slot> slots_;
+  int free_head_;
+  // Oldest and newest enqueued packets.
+  int oldest_;
+  int newest_;
   // Priority queue of the packets, sorted according to Comparator.
-  // Use pointers into list, to avoid moving whole struct within heap.
-  std::priority_queue<Packet*, std::vector<Packet*>, Comparator> prio_queue_;
+  std::vector<int> heap_;
   // Total number of bytes in the queue.
   uint64_t bytes_;
-  // Map<ssrc, set<seq_no> >, for checking duplicates.
-  typedef std::map<uint32_t, std::set<uint16_t> > SsrcSeqNoMap;
-  SsrcSeqNoMap dupe_map_;
+  // For checking duplicates. Sets are kept for reuse once empty.
+  std::vector<SeqNumSet> seq_num_sets_;
+};
+
+// Single-producer, single-consumer ring through which one thread hands packets
+// over without taking the pacer lock. The consumer side is only used with the
+// pacer lock held, so there is one consumer at a time.
+class ProducerQueue {
+ public:
+  explicit ProducerQueue(rtc::PlatformThreadRef thread)
+      : thread_(thread),
+        write_index_(0),
+        read_index_(0),
+        cached_read_index_(0),
+        pop_index_(0),
+        cached_write_index_(0) {}
+
+  bool IsOwnedByCurrentThread() const {
+    return rtc::IsThreadRefEqual(thread_, rtc::CurrentThreadRef());
+  }
+
+  // Producer side. Returns false if the queue is full.
+  bool Push(const Packet& packet) {
+    const int write_index = write_index_;
+    const int next_index = (write_index + 1) & (kCapacity - 1);
+    if (next_index == cached_read_index_) {
+      cached_read_index_ = rtc::AtomicOps::Load(&read_index_);
+      if (next_index == cached_read_index_)
+        return false;
+    }
+    packets_[write_index] = packet;
+    // Publishes the packet; Store() has a barrier before the write.
+    rtc::AtomicOps::Store(&write_index_, next_index);
+    return true;
+  }
+
+  // Consumer side. Returns false if the queue is empty. The slots of popped
+  // packets are not handed back to the producer until CommitPops().
+  bool Pop(Packet* packet) {
+    if (pop_index_ == cached_write_index_) {
+      cached_write_index_ = rtc::AtomicOps::Load(&write_index_);
+      if (pop_index_ == cached_write_index_)
+        return false;
+    }
+    *packet = packets_[pop_index_];
+    pop_index_ = (pop_index_ + 1) & (kCapacity - 1);
+    return true;
+  }
+
+  void CommitPops() {
+    if (read_index_ != pop_index_)
+      rtc::AtomicOps::Store(&read_index_, pop_index_);
+  }
+
+ private:
+  // Must be a power of two. One slot is left unused to tell full from empty.
+  static const int kCapacity = 512;
+
+  const rtc::PlatformThreadRef thread_;
+  volatile int write_index_;  // Only written by the producer.
+  volatile int read_index_;   // Only written by the consumer.
+  // Producer-only copy of |read_index_|, refreshed when the queue looks full.
+  int cached_read_index_;
+  // Consumer-only state: the next slot to pop, and a copy of |write_index_|
+  // refreshed when the queue looks empty.
+  int pop_index_;
+  int cached_write_index_;
+  Packet packets_[kCapacity];
 };
 
 class IntervalBudget {
@@ -222,11 +400,15 @@ PacedSender::PacedSender(Clock* clock,
       bitrate_bps_(1000 * bitrate_kbps),
       time_last_update_us_(clock->TimeInMicroseconds()),
       packets_(new paced_sender::PacketQueue()),
-      packet_counter_(0) {
+      packet_counter_(0),
+      num_producers_(0) {
   UpdateBytesPerInterval(kMinPacketLimitMs);
 }
 
-PacedSender::~PacedSender() {}
+PacedSender::~PacedSender() {
+  for (int i = 0; i < num_producers_; ++i)
+    delete producers_[i];
+}
 
 void PacedSender::Pause() {
   CriticalSectionScoped cs(critsect_.get());
@@ -245,12 +427,12 @@ void PacedSender::SetProbingEnabled(bool enabled) {
 
 void PacedSender::SetStatus(bool enable) {
   CriticalSectionScoped cs(critsect_.get());
-  enabled_ = enable;
+  rtc::AtomicOps::Store(&enabled_, enable);
 }
 
 bool PacedSender::Enabled() const {
   CriticalSectionScoped cs(critsect_.get());
-  return enabled_;
+  return enabled_ != 0;
 }
 
 void PacedSender::UpdateBitrate(int bitrate_kbps,
@@ -265,28 +447,71 @@ void PacedSender::UpdateBitrate(int bitrate_kbps,
 bool PacedSender::SendPacket(Priority priority, uint32_t ssrc,
     uint16_t sequence_number, int64_t capture_time_ms, size_t bytes,
     bool retransmission) {
+  if (!rtc::AtomicOps::Load(&enabled_)) {
+    return true;  // We can send now.
+  }
+
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  if (capture_time_ms < 0) {
+    capture_time_ms = now_ms;
+  }
+
+  // The enqueue order is assigned when the packet reaches |packets_|.
+  paced_sender::Packet packet(priority, ssrc, sequence_number,
+                              capture_time_ms, now_ms, bytes, retransmission,
+                              0);
+  paced_sender::ProducerQueue* producer = ProducerQueueForCurrentThread();
+  if (producer && producer->Push(packet))
+    return false;
+
+  // No hand-off queue, or it is full; queue the packet directly, after the
+  // ones already handed off.
   CriticalSectionScoped cs(critsect_.get());
+  DrainProducerQueues();
+  EnqueuePacket(&packet);
+  return false;
+}
 
-  if (!enabled_) {
-    return true;  // We can send now.
+paced_sender::ProducerQueue* PacedSender::ProducerQueueForCurrentThread() {
+  int num_producers = rtc::AtomicOps::Load(&num_producers_);
+  for (int i = 0; i < num_producers; ++i) {
+    if (producers_[i]->IsOwnedByCurrentThread())
+      return producers_[i];
+  }
+  // Only the calling thread can register a queue for itself, so nobody can
+  // have added it since the search above.
+  CriticalSectionScoped cs(critsect_.get());
+  num_producers = num_producers_;
+  if (num_producers == kMaxProducers)
+    return NULL;
+  producers_[num_producers] =
+      new paced_sender::ProducerQueue(rtc::CurrentThreadRef());
+  rtc::AtomicOps::Store(&num_producers_, num_producers + 1);
+  return producers_[num_producers];
+}
+
+void PacedSender::DrainProducerQueues() {
+  paced_sender::Packet packet;
+  for (int i = 0; i < num_producers_; ++i) {
+    while (producers_[i]->Pop(&packet))
+      EnqueuePacket(&packet);
+    producers_[i]->CommitPops();
   }
+}
+
+void PacedSender::EnqueuePacket(paced_sender::Packet* packet) {
   if (probing_enabled_ && !prober_->IsProbing()) {
     prober_->SetEnabled(true);
   }
   prober_->MaybeInitializeProbe(bitrate_bps_);
 
-  if (capture_time_ms < 0) {
-    capture_time_ms = clock_->TimeInMilliseconds();
-  }
-
-  packets_->Push(paced_sender::Packet(
-      priority, ssrc, sequence_number, capture_time_ms,
-      clock_->TimeInMilliseconds(), bytes, retransmission, packet_counter_++));
-  return false;
+  packet->enqueue_order = packet_counter_++;
+  packets_->Push(*packet);
 }
 
 int64_t PacedSender::ExpectedQueueTimeMs() const {
   CriticalSectionScoped cs(critsect_.get());
+  const_cast<PacedSender*>(this)->DrainProducerQueues();
   int target_rate = media_budget_->target_rate_kbps();
   assert(target_rate > 0);
   return static_cast<int64_t>(packets_->SizeInBytes() * 8 / target_rate);
@@ -294,11 +519,13 @@ int64_t PacedSender::ExpectedQueueTimeMs() const {
 
 size_t PacedSender::QueueSizePackets() const {
   CriticalSectionScoped cs(critsect_.get());
+  const_cast<PacedSender*>(this)->DrainProducerQueues();
   return packets_->SizeInPackets();
 }
 
 int64_t PacedSender::QueueInMs() const {
   CriticalSectionScoped cs(critsect_.get());
+  const_cast<PacedSender*>(this)->DrainProducerQueues();
 
   int64_t oldest_packet = packets_->OldestEnqueueTime();
   if (oldest_packet == 0)
@@ -309,6 +536,7 @@ int64_t PacedSender::QueueInMs() const {
 
 int64_t PacedSender::TimeUntilNextProcess() {
   CriticalSectionScoped cs(critsect_.get());
+  DrainProducerQueues();
   if (prober_->IsProbing()) {
     int64_t ret = prober_->TimeUntilNextProbe(clock_->TimeInMilliseconds());
     if (ret >= 0) {
@@ -323,6 +551,7 @@ int64_t PacedSender::TimeUntilNextProcess() {
 int32_t PacedSender::Process() {
   int64_t now_us = clock_->TimeInMicroseconds();
   CriticalSectionScoped cs(critsect_.get());
+  DrainProducerQueues();
   int64_t elapsed_time_ms = (now_us - time_last_update_us_ + 500) / 1000;
   time_last_update_us_ = now_us;
   if (!enabled_) {
@@ -341,10 +570,12 @@ int32_t PacedSender::Process() {
       // Since we need to release the lock in order to send, we first pop the
       // element from the priority queue but keep it in storage, so that we can
       // reinsert it if send fails.
-      const paced_sender::Packet& packet = packets_->BeginPop();
+      const paced_sender::Packet packet = packets_->BeginPop();
       if (SendPacket(packet)) {
-        // Send succeeded, remove it from the queue.
+        // Send succeeded, remove it from the queue. Also pick up packets
+        // handed off while the lock was released.
         packets_->FinalizePop(packet);
+        DrainProducerQueues();
         if (prober_->IsProbing()) {
           return 0;
         }
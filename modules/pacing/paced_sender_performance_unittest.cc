@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/pacing/include/paced_sender.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+// Sends every packet right away and no padding.
+class PacedSenderNullCallback : public PacedSender::Callback {
+ public:
+  bool TimeToSendPacket(uint32_t ssrc,
+                        uint16_t sequence_number,
+                        int64_t capture_time_ms,
+                        bool retransmission) override {
+    return true;
+  }
+  size_t TimeToSendPadding(size_t bytes) override { return 0; }
+};
+
+bool RunProcess(void* obj) {
+  static_cast<PacedSender*>(obj)->Process();
+  return true;
+}
+
+}  // namespace
+
+// Measures the cost of queueing and pacing out 10k packets/s spread over 50
+// SSRCs, with one audio stream at high priority and some retransmissions.
+TEST(PacedSenderPerformanceTest, InsertAndProcess) {
+  const int kNumSsrcs = 50;
+  const int kPacketsPerMs = 10;
+  const int kDurationMs = 10000;
+  const size_t kPacketSize = 100;
+  const uint32_t kFirstSsrc = 1000;
+  const int kRetransmissionInterval = 97;
+
+  SimulatedClock clock(123456);
+  PacedSenderNullCallback callback;
+  // 10k packets/s of 100 bytes is 8 Mbps.
+  PacedSender sender(&clock, &callback, 8000, 12000, 0);
+  sender.SetProbingEnabled(false);
+  uint16_t sequence_numbers[kNumSsrcs] = {0};
+
+  int num_packets = 0;
+  int64_t start_us = TickTime::MicrosecondTimestamp();
+  for (int ms = 0; ms < kDurationMs; ++ms) {
+    for (int i = 0; i < kPacketsPerMs; ++i, ++num_packets) {
+      int stream = num_packets % kNumSsrcs;
+      bool retransmission = num_packets % kRetransmissionInterval == 0;
+      int64_t capture_time_ms = clock.TimeInMilliseconds();
+      if (retransmission)
+        capture_time_ms -= 100;
+      sender.SendPacket(
+          stream == 0 ? PacedSender::kHighPriority
+                      : PacedSender::kNormalPriority,
+          kFirstSsrc + stream, sequence_numbers[stream]++, capture_time_ms,
+          kPacketSize, retransmission);
+    }
+    clock.AdvanceTimeMilliseconds(1);
+    if (sender.TimeUntilNextProcess() <= 0)
+      sender.Process();
+  }
+  int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+  EXPECT_LT(sender.QueueSizePackets(), static_cast<size_t>(kNumSsrcs));
+  webrtc::test::PrintResult("paced_sender_insert_and_process", "",
+                            "10k_packets_per_second",
+                            static_cast<size_t>(1000 * elapsed_us /
+                                                num_packets),
+                            "ns", false);
+}
+
+// Measures how long SendPacket() takes on the calling thread while another
+// thread keeps calling Process(), as an encoder thread would see it.
+TEST(PacedSenderPerformanceTest, SendPacketLatency) {
+  const int kNumSsrcs = 50;
+  const int kNumPackets = 200000;
+  const size_t kPacketSize = 100;
+  const uint32_t kFirstSsrc = 1000;
+  const int64_t kSlowCallUs = 100;
+
+  PacedSenderNullCallback callback;
+  PacedSender sender(Clock::GetRealTimeClock(), &callback, 100000, 150000, 0);
+  sender.SetProbingEnabled(false);
+  rtc::scoped_ptr<ThreadWrapper> process_thread =
+      ThreadWrapper::CreateThread(&RunProcess, &sender, "PacerProcess");
+  ASSERT_TRUE(process_thread->Start());
+
+  uint16_t sequence_numbers[kNumSsrcs] = {0};
+  int64_t total_us = 0;
+  int64_t max_us = 0;
+  size_t num_slow_calls = 0;
+  for (int i = 0; i < kNumPackets; ++i) {
+    int stream = i % kNumSsrcs;
+    int64_t start_us = TickTime::MicrosecondTimestamp();
+    sender.SendPacket(PacedSender::kNormalPriority, kFirstSsrc + stream,
+                      sequence_numbers[stream]++, -1, kPacketSize, false);
+    int64_t call_us = TickTime::MicrosecondTimestamp() - start_us;
+    total_us += call_us;
+    max_us = std::max(max_us, call_us);
+    if (call_us > kSlowCallUs)
+      ++num_slow_calls;
+  }
+  EXPECT_TRUE(process_thread->Stop());
+
+  webrtc::test::PrintResult("paced_sender_send_packet", "_mean", "contended",
+                            static_cast<size_t>(1000 * total_us / kNumPackets),
+                            "ns", false);
+  webrtc::test::PrintResult("paced_sender_send_packet", "_max", "contended",
+                            static_cast<size_t>(max_us), "us", false);
+  webrtc::test::PrintResult("paced_sender_send_packet", "_over_100us",
+                            "contended", num_slow_calls, "calls", false);
+}
+
+}  // namespace webrtc
@@ -14,6 +14,7 @@
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/pacing/include/paced_sender.h"
 #include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
 
 using testing::_;
 using testing::Return;
@@ -814,5 +815,58 @@ TEST_F(PacedSenderTest, PaddingOveruse) {
   send_bucket_->Process();
 }
 
+class PacedSenderCounting : public PacedSender::Callback {
+ public:
+  PacedSenderCounting() : packets_sent_(0) {}
+
+  bool TimeToSendPacket(uint32_t ssrc,
+                        uint16_t sequence_number,
+                        int64_t capture_time_ms,
+                        bool retransmission) override {
+    ++packets_sent_;
+    return true;
+  }
+
+  size_t TimeToSendPadding(size_t bytes) override { return 0; }
+
+  int packets_sent() const { return packets_sent_; }
+
+ private:
+  int packets_sent_;
+};
+
+static bool RunProcess(void* obj) {
+  static_cast<PacedSender*>(obj)->Process();
+  return true;
+}
+
+// Inserts packets from one thread while another thread keeps calling
+// Process(), as an encoder thread and the process thread do, and checks that
+// no packet is lost on the way.
+TEST(PacedSenderContentionTest, SendPacketWhileProcessing) {
+  const int kNumSsrcs = 50;
+  const int kNumPackets = 20000;
+  const size_t kPacketSize = 100;
+  const uint32_t kFirstSsrc = 1000;
+
+  PacedSenderCounting callback;
+  PacedSender sender(Clock::GetRealTimeClock(), &callback, 100000, 150000, 0);
+  sender.SetProbingEnabled(false);
+  rtc::scoped_ptr<ThreadWrapper> process_thread =
+      ThreadWrapper::CreateThread(&RunProcess, &sender, "PacerProcess");
+  ASSERT_TRUE(process_thread->Start());
+
+  uint16_t sequence_numbers[kNumSsrcs] = {0};
+  for (int i = 0; i < kNumPackets; ++i) {
+    int stream = i % kNumSsrcs;
+    sender.SendPacket(PacedSender::kNormalPriority, kFirstSsrc + stream,
+                      sequence_numbers[stream]++, -1, kPacketSize, false);
+  }
+  EXPECT_TRUE(process_thread->Stop());
+  // Every packet is either sent or still queued.
+  EXPECT_EQ(static_cast<size_t>(kNumPackets),
+            callback.packets_sent() + sender.QueueSizePackets());
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -85,8 +85,7 @@ int32_t FecReceiverImpl::AddReceivedRedPacket(
   // we remove the RED header
 
   ForwardErrorCorrection::ReceivedPacket* received_packet =
-      new ForwardErrorCorrection::ReceivedPacket;
-  received_packet->pkt = new ForwardErrorCorrection::Packet;
+      fec_->NewReceivedPacket();
 
   // get payload type from RED header
   uint8_t payload_type =
@@ -154,8 +153,7 @@ int32_t FecReceiverImpl::AddReceivedRedPacket(
 
     received_packet->pkt->length = blockLength;
 
-    second_received_packet = new ForwardErrorCorrection::ReceivedPacket;
-    second_received_packet->pkt = new ForwardErrorCorrection::Packet;
+    second_received_packet = fec_->NewReceivedPacket();
 
     second_received_packet->is_fec = true;
     second_received_packet->seq_num = header.sequenceNumber;
@@ -15,11 +15,11 @@
 #include <string.h>
 
 #include <algorithm>
-#include <iterator>
 
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction_internal.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
 
 namespace webrtc {
@@ -40,13 +40,70 @@ enum {
   kMaxFecPackets = ForwardErrorCorrection::kMaxMediaPackets
 };
 
+// Free list of packet storage for the decoder. A packet taken from the pool
+// returns itself on its last Release(). Since recovered packets may still be
+// referenced after the ForwardErrorCorrection is gone, the pool is detached
+// rather than deleted by its owner, and deletes itself once all its packets
+// have come back.
+class ForwardErrorCorrection::PacketPool {
+ public:
+  PacketPool() : num_outstanding_(0), detached_(false) {}
+
+  Packet* Get() {
+    Packet* packet;
+    if (free_.empty()) {
+      packet = new Packet;
+      packet->pool_ = this;
+    } else {
+      packet = free_.back();
+      free_.pop_back();
+    }
+    packet->length = 0;
+    ++num_outstanding_;
+    return packet;
+  }
+
+  void Return(Packet* packet) {
+    assert(packet->pool_ == this);
+    assert(num_outstanding_ > 0);
+    --num_outstanding_;
+    if (detached_) {
+      delete packet;
+      if (num_outstanding_ == 0)
+        delete this;
+      return;
+    }
+    free_.push_back(packet);
+  }
+
+  void Detach() {
+    detached_ = true;
+    for (size_t i = 0; i < free_.size(); ++i)
+      delete free_[i];
+    free_.clear();
+    if (num_outstanding_ == 0)
+      delete this;
+  }
+
+ private:
+  ~PacketPool() {}
+
+  std::vector<Packet*> free_;
+  size_t num_outstanding_;
+  bool detached_;
+};
+
 int32_t ForwardErrorCorrection::Packet::AddRef() { return ++ref_count_; }
 
 int32_t ForwardErrorCorrection::Packet::Release() {
   int32_t ref_count;
   ref_count = --ref_count_;
-  if (ref_count == 0)
-    delete this;
+  if (ref_count == 0) {
+    if (pool_)
+      pool_->Return(this);
+    else
+      delete this;
+  }
   return ref_count;
 }
 
@@ -84,9 +141,61 @@ ForwardErrorCorrection::RecoveredPacket::~RecoveredPacket() {}
 
 ForwardErrorCorrection::ForwardErrorCorrection()
     : generated_fec_packets_(kMaxMediaPackets),
-      fec_packet_received_(false) {}
+      fec_packet_received_(false),
+      xor_bytes_(internal::XorBytes_C),
+      packet_pool_(new PacketPool()),
+      received_packets_(kMaxMediaPackets),
+      recovered_packets_(kMaxMediaPackets),
+      fec_packets_(kMaxFecPackets),
+      protected_packets_(kMaxFecPackets * kMaxMediaPackets) {
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  xor_bytes_ = internal::XorBytes_SSE2;
+#else
+  if (WebRtc_GetCPUInfo(kSSE2))
+    xor_bytes_ = internal::XorBytes_SSE2;
+#endif
+#endif
+}
+
+ForwardErrorCorrection::~ForwardErrorCorrection() {
+  packet_pool_->Detach();
+}
 
-ForwardErrorCorrection::~ForwardErrorCorrection() {}
+ForwardErrorCorrection::ReceivedPacket*
+ForwardErrorCorrection::NewReceivedPacket() {
+  ReceivedPacket* received_packet = received_packets_.Get();
+  received_packet->pkt = packet_pool_->Get();
+  return received_packet;
+}
+
+template <typename T>
+void ForwardErrorCorrection::PushBack(std::list<T*>* list, T* value,
+                                      std::list<T*>* spare) {
+  if (spare->empty()) {
+    list->push_back(value);
+    return;
+  }
+  list->splice(list->end(), *spare, spare->begin());
+  list->back() = value;
+}
+
+template <typename T>
+void ForwardErrorCorrection::PopFront(std::list<T*>* list,
+                                      std::list<T*>* spare) {
+  spare->splice(spare->begin(), *list, list->begin());
+}
+
+template <typename T>
+typename std::list<T*>::iterator ForwardErrorCorrection::Erase(
+    std::list<T*>* list, typename std::list<T*>::iterator it,
+    std::list<T*>* spare) {
+  typename std::list<T*>::iterator next = it;
+  ++next;
+  spare->splice(spare->begin(), *list, it);
+  return next;
+}
 
 // Input packet
 //   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -263,11 +372,10 @@ void ForwardErrorCorrection::GenerateFecBitStrings(
           generated_fec_packets_[i].data[9] ^= media_payload_length[1];
 
           // XOR with RTP payload, leaving room for the ULP header.
-          for (int32_t j = kFecHeaderSize + ulp_header_size;
-               j < fec_packet_length; j++) {
-            generated_fec_packets_[i].data[j] ^=
-                media_packet->data[j - fec_rtp_offset];
-          }
+          xor_bytes_(&media_packet->data[kRtpHeaderSize],
+                     media_packet->length - kRtpHeaderSize,
+                     &generated_fec_packets_[i].data[kFecHeaderSize +
+                                                     ulp_header_size]);
         }
         if (fec_packet_length > generated_fec_packets_[i].length) {
           generated_fec_packets_[i].length = fec_packet_length;
@@ -448,25 +556,15 @@ void ForwardErrorCorrection::ResetState(
 
   // Free the memory for any existing recovered packets, if the user hasn't.
   while (!recovered_packet_list->empty()) {
-    delete recovered_packet_list->front();
-    recovered_packet_list->pop_front();
+    recovered_packets_.Put(recovered_packet_list->front());
+    PopFront(recovered_packet_list, &spare_recovered_nodes_);
   }
   assert(recovered_packet_list->empty());
 
   // Free the FEC packet list.
   while (!fec_packet_list_.empty()) {
-    FecPacketList::iterator fec_packet_list_it = fec_packet_list_.begin();
-    FecPacket* fec_packet = *fec_packet_list_it;
-    ProtectedPacketList::iterator protected_packet_list_it;
-    protected_packet_list_it = fec_packet->protected_pkt_list.begin();
-    while (protected_packet_list_it != fec_packet->protected_pkt_list.end()) {
-      delete* protected_packet_list_it;
-      protected_packet_list_it =
-          fec_packet->protected_pkt_list.erase(protected_packet_list_it);
-    }
-    assert(fec_packet->protected_pkt_list.empty());
-    delete fec_packet;
-    fec_packet_list_.pop_front();
+    DiscardFECPacket(fec_packet_list_.front());
+    PopFront(&fec_packet_list_, &spare_fec_nodes_);
   }
   assert(fec_packet_list_.empty());
 }
@@ -486,7 +584,7 @@ void ForwardErrorCorrection::InsertMediaPacket(
     }
     recovered_packet_list_it++;
   }
-  RecoveredPacket* recoverd_packet_to_insert = new RecoveredPacket;
+  RecoveredPacket* recoverd_packet_to_insert = recovered_packets_.Get();
   recoverd_packet_to_insert->was_recovered = false;
   // Inserted Media packet is already sent to VCM.
   recoverd_packet_to_insert->returned = true;
@@ -496,7 +594,8 @@ void ForwardErrorCorrection::InsertMediaPacket(
 
   // TODO(holmer): Consider replacing this with a binary search for the right
   // position, and then just insert the new packet. Would get rid of the sort.
-  recovered_packet_list->push_back(recoverd_packet_to_insert);
+  PushBack(recovered_packet_list, recoverd_packet_to_insert,
+           &spare_recovered_nodes_);
   recovered_packet_list->sort(SortablePacket::LessThan);
   UpdateCoveringFECPackets(recoverd_packet_to_insert);
 }
@@ -531,7 +630,7 @@ void ForwardErrorCorrection::InsertFECPacket(
     }
     fec_packet_list_it++;
   }
-  FecPacket* fec_packet = new FecPacket;
+  FecPacket* fec_packet = fec_packets_.Get();
   fec_packet->pkt = rx_packet->pkt;
   fec_packet->seq_num = rx_packet->seq_num;
   fec_packet->ssrc = rx_packet->ssrc;
@@ -546,8 +645,9 @@ void ForwardErrorCorrection::InsertFECPacket(
     uint8_t packet_mask = fec_packet->pkt->data[12 + byte_idx];
     for (uint16_t bit_idx = 0; bit_idx < 8; ++bit_idx) {
       if (packet_mask & (1 << (7 - bit_idx))) {
-        ProtectedPacket* protected_packet = new ProtectedPacket;
-        fec_packet->protected_pkt_list.push_back(protected_packet);
+        ProtectedPacket* protected_packet = protected_packets_.Get();
+        PushBack(&fec_packet->protected_pkt_list, protected_packet,
+                 &spare_protected_nodes_);
         // This wraps naturally with the sequence number.
         protected_packet->seq_num =
             static_cast<uint16_t>(seq_num_base + (byte_idx << 3) + bit_idx);
@@ -558,16 +658,16 @@ void ForwardErrorCorrection::InsertFECPacket(
   if (fec_packet->protected_pkt_list.empty()) {
     // All-zero packet mask; we can discard this FEC packet.
     LOG(LS_WARNING) << "FEC packet has an all-zero packet mask.";
-    delete fec_packet;
+    fec_packets_.Put(fec_packet);
   } else {
     AssignRecoveredPackets(fec_packet, recovered_packet_list);
     // TODO(holmer): Consider replacing this with a binary search for the right
     // position, and then just insert the new packet. Would get rid of the sort.
-    fec_packet_list_.push_back(fec_packet);
+    PushBack(&fec_packet_list_, fec_packet, &spare_fec_nodes_);
     fec_packet_list_.sort(SortablePacket::LessThan);
     if (fec_packet_list_.size() > kMaxFecPackets) {
       DiscardFECPacket(fec_packet_list_.front());
-      fec_packet_list_.pop_front();
+      PopFront(&fec_packet_list_, &spare_fec_nodes_);
     }
     assert(fec_packet_list_.size() <= kMaxFecPackets);
   }
@@ -577,22 +677,24 @@ void ForwardErrorCorrection::AssignRecoveredPackets(
     FecPacket* fec_packet, const RecoveredPacketList* recovered_packets) {
   // Search for missing packets which have arrived or have been recovered by
   // another FEC packet.
+  // Both lists are sorted, so walk them in step rather than building their
+  // intersection.
   ProtectedPacketList* not_recovered = &fec_packet->protected_pkt_list;
-  RecoveredPacketList already_recovered;
-  std::set_intersection(
-      recovered_packets->begin(), recovered_packets->end(),
-      not_recovered->begin(), not_recovered->end(),
-      std::inserter(already_recovered, already_recovered.end()),
-      SortablePacket::LessThan);
+  ProtectedPacketList::iterator not_recovered_it = not_recovered->begin();
+  RecoveredPacketList::const_iterator it = recovered_packets->begin();
   // Set the FEC pointers to all recovered packets so that we don't have to
   // search for them when we are doing recovery.
-  ProtectedPacketList::iterator not_recovered_it = not_recovered->begin();
-  for (RecoveredPacketList::iterator it = already_recovered.begin();
-       it != already_recovered.end(); ++it) {
-    // Search for the next recovered packet in |not_recovered|.
-    while ((*not_recovered_it)->seq_num != (*it)->seq_num)
+  while (it != recovered_packets->end() &&
+         not_recovered_it != not_recovered->end()) {
+    if (SortablePacket::LessThan(*it, *not_recovered_it)) {
+      ++it;
+    } else if (SortablePacket::LessThan(*not_recovered_it, *it)) {
+      ++not_recovered_it;
+    } else {
+      (*not_recovered_it)->pkt = (*it)->pkt;
+      ++it;
       ++not_recovered_it;
-    (*not_recovered_it)->pkt = (*it)->pkt;
+    }
   }
 }
 
@@ -616,7 +718,7 @@ void ForwardErrorCorrection::InsertPackets(
           static_cast<int>(fec_packet_list_.front()->seq_num));
       if (seq_num_diff > 0x3fff) {
         DiscardFECPacket(fec_packet_list_.front());
-        fec_packet_list_.pop_front();
+        PopFront(&fec_packet_list_, &spare_fec_nodes_);
       }
     }
 
@@ -626,8 +728,8 @@ void ForwardErrorCorrection::InsertPackets(
       // Insert packet at the end of |recoveredPacketList|.
       InsertMediaPacket(rx_packet, recovered_packet_list);
     }
-    // Delete the received packet "wrapper", but not the packet data.
-    delete rx_packet;
+    // Recycle the received packet "wrapper", but not the packet data.
+    received_packets_.Put(rx_packet);
     received_packet_list->pop_front();
   }
   assert(received_packet_list->empty());
@@ -640,7 +742,7 @@ void ForwardErrorCorrection::InitRecovery(const FecPacket* fec_packet,
   const uint16_t ulp_header_size =
       fec_packet->pkt->data[0] & 0x40 ? kUlpHeaderSizeLBitSet
                                       : kUlpHeaderSizeLBitClear;  // L bit set?
-  recovered->pkt = new Packet;
+  recovered->pkt = packet_pool_->Get();
   memset(recovered->pkt->data, 0, IP_PACKET_SIZE);
   recovered->returned = false;
   recovered->was_recovered = true;
@@ -695,9 +797,9 @@ void ForwardErrorCorrection::XorPackets(const Packet* src_packet,
 
   // XOR with RTP payload.
   // TODO(marpan/ajm): Are we doing more XORs than required here?
-  for (size_t i = kRtpHeaderSize; i < src_packet->length; ++i) {
-    dst_packet->pkt->data[i] ^= src_packet->data[i];
-  }
+  xor_bytes_(&src_packet->data[kRtpHeaderSize],
+             src_packet->length - kRtpHeaderSize,
+             &dst_packet->pkt->data[kRtpHeaderSize]);
 }
 
 void ForwardErrorCorrection::RecoverPacket(
@@ -727,7 +829,7 @@ void ForwardErrorCorrection::AttemptRecover(
     // We can only recover one packet with an FEC packet.
     if (packets_missing == 1) {
       // Recovery possible.
-      RecoveredPacket* packet_to_insert = new RecoveredPacket;
+      RecoveredPacket* packet_to_insert = recovered_packets_.Get();
       packet_to_insert->pkt = NULL;
       RecoverPacket(*fec_packet_list_it, packet_to_insert);
 
@@ -736,12 +838,14 @@ void ForwardErrorCorrection::AttemptRecover(
       // TODO(holmer): Consider replacing this with a binary search for the
       // right position, and then just insert the new packet. Would get rid of
       // the sort.
-      recovered_packet_list->push_back(packet_to_insert);
+      PushBack(recovered_packet_list, packet_to_insert,
+               &spare_recovered_nodes_);
       recovered_packet_list->sort(SortablePacket::LessThan);
       UpdateCoveringFECPackets(packet_to_insert);
       DiscardOldPackets(recovered_packet_list);
       DiscardFECPacket(*fec_packet_list_it);
-      fec_packet_list_it = fec_packet_list_.erase(fec_packet_list_it);
+      fec_packet_list_it =
+          Erase(&fec_packet_list_, fec_packet_list_it, &spare_fec_nodes_);
 
       // A packet has been recovered. We need to check the FEC list again, as
       // this may allow additional packets to be recovered.
@@ -751,7 +855,8 @@ void ForwardErrorCorrection::AttemptRecover(
       // Either all protected packets arrived or have been recovered. We can
       // discard this FEC packet.
       DiscardFECPacket(*fec_packet_list_it);
-      fec_packet_list_it = fec_packet_list_.erase(fec_packet_list_it);
+      fec_packet_list_it =
+          Erase(&fec_packet_list_, fec_packet_list_it, &spare_fec_nodes_);
     } else {
       fec_packet_list_it++;
     }
@@ -776,20 +881,18 @@ int ForwardErrorCorrection::NumCoveredPacketsMissing(
 
 void ForwardErrorCorrection::DiscardFECPacket(FecPacket* fec_packet) {
   while (!fec_packet->protected_pkt_list.empty()) {
-    delete fec_packet->protected_pkt_list.front();
-    fec_packet->protected_pkt_list.pop_front();
+    protected_packets_.Put(fec_packet->protected_pkt_list.front());
+    PopFront(&fec_packet->protected_pkt_list, &spare_protected_nodes_);
   }
   assert(fec_packet->protected_pkt_list.empty());
-  delete fec_packet;
+  fec_packets_.Put(fec_packet);
 }
 
 void ForwardErrorCorrection::DiscardOldPackets(
     RecoveredPacketList* recovered_packet_list) {
   while (recovered_packet_list->size() > kMaxMediaPackets) {
-    ForwardErrorCorrection::RecoveredPacket* packet =
-        recovered_packet_list->front();
-    delete packet;
-    recovered_packet_list->pop_front();
+    recovered_packets_.Put(recovered_packet_list->front());
+    PopFront(recovered_packet_list, &spare_recovered_nodes_);
   }
   assert(recovered_packet_list->size() <= kMaxMediaPackets);
 }
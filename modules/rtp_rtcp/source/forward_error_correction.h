@@ -23,6 +23,7 @@ namespace webrtc {
 
 // Forward declaration.
 class FecPacket;
+class ProtectedPacket;
 
 // Performs codec-independent forward error correction (FEC), based on RFC 5109.
 // Option exists to enable unequal protection (UEP) across packets.
@@ -37,23 +38,28 @@ class ForwardErrorCorrection {
   // refactored into proper classes, and their members should be made private.
   // This will require parts of the functionality in forward_error_correction.cc
   // and receiver_fec.cc to be refactored into the packet classes.
+  class PacketPool;
+
   class Packet {
    public:
-    Packet() : length(0), data(), ref_count_(0) {}
+    Packet() : length(0), data(), ref_count_(0), pool_(NULL) {}
     virtual ~Packet() {}
 
     // Add a reference.
     virtual int32_t AddRef();
 
-    // Release a reference. Will delete the object if the reference count
-    // reaches zero.
+    // Release a reference. Will delete the object, or hand it back to the
+    // pool it was taken from, if the reference count reaches zero.
     virtual int32_t Release();
 
     size_t length;               // Length of packet in bytes.
     uint8_t data[IP_PACKET_SIZE];  // Packet data.
 
    private:
+    friend class PacketPool;
+
     int32_t ref_count_;  // Counts the number of references to a packet.
+    PacketPool* pool_;   // Owning pool, or NULL if allocated with new.
   };
 
   // TODO(holmer): Refactor into a proper class.
@@ -203,11 +209,54 @@ class ForwardErrorCorrection {
   static size_t PacketOverhead();
 
   // Reset internal states from last frame and clear the recovered_packet_list.
-  // Frees all memory allocated by this class.
+  // Packets and packet wrappers are kept for reuse by later calls.
   void ResetState(RecoveredPacketList* recovered_packet_list);
 
+  // Returns a received packet wrapper with packet storage attached, to be
+  // filled in and passed to DecodeFEC(). Both are recycled from packets
+  // released by earlier DecodeFEC() calls when possible, so that a receiver
+  // in steady state does not allocate. The caller may also delete it.
+  ReceivedPacket* NewReceivedPacket();
+
  private:
   typedef std::list<FecPacket*> FecPacketList;
+  typedef std::list<ProtectedPacket*> ProtectedPacketList;
+  typedef void (*XorBytesProc)(const uint8_t* src, size_t length,
+                               uint8_t* dst);
+
+  // Keeps up to |max_size| released objects of type T for reuse. Objects
+  // handed out are ordinary heap objects, so whoever ends up owning one may
+  // still delete it.
+  template <typename T>
+  class FreeList {
+   public:
+    explicit FreeList(size_t max_size) : max_size_(max_size) {}
+    ~FreeList() {
+      for (size_t i = 0; i < free_.size(); ++i)
+        delete free_[i];
+    }
+
+    T* Get() {
+      if (free_.empty())
+        return new T;
+      T* object = free_.back();
+      free_.pop_back();
+      return object;
+    }
+
+    void Put(T* object) {
+      object->pkt = NULL;
+      if (free_.size() >= max_size_) {
+        delete object;
+        return;
+      }
+      free_.push_back(object);
+    }
+
+   private:
+    const size_t max_size_;
+    std::vector<T*> free_;
+  };
 
   void GenerateFecUlpHeaders(const PacketList& media_packet_list,
                              uint8_t* packet_mask, bool l_bit,
@@ -279,12 +328,12 @@ class ForwardErrorCorrection {
   void AttemptRecover(RecoveredPacketList* recovered_packet_list);
 
   // Initializes the packet recovery using the FEC packet.
-  static void InitRecovery(const FecPacket* fec_packet,
+  void InitRecovery(const FecPacket* fec_packet,
                            RecoveredPacket* recovered);
 
   // Performs XOR between |src_packet| and |dst_packet| and stores the result
   // in |dst_packet|.
-  static void XorPackets(const Packet* src_packet, RecoveredPacket* dst_packet);
+  void XorPackets(const Packet* src_packet, RecoveredPacket* dst_packet);
 
   // Finish up the recovery of a packet.
   static void FinishRecovery(RecoveredPacket* recovered);
@@ -299,13 +348,37 @@ class ForwardErrorCorrection {
   // This function returns 2 when two or more packets are missing.
   static int NumCoveredPacketsMissing(const FecPacket* fec_packet);
 
-  static void DiscardFECPacket(FecPacket* fec_packet);
-  static void DiscardOldPackets(RecoveredPacketList* recovered_packet_list);
+  void DiscardFECPacket(FecPacket* fec_packet);
+  void DiscardOldPackets(RecoveredPacketList* recovered_packet_list);
   static uint16_t ParseSequenceNumber(uint8_t* packet);
 
+  // List operations which move nodes to and from |spare| rather than
+  // allocating and freeing them.
+  template <typename T>
+  void PushBack(std::list<T*>* list, T* value, std::list<T*>* spare);
+  template <typename T>
+  void PopFront(std::list<T*>* list, std::list<T*>* spare);
+  template <typename T>
+  typename std::list<T*>::iterator Erase(std::list<T*>* list,
+                                         typename std::list<T*>::iterator it,
+                                         std::list<T*>* spare);
+
   std::vector<Packet> generated_fec_packets_;
   FecPacketList fec_packet_list_;
   bool fec_packet_received_;
+  // XOR kernel for payloads, selected for the CPU at construction.
+  XorBytesProc xor_bytes_;
+
+  // Recycled storage for the decoder. The packet pool outlives this object
+  // while any of its packets are still referenced.
+  PacketPool* packet_pool_;
+  FreeList<ReceivedPacket> received_packets_;
+  FreeList<RecoveredPacket> recovered_packets_;
+  FreeList<FecPacket> fec_packets_;
+  FreeList<ProtectedPacket> protected_packets_;
+  FecPacketList spare_fec_nodes_;
+  ProtectedPacketList spare_protected_nodes_;
+  RecoveredPacketList spare_recovered_nodes_;
 };
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_FORWARD_ERROR_CORRECTION_H_
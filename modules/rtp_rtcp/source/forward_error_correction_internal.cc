@@ -372,5 +372,21 @@ void GeneratePacketMasks(int num_media_packets, int num_fec_packets,
   }  // End of UEP modification
 }  //End of GetPacketMasks
 
+void XorBytes_C(const uint8_t* src, size_t length, uint8_t* dst) {
+  // Work on 64 bits at a time; memcpy avoids unaligned access.
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t src_word;
+    uint64_t dst_word;
+    memcpy(&src_word, &src[i], sizeof(src_word));
+    memcpy(&dst_word, &dst[i], sizeof(dst_word));
+    dst_word ^= src_word;
+    memcpy(&dst[i], &dst_word, sizeof(dst_word));
+  }
+  for (; i < length; ++i) {
+    dst[i] ^= src[i];
+  }
+}
+
 }  // namespace internal
 }  // namespace webrtc
@@ -65,6 +65,12 @@ void GeneratePacketMasks(int num_media_packets, int num_fec_packets,
                          const PacketMaskTable& mask_table,
                          uint8_t* packet_mask);
 
+// XORs |length| bytes of |src| into |dst|. The buffers must not overlap.
+void XorBytes_C(const uint8_t* src, size_t length, uint8_t* dst);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void XorBytes_SSE2(const uint8_t* src, size_t length, uint8_t* dst);
+#endif
+
 }  // namespace internal
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_FORWARD_ERROR_CORRECTION_INTERNAL_H_
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+
+#include <sstream>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+
+const size_t kRtpHeaderSize = 12;
+const size_t kMaxMediaPacketLength = 1200;
+const int kNumFrames = 200;
+
+// Creates a frame of |num_media_packets| packets of random length and
+// content, the last of which has the marker bit set.
+void ConstructMediaPackets(int num_media_packets,
+                           ForwardErrorCorrection::PacketList* packets) {
+  uint32_t timestamp = rand();
+  for (int i = 0; i < num_media_packets; ++i) {
+    ForwardErrorCorrection::Packet* packet =
+        new ForwardErrorCorrection::Packet();
+    packet->length =
+        kRtpHeaderSize + rand() % (kMaxMediaPacketLength - kRtpHeaderSize);
+    for (size_t j = 0; j < packet->length; ++j)
+      packet->data[j] = static_cast<uint8_t>(rand());
+    // Version 2, no marker bit.
+    packet->data[0] = (packet->data[0] | 0x80) & 0xbf;
+    packet->data[1] &= 0x7f;
+    ByteWriter<uint16_t>::WriteBigEndian(&packet->data[2], i);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet->data[4], timestamp);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet->data[8], 0x12345678);
+    packets->push_back(packet);
+  }
+  packets->back()->data[1] |= 0x80;
+}
+
+}  // namespace
+
+// Measures FEC generation for frames protected with 12, 24 and 48 packet
+// masks, with as many FEC packets as media packets.
+TEST(ForwardErrorCorrectionPerformanceTest, GenerateFec) {
+  const int kNumMediaPackets[] = {12, 24, 48};
+  const uint8_t kProtectionFactor = 255;
+  for (int num_media_packets : kNumMediaPackets) {
+    ForwardErrorCorrection fec;
+    ForwardErrorCorrection::PacketList media_packets;
+    ForwardErrorCorrection::PacketList fec_packets;
+    ConstructMediaPackets(num_media_packets, &media_packets);
+
+    int64_t start_us = TickTime::MicrosecondTimestamp();
+    for (int i = 0; i < kNumFrames; ++i) {
+      fec_packets.clear();
+      EXPECT_EQ(0, fec.GenerateFEC(media_packets, kProtectionFactor, 0, false,
+                                   kFecMaskRandom, &fec_packets));
+    }
+    int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+    EXPECT_EQ(static_cast<size_t>(num_media_packets), fec_packets.size());
+    fec_packets.clear();
+    while (!media_packets.empty()) {
+      delete media_packets.front();
+      media_packets.pop_front();
+    }
+
+    std::ostringstream trace;
+    trace << num_media_packets << "_media_packets";
+    webrtc::test::PrintResult("fec_generation", "", trace.str(),
+                              static_cast<size_t>(elapsed_us / kNumFrames),
+                              "us", false);
+  }
+}
+
+}  // namespace webrtc
@@ -8,14 +8,41 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <iterator>
 #include <list>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
+#include "webrtc/modules/rtp_rtcp/source/forward_error_correction_internal.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 using webrtc::ForwardErrorCorrection;
 
+// Number of calls to the global operator new in this test binary, so that
+// tests can check that a code path doesn't touch the heap.
+static volatile int g_num_heap_allocations = 0;
+
+void* operator new(size_t size) {
+  rtc::AtomicOps::Increment(&g_num_heap_allocations);
+  void* memory = malloc(size > 0 ? size : 1);
+  if (!memory)
+    abort();
+  return memory;
+}
+
+void operator delete(void* memory) noexcept {
+  free(memory);
+}
+
+static int NumHeapAllocations() {
+  return rtc::AtomicOps::Load(&g_num_heap_allocations);
+}
+
 // Minimum RTP header size in bytes.
 const uint8_t kRtpHeaderSize = 12;
 
@@ -793,6 +820,115 @@ TEST_F(RtpFecTest, FecRecoveryNonConsecutivePacketsWrap) {
   EXPECT_FALSE(IsRecoveryComplete());
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(FecXorTest, Sse2MatchesC) {
+  if (!WebRtc_GetCPUInfo(kSSE2)) {
+    printf("Skipping test, SSE2 not supported.\n");
+    return;
+  }
+  const size_t kMaxLength = 200;
+  uint8_t src[kMaxLength + 16];
+  uint8_t dst[kMaxLength + 16];
+  uint8_t dst_c[kMaxLength + 16];
+  for (size_t i = 0; i < sizeof(src); ++i) {
+    src[i] = static_cast<uint8_t>(rand());
+    dst[i] = static_cast<uint8_t>(rand());
+  }
+  memcpy(dst_c, dst, sizeof(dst));
+
+  // Cover every tail length and misaligned starting points.
+  for (size_t offset = 0; offset < 16; offset += 5) {
+    for (size_t length = 0; length <= kMaxLength; ++length) {
+      webrtc::internal::XorBytes_C(&src[offset], length, &dst_c[offset]);
+      webrtc::internal::XorBytes_SSE2(&src[offset], length, &dst[offset]);
+      ASSERT_EQ(0, memcmp(dst_c, dst, sizeof(dst)))
+          << "offset " << offset << ", length " << length;
+    }
+  }
+}
+#endif
+
+// Decodes a stream of frames, each losing one media packet, and checks that
+// after a warm-up DecodeFEC() no longer allocates: packets, wrappers and list
+// nodes all come from the decoder's free lists.
+TEST_F(RtpFecTest, DecodeRecyclesPacketsInSteadyState) {
+  const int kNumMediaPackets = 12;
+  const uint8_t kProtectionFactor = 255;
+  const int kNumImportantPackets = 0;
+  const bool kUseUnequalProtection = false;
+  const int kNumWarmUpFrames = 20;
+  const int kNumFrames = 100;
+
+  int seq_num = 0;
+  int num_heap_allocations = 0;
+  for (int i = 0; i < kNumWarmUpFrames + kNumFrames; ++i) {
+    ClearList(&media_packet_list_);
+    fec_packet_list_.clear();
+    fec_seq_num_ = ConstructMediaPacketsSeqNum(kNumMediaPackets, seq_num);
+    seq_num = fec_seq_num_ + kNumMediaPackets;
+    EXPECT_EQ(0, fec_->GenerateFEC(media_packet_list_, kProtectionFactor,
+                                   kNumImportantPackets, kUseUnequalProtection,
+                                   webrtc::kFecMaskRandom, &fec_packet_list_));
+
+    const int lost_index = i % kNumMediaPackets;
+    memset(media_loss_mask_, 0, sizeof(media_loss_mask_));
+    memset(fec_loss_mask_, 0, sizeof(fec_loss_mask_));
+    media_loss_mask_[lost_index] = 1;
+    NetworkReceivedPackets();
+    const int allocations_before = NumHeapAllocations();
+    EXPECT_EQ(0, fec_->DecodeFEC(&received_packet_list_,
+                                 &recovered_packet_list_));
+    if (i >= kNumWarmUpFrames)
+      num_heap_allocations += NumHeapAllocations() - allocations_before;
+
+    PacketList::iterator media_it = media_packet_list_.begin();
+    std::advance(media_it, lost_index);
+    const uint16_t lost_seq_num =
+        webrtc::ByteReader<uint16_t>::ReadBigEndian(&(*media_it)->data[2]);
+    bool recovered = false;
+    for (RecoveredPacketList::iterator it = recovered_packet_list_.begin();
+         it != recovered_packet_list_.end(); ++it) {
+      if ((*it)->seq_num != lost_seq_num)
+        continue;
+      recovered = (*it)->was_recovered &&
+                  (*it)->pkt->length == (*media_it)->length &&
+                  memcmp((*it)->pkt->data, (*media_it)->data,
+                         (*media_it)->length) == 0;
+    }
+    EXPECT_TRUE(recovered);
+  }
+  EXPECT_EQ(0, num_heap_allocations);
+}
+
+// Recovered packets must stay valid after the decoder which produced them is
+// deleted.
+TEST_F(RtpFecTest, RecoveredPacketsOutliveDecoder) {
+  const int kNumImportantPackets = 0;
+  const bool kUseUnequalProtection = false;
+  const int kNumMediaPackets = 4;
+  const uint8_t kProtectionFactor = 60;
+
+  fec_seq_num_ = ConstructMediaPackets(kNumMediaPackets);
+  EXPECT_EQ(0, fec_->GenerateFEC(media_packet_list_, kProtectionFactor,
+                                 kNumImportantPackets, kUseUnequalProtection,
+                                 webrtc::kFecMaskBursty, &fec_packet_list_));
+  memset(media_loss_mask_, 0, sizeof(media_loss_mask_));
+  memset(fec_loss_mask_, 0, sizeof(fec_loss_mask_));
+  media_loss_mask_[3] = 1;
+  NetworkReceivedPackets();
+  EXPECT_EQ(0,
+            fec_->DecodeFEC(&received_packet_list_, &recovered_packet_list_));
+
+  RecoveredPacketList recovered;
+  recovered.swap(recovered_packet_list_);
+  // |fec_packet_list_| points into the encoder's storage.
+  fec_packet_list_.clear();
+  delete fec_;
+  fec_ = new ForwardErrorCorrection();
+  recovered.swap(recovered_packet_list_);
+  EXPECT_TRUE(IsRecoveryComplete());
+}
+
 void RtpFecTest::TearDown() {
   fec_->ResetState(&recovered_packet_list_);
   delete fec_;
@@ -856,8 +992,7 @@ void RtpFecTest::ReceivedPackets(const PacketList& packet_list, int* loss_mask,
   while (packet_list_item != packet_list.end()) {
     packet = *packet_list_item;
     if (loss_mask[packet_idx] == 0) {
-      received_packet = new ForwardErrorCorrection::ReceivedPacket;
-      received_packet->pkt = new ForwardErrorCorrection::Packet;
+      received_packet = fec_->NewReceivedPacket();
       received_packet_list_.push_back(received_packet);
       received_packet->pkt->length = packet->length;
       memcpy(received_packet->pkt->data, packet->data, packet->length);
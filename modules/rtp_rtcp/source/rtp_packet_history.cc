@@ -12,9 +12,10 @@
 
 #include <assert.h>
 #include <stdlib.h>
-#include <string.h>   // memset
+#include <string.h>   // memcpy
+
+#include <algorithm>
 #include <limits>
-#include <set>
 
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
@@ -24,12 +25,33 @@ namespace webrtc {
 
 static const int kMinPacketRequestBytes = 50;
 
+RtpPacketBuffer::RtpPacketBuffer(size_t capacity)
+    : data_(new uint8_t[capacity]),
+      capacity_(capacity) {
+}
+
+RtpPacketBuffer::~RtpPacketBuffer() {
+}
+
+RTPPacketHistory::StoredPacket::StoredPacket()
+    : sequence_number(0),
+      length(0),
+      time_ms(0),
+      send_time_ms(0),
+      storage_type(kDontStore) {
+}
+
+RTPPacketHistory::StoredPacket::~StoredPacket() {
+}
+
 RTPPacketHistory::RTPPacketHistory(Clock* clock)
   : clock_(clock),
     critsect_(CriticalSectionWrapper::CreateCriticalSection()),
     store_(false),
-    prev_index_(0),
-    max_packet_length_(0) {
+    max_packet_length_(0),
+    has_packets_(false),
+    newest_seq_num_(0),
+    newest_index_(0) {
 }
 
 RTPPacketHistory::~RTPPacketHistory() {
@@ -55,32 +77,39 @@ void RTPPacketHistory::Allocate(size_t number_to_store) {
   assert(number_to_store <= kMaxHistoryCapacity);
   store_ = true;
   stored_packets_.resize(number_to_store);
-  stored_seq_nums_.resize(number_to_store);
-  stored_lengths_.resize(number_to_store);
-  stored_times_.resize(number_to_store);
-  stored_send_times_.resize(number_to_store);
-  stored_types_.resize(number_to_store);
 }
 
-void RTPPacketHistory::Free() {
-  if (!store_) {
+void RTPPacketHistory::Expand() {
+  size_t current_size = stored_packets_.size();
+  if (current_size >= kMaxHistoryCapacity)
     return;
+  size_t expanded_size = std::max(current_size * 3 / 2, current_size + 1);
+  expanded_size = std::min(expanded_size, kMaxHistoryCapacity);
+
+  // Move the stored packets so that they keep their distance to the newest
+  // packet, which keeps the sequence number to slot mapping intact.
+  std::vector<StoredPacket> expanded(expanded_size);
+  for (size_t i = 0; i < current_size; ++i) {
+    if (stored_packets_[i].length == 0)
+      continue;
+    size_t age = (newest_index_ + current_size - i) % current_size;
+    expanded[(newest_index_ + expanded_size - age) % expanded_size] =
+        stored_packets_[i];
   }
+  stored_packets_.swap(expanded);
+}
 
-  std::vector<std::vector<uint8_t> >::iterator it;
-  for (it = stored_packets_.begin(); it != stored_packets_.end(); ++it) {
-    it->clear();
+void RTPPacketHistory::Free() {
+  if (!store_) {
+    return;
   }
 
   stored_packets_.clear();
-  stored_seq_nums_.clear();
-  stored_lengths_.clear();
-  stored_times_.clear();
-  stored_send_times_.clear();
-  stored_types_.clear();
 
   store_ = false;
-  prev_index_ = 0;
+  has_packets_ = false;
+  newest_seq_num_ = 0;
+  newest_index_ = 0;
   max_packet_length_ = 0;
 }
 
@@ -89,28 +118,6 @@ bool RTPPacketHistory::StorePackets() const {
   return store_;
 }
 
-void RTPPacketHistory::VerifyAndAllocatePacketLength(size_t packet_length,
-                                                     uint32_t start_index) {
-  assert(packet_length > 0);
-  if (!store_) {
-    return;
-  }
-
-  // If start_index > 0 this is a resize and we must check any new (empty)
-  // packets created during the resize.
-  if (start_index == 0 && packet_length <= max_packet_length_) {
-    return;
-  }
-
-  max_packet_length_ = std::max(packet_length, max_packet_length_);
-
-  std::vector<std::vector<uint8_t> >::iterator it;
-  for (it = stored_packets_.begin() + start_index; it != stored_packets_.end();
-       ++it) {
-    it->resize(max_packet_length_);
-  }
-}
-
 int32_t RTPPacketHistory::PutRTPPacket(const uint8_t* packet,
                                        size_t packet_length,
                                        size_t max_packet_length,
@@ -128,7 +135,7 @@ int32_t RTPPacketHistory::PutRTPPacket(const uint8_t* packet,
   assert(packet);
   assert(packet_length > 3);
 
-  VerifyAndAllocatePacketLength(max_packet_length, 0);
+  max_packet_length_ = std::max(max_packet_length, max_packet_length_);
 
   if (packet_length > max_packet_length_) {
     LOG(LS_WARNING) << "Failed to store RTP packet with length: "
@@ -138,41 +145,56 @@ int32_t RTPPacketHistory::PutRTPPacket(const uint8_t* packet,
 
   const uint16_t seq_num = (packet[2] << 8) + packet[3];
 
-  // If index we're about to overwrite contains a packet that has not
-  // yet been sent (probably pending in paced sender), we need to expand
-  // the buffer.
-  if (stored_lengths_[prev_index_] > 0 &&
-      stored_send_times_[prev_index_] == 0) {
-    size_t current_size = static_cast<uint16_t>(stored_packets_.size());
-    if (current_size < kMaxHistoryCapacity) {
-      size_t expanded_size = std::max(current_size * 3 / 2, current_size + 1);
-      expanded_size = std::min(expanded_size, kMaxHistoryCapacity);
-      Allocate(expanded_size);
-      VerifyAndAllocatePacketLength(max_packet_length, current_size);
-      // Causes discontinuity, but that's OK-ish. FindSeqNum() will still work,
-      // but may be slower - at least until buffer has wrapped around once.
-      prev_index_ = current_size;
+  // Packets that are not newer than the newest one are stored in their slot.
+  // Those older than the history are dropped, as storing them would rewind the
+  // history.
+  size_t index = 0;
+  if (has_packets_ && !IsNewerSequenceNumber(seq_num, newest_seq_num_)) {
+    if (!IndexOf(seq_num, &index)) {
+      LOG(LS_WARNING) << "Failed to store RTP packet " << seq_num
+                      << ", older than the history.";
+      return -1;
+    }
+  } else {
+    const uint16_t distance = has_packets_ ? seq_num - newest_seq_num_ : 1;
+    size_t size = stored_packets_.size();
+    index = (newest_index_ + distance) % size;
+
+    // If index we're about to overwrite contains a packet that has not
+    // yet been sent (probably pending in paced sender), we need to expand
+    // the buffer.
+    if (stored_packets_[index].length > 0 &&
+        stored_packets_[index].send_time_ms == 0) {
+      Expand();
+      size = stored_packets_.size();
+      index = (newest_index_ + distance) % size;
     }
-  }
 
-  // Store packet
-  std::vector<std::vector<uint8_t> >::iterator it =
-      stored_packets_.begin() + prev_index_;
-  // TODO(sprang): Overhaul this class and get rid of this copy step.
-  //               (Finally introduce the RtpPacket class?)
-  std::copy(packet, packet + packet_length, it->begin());
+    // Drop whatever is left in the slots of skipped sequence numbers.
+    for (size_t i = 1; i < distance && i < size; ++i)
+      stored_packets_[(newest_index_ + i) % size].length = 0;
 
-  stored_seq_nums_[prev_index_] = seq_num;
-  stored_lengths_[prev_index_] = packet_length;
-  stored_times_[prev_index_] = (capture_time_ms > 0) ? capture_time_ms :
-      clock_->TimeInMilliseconds();
-  stored_send_times_[prev_index_] = 0;  // Packet not sent.
-  stored_types_[prev_index_] = type;
+    has_packets_ = true;
+    newest_seq_num_ = seq_num;
+    newest_index_ = index;
+  }
 
-  ++prev_index_;
-  if (prev_index_ >= stored_seq_nums_.size()) {
-    prev_index_ = 0;
+  // Store packet. The buffer is reused unless a view of the packet it holds
+  // is still referenced elsewhere.
+  StoredPacket& stored = stored_packets_[index];
+  if (!stored.buffer.get() || !stored.buffer->HasOneRef() ||
+      stored.buffer->capacity_ < max_packet_length_) {
+    stored.buffer = new rtc::RefCountedObject<RtpPacketBuffer>(
+        max_packet_length_);
   }
+  memcpy(stored.buffer->data_.get(), packet, packet_length);
+
+  stored.sequence_number = seq_num;
+  stored.length = packet_length;
+  stored.time_ms = (capture_time_ms > 0) ? capture_time_ms :
+      clock_->TimeInMilliseconds();
+  stored.send_time_ms = 0;  // Packet not sent.
+  stored.storage_type = type;
   return 0;
 }
 
@@ -182,18 +204,8 @@ bool RTPPacketHistory::HasRTPPacket(uint16_t sequence_number) const {
     return false;
   }
 
-  int32_t index = 0;
-  bool found = FindSeqNum(sequence_number, &index);
-  if (!found) {
-    return false;
-  }
-
-  size_t length = stored_lengths_.at(index);
-  if (length == 0 || length > max_packet_length_) {
-    // Invalid length.
-    return false;
-  }
-  return true;
+  size_t index = 0;
+  return FindSeqNum(sequence_number, &index);
 }
 
 bool RTPPacketHistory::SetSent(uint16_t sequence_number) {
@@ -202,18 +214,18 @@ bool RTPPacketHistory::SetSent(uint16_t sequence_number) {
     return false;
   }
 
-  int32_t index = 0;
+  size_t index = 0;
   bool found = FindSeqNum(sequence_number, &index);
   if (!found) {
     return false;
   }
 
   // Send time already set.
-  if (stored_send_times_[index] != 0) {
+  if (stored_packets_[index].send_time_ms != 0) {
     return false;
   }
 
-  stored_send_times_[index] = clock_->TimeInMilliseconds();
+  stored_packets_[index].send_time_ms = clock_->TimeInMilliseconds();
   return true;
 }
 
@@ -225,56 +237,71 @@ bool RTPPacketHistory::GetPacketAndSetSendTime(uint16_t sequence_number,
                                                int64_t* stored_time_ms) {
   CriticalSectionScoped cs(critsect_.get());
   assert(*packet_length >= max_packet_length_);
-  if (!store_) {
+  size_t index = 0;
+  if (!GetPacketIndexAndSetSendTime(sequence_number, min_elapsed_time_ms,
+                                    retransmit, &index)) {
     return false;
   }
+  const StoredPacket& stored = stored_packets_[index];
+  memcpy(packet, stored.buffer->data(), stored.length);
+  *packet_length = stored.length;
+  *stored_time_ms = stored.time_ms;
+  return true;
+}
 
-  int32_t index = 0;
-  bool found = FindSeqNum(sequence_number, &index);
-  if (!found) {
-    LOG(LS_WARNING) << "No match for getting seqNum " << sequence_number;
+bool RTPPacketHistory::GetPacketViewAndSetSendTime(
+    uint16_t sequence_number,
+    int64_t min_elapsed_time_ms,
+    bool retransmit,
+    rtc::scoped_refptr<RtpPacketBuffer>* packet,
+    size_t* packet_length,
+    int64_t* stored_time_ms) {
+  CriticalSectionScoped cs(critsect_.get());
+  size_t index = 0;
+  if (!GetPacketIndexAndSetSendTime(sequence_number, min_elapsed_time_ms,
+                                    retransmit, &index)) {
     return false;
   }
+  const StoredPacket& stored = stored_packets_[index];
+  *packet = stored.buffer;
+  *packet_length = stored.length;
+  *stored_time_ms = stored.time_ms;
+  return true;
+}
 
-  size_t length = stored_lengths_.at(index);
-  assert(length <= max_packet_length_);
-  if (length == 0) {
-    LOG(LS_WARNING) << "No match for getting seqNum " << sequence_number
-                    << ", len " << length;
+bool RTPPacketHistory::GetPacketIndexAndSetSendTime(
+    uint16_t sequence_number,
+    int64_t min_elapsed_time_ms,
+    bool retransmit,
+    size_t* index) {
+  if (!store_) {
     return false;
   }
 
+  if (!FindSeqNum(sequence_number, index)) {
+    LOG(LS_WARNING) << "No match for getting seqNum " << sequence_number;
+    return false;
+  }
+
+  StoredPacket& stored = stored_packets_[*index];
+  assert(stored.length <= max_packet_length_);
+
   // Verify elapsed time since last retrieve.
   int64_t now = clock_->TimeInMilliseconds();
   if (min_elapsed_time_ms > 0 &&
-      ((now - stored_send_times_.at(index)) < min_elapsed_time_ms)) {
+      ((now - stored.send_time_ms) < min_elapsed_time_ms)) {
     return false;
   }
 
-  if (retransmit && stored_types_.at(index) == kDontRetransmit) {
+  if (retransmit && stored.storage_type == kDontRetransmit) {
     // No bytes copied since this packet shouldn't be retransmitted or is
     // of zero size.
     return false;
   }
-  stored_send_times_[index] = clock_->TimeInMilliseconds();
-  GetPacket(index, packet, packet_length, stored_time_ms);
+  stored.send_time_ms = now;
   return true;
 }
 
-void RTPPacketHistory::GetPacket(int index,
-                                 uint8_t* packet,
-                                 size_t* packet_length,
-                                 int64_t* stored_time_ms) const {
-  // Get packet.
-  size_t length = stored_lengths_.at(index);
-  std::vector<std::vector<uint8_t> >::const_iterator it_found_packet =
-      stored_packets_.begin() + index;
-  std::copy(it_found_packet->begin(), it_found_packet->begin() + length,
-            packet);
-  *packet_length = length;
-  *stored_time_ms = stored_times_.at(index);
-}
-
 bool RTPPacketHistory::GetBestFittingPacket(uint8_t* packet,
                                             size_t* packet_length,
                                             int64_t* stored_time_ms) {
@@ -284,55 +311,61 @@ bool RTPPacketHistory::GetBestFittingPacket(uint8_t* packet,
   int index = FindBestFittingPacket(*packet_length);
   if (index < 0)
     return false;
-  GetPacket(index, packet, packet_length, stored_time_ms);
+  const StoredPacket& stored = stored_packets_[index];
+  memcpy(packet, stored.buffer->data(), stored.length);
+  *packet_length = stored.length;
+  *stored_time_ms = stored.time_ms;
   return true;
 }
 
-// private, lock should already be taken
-bool RTPPacketHistory::FindSeqNum(uint16_t sequence_number,
-                                  int32_t* index) const {
-  uint16_t temp_sequence_number = 0;
-  if (prev_index_ > 0) {
-    *index = prev_index_ - 1;
-    temp_sequence_number = stored_seq_nums_[*index];
-  } else {
-    *index = stored_seq_nums_.size() - 1;
-    temp_sequence_number = stored_seq_nums_[*index];  // wrap
-  }
+bool RTPPacketHistory::GetBestFittingPacketView(
+    rtc::scoped_refptr<RtpPacketBuffer>* packet,
+    size_t* packet_length,
+    int64_t* stored_time_ms) {
+  CriticalSectionScoped cs(critsect_.get());
+  if (!store_)
+    return false;
+  int index = FindBestFittingPacket(*packet_length);
+  if (index < 0)
+    return false;
+  const StoredPacket& stored = stored_packets_[index];
+  *packet = stored.buffer;
+  *packet_length = stored.length;
+  *stored_time_ms = stored.time_ms;
+  return true;
+}
 
-  int32_t idx = (prev_index_ - 1) - (temp_sequence_number - sequence_number);
-  if (idx >= 0 && idx < static_cast<int>(stored_seq_nums_.size())) {
-    *index = idx;
-    temp_sequence_number = stored_seq_nums_[*index];
-  }
+// private, lock should already be taken
+bool RTPPacketHistory::IndexOf(uint16_t sequence_number, size_t* index) const {
+  if (!has_packets_)
+    return false;
+  const size_t size = stored_packets_.size();
+  const uint16_t age = newest_seq_num_ - sequence_number;
+  if (age >= size)
+    return false;
+  *index = (newest_index_ + size - age) % size;
+  return true;
+}
 
-  if (temp_sequence_number != sequence_number) {
-    // We did not found a match, search all.
-    for (uint16_t m = 0; m < stored_seq_nums_.size(); m++) {
-      if (stored_seq_nums_[m] == sequence_number) {
-        *index = m;
-        temp_sequence_number = stored_seq_nums_[*index];
-        break;
-      }
-    }
-  }
-  if (temp_sequence_number == sequence_number) {
-    // We found a match.
-    return true;
-  }
-  return false;
+// private, lock should already be taken
+bool RTPPacketHistory::FindSeqNum(uint16_t sequence_number,
+                                  size_t* index) const {
+  if (!IndexOf(sequence_number, index))
+    return false;
+  const StoredPacket& stored = stored_packets_[*index];
+  return stored.length > 0 && stored.sequence_number == sequence_number;
 }
 
 int RTPPacketHistory::FindBestFittingPacket(size_t size) const {
-  if (size < kMinPacketRequestBytes || stored_lengths_.empty())
+  if (size < kMinPacketRequestBytes || stored_packets_.empty())
     return -1;
   size_t min_diff = std::numeric_limits<size_t>::max();
   int best_index = -1;  // Returned unchanged if we don't find anything.
-  for (size_t i = 0; i < stored_lengths_.size(); ++i) {
-    if (stored_lengths_[i] == 0)
+  for (size_t i = 0; i < stored_packets_.size(); ++i) {
+    size_t length = stored_packets_[i].length;
+    if (length == 0)
       continue;
-    size_t diff = (stored_lengths_[i] > size) ?
-        (stored_lengths_[i] - size) : (size - stored_lengths_[i]);
+    size_t diff = (length > size) ? (length - size) : (size - length);
     if (diff < min_diff) {
       min_diff = diff;
       best_index = static_cast<int>(i);
@@ -15,6 +15,9 @@
 
 #include <vector>
 
+#include "webrtc/base/refcount.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
@@ -27,6 +30,27 @@ class CriticalSectionWrapper;
 
 static const size_t kMaxHistoryCapacity = 9600;
 
+// Holds the bytes of one stored packet. Buffers are handed out by reference so
+// that callers can read a stored packet without copying it. The history only
+// writes to a buffer while it holds the sole reference, so the contents seen
+// through a reference never change.
+class RtpPacketBuffer : public rtc::RefCountInterface {
+ public:
+  const uint8_t* data() const { return data_.get(); }
+
+  virtual bool HasOneRef() const = 0;
+
+ protected:
+  explicit RtpPacketBuffer(size_t capacity);
+  virtual ~RtpPacketBuffer();
+
+ private:
+  friend class RTPPacketHistory;
+
+  rtc::scoped_ptr<uint8_t[]> data_;
+  const size_t capacity_;
+};
+
 class RTPPacketHistory {
  public:
   RTPPacketHistory(Clock* clock);
@@ -61,24 +85,56 @@ class RTPPacketHistory {
                                size_t* packet_length,
                                int64_t* stored_time_ms);
 
+  // Same as GetPacketAndSetSendTime(), but returns a reference to the stored
+  // bytes in |packet| instead of copying them.
+  bool GetPacketViewAndSetSendTime(uint16_t sequence_number,
+                                   int64_t min_elapsed_time_ms,
+                                   bool retransmit,
+                                   rtc::scoped_refptr<RtpPacketBuffer>* packet,
+                                   size_t* packet_length,
+                                   int64_t* stored_time_ms);
+
   bool GetBestFittingPacket(uint8_t* packet, size_t* packet_length,
                             int64_t* stored_time_ms);
 
+  // Same as GetBestFittingPacket(), but returns a reference to the stored
+  // bytes in |packet| instead of copying them.
+  bool GetBestFittingPacketView(rtc::scoped_refptr<RtpPacketBuffer>* packet,
+                                size_t* packet_length,
+                                int64_t* stored_time_ms);
+
   bool HasRTPPacket(uint16_t sequence_number) const;
 
   bool SetSent(uint16_t sequence_number);
 
  private:
-  void GetPacket(int index,
-                 uint8_t* packet,
-                 size_t* packet_length,
-                 int64_t* stored_time_ms) const
+  struct StoredPacket {
+    StoredPacket();
+    ~StoredPacket();
+
+    uint16_t sequence_number;
+    size_t length;  // Zero if the slot is empty.
+    int64_t time_ms;
+    int64_t send_time_ms;
+    StorageType storage_type;
+    rtc::scoped_refptr<RtpPacketBuffer> buffer;
+  };
+
+  // Looks up the packet with |sequence_number| and, if it may be sent now,
+  // updates its send time and returns its index.
+  bool GetPacketIndexAndSetSendTime(uint16_t sequence_number,
+                                    int64_t min_elapsed_time_ms,
+                                    bool retransmit,
+                                    size_t* index)
       EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
   void Allocate(size_t number_to_store) EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  void Expand() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
   void Free() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
-  void VerifyAndAllocatePacketLength(size_t packet_length, uint32_t start_index)
+  // Returns the slot |sequence_number| maps to, or false if it is outside of
+  // the window of sequence numbers covered by the history.
+  bool IndexOf(uint16_t sequence_number, size_t* index) const
       EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
-  bool FindSeqNum(uint16_t sequence_number, int32_t* index) const
+  bool FindSeqNum(uint16_t sequence_number, size_t* index) const
       EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
   int FindBestFittingPacket(size_t size) const
       EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
@@ -87,15 +143,14 @@ class RTPPacketHistory {
   Clock* clock_;
   rtc::scoped_ptr<CriticalSectionWrapper> critsect_;
   bool store_ GUARDED_BY(critsect_);
-  uint32_t prev_index_ GUARDED_BY(critsect_);
   size_t max_packet_length_ GUARDED_BY(critsect_);
 
-  std::vector<std::vector<uint8_t> > stored_packets_ GUARDED_BY(critsect_);
-  std::vector<uint16_t> stored_seq_nums_ GUARDED_BY(critsect_);
-  std::vector<size_t> stored_lengths_ GUARDED_BY(critsect_);
-  std::vector<int64_t> stored_times_ GUARDED_BY(critsect_);
-  std::vector<int64_t> stored_send_times_ GUARDED_BY(critsect_);
-  std::vector<StorageType> stored_types_ GUARDED_BY(critsect_);
+  // Ring of packets indexed by sequence number; the packet with sequence
+  // number |newest_seq_num_| - n lives in slot |newest_index_| - n.
+  std::vector<StoredPacket> stored_packets_ GUARDED_BY(critsect_);
+  bool has_packets_ GUARDED_BY(critsect_);
+  uint16_t newest_seq_num_ GUARDED_BY(critsect_);
+  size_t newest_index_ GUARDED_BY(critsect_);
 };
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_RTP_RTCP_RTP_PACKET_HISTORY_H_
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_history.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumStreams = 3;
+const uint16_t kHistorySize = 1000;
+const size_t kPacketSize = 1200;
+const size_t kMaxPacketLength = 1500;
+// 10 s of 30 Mbps.
+const int kNumPackets = 10 * 30000000 / (8 * kPacketSize);
+const int kNackInterval = 20;
+const uint16_t kNackDistance = 100;
+
+void WriteSequenceNumber(uint16_t seq_num, uint8_t* packet) {
+  packet[0] = 0x80;
+  packet[2] = seq_num >> 8;
+  packet[3] = seq_num;
+}
+
+// Stores 30 Mbps of simulcast video split over three streams, each with a
+// 1000 packet history. Every packet is fetched when the pacer sends it, and
+// every 20th packet is fetched again later for a retransmission. Returns the
+// time spent in the histories per packet.
+int RunPutGet(bool use_views) {
+  SimulatedClock clock(123456);
+  rtc::scoped_ptr<RTPPacketHistory> histories[kNumStreams];
+  for (int i = 0; i < kNumStreams; ++i) {
+    histories[i].reset(new RTPPacketHistory(&clock));
+    histories[i]->SetStorePacketsStatus(true, kHistorySize);
+  }
+  uint8_t packet[kMaxPacketLength] = {0};
+  uint8_t packet_out[kMaxPacketLength];
+
+  int64_t start = TickTime::MicrosecondTimestamp();
+  for (int i = 0; i < kNumPackets; ++i) {
+    RTPPacketHistory* history = histories[i % kNumStreams].get();
+    uint16_t seq_num = static_cast<uint16_t>(i / kNumStreams);
+    WriteSequenceNumber(seq_num, packet);
+    EXPECT_EQ(0, history->PutRTPPacket(packet, kPacketSize, kMaxPacketLength,
+                                       1, kAllowRetransmission));
+    bool nack = seq_num % kNackInterval == 0 && seq_num >= kNackDistance;
+    for (int send = 0; send < (nack ? 2 : 1); ++send) {
+      uint16_t send_seq_num = send == 0 ? seq_num : seq_num - kNackDistance;
+      size_t len;
+      int64_t time;
+      const uint8_t* data;
+      rtc::scoped_refptr<RtpPacketBuffer> view;
+      if (use_views) {
+        EXPECT_TRUE(history->GetPacketViewAndSetSendTime(
+            send_seq_num, 0, send > 0, &view, &len, &time));
+        data = view->data();
+      } else {
+        len = kMaxPacketLength;
+        EXPECT_TRUE(history->GetPacketAndSetSendTime(
+            send_seq_num, 0, send > 0, packet_out, &len, &time));
+        data = packet_out;
+      }
+      EXPECT_EQ(send_seq_num, (data[2] << 8) + data[3]);
+    }
+  }
+  int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start;
+  return static_cast<int>(1000 * elapsed_us / kNumPackets);
+}
+
+}  // namespace
+
+TEST(RtpPacketHistoryPerformanceTest, PutGet) {
+  webrtc::test::PrintResult("rtp_packet_history_put_get", "", "copy",
+                            RunPutGet(false), "ns", false);
+  webrtc::test::PrintResult("rtp_packet_history_put_get", "", "view",
+                            RunPutGet(true), "ns", false);
+}
+
+}  // namespace webrtc
@@ -271,4 +271,107 @@ TEST_F(RtpPacketHistoryTest, FullExpansion) {
   }
 }
 
+TEST_F(RtpPacketHistoryTest, GetRtpPacketView) {
+  hist_->SetStorePacketsStatus(true, 10);
+  size_t len = 0;
+  int64_t capture_time_ms = 1;
+  CreateRtpPacket(kSeqNum, kSsrc, kPayload, kTimestamp, packet_, &len);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                   capture_time_ms, kAllowRetransmission));
+
+  rtc::scoped_refptr<RtpPacketBuffer> view;
+  size_t len_out = 0;
+  int64_t time;
+  EXPECT_TRUE(hist_->GetPacketViewAndSetSendTime(kSeqNum, 0, false, &view,
+                                                 &len_out, &time));
+  ASSERT_TRUE(view.get() != NULL);
+  EXPECT_EQ(len, len_out);
+  EXPECT_EQ(capture_time_ms, time);
+  for (size_t i = 0; i < len; i++)  {
+    EXPECT_EQ(packet_[i], view->data()[i]);
+  }
+}
+
+TEST_F(RtpPacketHistoryTest, ViewOutlivesOverwrittenPacket) {
+  hist_->SetStorePacketsStatus(true, 10);
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  size_t len = 0;
+  CreateRtpPacket(kSeqNum, kSsrc, kPayload, kTimestamp, packet_, &len);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                   capture_time_ms, kAllowRetransmission));
+  rtc::scoped_refptr<RtpPacketBuffer> view;
+  size_t view_len = 0;
+  int64_t time;
+  EXPECT_TRUE(hist_->GetPacketViewAndSetSendTime(kSeqNum, 0, false, &view,
+                                                 &view_len, &time));
+
+  // Wrap around the history so that the slot of the first packet is reused.
+  for (int i = 1; i <= 10; ++i) {
+    len = 0;
+    CreateRtpPacket(kSeqNum + i, kSsrc + 1, kPayload, kTimestamp, packet_,
+                    &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                     capture_time_ms, kAllowRetransmission));
+    EXPECT_TRUE(hist_->SetSent(kSeqNum + i));
+  }
+  EXPECT_FALSE(hist_->HasRTPPacket(kSeqNum));
+  EXPECT_TRUE(hist_->HasRTPPacket(kSeqNum + 10));
+
+  // The view still holds the first packet.
+  EXPECT_EQ(kSeqNum, (view->data()[2] << 8) + view->data()[3]);
+  EXPECT_EQ(static_cast<uint8_t>(kSsrc), view->data()[11]);
+}
+
+TEST_F(RtpPacketHistoryTest, SequenceNumberWrapAndReordering) {
+  hist_->SetStorePacketsStatus(true, 10);
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  const uint16_t kSeqNums[] = {0xfffe, 0xffff, 1, 0, 3};
+  for (uint16_t seq_num : kSeqNums) {
+    size_t len = 0;
+    CreateRtpPacket(seq_num, kSsrc, kPayload, kTimestamp, packet_, &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                     capture_time_ms, kAllowRetransmission));
+  }
+  for (uint16_t seq_num : kSeqNums) {
+    size_t len = kMaxPacketLength;
+    int64_t time;
+    EXPECT_TRUE(hist_->GetPacketAndSetSendTime(seq_num, 0, false, packet_out_,
+                                               &len, &time));
+    EXPECT_EQ(seq_num, (packet_out_[2] << 8) + packet_out_[3]);
+  }
+  EXPECT_FALSE(hist_->HasRTPPacket(2));
+  EXPECT_FALSE(hist_->HasRTPPacket(4));
+}
+
+TEST_F(RtpPacketHistoryTest, DropsPacketOlderThanHistory) {
+  const size_t kHistorySize = 10;
+  hist_->SetStorePacketsStatus(true, kHistorySize);
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  for (uint16_t i = 0; i < kHistorySize; ++i) {
+    size_t len = 0;
+    CreateRtpPacket(kSeqNum + i, kSsrc, kPayload, kTimestamp, packet_, &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                     capture_time_ms, kAllowRetransmission));
+  }
+  // Just older than the oldest packet in the history.
+  size_t len = 0;
+  CreateRtpPacket(kSeqNum - 1, kSsrc, kPayload, kTimestamp, packet_, &len);
+  EXPECT_EQ(-1, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                    capture_time_ms, kAllowRetransmission));
+  EXPECT_FALSE(hist_->HasRTPPacket(kSeqNum - 1));
+
+  // The history still holds all packets and keeps its newest packet, so the
+  // next packet goes in after it.
+  for (uint16_t i = 0; i < kHistorySize; ++i)
+    EXPECT_TRUE(hist_->HasRTPPacket(kSeqNum + i));
+  len = 0;
+  CreateRtpPacket(kSeqNum + kHistorySize, kSsrc, kPayload, kTimestamp, packet_,
+                  &len);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                   capture_time_ms, kAllowRetransmission));
+  EXPECT_TRUE(hist_->HasRTPPacket(kSeqNum + kHistorySize));
+  for (uint16_t i = 1; i < kHistorySize; ++i)
+    EXPECT_TRUE(hist_->HasRTPPacket(kSeqNum + i));
+}
+
 }  // namespace webrtc
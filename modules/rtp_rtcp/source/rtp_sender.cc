@@ -530,18 +530,20 @@ size_t RTPSender::TrySendRedundantPayloads(size_t bytes_to_send) {
       return 0;
   }
 
-  uint8_t buffer[IP_PACKET_SIZE];
   int bytes_left = static_cast<int>(bytes_to_send);
   while (bytes_left > 0) {
+    rtc::scoped_refptr<RtpPacketBuffer> buffer;
     size_t length = bytes_left;
     int64_t capture_time_ms;
-    if (!packet_history_.GetBestFittingPacket(buffer, &length,
-                                              &capture_time_ms)) {
+    if (!packet_history_.GetBestFittingPacketView(&buffer, &length,
+                                                  &capture_time_ms)) {
       break;
     }
-    if (!PrepareAndSendPacket(buffer, length, capture_time_ms, true, false))
+    if (!PrepareAndSendPacket(buffer->data(), length, capture_time_ms, true,
+                              false)) {
       break;
-    RtpUtility::RtpHeaderParser rtp_parser(buffer, length);
+    }
+    RtpUtility::RtpHeaderParser rtp_parser(buffer->data(), length);
     RTPHeader rtp_header;
     rtp_parser.Parse(rtp_header);
     bytes_left -= static_cast<int>(length - rtp_header.headerLength);
@@ -662,18 +664,18 @@ bool RTPSender::StorePackets() const {
 }
 
 int32_t RTPSender::ReSendPacket(uint16_t packet_id, int64_t min_resend_time) {
-  size_t length = IP_PACKET_SIZE;
-  uint8_t data_buffer[IP_PACKET_SIZE];
+  rtc::scoped_refptr<RtpPacketBuffer> data_buffer;
+  size_t length = 0;
   int64_t capture_time_ms;
-  if (!packet_history_.GetPacketAndSetSendTime(packet_id, min_resend_time, true,
-                                               data_buffer, &length,
-                                               &capture_time_ms)) {
+  if (!packet_history_.GetPacketViewAndSetSendTime(packet_id, min_resend_time,
+                                                   true, &data_buffer, &length,
+                                                   &capture_time_ms)) {
     // Packet not found.
     return 0;
   }
 
   if (paced_sender_) {
-    RtpUtility::RtpHeaderParser rtp_parser(data_buffer, length);
+    RtpUtility::RtpHeaderParser rtp_parser(data_buffer->data(), length);
     RTPHeader header;
     if (!rtp_parser.Parse(header)) {
       assert(false);
@@ -695,7 +697,7 @@ int32_t RTPSender::ReSendPacket(uint16_t packet_id, int64_t min_resend_time) {
     CriticalSectionScoped lock(send_critsect_.get());
     rtx = rtx_;
   }
-  return PrepareAndSendPacket(data_buffer, length, capture_time_ms,
+  return PrepareAndSendPacket(data_buffer->data(), length, capture_time_ms,
                               (rtx & kRtxRetransmitted) > 0, true) ?
       static_cast<int32_t>(length) : -1;
 }
@@ -823,16 +825,16 @@ void RTPSender::UpdateNACKBitRate(uint32_t bytes, int64_t now) {
 bool RTPSender::TimeToSendPacket(uint16_t sequence_number,
                                  int64_t capture_time_ms,
                                  bool retransmission) {
-  size_t length = IP_PACKET_SIZE;
-  uint8_t data_buffer[IP_PACKET_SIZE];
+  rtc::scoped_refptr<RtpPacketBuffer> data_buffer;
+  size_t length = 0;
   int64_t stored_time_ms;
 
-  if (!packet_history_.GetPacketAndSetSendTime(sequence_number,
-                                               0,
-                                               retransmission,
-                                               data_buffer,
-                                               &length,
-                                               &stored_time_ms)) {
+  if (!packet_history_.GetPacketViewAndSetSendTime(sequence_number,
+                                                   0,
+                                                   retransmission,
+                                                   &data_buffer,
+                                                   &length,
+                                                   &stored_time_ms)) {
     // Packet cannot be found. Allow sending to continue.
     return true;
   }
@@ -844,20 +846,18 @@ bool RTPSender::TimeToSendPacket(uint16_t sequence_number,
     CriticalSectionScoped lock(send_critsect_.get());
     rtx = rtx_;
   }
-  return PrepareAndSendPacket(data_buffer,
+  return PrepareAndSendPacket(data_buffer->data(),
                               length,
                               capture_time_ms,
                               retransmission && (rtx & kRtxRetransmitted) > 0,
                               retransmission);
 }
 
-bool RTPSender::PrepareAndSendPacket(uint8_t* buffer,
+bool RTPSender::PrepareAndSendPacket(const uint8_t* buffer,
                                      size_t length,
                                      int64_t capture_time_ms,
                                      bool send_over_rtx,
                                      bool is_retransmit) {
-  uint8_t *buffer_to_send_ptr = buffer;
-
   RtpUtility::RtpHeaderParser rtp_parser(buffer, length);
   RTPHeader rtp_header;
   rtp_parser.Parse(rtp_header);
@@ -870,10 +870,14 @@ bool RTPSender::PrepareAndSendPacket(uint8_t* buffer,
       TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"), "PrepareAndSendPacket",
       "timestamp", rtp_header.timestamp, "seqnum", rtp_header.sequenceNumber);
 
-  uint8_t data_buffer_rtx[IP_PACKET_SIZE];
+  // |buffer| is shared with the packet history, so the header extensions are
+  // updated in a copy of the packet.
+  uint8_t data_buffer[IP_PACKET_SIZE];
+  uint8_t* buffer_to_send_ptr = data_buffer;
   if (send_over_rtx) {
-    BuildRtxPacket(buffer, &length, data_buffer_rtx);
-    buffer_to_send_ptr = data_buffer_rtx;
+    BuildRtxPacket(buffer, &length, data_buffer);
+  } else {
+    memcpy(data_buffer, buffer, length);
   }
 
   int64_t now_ms = clock_->TimeInMilliseconds();
@@ -1766,13 +1770,12 @@ int32_t RTPSender::SetFecParameters(
   return video_->SetFecParameters(delta_params, key_params);
 }
 
-void RTPSender::BuildRtxPacket(uint8_t* buffer, size_t* length,
+void RTPSender::BuildRtxPacket(const uint8_t* buffer, size_t* length,
                                uint8_t* buffer_rtx) {
   CriticalSectionScoped cs(send_critsect_.get());
   uint8_t* data_buffer_rtx = buffer_rtx;
   // Add RTX header.
-  RtpUtility::RtpHeaderParser rtp_parser(
-      reinterpret_cast<const uint8_t*>(buffer), *length);
+  RtpUtility::RtpHeaderParser rtp_parser(buffer, *length);
 
   RTPHeader rtp_header;
   rtp_parser.Parse(rtp_header);
@@ -23,6 +23,10 @@ namespace {
 // should be made, but Process() should be called directly.
 const int64_t kCallProcessImmediately = -1;
 
+// Used for modules that have not been queried with TimeUntilNextProcess yet.
+// Like kCallProcessImmediately, this sorts ahead of any real timestamp.
+const int64_t kQueryTimeUntilNextProcess = 0;
+
 int64_t GetNextCallbackTime(Module* module, int64_t time_now) {
   int64_t interval = module->TimeUntilNextProcess();
   // Currently some implementations erroneously return error codes from
@@ -44,7 +48,10 @@ rtc::scoped_ptr<ProcessThread> ProcessThread::Create() {
 }
 
 ProcessThreadImpl::ProcessThreadImpl()
-    : wake_up_(EventWrapper::Create()), stop_(false) {
+    : wake_up_(EventWrapper::Create()),
+      next_generation_(0),
+      processing_(false),
+      stop_(false) {
 }
 
 ProcessThreadImpl::~ProcessThreadImpl() {
@@ -58,6 +65,21 @@ ProcessThreadImpl::~ProcessThreadImpl() {
   }
 }
 
+void ProcessThreadImpl::Schedule(ModuleCallback* callback) {
+  callback->generation = ++next_generation_;
+  ScheduledCallback scheduled(callback->next_callback, callback->module,
+                              callback->generation);
+  if (processing_)
+    deferred_.push_back(scheduled);
+  else
+    schedule_.push(scheduled);
+}
+
+bool ProcessThreadImpl::IsCurrent(const ScheduledCallback& callback) const {
+  ModuleMap::const_iterator it = modules_.find(callback.module);
+  return it != modules_.end() && it->second.generation == callback.generation;
+}
+
 void ProcessThreadImpl::Start() {
   DCHECK(thread_checker_.CalledOnValidThread());
   DCHECK(!thread_.get());
@@ -66,8 +88,8 @@ void ProcessThreadImpl::Start() {
 
   DCHECK(!stop_);
 
-  for (ModuleCallback& m : modules_)
-    m.module->ProcessThreadAttached(this);
+  for (auto& m : modules_)
+    m.second.module->ProcessThreadAttached(this);
 
   thread_ = ThreadWrapper::CreateThread(
       &ProcessThreadImpl::Run, this, "ProcessThread");
@@ -90,17 +112,19 @@ void ProcessThreadImpl::Stop() {
   thread_.reset();
   stop_ = false;
 
-  for (ModuleCallback& m : modules_)
-    m.module->ProcessThreadAttached(nullptr);
+  for (auto& m : modules_)
+    m.second.module->ProcessThreadAttached(nullptr);
 }
 
 void ProcessThreadImpl::WakeUp(Module* module) {
   // Allowed to be called on any thread.
   {
     rtc::CritScope lock(&lock_);
-    for (ModuleCallback& m : modules_) {
-      if (m.module == module)
-        m.next_callback = kCallProcessImmediately;
+    ModuleMap::iterator it = modules_.find(module);
+    if (it != modules_.end() &&
+        it->second.next_callback != kCallProcessImmediately) {
+      it->second.next_callback = kCallProcessImmediately;
+      Schedule(&it->second);
     }
   }
   wake_up_->Set();
@@ -123,8 +147,7 @@ void ProcessThreadImpl::RegisterModule(Module* module) {
   {
     // Catch programmer error.
     rtc::CritScope lock(&lock_);
-    for (const ModuleCallback& mc : modules_)
-      DCHECK(mc.module != module);
+    DCHECK(modules_.find(module) == modules_.end());
   }
 #endif
 
@@ -136,7 +159,10 @@ void ProcessThreadImpl::RegisterModule(Module* module) {
 
   {
     rtc::CritScope lock(&lock_);
-    modules_.push_back(ModuleCallback(module));
+    ModuleCallback& callback = modules_.insert(
+        std::make_pair(module, ModuleCallback(module))).first->second;
+    callback.next_callback = kQueryTimeUntilNextProcess;
+    Schedule(&callback);
   }
 
   // Wake the thread calling ProcessThreadImpl::Process() to update the
@@ -150,9 +176,8 @@ void ProcessThreadImpl::DeRegisterModule(Module* module) {
   DCHECK(module);
   {
     rtc::CritScope lock(&lock_);
-    modules_.remove_if([&module](const ModuleCallback& m) {
-        return m.module == module;
-      });
+    // Entries left in |schedule_| for the module are skipped as stale.
+    modules_.erase(module);
   }
 
   // Notify the module that it's been detached, while not holding the lock.
@@ -173,27 +198,65 @@ bool ProcessThreadImpl::Process() {
     rtc::CritScope lock(&lock_);
     if (stop_)
       return false;
-    for (ModuleCallback& m : modules_) {
-      // TODO(tommi): Would be good to measure the time TimeUntilNextProcess
-      // takes and dcheck if it takes too long (e.g. >=10ms).  Ideally this
-      // operation should not require taking a lock, so querying all modules
-      // should run in a matter of nanoseconds.
-      if (m.next_callback == 0)
+    // Only modules that are due, were woken up or were just registered are
+    // at the top of the queue, so the remaining modules are not touched.
+    // Modules are rescheduled after the loop so that each one is processed
+    // at most once per iteration, even if it asks to be called right away or
+    // is woken up from within its Process().
+    processed_.clear();
+    processing_ = true;
+    while (!schedule_.empty() && schedule_.top().time <= now) {
+      ScheduledCallback scheduled = schedule_.top();
+      schedule_.pop();
+      if (!IsCurrent(scheduled))
+        continue;
+
+      ModuleCallback& m = modules_.find(scheduled.module)->second;
+      if (m.next_callback == kQueryTimeUntilNextProcess) {
+        // TODO(tommi): Would be good to measure the time TimeUntilNextProcess
+        // takes and dcheck if it takes too long (e.g. >=10ms).  Ideally this
+        // operation should not require taking a lock, so querying all modules
+        // should run in a matter of nanoseconds.
         m.next_callback = GetNextCallbackTime(m.module, now);
-
-      if (m.next_callback <= now ||
-          m.next_callback == kCallProcessImmediately) {
-        m.module->Process();
-        // Use a new 'now' reference to calculate when the next callback
-        // should occur.  We'll continue to use 'now' above for the baseline
-        // of calculating how long we should wait, to reduce variance.
-        int64_t new_now = TickTime::MillisecondTimestamp();
-        m.next_callback = GetNextCallbackTime(m.module, new_now);
+        if (m.next_callback > now) {
+          Schedule(&m);
+          continue;
+        }
       }
 
-      if (m.next_callback < next_checkpoint)
-        next_checkpoint = m.next_callback;
+      // Clear a pending wakeup, so that one from within Process() is seen.
+      m.next_callback = now;
+      // Process() may deregister the module, which invalidates |m|.
+      Module* module = m.module;
+      module->Process();
+      processed_.push_back(module);
     }
+    processing_ = false;
+    for (const ScheduledCallback& scheduled : deferred_)
+      schedule_.push(scheduled);
+    deferred_.clear();
+
+    for (Module* module : processed_) {
+      // Process() may have deregistered the module.
+      ModuleMap::iterator it = modules_.find(module);
+      if (it == modules_.end())
+        continue;
+      // If Process() woke the module up, it runs again on the next iteration.
+      if (it->second.next_callback == kCallProcessImmediately)
+        continue;
+      // Use a new 'now' reference to calculate when the next callback
+      // should occur.  We'll continue to use 'now' above for the baseline
+      // of calculating how long we should wait, to reduce variance.
+      int64_t new_now = TickTime::MillisecondTimestamp();
+      it->second.next_callback = GetNextCallbackTime(module, new_now);
+      Schedule(&it->second);
+    }
+
+    // Drop stale entries so they don't cause spurious wakeups.
+    while (!schedule_.empty() && !IsCurrent(schedule_.top()))
+      schedule_.pop();
+    if (!schedule_.empty() && schedule_.top().time < next_checkpoint)
+      next_checkpoint = schedule_.top().time;
 
     while (!queue_.empty()) {
       ProcessTask* task = queue_.front();
@@ -11,8 +11,10 @@
 #ifndef WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
 #define WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
 
-#include <list>
+#include <functional>
+#include <map>
 #include <queue>
+#include <vector>
 
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/thread_checker.h"
@@ -43,22 +45,57 @@ class ProcessThreadImpl : public ProcessThread {
 
  private:
   struct ModuleCallback {
-    ModuleCallback() : module(nullptr), next_callback(0) {}
+    ModuleCallback() : module(nullptr), next_callback(0), generation(0) {}
     ModuleCallback(const ModuleCallback& cb)
-        : module(cb.module), next_callback(cb.next_callback) {}
-    ModuleCallback(Module* module) : module(module), next_callback(0) {}
+        : module(cb.module),
+          next_callback(cb.next_callback),
+          generation(cb.generation) {}
+    ModuleCallback(Module* module)
+        : module(module), next_callback(0), generation(0) {}
     bool operator==(const ModuleCallback& cb) const {
       return cb.module == module;
     }
 
     Module* const module;
     int64_t next_callback;  // Absolute timestamp.
+    // Identifies the module's entry in |schedule_|. Changes every time the
+    // module is scheduled.
+    uint32_t generation;
 
    private:
     ModuleCallback& operator=(ModuleCallback&);
   };
 
-  typedef std::list<ModuleCallback> ModuleList;
+  // An entry in |schedule_|. Entries are not removed when a module is woken
+  // up or deregistered. Instead they become stale and are skipped once
+  // |generation| no longer matches the module's. Comparing times instead
+  // would revive an old entry whenever a module is rescheduled for the same
+  // millisecond.
+  struct ScheduledCallback {
+    ScheduledCallback(int64_t time, Module* module, uint32_t generation)
+        : time(time), module(module), generation(generation) {}
+    bool operator>(const ScheduledCallback& other) const {
+      return time > other.time;
+    }
+
+    int64_t time;
+    Module* module;
+    uint32_t generation;
+  };
+
+  typedef std::map<Module*, ModuleCallback> ModuleMap;
+  // Min-heap ordered by callback time, so that a wakeup only needs to look at
+  // the modules that are due instead of every registered module.
+  typedef std::priority_queue<ScheduledCallback,
+                              std::vector<ScheduledCallback>,
+                              std::greater<ScheduledCallback>> CallbackQueue;
+
+  // Adds an entry for |module| at its current |next_callback| time, making
+  // any earlier entry for it stale. While modules are being processed, the
+  // entry is held back in |deferred_| until the next iteration.
+  void Schedule(ModuleCallback* callback);
+  // Returns true if |callback| refers to the current schedule of a module.
+  bool IsCurrent(const ScheduledCallback& callback) const;
 
   // Warning: For some reason, if |lock_| comes immediately before |modules_|
   // with the current class layout, we will  start to have mysterious crashes
@@ -66,13 +103,27 @@ class ProcessThreadImpl : public ProcessThread {
   // issues, but I haven't figured out what they are, if there are alignment
   // requirements for mutexes on Mac or if there's something else to it.
   // So be careful with changing the layout.
-  rtc::CriticalSection lock_;  // Used to guard modules_, tasks_ and stop_.
+  // Used to guard modules_, schedule_, tasks_ and stop_.
+  rtc::CriticalSection lock_;
 
   rtc::ThreadChecker thread_checker_;
   const rtc::scoped_ptr<EventWrapper> wake_up_;
   rtc::scoped_ptr<ThreadWrapper> thread_;
 
-  ModuleList modules_;
+  ModuleMap modules_;
+  CallbackQueue schedule_;
+  // Source of ModuleCallback::generation. Shared by all modules so that a
+  // module that is deregistered and registered again does not revive the
+  // entries of its earlier registration.
+  uint32_t next_generation_;
+  // True while Process() runs the modules that are due.
+  bool processing_;
+  // Entries scheduled while |processing_|, e.g. by a module waking itself up
+  // from its Process().
+  std::vector<ScheduledCallback> deferred_;
+  // The modules run by an iteration of Process(). A member so that it is not
+  // reallocated on every iteration.
+  std::vector<Module*> processed_;
   // TODO(tommi): Support delayed tasks.
   std::queue<ProcessTask*> queue_;
   bool stop_;
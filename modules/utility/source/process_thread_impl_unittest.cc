@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/interface/module.h"
@@ -301,4 +303,134 @@ TEST(ProcessThreadImpl, PostTask) {
   thread.Stop();
 }
 
+// Exposes a single iteration of the worker loop so that it can be driven
+// without a thread.
+class ProcessThreadForTest : public ProcessThreadImpl {
+ public:
+  using ProcessThreadImpl::Process;
+};
+
+// Module that is due at fixed deadlines, regardless of how often Process() is
+// called in between.
+class DeadlineModule : public Module {
+ public:
+  DeadlineModule(int64_t first_deadline_ms, int64_t period_ms)
+      : deadline_ms_(first_deadline_ms),
+        period_ms_(period_ms),
+        process_count_(0) {}
+
+  int64_t TimeUntilNextProcess() override {
+    return std::max<int64_t>(
+        deadline_ms_ - TickTime::MillisecondTimestamp(), 0);
+  }
+  int32_t Process() override {
+    ++process_count_;
+    if (TickTime::MillisecondTimestamp() >= deadline_ms_)
+      deadline_ms_ += period_ms_;
+    return 0;
+  }
+  void ProcessThreadAttached(ProcessThread* process_thread) override {}
+
+  int64_t deadline_ms() const { return deadline_ms_; }
+  int process_count() const { return process_count_; }
+
+ private:
+  int64_t deadline_ms_;
+  const int64_t period_ms_;
+  int process_count_;
+};
+
+// Tests that a module that is woken up and then rescheduled for the deadline
+// it already had is still processed once per period.
+TEST(ProcessThreadImpl, WakeUpThenSameDeadline) {
+  const int64_t kPeriodMs = 20;
+  const int kNumPeriods = 5;
+  ProcessThreadForTest thread;
+  const int64_t first_deadline_ms =
+      TickTime::MillisecondTimestamp() + kPeriodMs;
+  DeadlineModule module(first_deadline_ms, kPeriodMs);
+  thread.RegisterModule(&module);
+  // Schedules the module at its first deadline.
+  thread.Process();
+  ASSERT_LT(TickTime::MillisecondTimestamp(), first_deadline_ms);
+
+  // Processes the module right away. Its deadline doesn't change, so it is
+  // scheduled for the same time again.
+  thread.WakeUp(&module);
+  thread.Process();
+  EXPECT_EQ(1, module.process_count());
+  EXPECT_EQ(first_deadline_ms, module.deadline_ms());
+
+  const int64_t end_ms =
+      first_deadline_ms + (kNumPeriods - 1) * kPeriodMs + kPeriodMs / 2;
+  while (TickTime::MillisecondTimestamp() < end_ms)
+    thread.Process();
+  EXPECT_EQ(1 + kNumPeriods, module.process_count());
+  thread.DeRegisterModule(&module);
+}
+
+// Module that is never due by itself, and that wakes itself up or
+// deregisters itself from within Process().
+class SelfSchedulingModule : public Module {
+ public:
+  SelfSchedulingModule(ProcessThread* thread, bool deregister)
+      : thread_(thread), deregister_(deregister), process_count_(0) {}
+
+  int64_t TimeUntilNextProcess() override { return 60 * 1000; }
+  int32_t Process() override {
+    ++process_count_;
+    if (deregister_)
+      thread_->DeRegisterModule(this);
+    else
+      thread_->WakeUp(this);
+    return 0;
+  }
+  void ProcessThreadAttached(ProcessThread* process_thread) override {}
+
+  int process_count() const { return process_count_; }
+
+ private:
+  ProcessThread* const thread_;
+  const bool deregister_;
+  int process_count_;
+};
+
+// Tests that a module waking itself up from Process() is processed once per
+// iteration rather than over and over in the same iteration.
+TEST(ProcessThreadImpl, WakeUpFromProcess) {
+  ProcessThreadForTest thread;
+  SelfSchedulingModule module(&thread, false);
+  thread.RegisterModule(&module);
+  // Queries the module.
+  thread.Process();
+  EXPECT_EQ(0, module.process_count());
+  thread.WakeUp(&module);
+  for (int i = 1; i <= 3; ++i) {
+    thread.Process();
+    EXPECT_EQ(i, module.process_count());
+  }
+  thread.DeRegisterModule(&module);
+}
+
+// Tests that a module can deregister itself from Process(), while another
+// module is processed in the same iteration.
+TEST(ProcessThreadImpl, DeregisterFromProcess) {
+  ProcessThreadForTest thread;
+  SelfSchedulingModule module(&thread, true);
+  SelfSchedulingModule other_module(&thread, false);
+  thread.RegisterModule(&module);
+  thread.RegisterModule(&other_module);
+  thread.Process();
+  thread.WakeUp(&module);
+  thread.WakeUp(&other_module);
+  thread.Process();
+  EXPECT_EQ(1, module.process_count());
+  EXPECT_EQ(1, other_module.process_count());
+  // The module is gone, while the other one woke itself up again.
+  thread.Process();
+  EXPECT_EQ(1, module.process_count());
+  EXPECT_EQ(2, other_module.process_count());
+  thread.DeRegisterModule(&other_module);
+}
+
 }  // namespace webrtc
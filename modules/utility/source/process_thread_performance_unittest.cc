@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/interface/module.h"
+#include "webrtc/modules/utility/source/process_thread_impl.h"
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+// Exposes a single iteration of the worker loop so that it can be timed
+// without a thread.
+class ProcessThreadForTest : public ProcessThreadImpl {
+ public:
+  using ProcessThreadImpl::Process;
+};
+
+// Module with a fixed callback interval that counts Process() calls.
+class FakeModule : public Module {
+ public:
+  explicit FakeModule(int64_t interval_ms)
+      : interval_ms_(interval_ms), process_count_(0) {}
+
+  int64_t TimeUntilNextProcess() override { return interval_ms_; }
+  int32_t Process() override {
+    ++process_count_;
+    return 0;
+  }
+  void ProcessThreadAttached(ProcessThread* process_thread) override {}
+
+  int process_count() const { return process_count_; }
+
+ private:
+  const int64_t interval_ms_;
+  int process_count_;
+};
+
+// Module that asks to be processed every |interval_ms| and then keeps the
+// thread busy for |work_us|, like the RTP/RTCP module of a loaded stream.
+// Records how late each Process() call is.
+class LoadedModule : public Module {
+ public:
+  LoadedModule(int64_t interval_ms, int64_t work_us)
+      : interval_ms_(interval_ms), work_us_(work_us), next_process_ms_(-1) {}
+
+  int64_t TimeUntilNextProcess() override {
+    if (next_process_ms_ < 0)
+      return 0;
+    return std::max<int64_t>(
+        next_process_ms_ - TickTime::MillisecondTimestamp(), 0);
+  }
+  int32_t Process() override {
+    int64_t now_ms = TickTime::MillisecondTimestamp();
+    if (next_process_ms_ >= 0)
+      delays_ms_.push_back(std::max<int64_t>(now_ms - next_process_ms_, 0));
+    next_process_ms_ = now_ms + interval_ms_;
+    int64_t done_us = TickTime::MicrosecondTimestamp() + work_us_;
+    while (TickTime::MicrosecondTimestamp() < done_us) {
+    }
+    return 0;
+  }
+  void ProcessThreadAttached(ProcessThread* process_thread) override {}
+
+  const std::vector<int64_t>& delays_ms() const { return delays_ms_; }
+
+ private:
+  const int64_t interval_ms_;
+  const int64_t work_us_;
+  int64_t next_process_ms_;
+  std::vector<int64_t> delays_ms_;
+};
+
+}  // namespace
+
+// Measures the overhead of one worker loop iteration when a single module is
+// due and all the others are idle. The cost should grow with the log of the
+// number of registered modules rather than linearly.
+TEST(ProcessThreadPerformanceTest, PerTickOverhead) {
+  const int kNumIdleModules[] = {10, 100, 1000};
+  const int kIterations = 10000;
+  for (int num_idle_modules : kNumIdleModules) {
+    ProcessThreadForTest thread;
+    ScopedVector<FakeModule> idle_modules;
+    for (int i = 0; i < num_idle_modules; ++i) {
+      idle_modules.push_back(new FakeModule(60 * 1000));
+      thread.RegisterModule(idle_modules.back());
+    }
+    FakeModule busy_module(0);
+    thread.RegisterModule(&busy_module);
+    // Let the thread query all modules once.
+    thread.Process();
+
+    int64_t start = TickTime::MicrosecondTimestamp();
+    for (int i = 0; i < kIterations; ++i)
+      thread.Process();
+    int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start;
+
+    EXPECT_GE(busy_module.process_count(), kIterations);
+    for (FakeModule* module : idle_modules) {
+      EXPECT_EQ(0, module->process_count());
+      thread.DeRegisterModule(module);
+    }
+    thread.DeRegisterModule(&busy_module);
+
+    std::ostringstream trace;
+    trace << num_idle_modules << "_idle_modules";
+    webrtc::test::PrintResult("process_thread_tick", "", trace.str(),
+                              static_cast<size_t>(1000 * elapsed_us /
+                                                  kIterations),
+                              "ns", false);
+  }
+}
+
+// Runs 200 streams that together need most of a core and spreads them over an
+// increasing number of threads by stream index, the way ChannelGroup spreads
+// channels by id. Reports how late Process() gets called. The maximum
+// depends on scheduling noise, so only the 99th percentile is checked, and
+// loosely.
+TEST(ProcessThreadPerformanceTest, ShardedProcessLateness) {
+  const int kNumStreams = 200;
+  const int64_t kIntervalMs = 10;
+  const int64_t kWorkUs = 40;
+  const int kRunTimeMs = 500;
+  const int kNumThreads[] = {1, 2, 4, 8};
+  for (int num_threads : kNumThreads) {
+    ScopedVector<ProcessThreadImpl> threads;
+    for (int i = 0; i < num_threads; ++i)
+      threads.push_back(new ProcessThreadImpl());
+    ScopedVector<LoadedModule> modules;
+    for (int i = 0; i < kNumStreams; ++i) {
+      modules.push_back(new LoadedModule(kIntervalMs, kWorkUs));
+      threads[i % num_threads]->RegisterModule(modules.back());
+    }
+
+    for (ProcessThreadImpl* thread : threads)
+      thread->Start();
+    SleepMs(kRunTimeMs);
+    for (ProcessThreadImpl* thread : threads)
+      thread->Stop();
+    for (int i = 0; i < kNumStreams; ++i)
+      threads[i % num_threads]->DeRegisterModule(modules[i]);
+
+    std::vector<int64_t> delays_ms;
+    for (LoadedModule* module : modules) {
+      EXPECT_FALSE(module->delays_ms().empty());
+      delays_ms.insert(delays_ms.end(), module->delays_ms().begin(),
+                       module->delays_ms().end());
+    }
+    ASSERT_FALSE(delays_ms.empty());
+    std::sort(delays_ms.begin(), delays_ms.end());
+    const int64_t delay_99th_ms = delays_ms[delays_ms.size() * 99 / 100];
+    if (num_threads <= static_cast<int>(CpuInfo::DetectNumberOfCores())) {
+      EXPECT_LT(delay_99th_ms, 5 * kIntervalMs) << num_threads << " threads";
+    }
+
+    std::ostringstream trace;
+    trace << num_threads << "_threads";
+    webrtc::test::PrintResult("process_thread_lateness_99th_percentile", "",
+                              trace.str(), static_cast<size_t>(delay_99th_ms),
+                              "ms", false);
+    webrtc::test::PrintResult("process_thread_lateness_max", "", trace.str(),
+                              static_cast<size_t>(delays_ms.back()), "ms",
+                              false);
+  }
+}
+
+}  // namespace webrtc
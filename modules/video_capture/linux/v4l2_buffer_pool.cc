@@ -0,0 +1,145 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_capture/linux/v4l2_buffer_pool.h"
+
+#include <linux/videodev2.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+
+namespace webrtc {
+namespace videocapturemodule {
+
+// I420 frame backed by a mapped capture buffer. The planes are laid out
+// back to back, with the chroma planes at half the luma stride.
+class V4L2BufferPool::WrappedBuffer : public VideoFrameBuffer {
+ public:
+  WrappedBuffer(const rtc::scoped_refptr<V4L2BufferPool>& pool,
+                int index,
+                int width,
+                int height)
+      : pool_(pool), index_(index), width_(width), height_(height) {}
+
+ private:
+  friend class rtc::RefCountedObject<WrappedBuffer>;
+  ~WrappedBuffer() override { pool_->ReturnBuffer(index_); }
+
+  int width() const override { return width_; }
+  int height() const override { return height_; }
+  const uint8_t* data(PlaneType type) const override {
+    const uint8_t* y_plane =
+        static_cast<const uint8_t*>(pool_->buffer(index_).start);
+    const int chroma_size = stride(kUPlane) * ((height_ + 1) / 2);
+    switch (type) {
+      case kYPlane:
+        return y_plane;
+      case kUPlane:
+        return y_plane + stride(kYPlane) * height_;
+      case kVPlane:
+        return y_plane + stride(kYPlane) * height_ + chroma_size;
+      default:
+        RTC_NOTREACHED();
+        return nullptr;
+    }
+  }
+  uint8_t* data(PlaneType type) override {
+    DCHECK(HasOneRef());
+    const WrappedBuffer* cbuffer = this;
+    return const_cast<uint8_t*>(cbuffer->data(type));
+  }
+  int stride(PlaneType type) const override {
+    return type == kYPlane ? width_ : (width_ + 1) / 2;
+  }
+  rtc::scoped_refptr<NativeHandle> native_handle() const override {
+    return nullptr;
+  }
+
+  const rtc::scoped_refptr<V4L2BufferPool> pool_;
+  const int index_;
+  const int width_;
+  const int height_;
+};
+
+V4L2BufferPool::V4L2BufferPool(int fd, const std::vector<Buffer>& buffers)
+    : fd_(fd),
+      buffers_(buffers),
+      crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      num_wrapped_buffers_(0),
+      stopped_(false) {
+}
+
+V4L2BufferPool::~V4L2BufferPool() {
+  for (size_t i = 0; i < buffers_.size(); ++i)
+    munmap(buffers_[i].start, buffers_[i].length);
+}
+
+rtc::scoped_refptr<VideoFrameBuffer> V4L2BufferPool::WrapI420Buffer(
+    int index,
+    int width,
+    int height) {
+  DCHECK_GE(index, 0);
+  DCHECK_LT(static_cast<size_t>(index), buffers_.size());
+  const size_t chroma_size = ((width + 1) / 2) * ((height + 1) / 2);
+  if (buffers_[index].length <
+      static_cast<size_t>(width * height) + 2 * chroma_size) {
+    return nullptr;
+  }
+  {
+    CriticalSectionScoped cs(crit_sect_.get());
+    // The buffer itself has already been dequeued.
+    const int num_queued_buffers =
+        static_cast<int>(buffers_.size()) - num_wrapped_buffers_ - 1;
+    if (stopped_ || num_queued_buffers < kMinQueuedBuffers)
+      return nullptr;
+    ++num_wrapped_buffers_;
+  }
+  return new rtc::RefCountedObject<WrappedBuffer>(this, index, width, height);
+}
+
+bool V4L2BufferPool::QueueBuffer(int index) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  if (stopped_)
+    return false;
+  return EnqueueBuffer(index);
+}
+
+void V4L2BufferPool::Stop() {
+  CriticalSectionScoped cs(crit_sect_.get());
+  stopped_ = true;
+}
+
+int V4L2BufferPool::num_wrapped_buffers() const {
+  CriticalSectionScoped cs(crit_sect_.get());
+  return num_wrapped_buffers_;
+}
+
+bool V4L2BufferPool::EnqueueBuffer(int index) {
+  struct v4l2_buffer buffer;
+  memset(&buffer, 0, sizeof(v4l2_buffer));
+  buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  buffer.memory = V4L2_MEMORY_MMAP;
+  buffer.index = index;
+  return ioctl(fd_, VIDIOC_QBUF, &buffer) != -1;
+}
+
+void V4L2BufferPool::ReturnBuffer(int index) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  --num_wrapped_buffers_;
+  // The device may already have been closed, and its descriptor reused.
+  if (!stopped_)
+    EnqueueBuffer(index);
+}
+
+}  // namespace videocapturemodule
+}  // namespace webrtc
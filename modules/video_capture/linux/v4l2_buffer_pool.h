@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CAPTURE_LINUX_V4L2_BUFFER_POOL_H_
+#define WEBRTC_MODULES_VIDEO_CAPTURE_LINUX_V4L2_BUFFER_POOL_H_
+
+#include <vector>
+
+#include "webrtc/base/refcount.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/scoped_ref_ptr.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/common_video/interface/video_frame_buffer.h"
+
+namespace webrtc {
+class CriticalSectionWrapper;
+namespace videocapturemodule {
+
+// The memory-mapped capture buffers of a V4L2 device. A dequeued buffer that
+// holds an I420 frame can be handed out without a copy by wrapping it in a
+// VideoFrameBuffer, which queues it to the device again once the last
+// reference to it goes away. Wrapped buffers keep the pool, and thereby the
+// mappings, alive, so capture can be stopped while frames are still in use.
+class V4L2BufferPool : public rtc::RefCountInterface {
+ public:
+  // A buffer should only be handed out if the device is left with at least
+  // this many buffers to capture into.
+  static const int kMinQueuedBuffers = 2;
+
+  struct Buffer {
+    void* start;
+    size_t length;
+  };
+
+  // |buffers| have been mapped from the device |fd| and are all queued to it.
+  // The pool unmaps them when destroyed but does not close |fd|, which must
+  // stay open until Stop() has been called.
+  V4L2BufferPool(int fd, const std::vector<Buffer>& buffers);
+
+  // Returns the mapping of buffer |index|.
+  const Buffer& buffer(int index) const { return buffers_[index]; }
+
+  // Wraps the I420 frame in the dequeued buffer |index|. Returns NULL if the
+  // buffer is too small for the frame, or if handing it out would leave the
+  // device with fewer than |kMinQueuedBuffers| buffers. The caller should
+  // then copy the frame and queue the buffer again with QueueBuffer().
+  rtc::scoped_refptr<VideoFrameBuffer> WrapI420Buffer(int index,
+                                                      int width,
+                                                      int height);
+
+  // Queues the dequeued buffer |index| to the device again.
+  bool QueueBuffer(int index);
+
+  // Called before the device is closed. Wrapped buffers released after this
+  // are not queued to the device again.
+  void Stop();
+
+  // The number of wrapped buffers that have not been released yet.
+  int num_wrapped_buffers() const;
+
+ protected:
+  ~V4L2BufferPool() override;
+
+  // Issues VIDIOC_QBUF for buffer |index|. Virtual so that tests can run the
+  // pool without a device.
+  virtual bool EnqueueBuffer(int index);
+
+ private:
+  class WrappedBuffer;
+
+  // Called by WrappedBuffer when its last reference is released.
+  void ReturnBuffer(int index);
+
+  const int fd_;
+  const std::vector<Buffer> buffers_;
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  int num_wrapped_buffers_ GUARDED_BY(crit_sect_);
+  bool stopped_ GUARDED_BY(crit_sect_);
+};
+
+}  // namespace videocapturemodule
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CAPTURE_LINUX_V4L2_BUFFER_POOL_H_
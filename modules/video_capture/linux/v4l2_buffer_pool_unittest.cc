@@ -0,0 +1,212 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+#include <sys/mman.h>
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_video/interface/i420_video_frame.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_capture/linux/v4l2_buffer_pool.h"
+#include "webrtc/modules/video_capture/video_capture_impl.h"
+#include "webrtc/system_wrappers/interface/ref_count.h"
+
+namespace webrtc {
+namespace videocapturemodule {
+namespace {
+
+const int kNumBuffers = 4;
+const int kWidth = 1280;
+const int kHeight = 720;
+
+// Stands in for a V4L2 device: the buffers are anonymous mappings, and
+// buffers queued to the "device" are recorded instead.
+class FakeV4L2BufferPool : public V4L2BufferPool {
+ public:
+  explicit FakeV4L2BufferPool(const std::vector<Buffer>& buffers)
+      : V4L2BufferPool(-1, buffers) {}
+
+  static rtc::scoped_refptr<FakeV4L2BufferPool> Create(size_t buffer_size) {
+    std::vector<Buffer> buffers(kNumBuffers);
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      buffers[i].start = mmap(NULL, buffer_size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      buffers[i].length = buffer_size;
+      memset(buffers[i].start, static_cast<int>(i), buffer_size);
+    }
+    return new rtc::RefCountedObject<FakeV4L2BufferPool>(buffers);
+  }
+
+  std::vector<int> queued_buffers;
+
+ protected:
+  bool EnqueueBuffer(int index) override {
+    queued_buffers.push_back(index);
+    return true;
+  }
+};
+
+// Capture module feeding frames from a FakeV4L2BufferPool, the way
+// VideoCaptureModuleV4L2 does.
+class FakeV4L2CaptureModule : public VideoCaptureImpl {
+ public:
+  explicit FakeV4L2CaptureModule(int32_t id) : VideoCaptureImpl(id) {}
+
+  void CaptureFrame(V4L2BufferPool* pool, int index, bool zero_copy) {
+    rtc::scoped_refptr<VideoFrameBuffer> buffer;
+    if (zero_copy)
+      buffer = pool->WrapI420Buffer(index, kWidth, kHeight);
+    if (!buffer || IncomingI420Buffer(buffer) != 0) {
+      VideoCaptureCapability frame_info;
+      frame_info.width = kWidth;
+      frame_info.height = kHeight;
+      frame_info.rawType = kVideoI420;
+      IncomingFrame(static_cast<uint8_t*>(pool->buffer(index).start),
+                    CalcBufferSize(kI420, kWidth, kHeight), frame_info);
+      if (!buffer)
+        pool->QueueBuffer(index);
+    }
+  }
+};
+
+// Keeps the frames delivered by the capture module.
+class FrameRecordingCallback : public VideoCaptureDataCallback {
+ public:
+  void OnIncomingCapturedFrame(const int32_t id,
+                               const I420VideoFrame& frame) override {
+    frames_.push_back(frame);
+  }
+  void OnCaptureDelayChanged(const int32_t id, const int32_t delay) override {}
+
+  std::vector<I420VideoFrame>* frames() { return &frames_; }
+
+ private:
+  std::vector<I420VideoFrame> frames_;
+};
+
+class V4L2BufferPoolTest : public ::testing::Test {
+ protected:
+  V4L2BufferPoolTest()
+      : pool_(FakeV4L2BufferPool::Create(
+            CalcBufferSize(kI420, kWidth, kHeight))) {}
+
+  // Delivers |num_frames| through the capture module, keeping at most one
+  // frame referenced at a time. Checks that each frame holds the contents of
+  // its buffer, and that it wraps the buffer itself only for |zero_copy|.
+  void CaptureFrames(bool zero_copy, int num_frames) {
+    RefCountImpl<FakeV4L2CaptureModule>* module =
+        new RefCountImpl<FakeV4L2CaptureModule>(0);
+    module->AddRef();
+    FrameRecordingCallback callback;
+    module->RegisterCaptureDataCallback(callback);
+    for (int i = 0; i < num_frames; ++i) {
+      const int index = i % kNumBuffers;
+      callback.frames()->clear();
+      module->CaptureFrame(pool_.get(), index, zero_copy);
+      ASSERT_EQ(1u, callback.frames()->size());
+      const I420VideoFrame& frame = callback.frames()->back();
+      EXPECT_EQ(index, frame.buffer(kVPlane)[kWidth * kHeight / 4 - 1]);
+      EXPECT_EQ(zero_copy, pool_->buffer(index).start == frame.buffer(kYPlane));
+    }
+    module->DeRegisterCaptureDataCallback();
+    module->Release();
+  }
+
+  rtc::scoped_refptr<FakeV4L2BufferPool> pool_;
+};
+
+TEST_F(V4L2BufferPoolTest, WrapsMappedBuffer) {
+  rtc::scoped_refptr<VideoFrameBuffer> buffer =
+      pool_->WrapI420Buffer(1, kWidth, kHeight);
+  ASSERT_TRUE(buffer.get() != NULL);
+  const uint8_t* start = static_cast<uint8_t*>(pool_->buffer(1).start);
+  const VideoFrameBuffer* const_buffer = buffer.get();
+  EXPECT_EQ(kWidth, buffer->width());
+  EXPECT_EQ(kHeight, buffer->height());
+  EXPECT_EQ(kWidth, buffer->stride(kYPlane));
+  EXPECT_EQ(kWidth / 2, buffer->stride(kUPlane));
+  EXPECT_EQ(kWidth / 2, buffer->stride(kVPlane));
+  EXPECT_EQ(start, const_buffer->data(kYPlane));
+  EXPECT_EQ(start + kWidth * kHeight, const_buffer->data(kUPlane));
+  EXPECT_EQ(start + kWidth * kHeight * 5 / 4, const_buffer->data(kVPlane));
+}
+
+TEST_F(V4L2BufferPoolTest, QueuesBufferWhenLastFrameIsReleased) {
+  I420VideoFrame frame(pool_->WrapI420Buffer(2, kWidth, kHeight), 0, 0,
+                       kVideoRotation_0);
+  ASSERT_FALSE(frame.IsZeroSize());
+  I420VideoFrame copy;
+  copy.ShallowCopy(frame);
+  EXPECT_EQ(1, pool_->num_wrapped_buffers());
+
+  frame.Reset();
+  EXPECT_TRUE(pool_->queued_buffers.empty());
+  copy.Reset();
+  ASSERT_EQ(1u, pool_->queued_buffers.size());
+  EXPECT_EQ(2, pool_->queued_buffers[0]);
+  EXPECT_EQ(0, pool_->num_wrapped_buffers());
+}
+
+TEST_F(V4L2BufferPoolTest, LeavesMinimumNumberOfBuffersQueued) {
+  rtc::scoped_refptr<VideoFrameBuffer> buffer0 =
+      pool_->WrapI420Buffer(0, kWidth, kHeight);
+  rtc::scoped_refptr<VideoFrameBuffer> buffer1 =
+      pool_->WrapI420Buffer(1, kWidth, kHeight);
+  EXPECT_TRUE(buffer0.get() != NULL);
+  EXPECT_TRUE(buffer1.get() != NULL);
+  EXPECT_TRUE(pool_->WrapI420Buffer(2, kWidth, kHeight).get() == NULL);
+
+  buffer0 = NULL;
+  EXPECT_TRUE(pool_->WrapI420Buffer(2, kWidth, kHeight).get() != NULL);
+}
+
+TEST_F(V4L2BufferPoolTest, RejectsTooSmallBuffer) {
+  EXPECT_TRUE(pool_->WrapI420Buffer(0, kWidth, kHeight + 2).get() == NULL);
+  EXPECT_EQ(0, pool_->num_wrapped_buffers());
+}
+
+TEST_F(V4L2BufferPoolTest, KeepsMappingAfterStop) {
+  rtc::scoped_refptr<VideoFrameBuffer> buffer0 =
+      pool_->WrapI420Buffer(0, kWidth, kHeight);
+  rtc::scoped_refptr<VideoFrameBuffer> buffer3 =
+      pool_->WrapI420Buffer(3, kWidth, kHeight);
+  ASSERT_TRUE(buffer0.get() != NULL);
+  ASSERT_TRUE(buffer3.get() != NULL);
+  pool_->Stop();
+  EXPECT_TRUE(pool_->WrapI420Buffer(1, kWidth, kHeight).get() == NULL);
+  EXPECT_FALSE(pool_->QueueBuffer(1));
+  buffer0 = NULL;
+  EXPECT_TRUE(pool_->queued_buffers.empty());
+
+  // The remaining wrapped buffer keeps the mappings alive.
+  pool_ = NULL;
+  const VideoFrameBuffer* const_buffer = buffer3.get();
+  EXPECT_EQ(3, const_buffer->data(kVPlane)[kWidth * kHeight / 4 - 1]);
+}
+
+TEST_F(V4L2BufferPoolTest, CapturesWithCopy) {
+  const int kNumFrames = 10;
+  CaptureFrames(false, kNumFrames);
+  EXPECT_EQ(static_cast<size_t>(kNumFrames), pool_->queued_buffers.size());
+  EXPECT_EQ(0, pool_->num_wrapped_buffers());
+}
+
+TEST_F(V4L2BufferPoolTest, CapturesWithoutCopy) {
+  const int kNumFrames = 10;
+  CaptureFrames(true, kNumFrames);
+  EXPECT_EQ(static_cast<size_t>(kNumFrames), pool_->queued_buffers.size());
+  EXPECT_EQ(0, pool_->num_wrapped_buffers());
+}
+
+}  // namespace
+}  // namespace videocapturemodule
+}  // namespace webrtc
@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+#include <sys/mman.h>
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_video/interface/i420_video_frame.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_capture/linux/v4l2_buffer_pool.h"
+#include "webrtc/modules/video_capture/video_capture_impl.h"
+#include "webrtc/system_wrappers/interface/ref_count.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace videocapturemodule {
+namespace {
+
+const int kNumBuffers = 4;
+const int kWidth = 1280;
+const int kHeight = 720;
+const int kNumFrames = 300;
+
+// Stands in for a V4L2 device: the buffers are anonymous mappings, and
+// queuing a buffer to the "device" does nothing.
+class FakeV4L2BufferPool : public V4L2BufferPool {
+ public:
+  explicit FakeV4L2BufferPool(const std::vector<Buffer>& buffers)
+      : V4L2BufferPool(-1, buffers) {}
+
+  static rtc::scoped_refptr<FakeV4L2BufferPool> Create(size_t buffer_size) {
+    std::vector<Buffer> buffers(kNumBuffers);
+    for (Buffer& buffer : buffers) {
+      buffer.start = mmap(NULL, buffer_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      buffer.length = buffer_size;
+      memset(buffer.start, 0, buffer_size);
+    }
+    return new rtc::RefCountedObject<FakeV4L2BufferPool>(buffers);
+  }
+
+ protected:
+  bool EnqueueBuffer(int index) override { return true; }
+};
+
+// Capture module feeding frames from a V4L2BufferPool, the way
+// VideoCaptureModuleV4L2 does.
+class FakeV4L2CaptureModule : public VideoCaptureImpl {
+ public:
+  explicit FakeV4L2CaptureModule(int32_t id) : VideoCaptureImpl(id) {}
+
+  void CaptureFrame(V4L2BufferPool* pool, int index, bool zero_copy) {
+    rtc::scoped_refptr<VideoFrameBuffer> buffer;
+    if (zero_copy)
+      buffer = pool->WrapI420Buffer(index, kWidth, kHeight);
+    if (!buffer || IncomingI420Buffer(buffer) != 0) {
+      VideoCaptureCapability frame_info;
+      frame_info.width = kWidth;
+      frame_info.height = kHeight;
+      frame_info.rawType = kVideoI420;
+      IncomingFrame(static_cast<uint8_t*>(pool->buffer(index).start),
+                    CalcBufferSize(kI420, kWidth, kHeight), frame_info);
+      if (!buffer)
+        pool->QueueBuffer(index);
+    }
+  }
+};
+
+// Measures the time from a buffer being dequeued until its frame reaches the
+// module's consumer, which is where ViECapturer hands it on to the encoder.
+class LatencyMeasuringCallback : public VideoCaptureDataCallback {
+ public:
+  LatencyMeasuringCallback() : captured_us_(0), total_latency_us_(0) {}
+
+  void FrameDequeued() { captured_us_ = TickTime::MicrosecondTimestamp(); }
+
+  void OnIncomingCapturedFrame(const int32_t id,
+                               const I420VideoFrame& frame) override {
+    total_latency_us_ += TickTime::MicrosecondTimestamp() - captured_us_;
+    frames_.push_back(frame);
+  }
+  void OnCaptureDelayChanged(const int32_t id, const int32_t delay) override {}
+
+  int64_t total_latency_us() const { return total_latency_us_; }
+  std::vector<I420VideoFrame>* frames() { return &frames_; }
+
+ private:
+  int64_t captured_us_;
+  int64_t total_latency_us_;
+  std::vector<I420VideoFrame> frames_;
+};
+
+// Delivers |kNumFrames| 720p frames through the capture module, keeping at
+// most one frame referenced at a time, and returns the average latency.
+size_t MeasureCaptureLatencyUs(bool zero_copy) {
+  rtc::scoped_refptr<FakeV4L2BufferPool> pool(
+      FakeV4L2BufferPool::Create(CalcBufferSize(kI420, kWidth, kHeight)));
+  RefCountImpl<FakeV4L2CaptureModule>* module =
+      new RefCountImpl<FakeV4L2CaptureModule>(0);
+  module->AddRef();
+  LatencyMeasuringCallback callback;
+  module->RegisterCaptureDataCallback(callback);
+  for (int i = 0; i < kNumFrames; ++i) {
+    callback.frames()->clear();
+    callback.FrameDequeued();
+    module->CaptureFrame(pool.get(), i % kNumBuffers, zero_copy);
+    EXPECT_EQ(1u, callback.frames()->size());
+  }
+  module->DeRegisterCaptureDataCallback();
+  module->Release();
+  return static_cast<size_t>(callback.total_latency_us() / kNumFrames);
+}
+
+}  // namespace
+
+TEST(V4L2CapturePerformanceTest, CaptureToEncoderLatency) {
+  webrtc::test::PrintResult("capture_to_encoder_latency", "", "copy",
+                            MeasureCaptureLatencyUs(false), "us", false);
+  webrtc::test::PrintResult("capture_to_encoder_latency", "", "zero_copy",
+                            MeasureCaptureLatencyUs(true), "us", false);
+}
+
+}  // namespace videocapturemodule
+}  // namespace webrtc
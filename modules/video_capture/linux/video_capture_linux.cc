@@ -20,6 +20,7 @@
 
 #include <iostream>
 #include <new>
+#include <vector>
 
 #include "webrtc/modules/video_capture/linux/video_capture_linux.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
@@ -56,7 +57,7 @@ VideoCaptureModuleV4L2::VideoCaptureModuleV4L2(const int32_t id)
       _currentFrameRate(-1),
       _captureStarted(false),
       _captureVideoType(kVideoI420),
-      _pool(NULL)
+      _zeroCopy(false)
 {
 }
 
@@ -231,6 +232,11 @@ int32_t VideoCaptureModuleV4L2::StartCapture(
     // initialize current width and height
     _currentWidth = video_fmt.fmt.pix.width;
     _currentHeight = video_fmt.fmt.pix.height;
+    // I420 frames with unpadded rows can be wrapped as they are.
+    _zeroCopy = _captureVideoType == kVideoI420 &&
+                (video_fmt.fmt.pix.bytesperline == 0 ||
+                 video_fmt.fmt.pix.bytesperline ==
+                     video_fmt.fmt.pix.width);
     _captureDelay = 120;
 
     // Trying to set frame rate, before check driver capability.
@@ -345,7 +351,7 @@ bool VideoCaptureModuleV4L2::AllocateVideoBuffers()
     _buffersAllocatedByDevice = rbuffer.count;
 
     //Map the buffers
-    _pool = new Buffer[rbuffer.count];
+    std::vector<V4L2BufferPool::Buffer> buffers(rbuffer.count);
 
     for (unsigned int i = 0; i < rbuffer.count; i++)
     {
@@ -360,33 +366,33 @@ bool VideoCaptureModuleV4L2::AllocateVideoBuffers()
             return false;
         }
 
-        _pool[i].start = mmap(NULL, buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED,
-                              _deviceFd, buffer.m.offset);
+        buffers[i].start = mmap(NULL, buffer.length, PROT_READ | PROT_WRITE,
+                                MAP_SHARED, _deviceFd, buffer.m.offset);
 
-        if (MAP_FAILED == _pool[i].start)
+        if (MAP_FAILED == buffers[i].start)
         {
             for (unsigned int j = 0; j < i; j++)
-                munmap(_pool[j].start, _pool[j].length);
+                munmap(buffers[j].start, buffers[j].length);
             return false;
         }
 
-        _pool[i].length = buffer.length;
+        buffers[i].length = buffer.length;
 
         if (ioctl(_deviceFd, VIDIOC_QBUF, &buffer) < 0)
         {
             return false;
         }
     }
+    _pool = new rtc::RefCountedObject<V4L2BufferPool>(_deviceFd, buffers);
     return true;
 }
 
 bool VideoCaptureModuleV4L2::DeAllocateVideoBuffers()
 {
-    // unmap buffers
-    for (int i = 0; i < _buffersAllocatedByDevice; i++)
-        munmap(_pool[i].start, _pool[i].length);
-
-    delete[] _pool;
+    // The buffers are unmapped once the last frame wrapping one of them has
+    // been released.
+    _pool->Stop();
+    _pool = NULL;
 
     // turn off stream
     enum v4l2_buf_type type;
@@ -464,14 +470,28 @@ bool VideoCaptureModuleV4L2::CaptureProcess()
         frameInfo.height = _currentHeight;
         frameInfo.rawType = _captureVideoType;
 
-        // convert to to I420 if needed
-        IncomingFrame((unsigned char*) _pool[buf.index].start,
-                      buf.bytesused, frameInfo);
-        // enqueue the buffer again
-        if (ioctl(_deviceFd, VIDIOC_QBUF, &buf) == -1)
+        // Deliver the mapped buffer as is if possible. It is enqueued again
+        // once the last frame referencing it has been released.
+        rtc::scoped_refptr<VideoFrameBuffer> buffer;
+        if (_zeroCopy &&
+            buf.bytesused ==
+                CalcBufferSize(kI420, _currentWidth, _currentHeight))
+        {
+            buffer = _pool->WrapI420Buffer(buf.index, _currentWidth,
+                                           _currentHeight);
+        }
+        if (!buffer || IncomingI420Buffer(buffer) != 0)
         {
-            WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceVideoCapture, _id,
-                       "Failed to enqueue capture buffer");
+            // convert to to I420 if needed
+            IncomingFrame(
+                static_cast<unsigned char*>(_pool->buffer(buf.index).start),
+                buf.bytesused, frameInfo);
+            // enqueue the buffer again
+            if (!buffer && !_pool->QueueBuffer(buf.index))
+            {
+                WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceVideoCapture,
+                             _id, "Failed to enqueue capture buffer");
+            }
         }
     }
     _captureCritSect->Leave();
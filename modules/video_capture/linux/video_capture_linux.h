@@ -11,7 +11,9 @@
 #ifndef WEBRTC_MODULES_VIDEO_CAPTURE_MAIN_SOURCE_LINUX_VIDEO_CAPTURE_LINUX_H_
 #define WEBRTC_MODULES_VIDEO_CAPTURE_MAIN_SOURCE_LINUX_VIDEO_CAPTURE_LINUX_H_
 
+#include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/common_types.h"
+#include "webrtc/modules/video_capture/linux/v4l2_buffer_pool.h"
 #include "webrtc/modules/video_capture/video_capture_impl.h"
 #include "webrtc/system_wrappers/interface/thread_wrapper.h"
 
@@ -51,12 +53,10 @@ private:
     int32_t _currentFrameRate;
     bool _captureStarted;
     RawVideoType _captureVideoType;
-    struct Buffer
-    {
-        void *start;
-        size_t length;
-    };
-    Buffer *_pool;
+    // Set if captured frames can be delivered straight from the mapped
+    // buffers, without a copy.
+    bool _zeroCopy;
+    rtc::scoped_refptr<V4L2BufferPool> _pool;
 };
 }  // namespace videocapturemodule
 }  // namespace webrtc
@@ -230,6 +230,29 @@ int32_t VideoCaptureImpl::DeliverCapturedFrame(I420VideoFrame& captureFrame) {
   return 0;
 }
 
+int32_t VideoCaptureImpl::IncomingI420Buffer(
+    const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
+    int64_t captureTime/*=0*/)
+{
+    CriticalSectionScoped cs(&_apiCs);
+    CriticalSectionScoped cs2(&_callBackCs);
+
+    TRACE_EVENT1("webrtc", "VC::IncomingI420Buffer", "capture_time",
+                 captureTime);
+
+    if (apply_rotation_ && _rotateFrame != kVideoRotation_0)
+    {
+        return -1;
+    }
+
+    I420VideoFrame captureFrame(buffer, 0, TickTime::MillisecondTimestamp(),
+                                _rotateFrame);
+    captureFrame.set_ntp_time_ms(captureTime);
+
+    DeliverCapturedFrame(captureFrame);
+    return 0;
+}
+
 int32_t VideoCaptureImpl::IncomingFrame(
     uint8_t* videoFrame,
     size_t videoFrameLength,
@@ -258,8 +281,6 @@ int32_t VideoCaptureImpl::IncomingFrame(
             return -1;
         }
 
-        int stride_y = width;
-        int stride_uv = (width + 1) / 2;
         int target_width = width;
         int target_height = height;
 
@@ -272,21 +293,11 @@ int32_t VideoCaptureImpl::IncomingFrame(
           }
         }
 
-        // TODO(mikhal): Update correct aligned stride values.
-        //Calc16ByteAlignedStride(target_width, &stride_y, &stride_uv);
         // Setting absolute height (in case it was negative).
         // In Windows, the image starts bottom left, instead of top left.
         // Setting a negative source height, inverts the image (within LibYuv).
-        int ret = _captureFrame.CreateEmptyFrame(target_width,
-                                                 abs(target_height),
-                                                 stride_y,
-                                                 stride_uv, stride_uv);
-        if (ret < 0)
-        {
-            LOG(LS_ERROR) << "Failed to create empty frame, this should only "
-                             "happen due to bad parameters.";
-            return -1;
-        }
+        _captureFrame.set_video_frame_buffer(
+            _bufferPool.CreateBuffer(target_width, abs(target_height)));
         const int conversionResult = ConvertToI420(
             commonVideoType, videoFrame, 0, 0,  // No cropping
             width, height, videoFrameLength,
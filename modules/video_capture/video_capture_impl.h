@@ -15,6 +15,7 @@
  * video_capture_impl.h
  */
 
+#include "webrtc/common_video/interface/i420_buffer_pool.h"
 #include "webrtc/common_video/interface/i420_video_frame.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/common_video/rotation.h"
@@ -105,6 +106,12 @@ protected:
     VideoCaptureImpl(const int32_t id);
     virtual ~VideoCaptureImpl();
     int32_t DeliverCapturedFrame(I420VideoFrame& captureFrame);
+    // Delivers |buffer|, which already holds an I420 frame, without copying
+    // it. Returns -1 if the frame has to be rotated by the module, in which
+    // case it should be delivered through IncomingFrame() instead.
+    int32_t IncomingI420Buffer(
+        const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
+        int64_t captureTime = 0);
 
     int32_t _id; // Module ID
     char* _deviceUniqueId; // current Device unique name;
@@ -133,6 +140,7 @@ private:
                                  // capture module.
 
     I420VideoFrame _captureFrame;
+    I420BufferPool _bufferPool;
 
     // Indicate whether rotation should be applied before delivered externally.
     bool apply_rotation_;
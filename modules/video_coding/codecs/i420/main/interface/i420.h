@@ -13,6 +13,7 @@
 
 #include <vector>
 
+#include "webrtc/common_video/interface/i420_buffer_pool.h"
 #include "webrtc/modules/video_coding/codecs/interface/video_codec_interface.h"
 #include "webrtc/typedefs.h"
 
@@ -149,6 +150,7 @@ class I420Decoder : public VideoDecoder {
                                       uint16_t* height);
 
   I420VideoFrame              _decodedImage;
+  I420BufferPool              _bufferPool;
   int                         _width;
   int                         _height;
   bool                        _inited;
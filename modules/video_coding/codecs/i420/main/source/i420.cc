@@ -204,9 +204,8 @@ int I420Decoder::Decode(const EncodedImage& inputImage, bool /*missingFrames*/,
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   // Set decoded image parameters.
-  int half_width = (_width + 1) / 2;
-  _decodedImage.CreateEmptyFrame(_width, _height,
-                                 _width, half_width, half_width);
+  _decodedImage.set_video_frame_buffer(
+      _bufferPool.CreateBuffer(_width, _height));
   // Converting from buffer to plane representation.
   int ret = ConvertToI420(kI420, buffer, 0, 0, _width, _height, 0,
                           kVideoRotation_0, &_decodedImage);
@@ -236,6 +235,7 @@ int I420Decoder::RegisterDecodeCompleteCallback(
 }
 
 int I420Decoder::Release() {
+  _bufferPool.Release();
   _inited = false;
   return WEBRTC_VIDEO_CODEC_OK;
 }
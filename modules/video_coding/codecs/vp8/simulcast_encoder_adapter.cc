@@ -17,6 +17,7 @@
 
 #include "webrtc/common.h"
 #include "webrtc/modules/video_coding/codecs/vp8/screenshare_layers.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
 
 namespace {
 
@@ -117,7 +118,12 @@ struct ScreenshareTemporalLayersFactory : webrtc::TemporalLayers::Factory {
 namespace webrtc {
 
 SimulcastEncoderAdapter::SimulcastEncoderAdapter(VideoEncoderFactory* factory)
-    : factory_(factory), encoded_complete_callback_(NULL) {
+    : factory_(factory),
+      encoded_complete_callback_(NULL),
+      parallel_encoding_(false),
+      current_input_image_(NULL),
+      current_codec_specific_info_(NULL),
+      current_send_key_frame_(false) {
   memset(&codec_, 0, sizeof(webrtc::VideoCodec));
 }
 
@@ -136,6 +142,8 @@ int SimulcastEncoderAdapter::Release() {
     factory_->Destroy(encoder);
     streaminfos_.pop_back();
   }
+  stream_encoder_.reset();
+  buffer_pool_.Release();
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -205,6 +213,11 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
                                       stream_codec.height,
                                       send_stream));
   }
+
+  if (parallel_encoding_ && number_of_streams > 1) {
+    stream_encoder_.reset(
+        new WorkerPool(number_of_streams - 1, "SimulcastEncoder"));
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -238,62 +251,103 @@ int SimulcastEncoderAdapter::Encode(
     }
   }
 
-  int src_width = input_image.width();
-  int src_height = input_image.height();
-  for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
-    std::vector<VideoFrameType> stream_frame_types;
-    if (send_key_frame) {
-      stream_frame_types.push_back(kKeyFrame);
+  if (send_key_frame) {
+    for (size_t stream_idx = 0; stream_idx < streaminfos_.size();
+         ++stream_idx) {
       streaminfos_[stream_idx].key_frame_request = false;
-    } else {
-      stream_frame_types.push_back(kDeltaFrame);
     }
+  }
 
-    int dst_width = streaminfos_[stream_idx].width;
-    int dst_height = streaminfos_[stream_idx].height;
-    // If scaling isn't required, because the input resolution
-    // matches the destination or the input image is empty (e.g.
-    // a keyframe request for encoders with internal camera
-    // sources), pass the image on directly. Otherwise, we'll
-    // scale it to match what the encoder expects (below).
-    if ((dst_width == src_width && dst_height == src_height) ||
-        input_image.IsZeroSize()) {
-      streaminfos_[stream_idx].encoder->Encode(input_image,
-                                               codec_specific_info,
-                                               &stream_frame_types);
-    } else {
-      I420VideoFrame dst_frame;
-      // Making sure that destination frame is of sufficient size.
-      // Aligning stride values based on width.
-      dst_frame.CreateEmptyFrame(dst_width, dst_height,
-                                 dst_width, (dst_width + 1) / 2,
-                                 (dst_width + 1) / 2);
-      libyuv::I420Scale(input_image.buffer(kYPlane),
-                        input_image.stride(kYPlane),
-                        input_image.buffer(kUPlane),
-                        input_image.stride(kUPlane),
-                        input_image.buffer(kVPlane),
-                        input_image.stride(kVPlane),
-                        src_width, src_height,
-                        dst_frame.buffer(kYPlane),
-                        dst_frame.stride(kYPlane),
-                        dst_frame.buffer(kUPlane),
-                        dst_frame.stride(kUPlane),
-                        dst_frame.buffer(kVPlane),
-                        dst_frame.stride(kVPlane),
-                        dst_width, dst_height,
-                        libyuv::kFilterBilinear);
-      dst_frame.set_timestamp(input_image.timestamp());
-      dst_frame.set_render_time_ms(input_image.render_time_ms());
-      streaminfos_[stream_idx].encoder->Encode(dst_frame,
-                                               codec_specific_info,
-                                               &stream_frame_types);
+  if (!stream_encoder_) {
+    for (size_t stream_idx = 0; stream_idx < streaminfos_.size();
+         ++stream_idx) {
+      EncodeStream(stream_idx, input_image, codec_specific_info,
+                   send_key_frame);
     }
+    return WEBRTC_VIDEO_CODEC_OK;
   }
 
+  current_input_image_ = &input_image;
+  current_codec_specific_info_ = codec_specific_info;
+  current_send_key_frame_ = send_key_frame;
+  stream_encoder_->RunTasks(EncodeStreamOfCurrentFrame, this,
+                            streaminfos_.size());
+  current_input_image_ = NULL;
+  current_codec_specific_info_ = NULL;
+
+  // Deliver the images in stream order, as a serial encode would.
+  for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
+    ScopedVector<PendingImage>& images = pending_images_[stream_idx];
+    for (size_t i = 0; i < images.size(); ++i) {
+      DeliverEncoded(stream_idx, images[i]->image, &images[i]->codec_specific,
+                     images[i]->has_fragmentation ? &images[i]->fragmentation
+                                                  : NULL);
+    }
+    images.clear();
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+void SimulcastEncoderAdapter::EncodeStream(
+    size_t stream_idx,
+    const I420VideoFrame& input_image,
+    const CodecSpecificInfo* codec_specific_info,
+    bool send_key_frame) {
+  std::vector<VideoFrameType> stream_frame_types;
+  if (send_key_frame) {
+    stream_frame_types.push_back(kKeyFrame);
+  } else {
+    stream_frame_types.push_back(kDeltaFrame);
+  }
+
+  int src_width = input_image.width();
+  int src_height = input_image.height();
+  int dst_width = streaminfos_[stream_idx].width;
+  int dst_height = streaminfos_[stream_idx].height;
+  // If scaling isn't required, because the input resolution
+  // matches the destination or the input image is empty (e.g.
+  // a keyframe request for encoders with internal camera
+  // sources), pass the image on directly. Otherwise, we'll
+  // scale it to match what the encoder expects (below).
+  if ((dst_width == src_width && dst_height == src_height) ||
+      input_image.IsZeroSize()) {
+    streaminfos_[stream_idx].encoder->Encode(input_image,
+                                             codec_specific_info,
+                                             &stream_frame_types);
+  } else {
+    I420VideoFrame dst_frame(buffer_pool_.CreateBuffer(dst_width, dst_height),
+                             0, 0, kVideoRotation_0);
+    libyuv::I420Scale(input_image.buffer(kYPlane),
+                      input_image.stride(kYPlane),
+                      input_image.buffer(kUPlane),
+                      input_image.stride(kUPlane),
+                      input_image.buffer(kVPlane),
+                      input_image.stride(kVPlane),
+                      src_width, src_height,
+                      dst_frame.buffer(kYPlane),
+                      dst_frame.stride(kYPlane),
+                      dst_frame.buffer(kUPlane),
+                      dst_frame.stride(kUPlane),
+                      dst_frame.buffer(kVPlane),
+                      dst_frame.stride(kVPlane),
+                      dst_width, dst_height,
+                      libyuv::kFilterBilinear);
+    dst_frame.set_timestamp(input_image.timestamp());
+    dst_frame.set_render_time_ms(input_image.render_time_ms());
+    streaminfos_[stream_idx].encoder->Encode(dst_frame,
+                                             codec_specific_info,
+                                             &stream_frame_types);
+  }
+}
+
+void SimulcastEncoderAdapter::EncodeStreamOfCurrentFrame(void* obj,
+                                                         size_t stream_idx) {
+  SimulcastEncoderAdapter* adapter = static_cast<SimulcastEncoderAdapter*>(obj);
+  adapter->EncodeStream(stream_idx, *adapter->current_input_image_,
+                        adapter->current_codec_specific_info_,
+                        adapter->current_send_key_frame_);
+}
+
 int SimulcastEncoderAdapter::RegisterEncodeCompleteCallback(
     EncodedImageCallback* callback) {
   encoded_complete_callback_ = callback;
@@ -366,7 +420,34 @@ int32_t SimulcastEncoderAdapter::Encoded(
     const CodecSpecificInfo* codecSpecificInfo,
     const RTPFragmentationHeader* fragmentation) {
   size_t stream_idx = GetStreamIndex(encodedImage);
+  if (current_input_image_ == NULL) {
+    return DeliverEncoded(stream_idx, encodedImage, codecSpecificInfo,
+                          fragmentation);
+  }
+
+  // Called on the thread encoding |stream_idx| during a parallel encode.
+  // Hold on to the image until Encode() delivers it. The encoders may pass
+  // a |fragmentation| that only lives during this call, so copy it.
+  PendingImage* pending = new PendingImage();
+  pending->image = encodedImage;
+  pending->codec_specific = *codecSpecificInfo;
+  pending->has_fragmentation = fragmentation != NULL;
+  if (fragmentation) {
+    pending->fragmentation.CopyFrom(*fragmentation);
+  }
+  pending_images_[stream_idx].push_back(pending);
+  return 0;
+}
+
+void SimulcastEncoderAdapter::SetParallelEncoding(bool enable) {
+  parallel_encoding_ = enable;
+}
 
+int32_t SimulcastEncoderAdapter::DeliverEncoded(
+    size_t stream_idx,
+    const EncodedImage& encodedImage,
+    const CodecSpecificInfo* codecSpecificInfo,
+    const RTPFragmentationHeader* fragmentation) {
   CodecSpecificInfo stream_codec_specific = *codecSpecificInfo;
   CodecSpecificInfoVP8* vp8Info = &(stream_codec_specific.codecSpecific.VP8);
   vp8Info->simulcastIdx = stream_idx;
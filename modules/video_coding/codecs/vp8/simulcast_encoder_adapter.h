@@ -15,10 +15,15 @@
 #include <vector>
 
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/interface/i420_buffer_pool.h"
+#include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
 
 namespace webrtc {
 
+class WorkerPool;
+
 class VideoEncoderFactory {
  public:
   virtual VideoEncoder* Create() = 0;
@@ -29,7 +34,9 @@ class VideoEncoderFactory {
 // SimulcastEncoderAdapter implements simulcast support by creating multiple
 // webrtc::VideoEncoder instances with the given VideoEncoderFactory.
 // All the public interfaces are expected to be called from the same thread,
-// e.g the encoder thread.
+// e.g the encoder thread. With parallel encoding enabled, the streams of a
+// frame are encoded concurrently on worker threads, but their encoded images
+// are still delivered on the thread calling Encode(), in stream order.
 class SimulcastEncoderAdapter : public VP8Encoder,
                                 public EncodedImageCallback {
  public:
@@ -53,7 +60,23 @@ class SimulcastEncoderAdapter : public VP8Encoder,
                   const CodecSpecificInfo* codecSpecificInfo = NULL,
                   const RTPFragmentationHeader* fragmentation = NULL) override;
 
+  // Encodes the simulcast streams of each frame concurrently, on one worker
+  // thread per stream beyond the first, when |enable| is true. Disabled by
+  // default. Takes effect on the next call to InitEncode(). The sub-encoders
+  // are still initialized with the |number_of_cores| given to InitEncode().
+  void SetParallelEncoding(bool enable);
+
  private:
+  // An image produced by a sub-encoder during a parallel encode, held until
+  // all streams of the frame are done. |image| still points to the
+  // sub-encoder's buffer, which is valid until its next Encode() call.
+  struct PendingImage {
+    EncodedImage image;
+    CodecSpecificInfo codec_specific;
+    bool has_fragmentation;
+    RTPFragmentationHeader fragmentation;
+  };
+
   struct StreamInfo {
     StreamInfo()
         : encoder(NULL), width(0), height(0),
@@ -92,6 +115,22 @@ class SimulcastEncoderAdapter : public VP8Encoder,
   // Get the stream index according to |encodedImage|.
   size_t GetStreamIndex(const EncodedImage& encodedImage);
 
+  // Scales |input_image| to the resolution of stream |stream_idx|, if needed,
+  // and encodes it with the encoder of that stream.
+  void EncodeStream(size_t stream_idx,
+                    const I420VideoFrame& input_image,
+                    const CodecSpecificInfo* codec_specific_info,
+                    bool send_key_frame);
+  // WorkerPool::TaskFunction that encodes a stream of the current frame.
+  static void EncodeStreamOfCurrentFrame(void* obj, size_t stream_idx);
+
+  // Sets the simulcast index of |encodedImage| to |stream_idx| and passes it
+  // on to |encoded_complete_callback_|.
+  int32_t DeliverEncoded(size_t stream_idx,
+                         const EncodedImage& encodedImage,
+                         const CodecSpecificInfo* codecSpecificInfo,
+                         const RTPFragmentationHeader* fragmentation);
+
   bool Initialized() const;
 
   rtc::scoped_ptr<VideoEncoderFactory> factory_;
@@ -99,6 +138,18 @@ class SimulcastEncoderAdapter : public VP8Encoder,
   VideoCodec codec_;
   std::vector<StreamInfo> streaminfos_;
   EncodedImageCallback* encoded_complete_callback_;
+  // Scaled images for the streams. Shared by the threads encoding them.
+  I420BufferPool buffer_pool_;
+
+  bool parallel_encoding_;
+  rtc::scoped_ptr<WorkerPool> stream_encoder_;
+  // The frame being encoded by |stream_encoder_|, and the images produced for
+  // each stream so far. A stream's images are only touched by the thread
+  // encoding that stream, until RunTasks() returns.
+  const I420VideoFrame* current_input_image_;
+  const CodecSpecificInfo* current_codec_specific_info_;
+  bool current_send_key_frame_;
+  ScopedVector<PendingImage> pending_images_[kMaxSimulcastStreams];
 };
 
 }  // namespace webrtc
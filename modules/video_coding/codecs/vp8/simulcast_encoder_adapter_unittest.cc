@@ -24,6 +24,13 @@ static VP8Encoder* CreateTestEncoderAdapter() {
   return VP8Encoder::Create();
 }
 
+static VP8Encoder* CreateParallelTestEncoderAdapter() {
+  VP8EncoderFactoryConfig::set_use_parallel_encoding(true);
+  VP8Encoder* encoder = CreateTestEncoderAdapter();
+  VP8EncoderFactoryConfig::set_use_parallel_encoding(false);
+  return encoder;
+}
+
 class TestSimulcastEncoderAdapter : public TestVp8Simulcast {
  public:
   TestSimulcastEncoderAdapter()
@@ -106,8 +113,47 @@ TEST_F(TestSimulcastEncoderAdapter, DISABLED_TestRPSIEncoder) {
   TestVp8Simulcast::TestRPSIEncoder();
 }
 
+// Runs the VP8 simulcast tests with the streams encoded in parallel.
+class TestSimulcastEncoderAdapterParallel : public TestVp8Simulcast {
+ public:
+  TestSimulcastEncoderAdapterParallel()
+     : TestVp8Simulcast(CreateParallelTestEncoderAdapter(),
+                        VP8Decoder::Create()) {}
+ protected:
+  virtual void TearDown() {
+    TestVp8Simulcast::TearDown();
+    VP8EncoderFactoryConfig::set_use_simulcast_adapter(false);
+  }
+};
+
+TEST_F(TestSimulcastEncoderAdapterParallel, TestKeyFrameRequestsOnAllStreams) {
+  TestVp8Simulcast::TestKeyFrameRequestsOnAllStreams();
+}
+
+TEST_F(TestSimulcastEncoderAdapterParallel, TestPaddingTwoStreams) {
+  TestVp8Simulcast::TestPaddingTwoStreams();
+}
+
+TEST_F(TestSimulcastEncoderAdapterParallel, TestSendAllStreams) {
+  TestVp8Simulcast::TestSendAllStreams();
+}
+
+TEST_F(TestSimulcastEncoderAdapterParallel, TestDisablingStreams) {
+  TestVp8Simulcast::TestDisablingStreams();
+}
+
+TEST_F(TestSimulcastEncoderAdapterParallel, TestSwitchingToOneStream) {
+  TestVp8Simulcast::TestSwitchingToOneStream();
+}
+
+TEST_F(TestSimulcastEncoderAdapterParallel, TestStrideEncodeDecode) {
+  TestVp8Simulcast::TestStrideEncodeDecode();
+}
+
 class MockVideoEncoder : public VideoEncoder {
  public:
+  MockVideoEncoder() : callback_(NULL) {}
+
   int32_t InitEncode(const VideoCodec* codecSettings,
                      int32_t numberOfCores,
                      size_t maxPayloadSize) {
@@ -115,11 +161,30 @@ class MockVideoEncoder : public VideoEncoder {
     return 0;
   }
 
+  // Produces an empty image of the stream's resolution, with a single
+  // fragment whose length is the width of the input.
   int32_t Encode(const I420VideoFrame& inputImage,
                  const CodecSpecificInfo* codecSpecificInfo,
-                 const std::vector<VideoFrameType>* frame_types) { return 0; }
+                 const std::vector<VideoFrameType>* frame_types) {
+    if (!callback_)
+      return 0;
+    EncodedImage image;
+    image._encodedWidth = codec_.width;
+    image._encodedHeight = codec_.height;
+    image._timeStamp = inputImage.timestamp();
+    image._frameType = frame_types->at(0);
+    CodecSpecificInfo codec_specific;
+    memset(&codec_specific, 0, sizeof(codec_specific));
+    codec_specific.codecType = kVideoCodecVP8;
+    RTPFragmentationHeader fragmentation;
+    fragmentation.VerifyAndAllocateFragmentationHeader(1);
+    fragmentation.fragmentationOffset[0] = 0;
+    fragmentation.fragmentationLength[0] = inputImage.width();
+    return callback_->Encoded(image, &codec_specific, &fragmentation);
+  }
 
   int32_t RegisterEncodeCompleteCallback(EncodedImageCallback* callback) {
+    callback_ = callback;
     return 0;
   }
 
@@ -141,6 +206,7 @@ class MockVideoEncoder : public VideoEncoder {
 
  private:
   VideoCodec codec_;
+  EncodedImageCallback* callback_;
 };
 
 class MockVideoEncoderFactory : public VideoEncoderFactory {
@@ -186,6 +252,35 @@ class TestSimulcastEncoderAdapterFakeHelper {
   MockVideoEncoderFactory* factory_;
 };
 
+// Records the images delivered by the adapter.
+class EncodedImageRecorder : public EncodedImageCallback {
+ public:
+  struct Image {
+    int simulcast_idx;
+    uint32_t width;
+    uint32_t timestamp;
+    size_t fragmentation_length;
+  };
+
+  int32_t Encoded(const EncodedImage& encoded_image,
+                  const CodecSpecificInfo* codec_specific_info,
+                  const RTPFragmentationHeader* fragmentation) override {
+    Image image;
+    image.simulcast_idx = codec_specific_info->codecSpecific.VP8.simulcastIdx;
+    image.width = encoded_image._encodedWidth;
+    image.timestamp = encoded_image._timeStamp;
+    image.fragmentation_length =
+        fragmentation ? fragmentation->fragmentationLength[0] : 0;
+    images_.push_back(image);
+    return 0;
+  }
+
+  const std::vector<Image>& images() const { return images_; }
+
+ private:
+  std::vector<Image> images_;
+};
+
 static const int kTestTemporalLayerProfile[3] = {3, 2, 1};
 
 class TestSimulcastEncoderAdapterFake : public ::testing::Test {
@@ -297,5 +392,37 @@ TEST_F(TestSimulcastEncoderAdapterFake, SetChannelParameters) {
   adapter_->SetChannelParameters(packetLoss, rtt);
 }
 
+TEST_F(TestSimulcastEncoderAdapterFake, ParallelEncodingKeepsStreamOrder) {
+  static_cast<SimulcastEncoderAdapter*>(adapter_.get())->SetParallelEncoding(
+      true);
+  SetupCodec();
+  EncodedImageRecorder recorder;
+  adapter_->RegisterEncodeCompleteCallback(&recorder);
+  // Enough bitrate to send all streams.
+  EXPECT_EQ(0, adapter_->SetRates(5000, 30));
+
+  I420VideoFrame input_frame;
+  input_frame.CreateEmptyFrame(codec_.width, codec_.height, codec_.width,
+                               (codec_.width + 1) / 2, (codec_.width + 1) / 2);
+  const int kNumFrames = 10;
+  for (int i = 0; i < kNumFrames; ++i) {
+    input_frame.set_timestamp(3000 * i);
+    EXPECT_EQ(0, adapter_->Encode(input_frame, NULL, NULL));
+  }
+
+  // The images arrive as from a serial encode, one per stream and frame, in
+  // stream order. The fragmentation is copied before the encoders release it.
+  const std::vector<EncodedImageRecorder::Image>& images = recorder.images();
+  ASSERT_EQ(3u * kNumFrames, images.size());
+  for (size_t i = 0; i < images.size(); ++i) {
+    const int stream_idx = i % 3;
+    EXPECT_EQ(stream_idx, images[i].simulcast_idx);
+    EXPECT_EQ(codec_.simulcastStream[stream_idx].width, images[i].width);
+    EXPECT_EQ(3000u * (i / 3), images[i].timestamp);
+    EXPECT_EQ(codec_.simulcastStream[stream_idx].width,
+              images[i].fragmentation_length);
+  }
+}
+
 }  // namespace testing
 }  // namespace webrtc
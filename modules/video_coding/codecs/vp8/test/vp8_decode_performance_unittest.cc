@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/libyuv/include/scaler.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_coding/codecs/interface/video_codec_interface.h"
+#include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/modules/video_coding/main/interface/video_coding.h"
+#include "webrtc/modules/video_coding/main/source/codec_timer.h"
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/frame_reader.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kSourceWidth = 352;
+const int kSourceHeight = 288;
+const int kNumFrames = 150;
+
+// Owns a copy of an encoded frame.
+struct StoredFrame {
+  EncodedImage image;
+  rtc::scoped_ptr<uint8_t[]> buffer;
+};
+
+// Keeps a copy of every encoded frame.
+class FrameStore : public EncodedImageCallback {
+ public:
+  int32_t Encoded(const EncodedImage& encoded_image,
+                  const CodecSpecificInfo* codec_specific_info,
+                  const RTPFragmentationHeader* fragmentation) override {
+    StoredFrame* frame = new StoredFrame();
+    frame->buffer.reset(new uint8_t[encoded_image._length]);
+    memcpy(frame->buffer.get(), encoded_image._buffer, encoded_image._length);
+    frame->image = encoded_image;
+    frame->image._buffer = frame->buffer.get();
+    frame->image._size = encoded_image._length;
+    frame->image._completeFrame = true;
+    frames_.push_back(frame);
+    return 0;
+  }
+
+  const ScopedVector<StoredFrame>& frames() const { return frames_; }
+
+ private:
+  ScopedVector<StoredFrame> frames_;
+};
+
+// Counts the decoded frames.
+class DecodedFrameCounter : public DecodedImageCallback {
+ public:
+  DecodedFrameCounter() : num_frames_(0) {}
+
+  int32_t Decoded(I420VideoFrame& decoded_image) override {
+    ++num_frames_;
+    return 0;
+  }
+
+  int num_frames() const { return num_frames_; }
+
+ private:
+  int num_frames_;
+};
+
+// Encodes |kNumFrames| frames of the CIF clip, scaled up to |width| x
+// |height|, into |store|.
+void EncodeClip(int width, int height, FrameStore* store) {
+  VideoCodec codec;
+  VideoCodingModule::Codec(kVideoCodecVP8, &codec);
+  codec.width = width;
+  codec.height = height;
+  codec.startBitrate = width * height / 1000;
+  codec.maxBitrate = 2 * codec.startBitrate;
+  codec.codecSpecific.VP8.frameDroppingOn = false;
+  rtc::scoped_ptr<VideoEncoder> encoder(VP8Encoder::Create());
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->InitEncode(&codec, CpuInfo::DetectNumberOfCores(), 1440));
+  encoder->RegisterEncodeCompleteCallback(store);
+
+  const size_t frame_length_in_bytes =
+      CalcBufferSize(kI420, kSourceWidth, kSourceHeight);
+  test::FrameReaderImpl frame_reader(test::ResourcePath("foreman_cif", "yuv"),
+                                     frame_length_in_bytes);
+  ASSERT_TRUE(frame_reader.Init());
+  rtc::scoped_ptr<uint8_t[]> frame_buffer(new uint8_t[frame_length_in_bytes]);
+  Scaler scaler;
+  ASSERT_EQ(0, scaler.Set(kSourceWidth, kSourceHeight, width, height, kI420,
+                          kI420, kScaleBilinear));
+  I420VideoFrame source_frame;
+  I420VideoFrame scaled_frame;
+  for (int i = 0; i < kNumFrames; ++i) {
+    ASSERT_TRUE(frame_reader.ReadFrame(frame_buffer.get()));
+    source_frame.CreateFrame(frame_buffer.get(), kSourceWidth, kSourceHeight,
+                             kVideoRotation_0);
+    ASSERT_EQ(0, scaler.Scale(source_frame, &scaled_frame));
+    scaled_frame.set_timestamp(3000 * i);
+    ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Encode(scaled_frame, NULL, NULL));
+  }
+  frame_reader.Close();
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Release());
+}
+
+// Decodes the frames of |store| with a decoder initialized for
+// |number_of_cores| cores, and prints the total decode time and the decode
+// time that VCMCodecTimer would have the receiver plan for.
+void DecodeAndPrint(const FrameStore& store,
+                    int width,
+                    int height,
+                    int number_of_cores,
+                    const std::string& trace) {
+  VideoCodec codec;
+  VideoCodingModule::Codec(kVideoCodecVP8, &codec);
+  codec.width = width;
+  codec.height = height;
+  rtc::scoped_ptr<VideoDecoder> decoder(VP8Decoder::Create());
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            decoder->InitDecode(&codec, number_of_cores));
+  DecodedFrameCounter counter;
+  decoder->RegisterDecodeCompleteCallback(&counter);
+
+  VCMCodecTimer timer;
+  TickTime start = TickTime::Now();
+  for (size_t i = 0; i < store.frames().size(); ++i) {
+    int64_t decode_start_ms = TickTime::MillisecondTimestamp();
+    ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              decoder->Decode(store.frames()[i]->image, false, NULL, NULL, 0));
+    timer.StopTimer(decode_start_ms, TickTime::MillisecondTimestamp());
+  }
+  int64_t runtime_ms = (TickTime::Now() - start).Milliseconds();
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder->Release());
+  EXPECT_EQ(static_cast<int>(store.frames().size()), counter.num_frames());
+
+  test::PrintResult("vp8_decode_time", "", trace, runtime_ms, "ms", true);
+  test::PrintResult("vp8_required_decode_time", "", trace,
+                    timer.RequiredDecodeTimeMs(kVideoFrameDelta), "ms", true);
+}
+
+void RunAndPrint(int width, int height, const std::string& trace) {
+  FrameStore store;
+  EncodeClip(width, height, &store);
+  ASSERT_EQ(static_cast<size_t>(kNumFrames), store.frames().size());
+  DecodeAndPrint(store, width, height, 1, trace + "_single_core");
+  DecodeAndPrint(store, width, height, CpuInfo::DetectNumberOfCores(),
+                 trace + "_all_cores");
+}
+
+}  // namespace
+
+// Each test decodes the same clip twice, first on a single core and then with
+// the decoder threads chosen for the number of cores of the machine.
+TEST(Vp8DecodePerformanceTest, Decode720p) {
+  RunAndPrint(1280, 720, "720p");
+}
+
+TEST(Vp8DecodePerformanceTest, Decode1080p) {
+  RunAndPrint(1920, 1080, "1080p");
+}
+
+}  // namespace webrtc
@@ -14,6 +14,7 @@
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/modules/video_coding/codecs/vp8/vp8_impl.h"
 #include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/test/testsupport/gtest_disable.h"
@@ -270,4 +271,22 @@ TEST_F(TestVp8Impl, TestReset) {
       0, memcmp(second_frame_buffer.get(), first_frame_buffer.get(), length));
 }
 
+TEST(TestVp8Decoder, ResetKeepsNumberOfThreads) {
+  VideoCodec codec;
+  memset(&codec, 0, sizeof(codec));
+  codec.codecType = kVideoCodecVP8;
+  codec.width = 1280;
+  codec.height = 720;
+  VP8DecoderImpl decoder;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder.InitDecode(&codec, 4));
+  EXPECT_EQ(2, decoder.num_threads());
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder.Reset());
+  EXPECT_EQ(2, decoder.num_threads());
+
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder.InitDecode(&codec, 1));
+  EXPECT_EQ(1, decoder.num_threads());
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder.Reset());
+  EXPECT_EQ(1, decoder.num_threads());
+}
+
 }  // namespace webrtc
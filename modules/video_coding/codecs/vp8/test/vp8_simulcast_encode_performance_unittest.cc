@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_coding/codecs/interface/video_codec_interface.h"
+#include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/modules/video_coding/codecs/vp8/vp8_factory.h"
+#include "webrtc/modules/video_coding/main/interface/video_coding.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/frame_reader.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kWidth = 352;
+const int kHeight = 288;
+const int kNumFrames = 100;
+const int kNumStreams = 3;
+
+// Counts the images produced by a simulcast encoder.
+class SimulcastImageCounter : public EncodedImageCallback {
+ public:
+  SimulcastImageCounter() : num_images_(0) {}
+
+  int32_t Encoded(const EncodedImage& encoded_image,
+                  const CodecSpecificInfo* codec_specific_info,
+                  const RTPFragmentationHeader* fragmentation) override {
+    ++num_images_;
+    return 0;
+  }
+
+  int num_images() const { return num_images_; }
+
+ private:
+  int num_images_;
+};
+
+// Encodes |kNumFrames| frames of the CIF clip into three VP8 simulcast
+// streams with the SimulcastEncoderAdapter, encoding the streams one after
+// the other or in parallel, and prints the per-frame encode latency.
+void EncodeAndPrint(bool parallel_encoding, const std::string& trace) {
+  VP8EncoderFactoryConfig::set_use_simulcast_adapter(true);
+  VP8EncoderFactoryConfig::set_use_parallel_encoding(parallel_encoding);
+  rtc::scoped_ptr<VideoEncoder> encoder(VP8Encoder::Create());
+  VP8EncoderFactoryConfig::set_use_parallel_encoding(false);
+  VP8EncoderFactoryConfig::set_use_simulcast_adapter(false);
+
+  VideoCodec codec;
+  VideoCodingModule::Codec(kVideoCodecVP8, &codec);
+  codec.width = kWidth;
+  codec.height = kHeight;
+  codec.startBitrate = 900;
+  codec.codecSpecific.VP8.frameDroppingOn = false;
+  codec.numberOfSimulcastStreams = kNumStreams;
+  for (int i = 0; i < kNumStreams; ++i) {
+    // Quarter, half and full resolution.
+    SimulcastStream* stream = &codec.simulcastStream[i];
+    stream->width = kWidth >> (kNumStreams - 1 - i);
+    stream->height = kHeight >> (kNumStreams - 1 - i);
+    stream->numberOfTemporalLayers = 1;
+    stream->maxBitrate = 150 << i;
+    stream->targetBitrate = 100 << i;
+    stream->minBitrate = 30 << i;
+    stream->qpMax = 56;
+  }
+  // Only allow the encoders to use a single core, so that any speedup comes
+  // from encoding the streams in parallel.
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->InitEncode(&codec, 1, 1440));
+  SimulcastImageCounter counter;
+  encoder->RegisterEncodeCompleteCallback(&counter);
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->SetRates(900, 30));
+
+  const size_t frame_length_in_bytes = CalcBufferSize(kI420, kWidth, kHeight);
+  test::FrameReaderImpl frame_reader(test::ResourcePath("foreman_cif", "yuv"),
+                                     frame_length_in_bytes);
+  ASSERT_TRUE(frame_reader.Init());
+  rtc::scoped_ptr<uint8_t[]> frame_buffer(new uint8_t[frame_length_in_bytes]);
+  I420VideoFrame frame;
+  std::vector<int64_t> encode_times_us;
+  for (int i = 0; i < kNumFrames; ++i) {
+    ASSERT_TRUE(frame_reader.ReadFrame(frame_buffer.get()));
+    frame.CreateFrame(frame_buffer.get(), kWidth, kHeight, kVideoRotation_0);
+    frame.set_timestamp(3000 * i);
+    TickTime encode_start = TickTime::Now();
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Encode(frame, NULL, NULL));
+    encode_times_us.push_back((TickTime::Now() - encode_start).Microseconds());
+  }
+  frame_reader.Close();
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Release());
+  EXPECT_EQ(kNumStreams * kNumFrames, counter.num_images());
+
+  int64_t total_time_us = 0;
+  for (int64_t encode_time_us : encode_times_us)
+    total_time_us += encode_time_us;
+  test::PrintResult("vp8_simulcast_encode_time", "", trace,
+                    static_cast<size_t>(total_time_us / encode_times_us.size()),
+                    "us", false);
+  test::PrintResult("vp8_simulcast_max_encode_time", "", trace,
+                    static_cast<size_t>(*std::max_element(
+                        encode_times_us.begin(), encode_times_us.end())),
+                    "us", false);
+}
+
+}  // namespace
+
+// Encodes three simulcast streams, first one after the other and then in
+// parallel, and reports the per-frame encode latency of both.
+TEST(Vp8SimulcastEncodePerformanceTest, EncodeCif) {
+  EncodeAndPrint(false, "serial");
+  EncodeAndPrint(true, "parallel");
+}
+
+}  // namespace webrtc
@@ -16,6 +16,7 @@
 namespace webrtc {
 
 bool VP8EncoderFactoryConfig::use_simulcast_adapter_ = false;
+bool VP8EncoderFactoryConfig::use_parallel_encoding_ = false;
 
 class VP8EncoderImplFactory : public VideoEncoderFactory {
  public:
@@ -28,7 +29,11 @@ class VP8EncoderImplFactory : public VideoEncoderFactory {
 
 VP8Encoder* VP8Encoder::Create() {
   if (VP8EncoderFactoryConfig::use_simulcast_adapter()) {
-    return new SimulcastEncoderAdapter(new VP8EncoderImplFactory());
+    SimulcastEncoderAdapter* adapter =
+        new SimulcastEncoderAdapter(new VP8EncoderImplFactory());
+    adapter->SetParallelEncoding(
+        VP8EncoderFactoryConfig::use_parallel_encoding());
+    return adapter;
   } else {
     return new VP8EncoderImpl();
   }
@@ -25,8 +25,16 @@ class VP8EncoderFactoryConfig {
   }
   static bool use_simulcast_adapter() { return use_simulcast_adapter_; }
 
+  // Whether a SimulcastEncoderAdapter created by VP8Encoder::Create encodes
+  // its streams in parallel, see SimulcastEncoderAdapter::SetParallelEncoding.
+  static void set_use_parallel_encoding(bool use_parallel_encoding) {
+    use_parallel_encoding_ = use_parallel_encoding;
+  }
+  static bool use_parallel_encoding() { return use_parallel_encoding_; }
+
  private:
   static bool use_simulcast_adapter_;
+  static bool use_parallel_encoding_;
 };
 
 }  // namespace webrtc
@@ -99,6 +99,23 @@ bool ValidSimulcastResolutions(const VideoCodec& codec, int num_streams) {
   }
   return true;
 }
+
+// Reads the frame size from the header of a VP8 key frame, see RFC 6386
+// section 9.1. Returns false if |buffer| does not start with one.
+bool ParseKeyFrameSize(const uint8_t* buffer,
+                       size_t length,
+                       int* width,
+                       int* height) {
+  // 3 bytes of frame tag, 3 bytes of start code, and 2 bytes each for the
+  // width and the height.
+  if (length < 10 || (buffer[0] & 0x01) != 0 || buffer[3] != 0x9d ||
+      buffer[4] != 0x01 || buffer[5] != 0x2a) {
+    return false;
+  }
+  *width = (buffer[6] | (buffer[7] << 8)) & 0x3fff;
+  *height = (buffer[8] | (buffer[9] << 8)) & 0x3fff;
+  return true;
+}
 }  // namespace
 
 const float kTl1MaxTimeToDropFrames = 20.0f;
@@ -546,6 +563,7 @@ int VP8EncoderImpl::InitEncode(const VideoCodec* inst,
   configurations_[0].g_threads = NumberOfThreads(configurations_[0].g_w,
                                                  configurations_[0].g_h,
                                                  number_of_cores);
+  token_partitions_ = TokenPartitions(inst->width, inst->height);
 
   // Creating a wrapper to the image - setting image data to NULL.
   // Actual pointer will be set in encode. Setting align to 1, as it
@@ -640,6 +658,17 @@ int VP8EncoderImpl::NumberOfThreads(int width, int height, int cpus) {
   }
 }
 
+int VP8EncoderImpl::TokenPartitions(int width, int height) {
+  // VP8DecoderImpl::ThreadsForTokenPartitions uses one thread per partition.
+  if (width * height >= 1920 * 1080) {
+    return VP8_FOUR_TOKENPARTITION;
+  } else if (width * height > 640 * 480) {
+    return VP8_TWO_TOKENPARTITION;
+  } else {
+    return VP8_ONE_TOKENPARTITION;
+  }
+}
+
 int VP8EncoderImpl::InitAndSetControlSettings() {
   vpx_codec_flags_t flags = 0;
   flags |= VPX_CODEC_USE_OUTPUT_PARTITION;
@@ -686,8 +715,10 @@ int VP8EncoderImpl::InitAndSetControlSettings() {
   for (size_t i = 0; i < encoders_.size(); ++i) {
     vpx_codec_control(&(encoders_[i]), VP8E_SET_STATIC_THRESHOLD, 1);
     vpx_codec_control(&(encoders_[i]), VP8E_SET_CPUUSED, cpu_speed_[i]);
+    // Never more than |token_partitions_|, which is for the full resolution.
     vpx_codec_control(&(encoders_[i]), VP8E_SET_TOKEN_PARTITIONS,
-                      static_cast<vp8e_token_partitions>(token_partitions_));
+                      static_cast<vp8e_token_partitions>(TokenPartitions(
+                          configurations_[i].g_w, configurations_[i].g_h)));
     vpx_codec_control(&(encoders_[i]), VP8E_SET_MAX_INTRA_BITRATE_PCT,
                       rc_max_intra_target_);
     vpx_codec_control(&(encoders_[i]), VP8E_SET_SCREEN_CONTENT_MODE,
@@ -1066,7 +1097,9 @@ VP8DecoderImpl::VP8DecoderImpl()
       propagation_cnt_(-1),
       last_frame_width_(0),
       last_frame_height_(0),
-      key_frame_required_(true) {
+      key_frame_required_(true),
+      number_of_cores_(1),
+      num_threads_(1) {
 }
 
 VP8DecoderImpl::~VP8DecoderImpl() {
@@ -1078,7 +1111,7 @@ int VP8DecoderImpl::Reset() {
   if (!inited_) {
     return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
   }
-  InitDecode(&codec_, 1);
+  InitDecode(&codec_, number_of_cores_);
   propagation_cnt_ = -1;
   return WEBRTC_VIDEO_CODEC_OK;
 }
@@ -1089,27 +1122,16 @@ int VP8DecoderImpl::InitDecode(const VideoCodec* inst,
   if (ret_val < 0) {
     return ret_val;
   }
-  if (decoder_ == NULL) {
-    decoder_ = new vpx_codec_ctx_t;
-  }
   if (inst && inst->codecType == kVideoCodecVP8) {
     feedback_mode_ = inst->codecSpecific.VP8.feedbackModeOn;
   }
-  vpx_codec_dec_cfg_t  cfg;
-  // Setting number of threads to a constant value (1)
-  cfg.threads = 1;
-  cfg.h = cfg.w = 0;  // set after decode
-
-vpx_codec_flags_t flags = 0;
-#ifndef WEBRTC_ARCH_ARM
-  flags = VPX_CODEC_USE_POSTPROC;
-#ifdef INDEPENDENT_PARTITIONS
-  flags |= VPX_CODEC_USE_INPUT_PARTITION;
-#endif
-#endif
-
-  if (vpx_codec_dec_init(decoder_, vpx_codec_vp8_dx(), &cfg, flags)) {
-    return WEBRTC_VIDEO_CODEC_MEMORY;
+  // Start from the expected resolution. The number of threads is updated on
+  // key frames, when the actual resolution is known.
+  number_of_cores_ = number_of_cores;
+  ret_val = InitDecoder(ThreadsForTokenPartitions(inst->width, inst->height,
+                                                  number_of_cores_));
+  if (ret_val < 0) {
+    return ret_val;
   }
 
   // Save VideoCodec instance for later; mainly for duplicating the decoder.
@@ -1148,6 +1170,20 @@ int VP8DecoderImpl::Decode(const EncodedImage& input_image,
   }
 #endif
 
+  // A key frame does not depend on earlier frames, so the decoder can be
+  // reinitialized with a number of threads suited to its resolution.
+  int key_frame_width = 0;
+  int key_frame_height = 0;
+  if (input_image._frameType == kKeyFrame && input_image._completeFrame &&
+      ParseKeyFrameSize(input_image._buffer, input_image._length,
+                        &key_frame_width, &key_frame_height)) {
+    int num_threads = ThreadsForTokenPartitions(
+        key_frame_width, key_frame_height, number_of_cores_);
+    // If the new decoder can't be created, keep decoding with the old one.
+    if (num_threads != num_threads_)
+      InitDecoder(num_threads);
+  }
+
 #ifndef WEBRTC_ARCH_ARM
   vp8_postproc_cfg_t ppcfg;
   // MFQE enabled to reduce key frame popping.
@@ -1332,6 +1368,55 @@ int VP8DecoderImpl::DecodePartitions(
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+int VP8DecoderImpl::InitDecoder(int num_threads) {
+  vpx_codec_dec_cfg_t  cfg;
+  cfg.threads = num_threads;
+  cfg.h = cfg.w = 0;  // set after decode
+
+  vpx_codec_flags_t flags = 0;
+#ifndef WEBRTC_ARCH_ARM
+  flags = VPX_CODEC_USE_POSTPROC;
+#ifdef INDEPENDENT_PARTITIONS
+  flags |= VPX_CODEC_USE_INPUT_PARTITION;
+#endif
+#endif
+
+  // Only replace the current decoder once the new one is ready.
+  vpx_codec_ctx_t* decoder = new vpx_codec_ctx_t;
+  if (vpx_codec_dec_init(decoder, vpx_codec_vp8_dx(), &cfg, flags)) {
+    delete decoder;
+    return WEBRTC_VIDEO_CODEC_MEMORY;
+  }
+  if (decoder_ != NULL) {
+    if (vpx_codec_destroy(decoder_)) {
+      vpx_codec_destroy(decoder);
+      delete decoder;
+      return WEBRTC_VIDEO_CODEC_MEMORY;
+    }
+    delete decoder_;
+  }
+  decoder_ = decoder;
+  num_threads_ = num_threads;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int VP8DecoderImpl::ThreadsForTokenPartitions(int width,
+                                              int height,
+                                              int cpus) {
+  // libvpx only decodes macroblock rows in parallel if their tokens are in
+  // different partitions, so these match VP8EncoderImpl::TokenPartitions.
+  if (width * height >= 1920 * 1080 && cpus > 4) {
+    // 4 threads for 1080p.
+    return 4;
+  } else if (width * height > 640 * 480 && cpus >= 3) {
+    // 2 threads for qHD/HD.
+    return 2;
+  } else {
+    // 1 thread for VGA or less.
+    return 1;
+  }
+}
+
 int VP8DecoderImpl::ReturnFrame(const vpx_image_t* img,
                                         uint32_t timestamp,
                                         int64_t ntp_time_ms) {
@@ -1409,7 +1494,7 @@ VideoDecoder* VP8DecoderImpl::Copy() {
   VP8DecoderImpl* copy = new VP8DecoderImpl;
 
   // Initialize the new decoder
-  if (copy->InitDecode(&codec_, 1) != WEBRTC_VIDEO_CODEC_OK) {
+  if (copy->InitDecode(&codec_, number_of_cores_) != WEBRTC_VIDEO_CODEC_OK) {
     delete copy;
     return NULL;
   }
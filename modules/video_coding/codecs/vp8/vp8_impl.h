@@ -66,6 +66,10 @@ class VP8EncoderImpl : public VP8Encoder {
   // Determine number of encoder threads to use.
   int NumberOfThreads(int width, int height, int number_of_cores);
 
+  // Determine number of token partitions to use, as log2 of the count. VP8
+  // decoders only decode a frame on several threads if it has more than one.
+  int TokenPartitions(int width, int height);
+
   // Call encoder initialize function and set control settings.
   int InitAndSetControlSettings();
 
@@ -142,6 +146,9 @@ class VP8DecoderImpl : public VP8Decoder {
 
   virtual VideoDecoder* Copy();
 
+  // Number of threads the decoder currently decodes on.
+  int num_threads() const { return num_threads_; }
+
  private:
   // Copy reference image from this _decoder to the _decoder in copyTo. Set
   // which frame type to copy in _refFrame->frame_type before the call to
@@ -155,6 +162,18 @@ class VP8DecoderImpl : public VP8Decoder {
                   uint32_t timeStamp,
                   int64_t ntp_time_ms);
 
+  // Replace |decoder_| with a new decoder that decodes on |num_threads|
+  // threads. Leaves |decoder_| untouched on failure.
+  int InitDecoder(int num_threads);
+
+  // Determine number of decoder threads to use: one thread per token
+  // partition that VP8EncoderImpl::TokenPartitions() uses at this resolution,
+  // if there are enough cores. Unlike VP8EncoderImpl::NumberOfThreads(), this
+  // never exceeds 4.
+  static int ThreadsForTokenPartitions(int width,
+                                       int height,
+                                       int number_of_cores);
+
   I420BufferPool buffer_pool_;
   DecodedImageCallback* decode_complete_callback_;
   bool inited_;
@@ -168,6 +187,8 @@ class VP8DecoderImpl : public VP8Decoder {
   int last_frame_width_;
   int last_frame_height_;
   bool key_frame_required_;
+  int number_of_cores_;
+  int num_threads_;
 };  // end of VP8DecoderImpl class
 }  // namespace webrtc
 
@@ -452,6 +452,24 @@ public:
     //                     < 0,         on error.
     virtual int32_t Decode(uint16_t maxWaitTimeMs = 200) = 0;
 
+    // Pipelined alternative to Decode(), splitting it into two stages that
+    // are meant to run on separate threads so that assembling the next frame
+    // in the jitter buffer overlaps with decoding the current one.
+    //
+    // AssembleFrame() waits for the next frame in the jitter buffer to become
+    // complete (waits no longer than maxWaitTimeMs) and queues it for
+    // decoding. Only a couple of frames are queued; while the queue is full
+    // it waits no longer than maxWaitTimeMs for a free slot.
+    // DecodeAssembledFrame() waits no longer than maxWaitTimeMs for a queued
+    // frame and passes it to the decoder. Queued frames are dropped by
+    // ResetDecoder() and TriggerDecoderShutdown(). Must not be mixed with
+    // Decode().
+    //
+    // Return value      : VCM_OK, on success.
+    //                     < 0,         on error.
+    virtual int32_t AssembleFrame(uint16_t maxWaitTimeMs) = 0;
+    virtual int32_t DecodeAssembledFrame(uint16_t maxWaitTimeMs) = 0;
+
     // Registers a callback which conveys the size of the render buffer.
     virtual int RegisterRenderBufferSizeCallback(
         VCMRenderBufferSizeCallback* callback) = 0;
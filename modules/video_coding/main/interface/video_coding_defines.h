@@ -112,6 +112,9 @@ class VCMReceiveStatisticsCallback {
   virtual void OnReceiveRatesUpdated(uint32_t bitRate, uint32_t frameRate) = 0;
   virtual void OnDiscardedPacketsUpdated(int discarded_packets) = 0;
   virtual void OnFrameCountsUpdated(const FrameCounts& frame_counts) = 0;
+  // Called for each frame decoded by DecodeAssembledFrame() with the time it
+  // was queued between the assembly and the decode stage.
+  virtual void OnDecodeQueueDelay(int delay_ms) = 0;
 
  protected:
   virtual ~VCMReceiveStatisticsCallback() {
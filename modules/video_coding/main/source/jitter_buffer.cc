@@ -10,6 +10,7 @@
 #include "webrtc/modules/video_coding/main/source/jitter_buffer.h"
 
 #include <assert.h>
+#include <string.h>
 
 #include <algorithm>
 #include <utility>
@@ -33,7 +34,8 @@ namespace webrtc {
 // Use this rtt if no value has been reported.
 static const int64_t kDefaultRtt = 200;
 
-typedef std::pair<uint32_t, VCMFrameBuffer*> FrameListPair;
+// Initial capacity of the frame lists, enough for a typical buffer.
+static const size_t kInitialFrameListCapacity = 64;
 
 bool IsKeyFrame(FrameListPair pair) {
   return pair.second->FrameType() == kVideoFrameKey;
@@ -43,17 +45,45 @@ bool HasNonEmptyState(FrameListPair pair) {
   return pair.second->GetState() != kStateEmpty;
 }
 
+FrameList::FrameList() : first_(0) {
+  frames_.reserve(kInitialFrameListCapacity);
+}
+
+FrameList::iterator FrameList::erase(FrameList::iterator it) {
+  if (it == begin()) {
+    ++first_;
+    return begin();
+  }
+  return frames_.erase(it);
+}
+
+void FrameList::clear() {
+  frames_.clear();
+  first_ = 0;
+}
+
 void FrameList::InsertFrame(VCMFrameBuffer* frame) {
-  insert(rbegin().base(), FrameListPair(frame->TimeStamp(), frame));
+  if (first_ > 0 && (empty() || frames_.size() == frames_.capacity())) {
+    // Reclaim the removed entries rather than growing the array.
+    frames_.erase(frames_.begin(), frames_.begin() + first_);
+    first_ = 0;
+  }
+  const uint32_t timestamp = frame->TimeStamp();
+  iterator it = end();
+  while (it != begin() && IsNewerTimestamp((it - 1)->first, timestamp))
+    --it;
+  frames_.insert(it, FrameListPair(timestamp, frame));
 }
 
 VCMFrameBuffer* FrameList::PopFrame(uint32_t timestamp) {
-  FrameList::iterator it = find(timestamp);
-  if (it == end())
-    return NULL;
-  VCMFrameBuffer* frame = it->second;
-  erase(it);
-  return frame;
+  for (reverse_iterator rit = rbegin(); rit != rend(); ++rit) {
+    if (rit->first == timestamp) {
+      VCMFrameBuffer* frame = rit->second;
+      erase(rit.base() - 1);
+      return frame;
+    }
+  }
+  return NULL;
 }
 
 VCMFrameBuffer* FrameList::Front() const {
@@ -72,7 +102,7 @@ int FrameList::RecycleFramesUntilKeyFrame(FrameList::iterator* key_frame_it,
     // Throw at least one frame.
     it->second->Reset();
     free_frames->push_back(it->second);
-    erase(it++);
+    it = erase(it);
     ++drop_count;
     if (it != end() && it->second->FrameType() == kVideoFrameKey) {
       *key_frame_it = it;
@@ -113,6 +143,123 @@ void FrameList::Reset(UnorderedFrameList* free_frames) {
   }
 }
 
+namespace {
+
+int CountBits(uint32_t bits) {
+  bits = bits - ((bits >> 1) & 0x55555555);
+  bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+  return (((bits + (bits >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+// Clears the bits [first, last] of |words| and returns how many were set.
+size_t ClearBits(uint32_t* words, int first, int last) {
+  size_t cleared = 0;
+  for (int word = first >> 5; word <= last >> 5; ++word) {
+    const int low = std::max(first, word << 5) & 31;
+    const int high = std::min(last, (word << 5) + 31) & 31;
+    const uint32_t mask = (0xFFFFFFFFu >> (31 - high)) & (0xFFFFFFFFu << low);
+    cleared += CountBits(words[word] & mask);
+    words[word] &= ~mask;
+  }
+  return cleared;
+}
+
+}  // namespace
+
+SequenceNumberBitmap::SequenceNumberBitmap()
+    : size_(0), oldest_(0), newest_(0) {
+  memset(bits_, 0, sizeof(bits_));
+}
+
+void SequenceNumberBitmap::Insert(uint16_t sequence_number) {
+  if (Contains(sequence_number))
+    return;
+  bits_[sequence_number >> 5] |= 1u << (sequence_number & 31);
+  if (size_ == 0) {
+    oldest_ = sequence_number;
+    newest_ = sequence_number;
+  } else if (IsNewerSequenceNumber(sequence_number, newest_)) {
+    newest_ = sequence_number;
+  } else if (IsNewerSequenceNumber(oldest_, sequence_number)) {
+    oldest_ = sequence_number;
+  }
+  ++size_;
+}
+
+void SequenceNumberBitmap::Erase(uint16_t sequence_number) {
+  if (!Contains(sequence_number))
+    return;
+  bits_[sequence_number >> 5] &= ~(1u << (sequence_number & 31));
+  if (--size_ == 0)
+    return;
+  if (sequence_number == oldest_) {
+    oldest_ = FindFirstFrom(sequence_number + 1);
+  } else if (sequence_number == newest_) {
+    // Removing the newest member is rare, search backwards bit by bit.
+    do {
+      --newest_;
+    } while (!Contains(newest_));
+  }
+}
+
+void SequenceNumberBitmap::EraseUpTo(uint16_t sequence_number) {
+  if (size_ == 0 || IsNewerSequenceNumber(oldest_, sequence_number))
+    return;
+  if (!IsNewerSequenceNumber(newest_, sequence_number)) {
+    Clear();
+    return;
+  }
+  if (oldest_ <= sequence_number) {
+    size_ -= ClearBits(bits_, oldest_, sequence_number);
+  } else {
+    size_ -= ClearBits(bits_, oldest_, 0xFFFF);
+    size_ -= ClearBits(bits_, 0, sequence_number);
+  }
+  oldest_ = FindFirstFrom(sequence_number + 1);
+}
+
+bool SequenceNumberBitmap::Contains(uint16_t sequence_number) const {
+  return (bits_[sequence_number >> 5] & (1u << (sequence_number & 31))) != 0;
+}
+
+void SequenceNumberBitmap::Clear() {
+  if (size_ == 0)
+    return;
+  // Only the words between the oldest and newest members can be non-zero.
+  if (oldest_ <= newest_) {
+    ClearBits(bits_, oldest_, newest_);
+  } else {
+    ClearBits(bits_, oldest_, 0xFFFF);
+    ClearBits(bits_, 0, newest_);
+  }
+  size_ = 0;
+}
+
+size_t SequenceNumberBitmap::CopyTo(uint16_t* sequence_numbers) const {
+  if (size_ == 0)
+    return 0;
+  uint16_t sequence_number = oldest_;
+  for (size_t i = 0; i < size_; ++i) {
+    sequence_number = FindFirstFrom(sequence_number);
+    sequence_numbers[i] = sequence_number++;
+  }
+  return size_;
+}
+
+uint16_t SequenceNumberBitmap::FindFirstFrom(uint16_t sequence_number) const {
+  // There is always a member before |newest_| is passed, so this terminates.
+  int word = sequence_number >> 5;
+  uint32_t bits = bits_[word] & (0xFFFFFFFFu << (sequence_number & 31));
+  while (bits == 0) {
+    word = (word + 1) % kNumWords;
+    bits = bits_[word];
+  }
+  int bit = 0;
+  while ((bits & (1u << bit)) == 0)
+    ++bit;
+  return static_cast<uint16_t>((word << 5) + bit);
+}
+
 VCMJitterBuffer::VCMJitterBuffer(Clock* clock, EventFactory* event_factory)
     : clock_(clock),
       running_(false),
@@ -141,7 +288,7 @@ VCMJitterBuffer::VCMJitterBuffer(Clock* clock, EventFactory* event_factory)
       nack_mode_(kNoNack),
       low_rtt_nack_threshold_ms_(-1),
       high_rtt_nack_threshold_ms_(-1),
-      missing_sequence_numbers_(SequenceNumberLessThan()),
+      missing_sequence_numbers_(),
       nack_seq_nums_(),
       max_nack_list_size_(0),
       max_packet_age_to_nack_(0),
@@ -265,7 +412,7 @@ void VCMJitterBuffer::Flush() {
   waiting_for_completion_.timestamp = 0;
   waiting_for_completion_.latest_packet_time = -1;
   first_packet_since_reset_ = true;
-  missing_sequence_numbers_.clear();
+  missing_sequence_numbers_.Clear();
 }
 
 // Get received key and delta frames
@@ -762,7 +909,7 @@ void VCMJitterBuffer::FindAndInsertContinuousFrames(
     }
     if (IsContinuousInState(*frame, decoding_state)) {
       decodable_frames_.InsertFrame(frame);
-      incomplete_frames_.erase(it++);
+      it = incomplete_frames_.erase(it);
       decoding_state.SetState(frame);
     } else if (frame->TemporalId() <= 0) {
       break;
@@ -798,7 +945,7 @@ void VCMJitterBuffer::SetNackMode(VCMNackMode mode,
   CriticalSectionScoped cs(crit_sect_);
   nack_mode_ = mode;
   if (mode == kNoNack) {
-    missing_sequence_numbers_.clear();
+    missing_sequence_numbers_.Clear();
   }
   assert(low_rtt_nack_threshold_ms >= -1 && high_rtt_nack_threshold_ms >= -1);
   assert(high_rtt_nack_threshold_ms == -1 ||
@@ -912,12 +1059,8 @@ uint16_t* VCMJitterBuffer::GetNackList(uint16_t* nack_list_size,
       }
     }
   }
-  unsigned int i = 0;
-  SequenceNumberSet::iterator it = missing_sequence_numbers_.begin();
-  for (; it != missing_sequence_numbers_.end(); ++it, ++i) {
-    nack_seq_nums_[i] = *it;
-  }
-  *nack_list_size = i;
+  *nack_list_size = static_cast<uint16_t>(
+      missing_sequence_numbers_.CopyTo(&nack_seq_nums_[0]));
   return &nack_seq_nums_[0];
 }
 
@@ -949,7 +1092,7 @@ bool VCMJitterBuffer::UpdateNackList(uint16_t sequence_number) {
     // Push any missing sequence numbers to the NACK list.
     for (uint16_t i = latest_received_sequence_number_ + 1;
          IsNewerSequenceNumber(sequence_number, i); ++i) {
-      missing_sequence_numbers_.insert(missing_sequence_numbers_.end(), i);
+      missing_sequence_numbers_.Insert(i);
       TRACE_EVENT_INSTANT1(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"), "AddNack",
                            "seqnum", i);
     }
@@ -963,7 +1106,7 @@ bool VCMJitterBuffer::UpdateNackList(uint16_t sequence_number) {
       return false;
     }
   } else {
-    missing_sequence_numbers_.erase(sequence_number);
+    missing_sequence_numbers_.Erase(sequence_number);
     TRACE_EVENT_INSTANT1(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"), "RemoveNack",
                          "seqnum", sequence_number);
   }
@@ -993,7 +1136,7 @@ bool VCMJitterBuffer::MissingTooOldPacket(
     return false;
   }
   const uint16_t age_of_oldest_missing_packet = latest_sequence_number -
-      *missing_sequence_numbers_.begin();
+      missing_sequence_numbers_.oldest();
   // Recycle frames if the NACK list contains too old sequence numbers as
   // the packets may have already been dropped by the sender.
   return age_of_oldest_missing_packet > max_packet_age_to_nack_;
@@ -1002,7 +1145,7 @@ bool VCMJitterBuffer::MissingTooOldPacket(
 bool VCMJitterBuffer::HandleTooOldPackets(uint16_t latest_sequence_number) {
   bool key_frame_found = false;
   const uint16_t age_of_oldest_missing_packet = latest_sequence_number -
-      *missing_sequence_numbers_.begin();
+      missing_sequence_numbers_.oldest();
   LOG_F(LS_WARNING) << "NACK list contains too old sequence numbers: "
                     << age_of_oldest_missing_packet << " > "
                     << max_packet_age_to_nack_;
@@ -1016,9 +1159,7 @@ void VCMJitterBuffer::DropPacketsFromNackList(
     uint16_t last_decoded_sequence_number) {
   // Erase all sequence numbers from the NACK list which we won't need any
   // longer.
-  missing_sequence_numbers_.erase(missing_sequence_numbers_.begin(),
-                                  missing_sequence_numbers_.upper_bound(
-                                      last_decoded_sequence_number));
+  missing_sequence_numbers_.EraseUpTo(last_decoded_sequence_number);
 }
 
 int64_t VCMJitterBuffer::LastDecodedTimestamp() const {
@@ -1051,8 +1192,8 @@ VCMFrameBuffer* VCMJitterBuffer::GetEmptyFrame() {
       return NULL;
     }
   }
-  VCMFrameBuffer* frame = free_frames_.front();
-  free_frames_.pop_front();
+  VCMFrameBuffer* frame = free_frames_.back();
+  free_frames_.pop_back();
   return frame;
 }
 
@@ -1092,7 +1233,7 @@ bool VCMJitterBuffer::RecycleFramesUntilKeyFrame() {
     // All frames dropped. Reset the decoding state and clear missing sequence
     // numbers as we're starting fresh.
     last_decoded_state_.Reset();
-    missing_sequence_numbers_.clear();
+    missing_sequence_numbers_.Clear();
   }
   return key_frame_found;
 }
@@ -1151,8 +1292,7 @@ void VCMJitterBuffer::CleanUpOldOrEmptyFrames() {
 
 // Must be called from within |crit_sect_|.
 bool VCMJitterBuffer::IsPacketRetransmitted(const VCMPacket& packet) const {
-  return missing_sequence_numbers_.find(packet.seqNum) !=
-      missing_sequence_numbers_.end();
+  return missing_sequence_numbers_.Contains(packet.seqNum);
 }
 
 // Must be called under the critical section |crit_sect_|. Should never be
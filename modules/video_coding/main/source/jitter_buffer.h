@@ -11,9 +11,7 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_JITTER_BUFFER_H_
 #define WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_JITTER_BUFFER_H_
 
-#include <list>
-#include <map>
-#include <set>
+#include <utility>
 #include <vector>
 
 #include "webrtc/base/constructormagic.h"
@@ -43,7 +41,7 @@ class VCMFrameBuffer;
 class VCMPacket;
 class VCMEncodedFrame;
 
-typedef std::list<VCMFrameBuffer*> UnorderedFrameList;
+typedef std::vector<VCMFrameBuffer*> UnorderedFrameList;
 
 struct VCMJitterSample {
   VCMJitterSample() : timestamp(0), frame_size(0), latest_packet_time(-1) {}
@@ -52,17 +50,41 @@ struct VCMJitterSample {
   int64_t latest_packet_time;
 };
 
-class TimestampLessThan {
+typedef std::pair<uint32_t, VCMFrameBuffer*> FrameListPair;
+
+// Frames ordered by timestamp, kept in a flat array. New frames are almost
+// always the newest and old frames are removed from the front, so both are
+// amortized O(1): removed front entries are only reclaimed once the array
+// runs out of capacity. Lookups search from the newest frame, which is where
+// most packets belong.
+class FrameList {
  public:
-  bool operator() (const uint32_t& timestamp1,
-                   const uint32_t& timestamp2) const {
-    return IsNewerTimestamp(timestamp2, timestamp1);
+  typedef std::vector<FrameListPair>::iterator iterator;
+  typedef std::vector<FrameListPair>::const_iterator const_iterator;
+  typedef std::vector<FrameListPair>::reverse_iterator reverse_iterator;
+  typedef std::vector<FrameListPair>::const_reverse_iterator
+      const_reverse_iterator;
+
+  FrameList();
+
+  iterator begin() { return frames_.begin() + first_; }
+  const_iterator begin() const { return frames_.begin() + first_; }
+  iterator end() { return frames_.end(); }
+  const_iterator end() const { return frames_.end(); }
+  reverse_iterator rbegin() { return frames_.rbegin(); }
+  const_reverse_iterator rbegin() const { return frames_.rbegin(); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
   }
-};
+  bool empty() const { return first_ == frames_.size(); }
+  size_t size() const { return frames_.size() - first_; }
+  void clear();
+
+  // Removes the frame at |it|, returning an iterator to the next one. Only
+  // iterators at or after |it| are invalidated.
+  iterator erase(iterator it);
 
-class FrameList
-    : public std::map<uint32_t, VCMFrameBuffer*, TimestampLessThan> {
- public:
   void InsertFrame(VCMFrameBuffer* frame);
   VCMFrameBuffer* PopFrame(uint32_t timestamp);
   VCMFrameBuffer* Front() const;
@@ -72,6 +94,47 @@ class FrameList
   void CleanUpOldOrEmptyFrames(VCMDecodingState* decoding_state,
                                UnorderedFrameList* free_frames);
   void Reset(UnorderedFrameList* free_frames);
+
+ private:
+  std::vector<FrameListPair> frames_;
+  // Number of removed entries at the front of |frames_|.
+  size_t first_;
+};
+
+// Set of sequence numbers kept as a bitmap over the whole sequence number
+// space, ordered by age like IsNewerSequenceNumber(). All members must be
+// within half the sequence number space of each other.
+class SequenceNumberBitmap {
+ public:
+  SequenceNumberBitmap();
+
+  void Insert(uint16_t sequence_number);
+  void Erase(uint16_t sequence_number);
+  // Removes all members which are not newer than |sequence_number|.
+  void EraseUpTo(uint16_t sequence_number);
+  bool Contains(uint16_t sequence_number) const;
+  void Clear();
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  // Oldest and newest members. Only valid if not empty.
+  uint16_t oldest() const { return oldest_; }
+  uint16_t newest() const { return newest_; }
+
+  // Writes the members, oldest first, to |sequence_numbers| and returns how
+  // many there were. |sequence_numbers| must have room for size() entries.
+  size_t CopyTo(uint16_t* sequence_numbers) const;
+
+ private:
+  // Returns the oldest member from |sequence_number| up to |newest_|.
+  uint16_t FindFirstFrom(uint16_t sequence_number) const;
+
+  static const int kNumWords = (1 << 16) / 32;
+
+  uint32_t bits_[kNumWords];
+  size_t size_;
+  uint16_t oldest_;
+  uint16_t newest_;
 };
 
 class VCMJitterBuffer {
@@ -187,15 +250,6 @@ class VCMJitterBuffer {
   void RegisterStatsCallback(VCMReceiveStatisticsCallback* callback);
 
  private:
-  class SequenceNumberLessThan {
-   public:
-    bool operator() (const uint16_t& sequence_number1,
-                     const uint16_t& sequence_number2) const {
-      return IsNewerSequenceNumber(sequence_number2, sequence_number1);
-    }
-  };
-  typedef std::set<uint16_t, SequenceNumberLessThan> SequenceNumberSet;
-
   // Gets the frame assigned to the timestamp of the packet. May recycle
   // existing frames if no free frames are available. Returns an error code if
   // failing, or kNoError on success. |frame_list| contains which list the
@@ -338,7 +392,7 @@ class VCMJitterBuffer {
   int64_t low_rtt_nack_threshold_ms_;
   int64_t high_rtt_nack_threshold_ms_;
   // Holds the internal NACK list (the missing sequence numbers).
-  SequenceNumberSet missing_sequence_numbers_;
+  SequenceNumberBitmap missing_sequence_numbers_;
   uint16_t latest_received_sequence_number_;
   std::vector<uint16_t> nack_seq_nums_;
   size_t max_nack_list_size_;
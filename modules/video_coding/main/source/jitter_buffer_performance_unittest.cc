@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+
+#include <sstream>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/video_coding/main/interface/video_coding.h"
+#include "webrtc/modules/video_coding/main/source/jitter_buffer.h"
+#include "webrtc/modules/video_coding/main/source/packet.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kNumFrames = 3000;
+const int kPacketsPerFrame = 30;
+const int kFramePeriodMs = 16;
+const size_t kPacketSize = 200;
+
+VCMPacket CreatePacket(const uint8_t* payload,
+                       uint16_t sequence_number,
+                       uint32_t timestamp,
+                       int index_in_frame,
+                       FrameType frame_type) {
+  VCMPacket packet;
+  packet.seqNum = sequence_number;
+  packet.timestamp = timestamp;
+  packet.frameType = frame_type;
+  packet.isFirstPacket = index_in_frame == 0;
+  packet.markerBit = index_in_frame == kPacketsPerFrame - 1;
+  packet.sizeBytes = kPacketSize;
+  packet.dataPtr = payload;
+  if (packet.isFirstPacket)
+    packet.completeNALU = kNaluStart;
+  else if (packet.markerBit)
+    packet.completeNALU = kNaluEnd;
+  else
+    packet.completeNALU = kNaluIncomplete;
+  return packet;
+}
+
+// Replays a 60 fps stream with 30 packets per frame and |loss_percent| random
+// packet loss through a jitter buffer in NACK mode. Lost packets are
+// retransmitted one frame later, the NACK list is queried and all complete
+// frames are extracted once per frame. Returns the cost per packet in ns.
+int64_t RunLossyStream(int loss_percent) {
+  SimulatedClock clock(0);
+  EventFactoryImpl event_factory;
+  VCMJitterBuffer jitter_buffer(&clock, &event_factory);
+  jitter_buffer.Start();
+  jitter_buffer.SetNackMode(kNack, -1, -1);
+  jitter_buffer.SetNackSettings(150, 250, 0);
+
+  const uint8_t payload[kPacketSize] = {0};
+  srand(1);
+  std::vector<VCMPacket> lost_packets;
+  uint16_t sequence_number = 0;
+  int num_packets = 0;
+  int num_decoded_frames = 0;
+  bool retransmitted = false;
+  int64_t start_us = TickTime::MicrosecondTimestamp();
+  for (int i = 0; i < kNumFrames; ++i) {
+    for (const VCMPacket& packet : lost_packets)
+      jitter_buffer.InsertPacket(packet, &retransmitted);
+    num_packets += static_cast<int>(lost_packets.size());
+    lost_packets.clear();
+    const uint32_t timestamp = 90 * kFramePeriodMs * i;
+    for (int j = 0; j < kPacketsPerFrame; ++j) {
+      VCMPacket packet =
+          CreatePacket(payload, sequence_number++, timestamp, j,
+                       i == 0 ? kVideoFrameKey : kVideoFrameDelta);
+      if (i > 0 && rand() % 100 < loss_percent) {
+        lost_packets.push_back(packet);
+      } else {
+        jitter_buffer.InsertPacket(packet, &retransmitted);
+        ++num_packets;
+      }
+    }
+    uint16_t nack_list_size = 0;
+    bool request_key_frame = false;
+    jitter_buffer.GetNackList(&nack_list_size, &request_key_frame);
+    EXPECT_FALSE(request_key_frame);
+    uint32_t next_timestamp = 0;
+    while (jitter_buffer.NextCompleteTimestamp(0, &next_timestamp)) {
+      VCMEncodedFrame* frame =
+          jitter_buffer.ExtractAndSetDecode(next_timestamp);
+      if (!frame)
+        break;
+      jitter_buffer.ReleaseFrame(frame);
+      ++num_decoded_frames;
+    }
+    clock.AdvanceTimeMilliseconds(kFramePeriodMs);
+  }
+  int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+  jitter_buffer.Stop();
+
+  // All but the last frame can be completed by retransmissions.
+  EXPECT_GE(num_decoded_frames, kNumFrames - 1);
+  return 1000 * elapsed_us / num_packets;
+}
+
+}  // namespace
+
+// Reports the cost of inserting a packet, including the NACK list upkeep,
+// for a lossless stream and for streams with 5% and 10% packet loss.
+TEST(JitterBufferPerformanceTest, InsertAndNackCostPerPacket) {
+  const int kLossPercents[] = {0, 5, 10};
+  for (int loss_percent : kLossPercents) {
+    std::ostringstream trace;
+    trace << loss_percent << "_percent_loss";
+    webrtc::test::PrintResult("jitter_buffer_insert_and_nack", "",
+                              trace.str(),
+                              static_cast<size_t>(RunLossyStream(loss_percent)),
+                              "ns", false);
+  }
+}
+
+}  // namespace webrtc
@@ -8,9 +8,11 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include <list>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/video_coding/main/source/frame_buffer.h"
@@ -237,6 +239,42 @@ class TestJitterBufferNack : public TestRunningJitterBuffer {
   }
 };
 
+TEST(SequenceNumberBitmapTest, OrderedAcrossWrap) {
+  SequenceNumberBitmap missing;
+  EXPECT_TRUE(missing.empty());
+  for (uint16_t i = 0xFFF0; i != 0x0010; i += 2)
+    missing.Insert(i);
+  EXPECT_EQ(16u, missing.size());
+  EXPECT_EQ(0xFFF0, missing.oldest());
+  EXPECT_EQ(0x000E, missing.newest());
+  EXPECT_TRUE(missing.Contains(0xFFFE));
+  EXPECT_FALSE(missing.Contains(0xFFFF));
+
+  missing.Erase(0xFFF0);
+  missing.Erase(0x000E);
+  missing.Erase(0x0003);
+  EXPECT_EQ(14u, missing.size());
+  EXPECT_EQ(0xFFF2, missing.oldest());
+  EXPECT_EQ(0x000C, missing.newest());
+
+  uint16_t sequence_numbers[16];
+  ASSERT_EQ(14u, missing.CopyTo(sequence_numbers));
+  for (size_t i = 0; i < 14; ++i)
+    EXPECT_EQ(static_cast<uint16_t>(0xFFF2 + 2 * i), sequence_numbers[i]);
+
+  missing.EraseUpTo(0x0001);
+  EXPECT_EQ(6u, missing.size());
+  EXPECT_EQ(0x0002, missing.oldest());
+  EXPECT_FALSE(missing.Contains(0xFFFE));
+
+  missing.EraseUpTo(0x000C);
+  EXPECT_TRUE(missing.empty());
+  EXPECT_FALSE(missing.Contains(0x000C));
+  missing.Insert(0x8000);
+  EXPECT_EQ(1u, missing.CopyTo(sequence_numbers));
+  EXPECT_EQ(0x8000, sequence_numbers[0]);
+}
+
 TEST_F(TestBasicJitterBuffer, StopRunning) {
   jitter_buffer_->Stop();
   EXPECT_TRUE(NULL == DecodeCompleteFrame());
@@ -2122,4 +2160,60 @@ TEST_F(TestJitterBufferNack, ResetByFutureKeyFrameDoesntError) {
   EXPECT_EQ(0, nack_list_size);
 }
 
+// Replays a 60 fps stream with 30 packets per frame and 10% random packet loss
+// through the jitter buffer. Lost packets are retransmitted one frame later,
+// and the NACK list is queried once per frame. Every lost packet is NACKed once
+// a later packet has arrived, and every frame is decoded.
+TEST_F(TestJitterBufferNack, LossyStreamIsRecovered) {
+  const int kNumFrames = 300;
+  const int kPacketsPerFrame = 30;
+  const int kLossPercent = 10;
+  const int kFramePeriodMs = 16;
+  const unsigned int kPacketSize = 200;
+
+  srand(1);
+  std::vector<VCMPacket> lost_packets;
+  uint16_t sequence_number = 0;
+  uint16_t last_received_sequence_number = 0;
+  int num_decoded_frames = 0;
+  bool retransmitted = false;
+  for (int i = 0; i < kNumFrames; ++i) {
+    for (size_t j = 0; j < lost_packets.size(); ++j)
+      jitter_buffer_->InsertPacket(lost_packets[j], &retransmitted);
+    lost_packets.clear();
+    const uint32_t timestamp = 90 * kFramePeriodMs * i;
+    for (int j = 0; j < kPacketsPerFrame; ++j) {
+      VCMPacket packet = stream_generator_->GeneratePacket(
+          sequence_number++, timestamp, kPacketSize, j == 0,
+          j == kPacketsPerFrame - 1,
+          i == 0 ? kVideoFrameKey : kVideoFrameDelta);
+      if (i > 0 && rand() % 100 < kLossPercent) {
+        lost_packets.push_back(packet);
+      } else {
+        jitter_buffer_->InsertPacket(packet, &retransmitted);
+        last_received_sequence_number = packet.seqNum;
+      }
+    }
+    size_t num_detected_losses = 0;
+    while (num_detected_losses < lost_packets.size() &&
+           lost_packets[num_detected_losses].seqNum <
+               last_received_sequence_number) {
+      ++num_detected_losses;
+    }
+    uint16_t nack_list_size = 0;
+    bool request_key_frame = false;
+    uint16_t* nack_list =
+        jitter_buffer_->GetNackList(&nack_list_size, &request_key_frame);
+    EXPECT_FALSE(request_key_frame);
+    ASSERT_EQ(num_detected_losses, nack_list_size) << "Frame " << i;
+    for (size_t j = 0; j < num_detected_losses; ++j)
+      EXPECT_EQ(lost_packets[j].seqNum, nack_list[j]);
+    while (DecodeCompleteFrame())
+      ++num_decoded_frames;
+    clock_->AdvanceTimeMilliseconds(kFramePeriodMs);
+  }
+  // All but the last frame can be completed by retransmissions.
+  EXPECT_GE(num_decoded_frames, kNumFrames - 1);
+}
+
 }  // namespace webrtc
@@ -263,6 +263,14 @@ class VideoCodingModuleImpl : public VideoCodingModule {
     return receiver_->Decode(maxWaitTimeMs);
   }
 
+  int32_t AssembleFrame(uint16_t maxWaitTimeMs) override {
+    return receiver_->AssembleFrame(maxWaitTimeMs);
+  }
+
+  int32_t DecodeAssembledFrame(uint16_t maxWaitTimeMs) override {
+    return receiver_->DecodeAssembledFrame(maxWaitTimeMs);
+  }
+
   int32_t ResetDecoder() override { return receiver_->ResetDecoder(); }
 
   int32_t ReceiveCodec(VideoCodec* currentReceiveCodec) const override {
@@ -13,6 +13,7 @@
 
 #include "webrtc/modules/video_coding/main/interface/video_coding.h"
 
+#include <deque>
 #include <vector>
 
 #include "webrtc/base/thread_annotations.h"
@@ -30,6 +31,7 @@
 
 namespace webrtc {
 
+class ConditionVariableWrapper;
 class EncodedFrameObserver;
 
 namespace vcm {
@@ -168,6 +170,8 @@ class VideoReceiver {
   int RegisterRenderBufferSizeCallback(VCMRenderBufferSizeCallback* callback);
 
   int32_t Decode(uint16_t maxWaitTimeMs);
+  int32_t AssembleFrame(uint16_t maxWaitTimeMs);
+  int32_t DecodeAssembledFrame(uint16_t maxWaitTimeMs);
   int32_t ResetDecoder();
 
   int32_t ReceiveCodec(VideoCodec* currentReceiveCodec) const;
@@ -207,6 +211,24 @@ class VideoReceiver {
   int32_t NackList(uint16_t* nackList, uint16_t* size);
 
  private:
+  // A frame queued by AssembleFrame(), with the time it was queued.
+  struct AssembledFrame {
+    AssembledFrame(VCMEncodedFrame* frame, int64_t queued_ms)
+        : frame(frame), queued_ms(queued_ms) {}
+    VCMEncodedFrame* frame;
+    int64_t queued_ms;
+  };
+
+  // Gets the next frame to decode from the jitter buffer, waiting no longer
+  // than |maxWaitTimeMs|.
+  int32_t FrameForDecoding(uint16_t maxWaitTimeMs, VCMEncodedFrame** frame);
+  // Decodes |frame| and returns it to the jitter buffer.
+  int32_t DecodeAndReleaseFrame(VCMEncodedFrame* frame);
+  // Returns the frames queued by AssembleFrame() to the jitter buffer. If
+  // |shutdown|, AssembleFrame() stops queuing frames until the receiver is
+  // initialized or reset again.
+  void DropAssembledFrames(bool shutdown);
+
   enum VCMKeyRequestMode {
     kKeyOnError,    // Normal mode, request key frames on decoder error
     kKeyOnKeyLoss,  // Request key frames on decoder error and on packet loss
@@ -245,6 +267,13 @@ class VideoReceiver {
   VCMProcessTimer _receiveStatsTimer;
   VCMProcessTimer _retransmissionTimer;
   VCMProcessTimer _keyRequestTimer;
+
+  rtc::scoped_ptr<CriticalSectionWrapper> assembled_crit_sect_;
+  // Signaled when a frame is queued or dequeued, and on shutdown.
+  rtc::scoped_ptr<ConditionVariableWrapper> assembled_frames_changed_;
+  std::deque<AssembledFrame> assembled_frames_
+      GUARDED_BY(assembled_crit_sect_);
+  bool decoder_shutdown_ GUARDED_BY(assembled_crit_sect_);
 };
 
 }  // namespace vcm
@@ -16,6 +16,7 @@
 #include "webrtc/modules/video_coding/main/source/packet.h"
 #include "webrtc/modules/video_coding/main/source/video_coding_impl.h"
 #include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
 #include "webrtc/system_wrappers/interface/trace_event.h"
 
@@ -23,6 +24,10 @@
 
 namespace webrtc {
 namespace vcm {
+namespace {
+// Number of frames AssembleFrame() may queue ahead of DecodeAssembledFrame().
+const size_t kMaxAssembledFrames = 2;
+}  // namespace
 
 VideoReceiver::VideoReceiver(Clock* clock, EventFactory* event_factory)
     : clock_(clock),
@@ -49,7 +54,11 @@ VideoReceiver::VideoReceiver(Clock* clock, EventFactory* event_factory)
       _codecDataBase(NULL),
       _receiveStatsTimer(1000, clock_),
       _retransmissionTimer(10, clock_),
-      _keyRequestTimer(500, clock_) {
+      _keyRequestTimer(500, clock_),
+      assembled_crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      assembled_frames_changed_(
+          ConditionVariableWrapper::CreateConditionVariable()),
+      decoder_shutdown_(false) {
   assert(clock_);
 #ifdef DEBUG_DECODER_BIT_STREAM
   _bitStreamBeforeDecoder = fopen("decoderBitStream.bit", "wb");
@@ -248,6 +257,7 @@ int32_t VideoReceiver::SetVideoProtection(VCMVideoProtection videoProtection,
 
 // Initialize receiver, resets codec database etc
 int32_t VideoReceiver::InitializeReceiver() {
+  DropAssembledFrames(false);
   int32_t ret = _receiver.Initialize();
   if (ret < 0) {
     return ret;
@@ -340,11 +350,82 @@ int VideoReceiver::RegisterRenderBufferSizeCallback(
 
 void VideoReceiver::TriggerDecoderShutdown() {
   _receiver.TriggerDecoderShutdown();
+  // Frames still queued would otherwise be decoded once receiving restarts.
+  DropAssembledFrames(true);
 }
 
 // Decode next frame, blocking.
 // Should be called as often as possible to get the most out of the decoder.
 int32_t VideoReceiver::Decode(uint16_t maxWaitTimeMs) {
+  VCMEncodedFrame* frame = NULL;
+  const int32_t ret = FrameForDecoding(maxWaitTimeMs, &frame);
+  if (ret != VCM_OK) {
+    return ret;
+  }
+  return DecodeAndReleaseFrame(frame);
+}
+
+// Take the next frame from the jitter buffer and queue it for decoding,
+// blocking. Only one thread may call this at a time.
+int32_t VideoReceiver::AssembleFrame(uint16_t maxWaitTimeMs) {
+  {
+    CriticalSectionScoped cs(assembled_crit_sect_.get());
+    if (assembled_frames_.size() >= kMaxAssembledFrames) {
+      assembled_frames_changed_->SleepCS(*assembled_crit_sect_,
+                                         maxWaitTimeMs);
+      if (assembled_frames_.size() >= kMaxAssembledFrames) {
+        return VCM_FRAME_NOT_READY;
+      }
+    }
+  }
+
+  VCMEncodedFrame* frame = NULL;
+  const int32_t ret = FrameForDecoding(maxWaitTimeMs, &frame);
+  if (ret != VCM_OK) {
+    return ret;
+  }
+  CriticalSectionScoped cs(assembled_crit_sect_.get());
+  if (decoder_shutdown_) {
+    // The frame was taken from the jitter buffer while shutting down.
+    _receiver.ReleaseFrame(frame);
+    return VCM_FRAME_NOT_READY;
+  }
+  assembled_frames_.push_back(
+      AssembledFrame(frame, clock_->TimeInMilliseconds()));
+  assembled_frames_changed_->WakeAll();
+  return VCM_OK;
+}
+
+// Decode the oldest frame queued by AssembleFrame(), blocking.
+int32_t VideoReceiver::DecodeAssembledFrame(uint16_t maxWaitTimeMs) {
+  VCMEncodedFrame* frame = NULL;
+  int64_t queued_ms = 0;
+  {
+    CriticalSectionScoped cs(assembled_crit_sect_.get());
+    if (assembled_frames_.empty()) {
+      assembled_frames_changed_->SleepCS(*assembled_crit_sect_,
+                                         maxWaitTimeMs);
+      if (assembled_frames_.empty()) {
+        return VCM_FRAME_NOT_READY;
+      }
+    }
+    frame = assembled_frames_.front().frame;
+    queued_ms = assembled_frames_.front().queued_ms;
+    assembled_frames_.pop_front();
+    assembled_frames_changed_->WakeAll();
+  }
+  {
+    CriticalSectionScoped cs(process_crit_sect_.get());
+    if (_receiveStatsCallback != NULL) {
+      _receiveStatsCallback->OnDecodeQueueDelay(
+          static_cast<int>(clock_->TimeInMilliseconds() - queued_ms));
+    }
+  }
+  return DecodeAndReleaseFrame(frame);
+}
+
+int32_t VideoReceiver::FrameForDecoding(uint16_t maxWaitTimeMs,
+                                        VCMEncodedFrame** frame) {
   int64_t nextRenderTimeMs;
   bool supports_render_scheduling;
   {
@@ -358,41 +439,46 @@ int32_t VideoReceiver::Decode(uint16_t maxWaitTimeMs) {
     supports_render_scheduling = _codecDataBase.SupportsRenderScheduling();
   }
 
-  VCMEncodedFrame* frame = _receiver.FrameForDecoding(
+  *frame = _receiver.FrameForDecoding(
       maxWaitTimeMs, nextRenderTimeMs, supports_render_scheduling);
+  return *frame != NULL ? VCM_OK : VCM_FRAME_NOT_READY;
+}
 
-  if (frame == NULL) {
-    return VCM_FRAME_NOT_READY;
-  } else {
-    CriticalSectionScoped cs(_receiveCritSect);
+int32_t VideoReceiver::DecodeAndReleaseFrame(VCMEncodedFrame* frame) {
+  CriticalSectionScoped cs(_receiveCritSect);
 
-    // If this frame was too late, we should adjust the delay accordingly
-    _timing.UpdateCurrentDelay(frame->RenderTimeMs(),
-                               clock_->TimeInMilliseconds());
+  // If this frame was too late, we should adjust the delay accordingly
+  _timing.UpdateCurrentDelay(frame->RenderTimeMs(),
+                             clock_->TimeInMilliseconds());
 
-    if (pre_decode_image_callback_) {
-      EncodedImage encoded_image(frame->EncodedImage());
-      pre_decode_image_callback_->Encoded(encoded_image, NULL, NULL);
-    }
+  if (pre_decode_image_callback_) {
+    EncodedImage encoded_image(frame->EncodedImage());
+    pre_decode_image_callback_->Encoded(encoded_image, NULL, NULL);
+  }
 
 #ifdef DEBUG_DECODER_BIT_STREAM
-    if (_bitStreamBeforeDecoder != NULL) {
-      // Write bit stream to file for debugging purposes
-      if (fwrite(
-              frame->Buffer(), 1, frame->Length(), _bitStreamBeforeDecoder) !=
-          frame->Length()) {
-        return -1;
-      }
+  if (_bitStreamBeforeDecoder != NULL) {
+    // Write bit stream to file for debugging purposes
+    if (fwrite(
+            frame->Buffer(), 1, frame->Length(), _bitStreamBeforeDecoder) !=
+        frame->Length()) {
+      return -1;
     }
+  }
 #endif
-    const int32_t ret = Decode(*frame);
-    _receiver.ReleaseFrame(frame);
-    frame = NULL;
-    if (ret != VCM_OK) {
-      return ret;
-    }
+  const int32_t ret = Decode(*frame);
+  _receiver.ReleaseFrame(frame);
+  return ret;
+}
+
+void VideoReceiver::DropAssembledFrames(bool shutdown) {
+  CriticalSectionScoped cs(assembled_crit_sect_.get());
+  decoder_shutdown_ = shutdown;
+  while (!assembled_frames_.empty()) {
+    _receiver.ReleaseFrame(assembled_frames_.front().frame);
+    assembled_frames_.pop_front();
   }
-  return VCM_OK;
+  assembled_frames_changed_->WakeAll();
 }
 
 int32_t VideoReceiver::RequestSliceLossIndication(
@@ -490,6 +576,7 @@ int32_t VideoReceiver::Decode(const VCMEncodedFrame& frame) {
 
 // Reset the decoder state
 int32_t VideoReceiver::ResetDecoder() {
+  DropAssembledFrames(false);
   bool reset_key_request = false;
   {
     CriticalSectionScoped cs(_receiveCritSect);
@@ -201,6 +201,77 @@ TEST_F(TestVideoReceiver, PaddingOnlyAndVideo) {
   }
 }
 
+TEST_F(TestVideoReceiver, PipelinedDecoding) {
+  const size_t kFrameSize = 1200;
+  const uint8_t payload[kFrameSize] = {0};
+  WebRtcRTPHeader header;
+  memset(&header, 0, sizeof(header));
+  header.type.Video.isFirstPacket = true;
+  header.header.markerBit = true;
+  header.header.payloadType = kUnusedPayloadType;
+  header.header.ssrc = 1;
+  header.header.headerLength = 12;
+  header.type.Video.codec = kRtpVideoVp8;
+  header.type.Video.codecHeader.VP8.pictureId = -1;
+  header.type.Video.codecHeader.VP8.tl0PicIdx = -1;
+  // Insert a key frame followed by three delta frames.
+  for (int i = 0; i < 4; ++i) {
+    header.frameType = i == 0 ? kVideoFrameKey : kVideoFrameDelta;
+    EXPECT_EQ(0, receiver_->IncomingPacket(payload, kFrameSize, header));
+    ++header.header.sequenceNumber;
+    header.header.timestamp += 3000;
+    clock_.AdvanceTimeMilliseconds(33);
+  }
+  EXPECT_EQ(0, receiver_->Process());
+
+  EXPECT_CALL(decoder_, Decode(_, _, _, _, _)).Times(0);
+  EXPECT_EQ(VCM_FRAME_NOT_READY, receiver_->DecodeAssembledFrame(0));
+  EXPECT_EQ(0, receiver_->AssembleFrame(0));
+  EXPECT_EQ(0, receiver_->AssembleFrame(0));
+  // The decode queue is full.
+  EXPECT_EQ(VCM_FRAME_NOT_READY, receiver_->AssembleFrame(0));
+
+  EXPECT_CALL(decoder_, Decode(_, _, _, _, _)).Times(1);
+  EXPECT_EQ(0, receiver_->DecodeAssembledFrame(0));
+  EXPECT_EQ(0, receiver_->AssembleFrame(0));
+
+  // Resetting the decoder drops the queued frames.
+  EXPECT_EQ(0, receiver_->ResetDecoder());
+  EXPECT_CALL(decoder_, Decode(_, _, _, _, _)).Times(0);
+  EXPECT_EQ(VCM_FRAME_NOT_READY, receiver_->DecodeAssembledFrame(0));
+}
+
+TEST_F(TestVideoReceiver, PipelinedDecodingShutdownDropsQueuedFrames) {
+  const size_t kFrameSize = 1200;
+  const uint8_t payload[kFrameSize] = {0};
+  WebRtcRTPHeader header;
+  memset(&header, 0, sizeof(header));
+  header.type.Video.isFirstPacket = true;
+  header.header.markerBit = true;
+  header.header.payloadType = kUnusedPayloadType;
+  header.header.ssrc = 1;
+  header.header.headerLength = 12;
+  header.type.Video.codec = kRtpVideoVp8;
+  header.type.Video.codecHeader.VP8.pictureId = -1;
+  header.type.Video.codecHeader.VP8.tl0PicIdx = -1;
+  for (int i = 0; i < 3; ++i) {
+    header.frameType = i == 0 ? kVideoFrameKey : kVideoFrameDelta;
+    EXPECT_EQ(0, receiver_->IncomingPacket(payload, kFrameSize, header));
+    ++header.header.sequenceNumber;
+    header.header.timestamp += 3000;
+    clock_.AdvanceTimeMilliseconds(33);
+  }
+  EXPECT_EQ(0, receiver_->Process());
+
+  EXPECT_EQ(0, receiver_->AssembleFrame(0));
+  EXPECT_EQ(0, receiver_->AssembleFrame(0));
+  receiver_->TriggerDecoderShutdown();
+  EXPECT_CALL(decoder_, Decode(_, _, _, _, _)).Times(0);
+  EXPECT_EQ(VCM_FRAME_NOT_READY, receiver_->DecodeAssembledFrame(0));
+  EXPECT_EQ(VCM_FRAME_NOT_READY, receiver_->AssembleFrame(0));
+  EXPECT_EQ(VCM_FRAME_NOT_READY, receiver_->DecodeAssembledFrame(0));
+}
+
 TEST_F(TestVideoReceiver, ReceiverDelay) {
   EXPECT_EQ(0, receiver_->SetMinReceiverDelay(0));
   EXPECT_EQ(0, receiver_->SetMinReceiverDelay(5000));
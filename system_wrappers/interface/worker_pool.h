@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_WORKER_POOL_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_WORKER_POOL_H_
+
+#include <stddef.h>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+class ConditionVariableWrapper;
+class CriticalSectionWrapper;
+
+// Runs a batch of indexed tasks on a pool of worker threads. The calling
+// thread takes part in the work, so a batch of N tasks needs N - 1 workers to
+// run fully in parallel. Every task runs exactly once, on whichever thread
+// takes it first.
+class WorkerPool {
+ public:
+  // Runs task |index| of the current batch.
+  typedef void (*TaskFunction)(void* obj, size_t index);
+
+  // Spawns |num_threads| worker threads named |thread_name|. Fewer threads may
+  // be running if some failed to start; check num_threads().
+  WorkerPool(size_t num_threads, const char* thread_name);
+  ~WorkerPool();
+
+  // Calls |task(obj, i)| for all i smaller than |num_tasks|, each on one of
+  // the worker threads or on the calling thread. Returns once all calls have
+  // completed. Must not be called concurrently.
+  void RunTasks(TaskFunction task, void* obj, size_t num_tasks);
+
+  size_t num_threads() const { return threads_.size(); }
+
+ private:
+  static bool Run(void* obj);
+  // Waits for a batch and takes part in it. Returns false when stopping.
+  bool Process();
+  // Runs tasks until there are none left in the current batch.
+  void RunPendingTasks();
+
+  rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  // Signaled when a new batch is posted, or when stopping.
+  rtc::scoped_ptr<ConditionVariableWrapper> batch_posted_;
+  // Signaled when the last worker is done with the current batch.
+  rtc::scoped_ptr<ConditionVariableWrapper> batch_done_;
+  ScopedVector<ThreadWrapper> threads_;
+
+  // The current batch, protected by |crit_|.
+  uint32_t generation_;
+  bool stop_;
+  size_t busy_workers_;
+  TaskFunction task_;
+  void* obj_;
+  size_t num_tasks_;
+  size_t next_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerPool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INTERFACE_WORKER_POOL_H_
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/worker_pool.h"
+
+#include <assert.h>
+
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+
+namespace webrtc {
+
+WorkerPool::WorkerPool(size_t num_threads, const char* thread_name)
+    : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      batch_posted_(ConditionVariableWrapper::CreateConditionVariable()),
+      batch_done_(ConditionVariableWrapper::CreateConditionVariable()),
+      generation_(0),
+      stop_(false),
+      busy_workers_(0),
+      task_(NULL),
+      obj_(NULL),
+      num_tasks_(0),
+      next_(0) {
+  for (size_t i = 0; i < num_threads; ++i) {
+    rtc::scoped_ptr<ThreadWrapper> thread =
+        ThreadWrapper::CreateThread(Run, this, thread_name);
+    if (!thread->Start())
+      break;
+    threads_.push_back(thread.release());
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    CriticalSectionScoped cs(crit_.get());
+    stop_ = true;
+    batch_posted_->WakeAll();
+  }
+  for (size_t i = 0; i < threads_.size(); ++i)
+    threads_[i]->Stop();
+}
+
+void WorkerPool::RunTasks(TaskFunction task, void* obj, size_t num_tasks) {
+  {
+    CriticalSectionScoped cs(crit_.get());
+    assert(busy_workers_ == 0);
+    task_ = task;
+    obj_ = obj;
+    num_tasks_ = num_tasks;
+    next_ = 0;
+    busy_workers_ = threads_.size();
+    ++generation_;
+    batch_posted_->WakeAll();
+  }
+  RunPendingTasks();
+  CriticalSectionScoped cs(crit_.get());
+  while (busy_workers_ > 0)
+    batch_done_->SleepCS(*crit_);
+}
+
+bool WorkerPool::Run(void* obj) {
+  return static_cast<WorkerPool*>(obj)->Process();
+}
+
+bool WorkerPool::Process() {
+  // Batches are numbered from 1, so a worker that starts late still picks up
+  // the batch it is counted in.
+  uint32_t seen_generation = 0;
+  while (true) {
+    {
+      CriticalSectionScoped cs(crit_.get());
+      while (!stop_ && generation_ == seen_generation)
+        batch_posted_->SleepCS(*crit_);
+      if (stop_)
+        return false;
+      seen_generation = generation_;
+    }
+    RunPendingTasks();
+    CriticalSectionScoped cs(crit_.get());
+    if (--busy_workers_ == 0)
+      batch_done_->WakeAll();
+  }
+}
+
+void WorkerPool::RunPendingTasks() {
+  while (true) {
+    size_t index;
+    {
+      CriticalSectionScoped cs(crit_.get());
+      if (next_ >= num_tasks_)
+        return;
+      index = next_++;
+    }
+    task_(obj_, index);
+  }
+}
+
+}  // namespace webrtc
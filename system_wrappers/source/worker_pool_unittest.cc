@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/worker_pool.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+
+namespace webrtc {
+
+namespace {
+
+// Counts how many times each task ran.
+void CountTask(void* obj, size_t index) {
+  std::vector<int>* counts = static_cast<std::vector<int>*>(obj);
+  ++(*counts)[index];
+}
+
+// Blocks until all tasks of the batch have started, so it only completes if
+// every task runs on its own thread.
+struct Rendezvous {
+  explicit Rendezvous(int num_tasks) : num_started(0), num_tasks(num_tasks) {}
+  Atomic32 num_started;
+  const int num_tasks;
+};
+
+void RendezvousTask(void* obj, size_t index) {
+  Rendezvous* rendezvous = static_cast<Rendezvous*>(obj);
+  ++rendezvous->num_started;
+  while (rendezvous->num_started.Value() < rendezvous->num_tasks)
+    SleepMs(1);
+}
+
+}  // namespace
+
+TEST(WorkerPoolTest, RunsEveryTaskOnce) {
+  const size_t kNumTasks = 17;
+  WorkerPool pool(3, "WorkerPoolTest");
+  ASSERT_EQ(3u, pool.num_threads());
+  std::vector<int> counts(kNumTasks, 0);
+  for (int i = 1; i <= 10; ++i) {
+    pool.RunTasks(CountTask, &counts, kNumTasks);
+    for (size_t j = 0; j < kNumTasks; ++j)
+      EXPECT_EQ(i, counts[j]) << "Task " << j;
+  }
+}
+
+TEST(WorkerPoolTest, RunsEmptyBatch) {
+  WorkerPool pool(2, "WorkerPoolTest");
+  std::vector<int> counts;
+  pool.RunTasks(CountTask, &counts, 0);
+}
+
+TEST(WorkerPoolTest, RunsWithoutWorkers) {
+  const size_t kNumTasks = 4;
+  WorkerPool pool(0, "WorkerPoolTest");
+  std::vector<int> counts(kNumTasks, 0);
+  pool.RunTasks(CountTask, &counts, kNumTasks);
+  for (size_t j = 0; j < kNumTasks; ++j)
+    EXPECT_EQ(1, counts[j]);
+}
+
+TEST(WorkerPoolTest, RunsTasksInParallel) {
+  const int kNumThreads = 3;
+  WorkerPool pool(kNumThreads, "WorkerPoolTest");
+  ASSERT_EQ(static_cast<size_t>(kNumThreads), pool.num_threads());
+  // The calling thread takes the extra task.
+  Rendezvous rendezvous(kNumThreads + 1);
+  pool.RunTasks(RendezvousTask, &rendezvous, kNumThreads + 1);
+  EXPECT_EQ(kNumThreads + 1, rendezvous.num_started.Value());
+}
+
+}  // namespace webrtc
@@ -52,6 +52,7 @@
         'interface/trace.h',
         'interface/trace_event.h',
         'interface/utf_util_win.h',
+        'interface/worker_pool.h',
         'source/aligned_malloc.cc',
         'source/atomic32_mac.cc',
         'source/atomic32_posix.cc',
@@ -107,6 +108,7 @@
         'source/trace_posix.h',
         'source/trace_win.cc',
         'source/trace_win.h',
+        'source/worker_pool.cc',
       ],
       'conditions': [
         ['enable_data_logging==1', {
@@ -36,6 +36,7 @@
         'source/stl_util_unittest.cc',
         'source/thread_unittest.cc',
         'source/thread_posix_unittest.cc',
+        'source/worker_pool_unittest.cc',
       ],
       'conditions': [
         ['enable_data_logging==1', {
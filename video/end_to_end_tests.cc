@@ -8,7 +8,9 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 #include <algorithm>
+#include <deque>
 #include <map>
+#include <set>
 #include <sstream>
 #include <string>
 
@@ -17,6 +19,7 @@
 #include "webrtc/base/checks.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/call.h"
+#include "webrtc/common_video/interface/i420_buffer_pool.h"
 #include "webrtc/frame_callback.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
@@ -230,6 +233,66 @@ TEST_F(EndToEndTest, TransmitsFirstFrame) {
   DestroyStreams();
 }
 
+TEST_F(EndToEndTest, RendersFramesWithPipelinedDecoding) {
+  static const int kNumFrames = 10;
+  class Renderer : public VideoRenderer {
+   public:
+    Renderer() : event_(EventWrapper::Create()), rendered_frames_(0) {}
+
+    void RenderFrame(const I420VideoFrame& video_frame,
+                     int /*time_to_render_ms*/) override {
+      if (++rendered_frames_ == kNumFrames)
+        event_->Set();
+    }
+    bool IsTextureSupported() const override { return false; }
+
+    EventTypeWrapper Wait(unsigned long max_time_ms) {  // NOLINT
+      return event_->Wait(max_time_ms);
+    }
+
+    rtc::scoped_ptr<EventWrapper> event_;
+    int rendered_frames_;
+  } renderer;
+
+  test::DirectTransport sender_transport, receiver_transport;
+
+  CreateCalls(Call::Config(&sender_transport),
+              Call::Config(&receiver_transport));
+
+  sender_transport.SetReceiver(receiver_call_->Receiver());
+  receiver_transport.SetReceiver(sender_call_->Receiver());
+
+  CreateSendConfig(1);
+  CreateMatchingReceiveConfigs();
+  receive_configs_[0].renderer = &renderer;
+  receive_configs_[0].pipelined_decoding = true;
+
+  CreateStreams();
+  Start();
+
+  rtc::scoped_ptr<test::FrameGenerator> frame_generator(
+      test::FrameGenerator::CreateChromaGenerator(
+          encoder_config_.streams[0].width, encoder_config_.streams[0].height));
+  // Keep sending frames until enough of them have been rendered.
+  bool rendered = false;
+  for (int i = 0; !rendered && i < kDefaultTimeoutMs / 33; ++i) {
+    send_stream_->Input()->IncomingCapturedFrame(*frame_generator->NextFrame());
+    rendered = renderer.Wait(33) == kEventSignaled;
+  }
+  EXPECT_TRUE(rendered) << "Timed out while waiting for the frames to render.";
+  VideoReceiveStream::Stats stats = receive_streams_[0]->GetStats();
+  EXPECT_GE(stats.decode_queue_ms, 0);
+  EXPECT_GE(stats.deliver_queue_ms, 0);
+  EXPECT_GE(stats.deliver_ms, 0);
+
+  Stop();
+
+  sender_transport.StopSending();
+  receiver_transport.StopSending();
+
+  DestroyStreams();
+}
+
 TEST_F(EndToEndTest, SendsAndReceivesVP9) {
   class VP9Observer : public test::EndToEndTest, public VideoRenderer {
    public:
@@ -849,6 +912,129 @@ TEST_F(EndToEndTest, UsesFrameCallbacks) {
   DestroyStreams();
 }
 
+TEST_F(EndToEndTest, ReusesFrameBuffersInSteadyState) {
+  static const int kWidth = 320;
+  static const int kHeight = 240;
+  static const int kNumWarmupFrames = 10;
+  static const int kNumFrames = 100;
+  // Frames referenced by each observer at a time, as a renderer would.
+  static const size_t kNumHeldFrames = 3;
+
+  // Holds on to the last few frames it sees. The renderer also samples the
+  // number of I420Buffers allocated in the process once the pipeline has
+  // warmed up, and again after |kNumFrames| more frames.
+  class FrameObserver : public I420FrameCallback, public VideoRenderer {
+   public:
+    FrameObserver()
+        : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+          event_(EventWrapper::Create()),
+          num_frames_(0),
+          num_allocated_after_warmup_(-1),
+          num_allocated_at_end_(-1) {}
+
+    void FrameCallback(I420VideoFrame* frame) override { AddFrame(*frame); }
+    void RenderFrame(const I420VideoFrame& video_frame,
+                     int /*time_to_render_ms*/) override {
+      AddFrame(video_frame);
+    }
+    bool IsTextureSupported() const override { return false; }
+
+    EventTypeWrapper Wait(unsigned long max_time_ms) {  // NOLINT
+      return event_->Wait(max_time_ms);
+    }
+    int num_allocated_after_warmup() {
+      CriticalSectionScoped lock(crit_.get());
+      return num_allocated_after_warmup_;
+    }
+    int num_allocated_at_end() {
+      CriticalSectionScoped lock(crit_.get());
+      return num_allocated_at_end_;
+    }
+
+   private:
+    void AddFrame(const I420VideoFrame& frame) {
+      CriticalSectionScoped lock(crit_.get());
+      held_frames_.push_back(frame);
+      if (held_frames_.size() > kNumHeldFrames)
+        held_frames_.pop_front();
+      ++num_frames_;
+      if (num_frames_ == kNumWarmupFrames)
+        num_allocated_after_warmup_ = I420Buffer::NumAllocated();
+      if (num_frames_ == kNumWarmupFrames + kNumFrames) {
+        num_allocated_at_end_ = I420Buffer::NumAllocated();
+        event_->Set();
+      }
+    }
+
+    const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+    const rtc::scoped_ptr<EventWrapper> event_;
+    int num_frames_;
+    int num_allocated_after_warmup_;
+    int num_allocated_at_end_;
+    std::deque<I420VideoFrame> held_frames_;
+  };
+
+  FrameObserver pre_encode_observer;
+  FrameObserver renderer;
+
+  test::DirectTransport sender_transport, receiver_transport;
+
+  CreateCalls(Call::Config(&sender_transport),
+              Call::Config(&receiver_transport));
+
+  sender_transport.SetReceiver(receiver_call_->Receiver());
+  receiver_transport.SetReceiver(sender_call_->Receiver());
+
+  CreateSendConfig(1);
+  rtc::scoped_ptr<VideoEncoder> encoder(
+      VideoEncoder::Create(VideoEncoder::kVp8));
+  send_config_.encoder_settings.encoder = encoder.get();
+  send_config_.encoder_settings.payload_name = "VP8";
+  ASSERT_EQ(1u, encoder_config_.streams.size()) << "Test setup error.";
+  encoder_config_.streams[0].width = kWidth;
+  encoder_config_.streams[0].height = kHeight;
+  send_config_.pre_encode_callback = &pre_encode_observer;
+
+  CreateMatchingReceiveConfigs();
+  receive_configs_[0].renderer = &renderer;
+
+  CreateStreams();
+  Start();
+
+  // Captured frames are smaller than the send resolution so that they are
+  // scaled before being encoded. They come from a pool too, as they would
+  // from a capturer, so that only allocations in the pipeline are counted.
+  I420BufferPool capture_pool;
+  bool rendered = false;
+  for (int i = 0; !rendered && i < 2 * kDefaultTimeoutMs / 33; ++i) {
+    rtc::scoped_refptr<VideoFrameBuffer> buffer =
+        capture_pool.CreateBuffer(kWidth / 2, kHeight / 2);
+    memset(buffer->data(kYPlane), 0x80,
+           buffer->stride(kYPlane) * buffer->height());
+    memset(buffer->data(kUPlane), i, buffer->stride(kUPlane) *
+                                         ((buffer->height() + 1) / 2));
+    memset(buffer->data(kVPlane), 0xFF - i, buffer->stride(kVPlane) *
+                                                ((buffer->height() + 1) / 2));
+    send_stream_->Input()->IncomingCapturedFrame(
+        I420VideoFrame(buffer, 0, 0, kVideoRotation_0));
+    rendered = renderer.Wait(33) == kEventSignaled;
+  }
+  EXPECT_TRUE(rendered) << "Timed out while waiting for the frames to render.";
+  EXPECT_EQ(kEventSignaled, pre_encode_observer.Wait(kDefaultTimeoutMs));
+
+  Stop();
+
+  sender_transport.StopSending();
+  receiver_transport.StopSending();
+
+  DestroyStreams();
+
+  // Buffers are only allocated while the pools fill up.
+  ASSERT_GE(renderer.num_allocated_after_warmup(), 0);
+  EXPECT_EQ(renderer.num_allocated_after_warmup(),
+            renderer.num_allocated_at_end());
+}
+
 void EndToEndTest::ReceivesPliAndRecovers(int rtp_history_ms) {
   static const int kPacketsToDrop = 1;
 
@@ -14,13 +14,20 @@
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 
 namespace webrtc {
+namespace {
+// Per-frame smoothing factor of the pipelined decoding stage latencies.
+const float kStageDelayAlpha = 0.9f;
+}  // namespace
 
 ReceiveStatisticsProxy::ReceiveStatisticsProxy(uint32_t ssrc, Clock* clock)
     : clock_(clock),
       crit_(CriticalSectionWrapper::CreateCriticalSection()),
       // 1000ms window, scale 1000 for ms to s.
       decode_fps_estimator_(1000, 1000),
-      renders_fps_estimator_(1000, 1000) {
+      renders_fps_estimator_(1000, 1000),
+      decode_queue_ms_(kStageDelayAlpha),
+      deliver_queue_ms_(kStageDelayAlpha),
+      deliver_ms_(kStageDelayAlpha) {
   stats_.ssrc = ssrc;
 }
 
@@ -110,6 +117,26 @@ void ReceiveStatisticsProxy::OnRenderedFrame() {
   stats_.render_frame_rate = renders_fps_estimator_.Rate(now);
 }
 
+void ReceiveStatisticsProxy::OnDeliveredFrame(int queue_ms, int deliver_ms) {
+  CriticalSectionScoped lock(crit_.get());
+  deliver_queue_ms_.Apply(1.0f, queue_ms);
+  deliver_ms_.Apply(1.0f, deliver_ms);
+  stats_.deliver_queue_ms =
+      static_cast<int>(deliver_queue_ms_.filtered() + 0.5f);
+  stats_.deliver_ms = static_cast<int>(deliver_ms_.filtered() + 0.5f);
+}
+
+void ReceiveStatisticsProxy::OnDroppedDecodedFrame() {
+  CriticalSectionScoped lock(crit_.get());
+  ++stats_.dropped_decoded_frames;
+}
+
+void ReceiveStatisticsProxy::OnDecodeQueueDelay(int delay_ms) {
+  CriticalSectionScoped lock(crit_.get());
+  decode_queue_ms_.Apply(1.0f, delay_ms);
+  stats_.decode_queue_ms = static_cast<int>(decode_queue_ms_.filtered() + 0.5f);
+}
+
 void ReceiveStatisticsProxy::OnReceiveRatesUpdated(uint32_t bitRate,
                                                    uint32_t frameRate) {
 }
@@ -13,6 +13,7 @@
 
 #include <string>
 
+#include "webrtc/base/exp_filter.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/common_types.h"
 #include "webrtc/frame_callback.h"
@@ -43,11 +44,18 @@ class ReceiveStatisticsProxy : public ViEDecoderObserver,
 
   void OnDecodedFrame();
   void OnRenderedFrame();
+  // Called by the deliver thread of pipelined decoding for each delivered
+  // frame.
+  void OnDeliveredFrame(int queue_ms, int deliver_ms);
+  // Called when pipelined decoding drops a decoded frame because the deliver
+  // thread didn't keep up.
+  void OnDroppedDecodedFrame();
 
   // Overrides VCMReceiveStatisticsCallback
   void OnReceiveRatesUpdated(uint32_t bitRate, uint32_t frameRate) override;
   void OnFrameCountsUpdated(const FrameCounts& frame_counts) override;
   void OnDiscardedPacketsUpdated(int discarded_packets) override;
+  void OnDecodeQueueDelay(int delay_ms) override;
 
   // Overrides ViEDecoderObserver.
   void IncomingCodecChanged(const int video_channel,
@@ -84,6 +92,9 @@ class ReceiveStatisticsProxy : public ViEDecoderObserver,
   VideoReceiveStream::Stats stats_ GUARDED_BY(crit_);
   RateStatistics decode_fps_estimator_ GUARDED_BY(crit_);
   RateStatistics renders_fps_estimator_ GUARDED_BY(crit_);
+  rtc::ExpFilter decode_queue_ms_ GUARDED_BY(crit_);
+  rtc::ExpFilter deliver_queue_ms_ GUARDED_BY(crit_);
+  rtc::ExpFilter deliver_ms_ GUARDED_BY(crit_);
 };
 
 }  // namespace webrtc
@@ -61,6 +61,7 @@ std::string VideoReceiveStream::Config::ToString() const {
   ss << ", pre_render_callback: "
      << (pre_render_callback != nullptr ? "(I420FrameCallback)" : "nullptr");
   ss << ", target_delay_ms: " << target_delay_ms;
+  ss << ", pipelined_decoding: " << (pipelined_decoding ? "on" : "off");
   ss << '}';
 
   return ss.str();
@@ -194,6 +195,9 @@ VideoReceiveStream::VideoReceiveStream(webrtc::VideoEngine* video_engine,
 
   codec_ = ViECodec::GetInterface(video_engine);
 
+  if (config_.pipelined_decoding)
+    CHECK_EQ(0, video_engine_base_->SetPipelinedDecoding(channel_, true));
+
   if (config_.rtp.fec.ulpfec_payload_type != -1) {
     // ULPFEC without RED doesn't make sense.
     DCHECK(config_.rtp.fec.red_payload_type != -1);
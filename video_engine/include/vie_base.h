@@ -125,6 +125,20 @@ struct CpuOveruseMetrics {
                                      // expressed in ms delay per second.
 };
 
+// Set through the Config given to VideoEngine::Create() to spread the periodic
+// processing of channels (RTP/RTCP, jitter buffer, sync) over several threads.
+// Channels are assigned to a thread by channel id, the modules shared by all
+// channels run on the first thread. If |pin_to_cores| is set, thread i is
+// bound to core i modulo the number of cores, where supported.
+struct ModuleProcessThreads {
+  ModuleProcessThreads() : num_threads(1), pin_to_cores(false) {}
+  ModuleProcessThreads(int num_threads, bool pin_to_cores)
+      : num_threads(num_threads), pin_to_cores(pin_to_cores) {}
+
+  int num_threads;
+  bool pin_to_cores;
+};
+
 class CpuOveruseMetricsObserver {
  public:
   virtual ~CpuOveruseMetricsObserver() {}
@@ -257,6 +271,10 @@ class WEBRTC_DLLEXPORT ViEBase {
       int channel,
       ReceiveStatisticsProxy* receive_statistics_proxy) = 0;
 
+  // Runs frame assembly, decoding and delivery of decoded frames on separate
+  // threads for the specified channel. Must be set before StartReceive().
+  virtual int SetPipelinedDecoding(int channel, bool enable) = 0;
+
  protected:
   ViEBase() {}
   virtual ~ViEBase() {}
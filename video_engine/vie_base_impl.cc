@@ -411,4 +411,20 @@ void ViEBaseImpl::RegisterReceiveStatisticsProxy(
   }
   vie_channel->RegisterReceiveStatisticsProxy(receive_statistics_proxy);
 }
+
+int ViEBaseImpl::SetPipelinedDecoding(int channel, bool enable) {
+  LOG_F(LS_INFO) << "SetPipelinedDecoding on channel " << channel << ": "
+                 << (enable ? "on" : "off");
+  ViEChannelManagerScoped cs(*(shared_data_.channel_manager()));
+  ViEChannel* vie_channel = cs.Channel(channel);
+  if (!vie_channel) {
+    shared_data_.SetLastError(kViEBaseInvalidChannelId);
+    return -1;
+  }
+  if (vie_channel->SetPipelinedDecoding(enable) != 0) {
+    shared_data_.SetLastError(kViEBaseAlreadyReceiving);
+    return -1;
+  }
+  return 0;
+}
 }  // namespace webrtc
@@ -79,6 +79,7 @@ class ViEBaseImpl
   void RegisterReceiveStatisticsProxy(
       int channel,
       ReceiveStatisticsProxy* receive_statistics_proxy) override;
+  int SetPipelinedDecoding(int channel, bool enable) override;
   // ViEBaseImpl owns ViESharedData used by all interface implementations.
   ViESharedData shared_data_;
 };
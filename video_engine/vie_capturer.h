@@ -167,6 +167,8 @@ class ViECapturer
 
   // Image processing.
   ViEEffectFilter* effect_filter_ GUARDED_BY(effects_and_stats_cs_.get());
+  // Frame handed to |effect_filter_|, kept to not reallocate it per frame.
+  std::vector<uint8_t> effect_buffer_ GUARDED_BY(effects_and_stats_cs_.get());
   VideoProcessingModule* image_proc_module_;
   int image_proc_module_ref_counter_;
   VideoProcessingModule::FrameStats* deflicker_frame_stats_
@@ -25,6 +25,7 @@
 #include "webrtc/modules/video_coding/main/interface/video_coding.h"
 #include "webrtc/modules/video_processing/main/interface/video_processing.h"
 #include "webrtc/modules/video_render/include/video_render_defines.h"
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
 #include "webrtc/system_wrappers/interface/metrics.h"
@@ -42,6 +43,9 @@
 namespace webrtc {
 
 const int kMaxDecodeWaitTimeMs = 50;
+// Number of decoded frames queued for the deliver thread when decoding is
+// pipelined.
+const size_t kMaxDeliverQueueSize = 2;
 const int kInvalidRtpExtensionId = 0;
 static const int kMaxTargetDelayMs = 10000;
 static const float kMaxIncompleteTimeMultiplier = 3.5f;
@@ -107,7 +111,7 @@ ViEChannel::ViEChannel(int32_t channel_id,
       vie_sender_(channel_id),
       vie_sync_(vcm_, this),
       stats_observer_(new ChannelStatsObserver(this)),
-      vcm_receive_stats_callback_(NULL),
+      receive_statistics_proxy_(NULL),
       module_process_thread_(module_process_thread),
       codec_observer_(NULL),
       do_key_frame_callbackRequest_(false),
@@ -131,7 +135,12 @@ ViEChannel::ViEChannel(int32_t channel_id,
       max_nack_reordering_threshold_(kMaxPacketAgeToNack),
       pre_render_callback_(NULL),
       report_block_stats_sender_(new ReportBlockStats()),
-      report_block_stats_receiver_(new ReportBlockStats()) {
+      report_block_stats_receiver_(new ReportBlockStats()),
+      pipelined_decoding_(false),
+      deliver_cs_(CriticalSectionWrapper::CreateCriticalSection()),
+      deliver_queue_changed_(
+          ConditionVariableWrapper::CreateConditionVariable()),
+      dropped_decoded_frames_(0) {
   RtpRtcp::Configuration configuration = CreateRtpRtcpConfiguration();
   configuration.remote_bitrate_estimator = remote_bitrate_estimator;
   configuration.receive_statistics = vie_receiver_.GetReceiveStatistics();
@@ -615,6 +624,11 @@ uint32_t ViEChannel::DiscardedPackets() const {
   return vcm_->DiscardedPackets();
 }
 
+int ViEChannel::DroppedDecodedFrames() const {
+  CriticalSectionScoped cs(deliver_cs_.get());
+  return dropped_decoded_frames_;
+}
+
 int ViEChannel::ReceiveDelay() const {
   return vcm_->Delay();
 }
@@ -1598,6 +1612,15 @@ int32_t ViEChannel::EnableColorEnhancement(bool enable) {
   return 0;
 }
 
+int32_t ViEChannel::SetPipelinedDecoding(bool enable) {
+  if (decode_thread_) {
+    LOG_F(LS_ERROR) << "Can't change pipelined decoding while receiving.";
+    return -1;
+  }
+  pipelined_decoding_ = enable;
+  return 0;
+}
+
 RtpRtcp* ViEChannel::rtp_rtcp() {
   return rtp_rtcp_.get();
 }
@@ -1620,6 +1643,37 @@ CallStatsObserver* ViEChannel::GetStatsObserver() {
 // the same lock in the path of decode callback can deadlock.
 int32_t ViEChannel::FrameToRender(
     I420VideoFrame& video_frame) {  // NOLINT
+  if (!pipelined_decoding_) {
+    DeliverDecodedFrame(&video_frame);
+    return 0;
+  }
+
+  bool dropped = false;
+  {
+    CriticalSectionScoped cs(deliver_cs_.get());
+    // The decoder holds the VCM receive lock while in here, so drop the
+    // oldest frame rather than waiting for the deliver thread if it doesn't
+    // keep up.
+    if (deliver_queue_.size() >= kMaxDeliverQueueSize) {
+      deliver_queue_.pop_front();
+      ++dropped_decoded_frames_;
+      dropped = true;
+    }
+    DecodedFrame decoded_frame;
+    decoded_frame.frame.ShallowCopy(video_frame);
+    decoded_frame.queued_ms = Clock::GetRealTimeClock()->TimeInMilliseconds();
+    deliver_queue_.push_back(decoded_frame);
+    deliver_queue_changed_->WakeAll();
+  }
+  if (dropped) {
+    CriticalSectionScoped cs(callback_cs_.get());
+    if (receive_statistics_proxy_ != NULL)
+      receive_statistics_proxy_->OnDroppedDecodedFrame();
+  }
+  return 0;
+}
+
+void ViEChannel::DeliverDecodedFrame(I420VideoFrame* video_frame) {
   CriticalSectionScoped cs(callback_cs_.get());
 
   if (decoder_reset_) {
@@ -1627,30 +1681,30 @@ int32_t ViEChannel::FrameToRender(
     if (codec_observer_) {
       // The codec set by RegisterReceiveCodec might not be the size we're
       // actually decoding.
-      receive_codec_.width = static_cast<uint16_t>(video_frame.width());
-      receive_codec_.height = static_cast<uint16_t>(video_frame.height());
+      receive_codec_.width = static_cast<uint16_t>(video_frame->width());
+      receive_codec_.height = static_cast<uint16_t>(video_frame->height());
       codec_observer_->IncomingCodecChanged(channel_id_, receive_codec_);
     }
     decoder_reset_ = false;
   }
   // Post processing is not supported if the frame is backed by a texture.
-  if (video_frame.native_handle() == NULL) {
+  if (video_frame->native_handle() == NULL) {
     if (pre_render_callback_ != NULL)
-      pre_render_callback_->FrameCallback(&video_frame);
+      pre_render_callback_->FrameCallback(video_frame);
     if (effect_filter_) {
       size_t length =
-          CalcBufferSize(kI420, video_frame.width(), video_frame.height());
-      rtc::scoped_ptr<uint8_t[]> video_buffer(new uint8_t[length]);
-      ExtractBuffer(video_frame, length, video_buffer.get());
+          CalcBufferSize(kI420, video_frame->width(), video_frame->height());
+      effect_buffer_.resize(length);
+      ExtractBuffer(*video_frame, length, &effect_buffer_[0]);
       effect_filter_->Transform(length,
-                                video_buffer.get(),
-                                video_frame.ntp_time_ms(),
-                                video_frame.timestamp(),
-                                video_frame.width(),
-                                video_frame.height());
+                                &effect_buffer_[0],
+                                video_frame->ntp_time_ms(),
+                                video_frame->timestamp(),
+                                video_frame->width(),
+                                video_frame->height());
     }
     if (color_enhancement_) {
-      VideoProcessingModule::ColorEnhancement(&video_frame);
+      VideoProcessingModule::ColorEnhancement(video_frame);
     }
   }
 
@@ -1661,9 +1715,7 @@ int32_t ViEChannel::FrameToRender(
     no_of_csrcs = 1;
   }
   std::vector<uint32_t> csrcs(arr_ofCSRC, arr_ofCSRC + no_of_csrcs);
-  DeliverFrame(&video_frame, csrcs);
-
-  return 0;
+  DeliverFrame(video_frame, csrcs);
 }
 
 int32_t ViEChannel::ReceivedDecodedReferenceFrame(
@@ -1684,15 +1736,21 @@ void ViEChannel::OnReceiveRatesUpdated(uint32_t bit_rate, uint32_t frame_rate) {
 
 void ViEChannel::OnDiscardedPacketsUpdated(int discarded_packets) {
   CriticalSectionScoped cs(callback_cs_.get());
-  if (vcm_receive_stats_callback_ != NULL)
-    vcm_receive_stats_callback_->OnDiscardedPacketsUpdated(discarded_packets);
+  if (receive_statistics_proxy_ != NULL)
+    receive_statistics_proxy_->OnDiscardedPacketsUpdated(discarded_packets);
 }
 
 void ViEChannel::OnFrameCountsUpdated(const FrameCounts& frame_counts) {
   CriticalSectionScoped cs(callback_cs_.get());
   receive_frame_counts_ = frame_counts;
-  if (vcm_receive_stats_callback_ != NULL)
-    vcm_receive_stats_callback_->OnFrameCountsUpdated(frame_counts);
+  if (receive_statistics_proxy_ != NULL)
+    receive_statistics_proxy_->OnFrameCountsUpdated(frame_counts);
+}
+
+void ViEChannel::OnDecodeQueueDelay(int delay_ms) {
+  CriticalSectionScoped cs(callback_cs_.get());
+  if (receive_statistics_proxy_ != NULL)
+    receive_statistics_proxy_->OnDecodeQueueDelay(delay_ms);
 }
 
 void ViEChannel::OnDecoderTiming(int decode_ms,
@@ -1739,7 +1797,49 @@ bool ViEChannel::ChannelDecodeThreadFunction(void* obj) {
 }
 
 bool ViEChannel::ChannelDecodeProcess() {
-  vcm_->Decode(kMaxDecodeWaitTimeMs);
+  if (pipelined_decoding_)
+    vcm_->DecodeAssembledFrame(kMaxDecodeWaitTimeMs);
+  else
+    vcm_->Decode(kMaxDecodeWaitTimeMs);
+  return true;
+}
+
+bool ViEChannel::ChannelAssembleThreadFunction(void* obj) {
+  return static_cast<ViEChannel*>(obj)->ChannelAssembleProcess();
+}
+
+bool ViEChannel::ChannelAssembleProcess() {
+  vcm_->AssembleFrame(kMaxDecodeWaitTimeMs);
+  return true;
+}
+
+bool ViEChannel::ChannelDeliverThreadFunction(void* obj) {
+  return static_cast<ViEChannel*>(obj)->ChannelDeliverProcess();
+}
+
+bool ViEChannel::ChannelDeliverProcess() {
+  DecodedFrame decoded_frame;
+  {
+    CriticalSectionScoped cs(deliver_cs_.get());
+    if (deliver_queue_.empty()) {
+      deliver_queue_changed_->SleepCS(*deliver_cs_, kMaxDecodeWaitTimeMs);
+      if (deliver_queue_.empty())
+        return true;
+    }
+    decoded_frame = deliver_queue_.front();
+    deliver_queue_.pop_front();
+  }
+  Clock* clock = Clock::GetRealTimeClock();
+  const int64_t start_ms = clock->TimeInMilliseconds();
+  DeliverDecodedFrame(&decoded_frame.frame);
+  const int64_t deliver_ms = clock->TimeInMilliseconds() - start_ms;
+
+  CriticalSectionScoped cs(callback_cs_.get());
+  if (receive_statistics_proxy_ != NULL) {
+    receive_statistics_proxy_->OnDeliveredFrame(
+        static_cast<int>(start_ms - decoded_frame.queued_ms),
+        static_cast<int>(deliver_ms));
+  }
   return true;
 }
 
@@ -1842,6 +1942,16 @@ int32_t ViEChannel::StartDecodeThread() {
                                                this, "DecodingThread");
   decode_thread_->Start();
   decode_thread_->SetPriority(kHighestPriority);
+  if (pipelined_decoding_) {
+    assemble_thread_ = ThreadWrapper::CreateThread(
+        ChannelAssembleThreadFunction, this, "FrameAssemblyThread");
+    assemble_thread_->Start();
+    assemble_thread_->SetPriority(kHighestPriority);
+    deliver_thread_ = ThreadWrapper::CreateThread(
+        ChannelDeliverThreadFunction, this, "FrameDeliveryThread");
+    deliver_thread_->Start();
+    deliver_thread_->SetPriority(kHighestPriority);
+  }
   return 0;
 }
 
@@ -1850,10 +1960,25 @@ int32_t ViEChannel::StopDecodeThread() {
     return 0;
   }
 
+  // Also drops the frames queued for decoding when decoding is pipelined.
   vcm_->TriggerDecoderShutdown();
 
+  if (assemble_thread_) {
+    assemble_thread_->Stop();
+    assemble_thread_.reset();
+  }
   decode_thread_->Stop();
   decode_thread_.reset();
+  if (deliver_thread_) {
+    {
+      CriticalSectionScoped cs(deliver_cs_.get());
+      deliver_queue_changed_->WakeAll();
+    }
+    deliver_thread_->Stop();
+    deliver_thread_.reset();
+    CriticalSectionScoped cs(deliver_cs_.get());
+    deliver_queue_.clear();
+  }
 
   return 0;
 }
@@ -1946,7 +2071,7 @@ void ViEChannel::RegisterSendFrameCountObserver(
 void ViEChannel::RegisterReceiveStatisticsProxy(
     ReceiveStatisticsProxy* receive_statistics_proxy) {
   CriticalSectionScoped cs(callback_cs_.get());
-  vcm_receive_stats_callback_ = receive_statistics_proxy;
+  receive_statistics_proxy_ = receive_statistics_proxy;
 }
 
 void ViEChannel::ReceivedBWEPacket(int64_t arrival_time_ms,
@@ -11,7 +11,9 @@
 #ifndef WEBRTC_VIDEO_ENGINE_VIE_CHANNEL_H_
 #define WEBRTC_VIDEO_ENGINE_VIE_CHANNEL_H_
 
+#include <deque>
 #include <list>
+#include <vector>
 
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
@@ -29,11 +31,13 @@
 #include "webrtc/video_engine/vie_receiver.h"
 #include "webrtc/video_engine/vie_sender.h"
 #include "webrtc/video_engine/vie_sync_module.h"
+#include "webrtc/video_frame.h"
 
 namespace webrtc {
 
 class CallStatsObserver;
 class ChannelStatsObserver;
+class ConditionVariableWrapper;
 class Config;
 class CriticalSectionWrapper;
 class EncodedImageCallback;
@@ -101,6 +105,10 @@ class ViEChannel
                                  uint32_t* num_delta_frames);
   uint32_t DiscardedPackets() const;
 
+  // Returns the number of decoded frames dropped because the deliver thread
+  // of pipelined decoding didn't keep up.
+  int DroppedDecodedFrames() const;
+
   // Returns the estimated delay in milliseconds.
   int ReceiveDelay() const;
 
@@ -304,6 +312,11 @@ class ViEChannel
 
   int32_t EnableColorEnhancement(bool enable);
 
+  // Runs frame assembly, decoding and delivery of decoded frames on separate
+  // threads connected by bounded queues, instead of on one decode thread.
+  // Can only be changed while not receiving.
+  int32_t SetPipelinedDecoding(bool enable);
+
   // Gets the modules used by the channel.
   RtpRtcp* rtp_rtcp();
   scoped_refptr<PayloadRouter> send_payload_router();
@@ -326,6 +339,7 @@ class ViEChannel
   void OnReceiveRatesUpdated(uint32_t bit_rate, uint32_t frame_rate) override;
   void OnDiscardedPacketsUpdated(int discarded_packets) override;
   void OnFrameCountsUpdated(const FrameCounts& frame_counts) override;
+  void OnDecodeQueueDelay(int delay_ms) override;
 
   // Implements VCMDecoderTimingCallback.
   virtual void OnDecoderTiming(int decode_ms,
@@ -372,6 +386,10 @@ class ViEChannel
  protected:
   static bool ChannelDecodeThreadFunction(void* obj);
   bool ChannelDecodeProcess();
+  static bool ChannelAssembleThreadFunction(void* obj);
+  bool ChannelAssembleProcess();
+  static bool ChannelDeliverThreadFunction(void* obj);
+  bool ChannelDeliverProcess();
 
   void OnRttUpdate(int64_t rtt);
 
@@ -392,6 +410,9 @@ class ViEChannel
   int32_t StartDecodeThread();
   int32_t StopDecodeThread();
 
+  // Runs the frame callbacks and delivers |video_frame| to the renderers.
+  void DeliverDecodedFrame(I420VideoFrame* video_frame);
+
   int32_t ProcessNACKRequest(const bool enable);
   int32_t ProcessFECRequest(const bool enable,
                             const unsigned char payload_typeRED,
@@ -514,8 +535,7 @@ class ViEChannel
   rtc::scoped_ptr<ChannelStatsObserver> stats_observer_;
 
   // Not owned.
-  VCMReceiveStatisticsCallback* vcm_receive_stats_callback_
-      GUARDED_BY(callback_cs_);
+  ReceiveStatisticsProxy* receive_statistics_proxy_ GUARDED_BY(callback_cs_);
   FrameCounts receive_frame_counts_ GUARDED_BY(callback_cs_);
   ProcessThread& module_process_thread_;
   ViEDecoderObserver* codec_observer_;
@@ -539,6 +559,8 @@ class ViEChannel
   rtc::scoped_ptr<ThreadWrapper> decode_thread_;
 
   ViEEffectFilter* effect_filter_;
+  // Frame handed to |effect_filter_|, kept to not reallocate it per frame.
+  std::vector<uint8_t> effect_buffer_;
   bool color_enhancement_;
 
   // User set MTU, -1 if not set.
@@ -553,6 +575,22 @@ class ViEChannel
 
   rtc::scoped_ptr<ReportBlockStats> report_block_stats_sender_;
   rtc::scoped_ptr<ReportBlockStats> report_block_stats_receiver_;
+
+  // Pipelined decoding, see SetPipelinedDecoding().
+  struct DecodedFrame {
+    I420VideoFrame frame;
+    int64_t queued_ms;
+  };
+  bool pipelined_decoding_;
+  rtc::scoped_ptr<ThreadWrapper> assemble_thread_;
+  rtc::scoped_ptr<ThreadWrapper> deliver_thread_;
+  rtc::scoped_ptr<CriticalSectionWrapper> deliver_cs_;
+  // Signaled when a frame is queued, and on shutdown.
+  rtc::scoped_ptr<ConditionVariableWrapper> deliver_queue_changed_;
+  // Decoded frames waiting for the deliver thread.
+  std::deque<DecodedFrame> deliver_queue_ GUARDED_BY(deliver_cs_);
+  // Decoded frames dropped because the deliver thread didn't keep up.
+  int dropped_decoded_frames_ GUARDED_BY(deliver_cs_);
 };
 
 }  // namespace webrtc
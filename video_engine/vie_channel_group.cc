@@ -139,7 +139,8 @@ class WrappingBitrateEstimator : public RemoteBitrateEstimator {
 };
 }  // namespace
 
-ChannelGroup::ChannelGroup(ProcessThread* process_thread, const Config* config)
+ChannelGroup::ChannelGroup(const std::vector<ProcessThread*>& process_threads,
+                           const Config* config)
     : remb_(new VieRemb()),
       bitrate_allocator_(new BitrateAllocator()),
       bitrate_controller_(
@@ -149,7 +150,8 @@ ChannelGroup::ChannelGroup(ProcessThread* process_thread, const Config* config)
       encoder_state_feedback_(new EncoderStateFeedback()),
       config_(config),
       own_config_(),
-      process_thread_(process_thread) {
+      process_threads_(process_threads) {
+  DCHECK(!process_threads_.empty());
   if (!config) {
     own_config_.reset(new Config);
     config_ = own_config_.get();
@@ -163,15 +165,17 @@ ChannelGroup::ChannelGroup(ProcessThread* process_thread, const Config* config)
 
   call_stats_->RegisterStatsObserver(remote_bitrate_estimator_.get());
 
+  ProcessThread* process_thread = process_threads_[0];
   process_thread->RegisterModule(remote_bitrate_estimator_.get());
   process_thread->RegisterModule(call_stats_.get());
   process_thread->RegisterModule(bitrate_controller_.get());
 }
 
 ChannelGroup::~ChannelGroup() {
-  process_thread_->DeRegisterModule(bitrate_controller_.get());
-  process_thread_->DeRegisterModule(call_stats_.get());
-  process_thread_->DeRegisterModule(remote_bitrate_estimator_.get());
+  ProcessThread* process_thread = process_threads_[0];
+  process_thread->DeRegisterModule(bitrate_controller_.get());
+  process_thread->DeRegisterModule(call_stats_.get());
+  process_thread->DeRegisterModule(remote_bitrate_estimator_.get());
   call_stats_->DeregisterStatsObserver(remote_bitrate_estimator_.get());
   DCHECK(channels_.empty());
   DCHECK(channel_map_.empty());
@@ -184,8 +188,9 @@ bool ChannelGroup::CreateSendChannel(int channel_id,
                                      int number_of_cores,
                                      bool disable_default_encoder) {
   rtc::scoped_ptr<ViEEncoder> vie_encoder(new ViEEncoder(
-      channel_id, number_of_cores, *config_, *process_thread_,
-      bitrate_allocator_.get(), bitrate_controller_.get(), false));
+      channel_id, number_of_cores, *config_,
+      *ProcessThreadForChannel(channel_id), bitrate_allocator_.get(),
+      bitrate_controller_.get(), false));
   if (!vie_encoder->Init()) {
     return false;
   }
@@ -229,7 +234,8 @@ bool ChannelGroup::CreateChannel(int channel_id,
   DCHECK(vie_encoder);
 
   rtc::scoped_ptr<ViEChannel> channel(new ViEChannel(
-      channel_id, engine_id, number_of_cores, *config_, *process_thread_,
+      channel_id, engine_id, number_of_cores, *config_,
+      *ProcessThreadForChannel(channel_id),
       encoder_state_feedback_->GetRtcpIntraFrameObserver(),
       bitrate_controller_->CreateRtcpBandwidthObserver(),
       remote_bitrate_estimator_.get(), call_stats_->rtcp_rtt_stats(),
@@ -336,6 +342,10 @@ ViEEncoder* ChannelGroup::GetEncoder(int channel_id) const {
   return it->second;
 }
 
+ProcessThread* ChannelGroup::ProcessThreadForChannel(int channel_id) const {
+  return process_threads_[channel_id % process_threads_.size()];
+}
+
 ViEChannel* ChannelGroup::PopChannel(int channel_id) {
   ChannelMap::iterator c_it = channel_map_.find(channel_id);
   DCHECK(c_it != channel_map_.end());
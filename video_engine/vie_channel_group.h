@@ -38,7 +38,10 @@ typedef std::list<ViEChannel*> ChannelList;
 // group are assumed to send/receive data to the same end-point.
 class ChannelGroup : public BitrateObserver {
  public:
-  ChannelGroup(ProcessThread* process_thread, const Config* config);
+  // Modules shared by the channels of the group run on the first of
+  // |process_threads|, the channels are spread over all of them.
+  ChannelGroup(const std::vector<ProcessThread*>& process_threads,
+               const Config* config);
   ~ChannelGroup();
   bool CreateSendChannel(int channel_id,
                          int engine_id,
@@ -88,6 +91,7 @@ class ChannelGroup : public BitrateObserver {
                      ViEEncoder* vie_encoder,
                      bool sender,
                      bool disable_default_encoder);
+  ProcessThread* ProcessThreadForChannel(int channel_id) const;
   ViEChannel* PopChannel(int channel_id);
   ViEEncoder* PopEncoder(int channel_id);
 
@@ -106,7 +110,7 @@ class ChannelGroup : public BitrateObserver {
   rtc::scoped_ptr<Config> own_config_;
 
   // Registered at construct time and assumed to outlive this class.
-  ProcessThread* process_thread_;
+  const std::vector<ProcessThread*> process_threads_;
 };
 
 }  // namespace webrtc
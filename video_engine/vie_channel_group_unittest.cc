@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <set>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/modules/interface/module.h"
+#include "webrtc/modules/utility/interface/process_thread.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/video_engine/vie_channel.h"
+#include "webrtc/video_engine/vie_channel_group.h"
+
+namespace webrtc {
+namespace {
+
+// Keeps track of the modules registered on it instead of processing them.
+class ModuleRecordingProcessThread : public ProcessThread {
+ public:
+  void Start() override {}
+  void Stop() override {}
+  void WakeUp(Module* module) override {}
+  void PostTask(rtc::scoped_ptr<ProcessTask> task) override {}
+
+  void RegisterModule(Module* module) override {
+    rtc::CritScope lock(&crit_);
+    EXPECT_TRUE(modules_.insert(module).second) << "Registered twice.";
+  }
+  void DeRegisterModule(Module* module) override {
+    rtc::CritScope lock(&crit_);
+    modules_.erase(module);
+  }
+
+  bool HasModule(Module* module) const {
+    rtc::CritScope lock(&crit_);
+    return modules_.find(module) != modules_.end();
+  }
+  size_t num_modules() const {
+    rtc::CritScope lock(&crit_);
+    return modules_.size();
+  }
+
+ private:
+  mutable rtc::CriticalSection crit_;
+  std::set<Module*> modules_;
+};
+
+}  // namespace
+
+// Creates a send channel and receive channels sharing its encoder, the way a
+// Call with many streams does, and checks where their modules end up.
+TEST(ChannelGroupTest, SpreadsChannelsOverProcessThreads) {
+  const int kNumThreads = 4;
+  const int kNumChannels = 4 * kNumThreads + 1;
+  const int kSendChannelId = 0;
+  ScopedVector<ModuleRecordingProcessThread> threads;
+  std::vector<ProcessThread*> process_threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(new ModuleRecordingProcessThread());
+    process_threads.push_back(threads.back());
+  }
+
+  ChannelGroup group(process_threads, nullptr);
+  // The modules shared by the group all run on the first thread.
+  const size_t num_group_modules = threads[0]->num_modules();
+  EXPECT_GT(num_group_modules, 0u);
+  for (int i = 1; i < kNumThreads; ++i)
+    EXPECT_EQ(0u, threads[i]->num_modules());
+
+  ASSERT_TRUE(group.CreateSendChannel(kSendChannelId, 0, 1, false));
+  group.AddChannel(kSendChannelId);
+  for (int id = 1; id < kNumChannels; ++id) {
+    ASSERT_TRUE(group.CreateReceiveChannel(id, 0, kSendChannelId, 1, false));
+    group.AddChannel(id);
+  }
+
+  // Each channel runs on exactly one thread, picked by channel id.
+  std::vector<int> num_channels(kNumThreads, 0);
+  for (int id = 0; id < kNumChannels; ++id) {
+    RtpRtcp* rtp_rtcp = group.GetChannel(id)->rtp_rtcp();
+    for (int i = 0; i < kNumThreads; ++i) {
+      EXPECT_EQ(i == id % kNumThreads, threads[i]->HasModule(rtp_rtcp))
+          << "Channel " << id << ", thread " << i;
+    }
+    ++num_channels[id % kNumThreads];
+  }
+  // The channels are spread evenly, and so are their modules, apart from the
+  // ones of the group and of the encoder of the send channel.
+  const size_t modules_per_channel =
+      threads[1]->num_modules() / num_channels[1];
+  EXPECT_GT(modules_per_channel, 0u);
+  for (int i = 0; i < kNumThreads; ++i) {
+    EXPECT_LE(num_channels[i], kNumChannels / kNumThreads + 1);
+    EXPECT_GE(num_channels[i], kNumChannels / kNumThreads);
+    if (i != kSendChannelId % kNumThreads) {
+      EXPECT_EQ(num_channels[i] * modules_per_channel,
+                threads[i]->num_modules());
+    }
+  }
+
+  // All channel modules are removed again with the channels.
+  for (int id = kNumChannels - 1; id >= 0; --id)
+    group.DeleteChannel(id);
+  EXPECT_EQ(num_group_modules, threads[0]->num_modules());
+  for (int i = 1; i < kNumThreads; ++i)
+    EXPECT_EQ(0u, threads[i]->num_modules());
+}
+
+}  // namespace webrtc
@@ -37,8 +37,7 @@ ViEChannelManager::ViEChannelManager(int engine_id,
       number_of_cores_(number_of_cores),
       free_channel_ids_(new bool[kViEMaxNumberOfChannels]),
       free_channel_ids_size_(kViEMaxNumberOfChannels),
-      voice_sync_interface_(NULL),
-      module_process_thread_(NULL) {
+      voice_sync_interface_(NULL) {
   for (int idx = 0; idx < free_channel_ids_size_; idx++) {
     free_channel_ids_[idx] = true;
   }
@@ -68,10 +67,11 @@ ViEChannelManager::~ViEChannelManager() {
   assert(channel_groups_.empty());
 }
 
-void ViEChannelManager::SetModuleProcessThread(
-    ProcessThread* module_process_thread) {
-  assert(!module_process_thread_);
-  module_process_thread_ = module_process_thread;
+void ViEChannelManager::SetModuleProcessThreads(
+    const std::vector<ProcessThread*>& module_process_threads) {
+  assert(module_process_threads_.empty());
+  assert(!module_process_threads.empty());
+  module_process_threads_ = module_process_threads;
 }
 
 int ViEChannelManager::CreateChannel(int* channel_id,
@@ -86,7 +86,7 @@ int ViEChannelManager::CreateChannel(int* channel_id,
 
   // Create a new channel group and add this channel.
   rtc::scoped_ptr<ChannelGroup> group(
-      new ChannelGroup(module_process_thread_, channel_group_config));
+      new ChannelGroup(module_process_threads_, channel_group_config));
 
   if (!group->CreateSendChannel(new_channel_id, engine_id_, number_of_cores_,
                                 false)) {
@@ -13,6 +13,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #include "webrtc/engine_configurations.h"
 #include "webrtc/typedefs.h"
@@ -44,7 +45,9 @@ class ViEChannelManager: private ViEManagerBase {
                     const Config& config);
   ~ViEChannelManager();
 
-  void SetModuleProcessThread(ProcessThread* module_process_thread);
+  // Channels are spread over |module_process_threads| by channel id.
+  void SetModuleProcessThreads(
+      const std::vector<ProcessThread*>& module_process_threads);
 
   // Creates a new channel. 'channel_id' will be the id of the created channel.
   int CreateChannel(int* channel_id,
@@ -123,7 +126,7 @@ class ViEChannelManager: private ViEManagerBase {
   // TODO(mflodman) Make part of channel group.
   VoEVideoSync* voice_sync_interface_;
 
-  ProcessThread* module_process_thread_;
+  std::vector<ProcessThread*> module_process_threads_;
 };
 
 class ViEChannelManagerScoped: private ViEManagerScopedBase {
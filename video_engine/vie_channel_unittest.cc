@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_video/interface/i420_video_frame.h"
+#include "webrtc/modules/utility/interface/process_thread.h"
+#include "webrtc/video_engine/vie_channel.h"
+#include "webrtc/video_engine/vie_channel_group.h"
+
+namespace webrtc {
+namespace {
+
+// Never processes the modules registered on it.
+class FakeProcessThread : public ProcessThread {
+ public:
+  void Start() override {}
+  void Stop() override {}
+  void WakeUp(Module* module) override {}
+  void PostTask(rtc::scoped_ptr<ProcessTask> task) override {}
+  void RegisterModule(Module* module) override {}
+  void DeRegisterModule(Module* module) override {}
+};
+
+}  // namespace
+
+// Decoded frames are queued for the deliver thread, which isn't running as
+// the channel isn't receiving. All but the two newest frames are dropped,
+// and every drop is counted.
+TEST(ViEChannelTest, CountsDroppedDecodedFrames) {
+  const int kSendChannelId = 0;
+  const int kChannelId = 1;
+  const int kNumFrames = 5;
+  FakeProcessThread process_thread;
+  ChannelGroup group(std::vector<ProcessThread*>(1, &process_thread),
+                     nullptr);
+  // A receive channel needs the encoder of a send channel.
+  ASSERT_TRUE(group.CreateSendChannel(kSendChannelId, 0, 1, false));
+  group.AddChannel(kSendChannelId);
+  ASSERT_TRUE(
+      group.CreateReceiveChannel(kChannelId, 0, kSendChannelId, 1, false));
+  group.AddChannel(kChannelId);
+  ViEChannel* channel = group.GetChannel(kChannelId);
+  ASSERT_TRUE(channel != nullptr);
+  ASSERT_EQ(0, channel->SetPipelinedDecoding(true));
+
+  I420VideoFrame frame;
+  frame.CreateEmptyFrame(16, 16, 16, 8, 8);
+  for (int i = 0; i < kNumFrames; ++i) {
+    frame.set_timestamp(3000 * i);
+    EXPECT_EQ(0, channel->FrameToRender(frame));
+    EXPECT_EQ(i < 2 ? 0 : i - 1, channel->DroppedDecodedFrames());
+  }
+
+  group.DeleteChannel(kChannelId);
+  group.DeleteChannel(kSendChannelId);
+}
+
+}  // namespace webrtc
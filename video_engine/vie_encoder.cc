@@ -591,10 +591,10 @@ void ViEEncoder::DeliverFrame(int id,
       if (effect_filter_) {
         size_t length =
             CalcBufferSize(kI420, video_frame->width(), video_frame->height());
-        rtc::scoped_ptr<uint8_t[]> video_buffer(new uint8_t[length]);
-        ExtractBuffer(*video_frame, length, video_buffer.get());
+        effect_buffer_.resize(length);
+        ExtractBuffer(*video_frame, length, &effect_buffer_[0]);
         effect_filter_->Transform(length,
-                                  video_buffer.get(),
+                                  &effect_buffer_[0],
                                   video_frame->ntp_time_ms(),
                                   video_frame->timestamp(),
                                   video_frame->width(),
@@ -235,6 +235,8 @@ class ViEEncoder
 
   ViEEncoderObserver* codec_observer_ GUARDED_BY(callback_cs_);
   ViEEffectFilter* effect_filter_ GUARDED_BY(callback_cs_);
+  // Frame handed to |effect_filter_|, kept to not reallocate it per frame.
+  std::vector<uint8_t> effect_buffer_ GUARDED_BY(callback_cs_);
   ProcessThread& module_process_thread_;
   rtc::scoped_ptr<ProcessThread> pacer_thread_;
 
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 
+#include "libyuv/convert.h"  // NOLINT
 #include "webrtc/base/checks.h"
 #include "webrtc/common_video/interface/i420_video_frame.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
@@ -67,7 +68,28 @@ void ViEFrameProviderBase::DeliverFrame(I420VideoFrame* video_frame,
           extra_frame_.reset(new I420VideoFrame());
         }
         // TODO(mflodman): We can get rid of this frame copy.
-        extra_frame_->CopyFrame(*video_frame);
+        // The previous copy may still be referenced by a callback, so copy
+        // into a buffer from the pool rather than reallocating. CopyFrame()
+        // would replace the pooled buffer with a new one.
+        extra_frame_->set_video_frame_buffer(buffer_pool_.CreateBuffer(
+            video_frame->width(), video_frame->height()));
+        libyuv::I420Copy(video_frame->buffer(kYPlane),
+                         video_frame->stride(kYPlane),
+                         video_frame->buffer(kUPlane),
+                         video_frame->stride(kUPlane),
+                         video_frame->buffer(kVPlane),
+                         video_frame->stride(kVPlane),
+                         extra_frame_->buffer(kYPlane),
+                         extra_frame_->stride(kYPlane),
+                         extra_frame_->buffer(kUPlane),
+                         extra_frame_->stride(kUPlane),
+                         extra_frame_->buffer(kVPlane),
+                         extra_frame_->stride(kVPlane),
+                         video_frame->width(), video_frame->height());
+        extra_frame_->set_timestamp(video_frame->timestamp());
+        extra_frame_->set_ntp_time_ms(video_frame->ntp_time_ms());
+        extra_frame_->set_render_time_ms(video_frame->render_time_ms());
+        extra_frame_->set_rotation(video_frame->rotation());
         callback->DeliverFrame(id_, extra_frame_.get(), csrcs);
       }
     }
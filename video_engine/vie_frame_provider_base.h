@@ -16,6 +16,7 @@
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/thread_checker.h"
 #include "webrtc/common_types.h"
+#include "webrtc/common_video/interface/i420_buffer_pool.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -98,6 +99,7 @@ class ViEFrameProviderBase {
 
  private:
   rtc::scoped_ptr<I420VideoFrame> extra_frame_;
+  I420BufferPool buffer_pool_;
   int frame_delay_;
 };
 
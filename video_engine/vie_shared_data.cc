@@ -8,9 +8,18 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+
+#if defined(WEBRTC_LINUX)
+#include <sched.h>
+#endif
+
+#include "webrtc/common.h"
 #include "webrtc/modules/utility/interface/process_thread.h"
 #include "webrtc/system_wrappers/interface/cpu_info.h"
+#include "webrtc/system_wrappers/interface/logging.h"
 #include "webrtc/system_wrappers/interface/trace.h"
+#include "webrtc/video_engine/include/vie_base.h"
 #include "webrtc/video_engine/vie_channel_manager.h"
 #include "webrtc/video_engine/vie_defines.h"
 #include "webrtc/video_engine/vie_input_manager.h"
@@ -19,17 +28,48 @@
 
 namespace webrtc {
 
+namespace {
+// Binds the thread it runs on to a core.
+class PinToCoreTask : public ProcessTask {
+ public:
+  explicit PinToCoreTask(int core) : core_(core) {}
+
+  void Run() override {
+#if defined(WEBRTC_LINUX)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core_, &cpu_set);
+    if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+      LOG(LS_WARNING) << "Failed to pin module process thread to core "
+                      << core_;
+    }
+#endif
+  }
+
+ private:
+  const int core_;
+};
+}  // namespace
+
 ViESharedData::ViESharedData(const Config& config)
     : number_cores_(CpuInfo::DetectNumberOfCores()),
       channel_manager_(new ViEChannelManager(0, number_cores_, config)),
       input_manager_(new ViEInputManager(0, config)),
       render_manager_(new ViERenderManager(0)),
-      module_process_thread_(ProcessThread::Create()),
       last_error_(0) {
   Trace::CreateTrace();
-  channel_manager_->SetModuleProcessThread(module_process_thread_.get());
-  input_manager_->SetModuleProcessThread(module_process_thread_.get());
-  module_process_thread_->Start();
+  const ModuleProcessThreads& threads = config.Get<ModuleProcessThreads>();
+  for (int i = 0; i < std::max(threads.num_threads, 1); ++i)
+    module_process_threads_.push_back(ProcessThread::Create().release());
+  channel_manager_->SetModuleProcessThreads(module_process_threads_.get());
+  input_manager_->SetModuleProcessThread(module_process_threads_[0]);
+  for (size_t i = 0; i < module_process_threads_.size(); ++i) {
+    module_process_threads_[i]->Start();
+    if (threads.pin_to_cores) {
+      module_process_threads_[i]->PostTask(rtc::scoped_ptr<ProcessTask>(
+          new PinToCoreTask(static_cast<int>(i) % number_cores_)));
+    }
+  }
 }
 
 ViESharedData::~ViESharedData() {
@@ -38,7 +78,8 @@ ViESharedData::~ViESharedData() {
   channel_manager_.reset();
   render_manager_.reset();
 
-  module_process_thread_->Stop();
+  for (ProcessThread* thread : module_process_threads_)
+    thread->Stop();
   Trace::ReturnTrace();
 }
 
@@ -17,6 +17,7 @@
 #include <map>
 
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
 
 namespace webrtc {
 
@@ -51,7 +52,8 @@ class ViESharedData {
   rtc::scoped_ptr<ViEChannelManager> channel_manager_;
   rtc::scoped_ptr<ViEInputManager> input_manager_;
   rtc::scoped_ptr<ViERenderManager> render_manager_;
-  rtc::scoped_ptr<ProcessThread> module_process_thread_;
+  // The first thread also runs the modules of the input manager.
+  ScopedVector<ProcessThread> module_process_threads_;
   mutable int last_error_;
 
   std::map<int, CpuOveruseObserver*> overuse_observers_;
@@ -79,6 +79,15 @@ class VideoReceiveStream {
     int min_playout_delay_ms = 0;
     int render_delay_ms = 0;
 
+    // Stage latencies of pipelined decoding, see Config::pipelined_decoding.
+    // The time decodable frames wait for the decoder, the time decoded frames
+    // wait for delivery and the time spent delivering them to the renderer.
+    int decode_queue_ms = 0;
+    int deliver_queue_ms = 0;
+    int deliver_ms = 0;
+    // Decoded frames dropped because delivery didn't keep up.
+    int dropped_decoded_frames = 0;
+
     int total_bitrate_bps = 0;
     int discarded_packets = 0;
 
@@ -96,7 +105,8 @@ class VideoReceiveStream {
           audio_channel_id(-1),
           pre_decode_callback(NULL),
           pre_render_callback(NULL),
-          target_delay_ms(0) {}
+          target_delay_ms(0),
+          pipelined_decoding(false) {}
     std::string ToString() const;
 
     // Decoders for every payload that we can receive.
@@ -184,6 +194,12 @@ class VideoReceiveStream {
     // Target delay in milliseconds. A positive value indicates this stream is
     // used for streaming instead of a real-time call.
     int target_delay_ms;
+
+    // Assemble frames in the jitter buffer, decode them and deliver them to
+    // the renderer on separate threads, connected by short queues, instead of
+    // doing all three on one thread. Lowers the end-to-end latency at high
+    // frame rates.
+    bool pipelined_decoding;
   };
 
   virtual void Start() = 0;
@@ -911,8 +911,10 @@ Channel::~Channel()
                      "~Channel() failed to de-register VAD callback"
                      " (Audio coding module)");
     }
-    // De-register modules in process thread
-    _moduleProcessThreadPtr->DeRegisterModule(_rtpRtcpModule.get());
+    // De-register modules in process thread. The channel is only attached to
+    // one once SetEngineInformation() has been called.
+    if (_moduleProcessThreadPtr)
+        _moduleProcessThreadPtr->DeRegisterModule(_rtpRtcpModule.get());
 
     // End of modules shutdown
 
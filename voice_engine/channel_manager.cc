@@ -11,6 +11,9 @@
 #include "webrtc/common.h"
 #include "webrtc/voice_engine/channel_manager.h"
 
+#include <algorithm>
+
+#include "webrtc/system_wrappers/interface/sleep.h"
 #include "webrtc/voice_engine/channel.h"
 
 namespace webrtc {
@@ -45,10 +48,19 @@ ChannelOwner& ChannelOwner::operator=(const ChannelOwner& other) {
 ChannelOwner::ChannelRef::ChannelRef(class Channel* channel)
     : channel(channel), ref_count(1) {}
 
+namespace {
+
+bool ChannelIdLess(const ChannelOwner& channel_owner, int32_t channel_id) {
+  return channel_owner.channel()->ChannelId() < channel_id;
+}
+
+}  // namespace
+
 ChannelManager::ChannelManager(uint32_t instance_id, const Config& config)
     : instance_id_(instance_id),
       last_channel_id_(-1),
       lock_(CriticalSectionWrapper::CreateCriticalSection()),
+      current_table_(0),
       config_(config) {}
 
 ChannelOwner ChannelManager::CreateChannel() {
@@ -64,46 +76,60 @@ ChannelOwner ChannelManager::CreateChannelInternal(const Config& config) {
   Channel::CreateChannel(channel, ++last_channel_id_, instance_id_, config);
   ChannelOwner channel_owner(channel);
 
-  CriticalSectionScoped crit(lock_.get());
-
-  channels_.push_back(channel_owner);
+  std::vector<ChannelOwner> references;
+  {
+    CriticalSectionScoped crit(lock_.get());
+    const int current = current_table_.Value();
+    std::vector<ChannelOwner>& next = channels_[1 - current];
+    next = channels_[current];
+    // Channel ids are mostly increasing, but two threads can create channels
+    // concurrently, so insert the channel at its sorted position.
+    next.insert(std::lower_bound(next.begin(), next.end(),
+                                 channel->ChannelId(), ChannelIdLess),
+                channel_owner);
+    SwapTables(&references);
+  }
 
   return channel_owner;
 }
 
 ChannelOwner ChannelManager::GetChannel(int32_t channel_id) {
-  CriticalSectionScoped crit(lock_.get());
-
-  for (size_t i = 0; i < channels_.size(); ++i) {
-    if (channels_[i].channel()->ChannelId() == channel_id)
-      return channels_[i];
-  }
-  return ChannelOwner(NULL);
+  const int table = BeginRead();
+  const std::vector<ChannelOwner>& channels = channels_[table];
+  std::vector<ChannelOwner>::const_iterator it = std::lower_bound(
+      channels.begin(), channels.end(), channel_id, ChannelIdLess);
+  ChannelOwner channel_owner(NULL);
+  if (it != channels.end() && it->channel()->ChannelId() == channel_id)
+    channel_owner = *it;
+  EndRead(table);
+  return channel_owner;
 }
 
 void ChannelManager::GetAllChannels(std::vector<ChannelOwner>* channels) {
-  CriticalSectionScoped crit(lock_.get());
-
-  *channels = channels_;
+  const int table = BeginRead();
+  *channels = channels_[table];
+  EndRead(table);
 }
 
 void ChannelManager::DestroyChannel(int32_t channel_id) {
   assert(channel_id >= 0);
-  // Holds a reference to a channel, this is used so that we never delete
-  // Channels while holding a lock, but rather when the method returns.
-  ChannelOwner reference(NULL);
+  // Holds references to the channels of the previous table, this is used so
+  // that we never delete Channels while holding a lock, but rather when the
+  // method returns.
+  std::vector<ChannelOwner> references;
   {
     CriticalSectionScoped crit(lock_.get());
-
-    for (std::vector<ChannelOwner>::iterator it = channels_.begin();
-         it != channels_.end();
-         ++it) {
-      if (it->channel()->ChannelId() == channel_id) {
-        reference = *it;
-        channels_.erase(it);
-        break;
-      }
-    }
+    const int current = current_table_.Value();
+    const std::vector<ChannelOwner>& channels = channels_[current];
+    std::vector<ChannelOwner>::const_iterator it = std::lower_bound(
+        channels.begin(), channels.end(), channel_id, ChannelIdLess);
+    if (it == channels.end() || it->channel()->ChannelId() != channel_id)
+      return;
+    std::vector<ChannelOwner>& next = channels_[1 - current];
+    next.reserve(channels.size() - 1);
+    next.assign(channels.begin(), it);
+    next.insert(next.end(), it + 1, channels.end());
+    SwapTables(&references);
   }
 }
 
@@ -113,14 +139,43 @@ void ChannelManager::DestroyAllChannels() {
   std::vector<ChannelOwner> references;
   {
     CriticalSectionScoped crit(lock_.get());
-    references = channels_;
-    channels_.clear();
+    // The table which is not current is already empty.
+    SwapTables(&references);
   }
 }
 
 size_t ChannelManager::NumOfChannels() const {
-  CriticalSectionScoped crit(lock_.get());
-  return channels_.size();
+  const int table = BeginRead();
+  const size_t num_channels = channels_[table].size();
+  EndRead(table);
+  return num_channels;
+}
+
+int ChannelManager::BeginRead() const {
+  while (true) {
+    const int table = current_table_.Value();
+    ++num_readers_[table];
+    // If a writer made the other table current before the read was marked, it
+    // may already have stopped waiting for readers of |table|. Retry with the
+    // new table in that case.
+    if (current_table_.Value() == table)
+      return table;
+    --num_readers_[table];
+  }
+}
+
+void ChannelManager::EndRead(int table) const {
+  --num_readers_[table];
+}
+
+void ChannelManager::SwapTables(std::vector<ChannelOwner>* references) {
+  const int previous = current_table_.Value();
+  current_table_.CompareExchange(1 - previous, previous);
+  // Reads are short, as they only copy references, so a writer rarely waits.
+  while (num_readers_[previous].Value() != 0)
+    SleepMs(1);
+  references->swap(channels_[previous]);
+  channels_[previous].clear();
 }
 
 ChannelManager::Iterator::Iterator(ChannelManager* channel_manager)
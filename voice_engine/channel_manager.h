@@ -52,8 +52,8 @@ class ChannelOwner {
 
   ChannelOwner& operator=(const ChannelOwner& other);
 
-  Channel* channel() { return channel_ref_->channel.get(); }
-  bool IsValid() { return channel_ref_->channel.get() != NULL; }
+  Channel* channel() const { return channel_ref_->channel.get(); }
+  bool IsValid() const { return channel_ref_->channel.get() != NULL; }
  private:
   // Shared instance of a Channel. Copying ChannelOwners increase the reference
   // count and destroying ChannelOwners decrease references. Channels are
@@ -67,6 +67,12 @@ class ChannelOwner {
   ChannelRef* channel_ref_;
 };
 
+// Channels are kept in a copy-on-write table, so that GetChannel() and
+// Iterator, which are used by every VoE API call and by the audio threads, never
+// take a lock. Writers (CreateChannel() and DestroyChannel()) are serialized by
+// |lock_|, copy the current table and make the copy current. Readers mark the
+// table they use, and writers wait for those reads to finish before they clear
+// the previous table.
 class ChannelManager {
  public:
   ChannelManager(uint32_t instance_id, const Config& config);
@@ -114,12 +120,30 @@ class ChannelManager {
   // Create a channel given a configuration, |config|.
   ChannelOwner CreateChannelInternal(const Config& config);
 
+  // Marks the start of a read of the current table and returns its index in
+  // |channels_|. The table stays unchanged until EndRead() is called.
+  int BeginRead() const;
+  void EndRead(int table) const;
+
+  // Makes the table which is not current, and which a writer has filled in,
+  // the current one. Waits until no reader uses the previous table, and then
+  // moves the references it holds to |references|, so that the caller can
+  // release them after |lock_| is released.
+  void SwapTables(std::vector<ChannelOwner>* references);
+
   uint32_t instance_id_;
 
   Atomic32 last_channel_id_;
 
+  // Serializes the writers.
   rtc::scoped_ptr<CriticalSectionWrapper> lock_;
-  std::vector<ChannelOwner> channels_;
+  // The current table, |channels_[current_table_]|, holds all channels sorted
+  // by channel id. The other table is empty, except while a writer builds the
+  // next table in it.
+  std::vector<ChannelOwner> channels_[2];
+  mutable Atomic32 current_table_;
+  // Number of readers of each table.
+  mutable Atomic32 num_readers_[2];
 
   const Config& config_;
 
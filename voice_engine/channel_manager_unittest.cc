@@ -0,0 +1,279 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/voice_engine/channel_manager.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common.h"
+#include "webrtc/modules/audio_device/include/fake_audio_device.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/voice_engine/channel.h"
+#include "webrtc/voice_engine/include/voe_base.h"
+#include "webrtc/voice_engine/include/voe_rtp_rtcp.h"
+
+namespace webrtc {
+namespace voe {
+
+TEST(ChannelManagerTest, GetsAndDestroysChannels) {
+  Config config;
+  ChannelManager channel_manager(0, config);
+  std::vector<int> channel_ids;
+  for (int i = 0; i < 3; ++i) {
+    ChannelOwner channel_owner = channel_manager.CreateChannel();
+    ASSERT_TRUE(channel_owner.IsValid());
+    channel_ids.push_back(channel_owner.channel()->ChannelId());
+  }
+  EXPECT_EQ(3u, channel_manager.NumOfChannels());
+
+  for (size_t i = 0; i < channel_ids.size(); ++i) {
+    ChannelOwner channel_owner = channel_manager.GetChannel(channel_ids[i]);
+    ASSERT_TRUE(channel_owner.IsValid());
+    EXPECT_EQ(channel_ids[i], channel_owner.channel()->ChannelId());
+  }
+
+  channel_manager.DestroyChannel(channel_ids[1]);
+  EXPECT_EQ(2u, channel_manager.NumOfChannels());
+  EXPECT_FALSE(channel_manager.GetChannel(channel_ids[1]).IsValid());
+  EXPECT_TRUE(channel_manager.GetChannel(channel_ids[0]).IsValid());
+  EXPECT_TRUE(channel_manager.GetChannel(channel_ids[2]).IsValid());
+  EXPECT_FALSE(channel_manager.GetChannel(channel_ids[2] + 1).IsValid());
+
+  // Destroying a channel which does not exist is a no-op.
+  channel_manager.DestroyChannel(channel_ids[1]);
+  EXPECT_EQ(2u, channel_manager.NumOfChannels());
+
+  channel_manager.DestroyAllChannels();
+  EXPECT_EQ(0u, channel_manager.NumOfChannels());
+  EXPECT_FALSE(channel_manager.GetChannel(channel_ids[0]).IsValid());
+}
+
+TEST(ChannelManagerTest, IteratorKeepsItsChannels) {
+  Config config;
+  ChannelManager channel_manager(0, config);
+  const int channel_id = channel_manager.CreateChannel().channel()->ChannelId();
+  channel_manager.CreateChannel();
+
+  ChannelManager::Iterator it(&channel_manager);
+  channel_manager.DestroyAllChannels();
+  // A new channel is not part of the iteration, and the destroyed channels are
+  // kept alive by the iterator.
+  channel_manager.CreateChannel();
+  ASSERT_TRUE(it.IsValid());
+  EXPECT_EQ(channel_id, it.GetChannel()->ChannelId());
+  int num_channels = 0;
+  for (; it.IsValid(); it.Increment()) {
+    ASSERT_TRUE(it.GetChannel() != NULL);
+    ++num_channels;
+  }
+  EXPECT_EQ(2, num_channels);
+  EXPECT_EQ(1u, channel_manager.NumOfChannels());
+}
+
+// Looks up channels directly on a ChannelManager from several threads, while
+// channels are created and destroyed.
+class ChannelManagerConcurrencyTest : public ::testing::Test {
+ protected:
+  static const int kNumStableChannels = 20;
+  static const int kNumThreads = 4;
+  static const int kNumCreateDestroyCalls = 200;
+
+  ChannelManagerConcurrencyTest() : channel_manager_(0, config_) {}
+
+  void SetUp() override {
+    for (int i = 0; i < kNumStableChannels; ++i) {
+      ChannelOwner channel_owner = channel_manager_.CreateChannel();
+      ASSERT_TRUE(channel_owner.IsValid());
+      stable_channels_.push_back(channel_owner.channel()->ChannelId());
+    }
+    // Channel ids are handed out in increasing order, so the lookups below
+    // cover all channels created by the test.
+    max_channel_id_ = stable_channels_.back() + kNumCreateDestroyCalls;
+  }
+
+  static bool LookupThreadFunc(void* obj) {
+    return static_cast<ChannelManagerConcurrencyTest*>(obj)->LookUpChannels();
+  }
+
+  // Every channel found must have the requested id, the stable channels must
+  // always be found, and an iteration must see the channels sorted by id.
+  bool LookUpChannels() {
+    int num_stable_channels_found = 0;
+    for (int id = 0; id <= max_channel_id_; ++id) {
+      ChannelOwner channel_owner = channel_manager_.GetChannel(id);
+      if (!channel_owner.IsValid())
+        continue;
+      if (channel_owner.channel()->ChannelId() != id)
+        ++num_errors_;
+      if (id <= stable_channels_.back())
+        ++num_stable_channels_found;
+    }
+    if (num_stable_channels_found != kNumStableChannels)
+      ++num_errors_;
+
+    int num_channels = 0;
+    int last_id = -1;
+    for (ChannelManager::Iterator it(&channel_manager_); it.IsValid();
+         it.Increment()) {
+      if (it.GetChannel()->ChannelId() <= last_id)
+        ++num_errors_;
+      last_id = it.GetChannel()->ChannelId();
+      ++num_channels;
+    }
+    if (num_channels < kNumStableChannels ||
+        num_channels > kNumStableChannels + 1) {
+      ++num_errors_;
+    }
+    ++num_reads_;
+    return true;
+  }
+
+  Config config_;
+  ChannelManager channel_manager_;
+  std::vector<int> stable_channels_;
+  int max_channel_id_;
+  Atomic32 num_reads_;
+  Atomic32 num_errors_;
+};
+
+TEST_F(ChannelManagerConcurrencyTest, LooksUpChannelsWhileChannelsChange) {
+  rtc::scoped_ptr<ThreadWrapper> threads[kNumThreads];
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads[i] = ThreadWrapper::CreateThread(LookupThreadFunc, this, "lookup");
+    ASSERT_TRUE(threads[i]->Start());
+  }
+  // Let the lookups get going, so that they overlap with the writes.
+  while (num_reads_.Value() < kNumThreads)
+    SleepMs(1);
+
+  int last_id = stable_channels_.back();
+  for (int i = 0; i < kNumCreateDestroyCalls; ++i) {
+    ChannelOwner channel_owner = channel_manager_.CreateChannel();
+    // The lookup threads are stopped below, so do not return early here.
+    EXPECT_TRUE(channel_owner.IsValid());
+    const int id = channel_owner.channel()->ChannelId();
+    EXPECT_GT(id, last_id);
+    last_id = id;
+    EXPECT_EQ(static_cast<size_t>(kNumStableChannels + 1),
+              channel_manager_.NumOfChannels());
+    channel_manager_.DestroyChannel(id);
+  }
+
+  for (int i = 0; i < kNumThreads; ++i)
+    EXPECT_TRUE(threads[i]->Stop());
+
+  EXPECT_EQ(0, num_errors_.Value());
+  EXPECT_EQ(static_cast<size_t>(kNumStableChannels),
+            channel_manager_.NumOfChannels());
+  channel_manager_.DestroyAllChannels();
+}
+
+// Calls VoERTP_RTCP and VoEBase APIs, which look up channels, from several
+// threads over many channels, while channels are created and deleted.
+class ChannelManagerStressTest : public ::testing::Test {
+ protected:
+  static const int kNumChannels = 500;
+  static const int kNumThreads = 4;
+  static const int kNumCreateDeleteCalls = 200;
+
+  struct ReaderThread {
+    ChannelManagerStressTest* test;
+    // The thread uses every |kNumThreads|th channel of |channels_|, starting
+    // with the |index|th, so that the threads do not overwrite each other's
+    // SSRCs.
+    int index;
+    unsigned int ssrc;
+    rtc::scoped_ptr<ThreadWrapper> thread;
+  };
+
+  ChannelManagerStressTest()
+      : voe_(VoiceEngine::Create()),
+        base_(VoEBase::GetInterface(voe_)),
+        rtp_rtcp_(VoERTP_RTCP::GetInterface(voe_)),
+        adm_(new FakeAudioDeviceModule) {}
+
+  ~ChannelManagerStressTest() {
+    rtp_rtcp_->Release();
+    base_->Release();
+    VoiceEngine::Delete(voe_);
+  }
+
+  void SetUp() override {
+    ASSERT_EQ(0, base_->Init(adm_.get(), NULL));
+    for (int i = 0; i < kNumChannels; ++i) {
+      const int channel = base_->CreateChannel();
+      ASSERT_NE(-1, channel);
+      channels_.push_back(channel);
+    }
+  }
+
+  static bool ReaderThreadFunc(void* obj) {
+    ReaderThread* reader = static_cast<ReaderThread*>(obj);
+    return reader->test->ReadChannels(reader);
+  }
+
+  bool ReadChannels(ReaderThread* reader) {
+    ++reader->ssrc;
+    for (size_t i = reader->index; i < channels_.size(); i += kNumThreads) {
+      unsigned int ssrc = 0;
+      if (rtp_rtcp_->SetLocalSSRC(channels_[i], reader->ssrc) != 0 ||
+          rtp_rtcp_->GetLocalSSRC(channels_[i], ssrc) != 0 ||
+          ssrc != reader->ssrc) {
+        ++num_errors_;
+      }
+    }
+    ++num_reads_;
+    return true;
+  }
+
+  VoiceEngine* voe_;
+  VoEBase* base_;
+  VoERTP_RTCP* rtp_rtcp_;
+  rtc::scoped_ptr<FakeAudioDeviceModule> adm_;
+  std::vector<int> channels_;
+  Atomic32 num_reads_;
+  Atomic32 num_errors_;
+};
+
+TEST_F(ChannelManagerStressTest, LooksUpChannelsWhileChannelsChange) {
+  ReaderThread readers[kNumThreads];
+  for (int i = 0; i < kNumThreads; ++i) {
+    readers[i].test = this;
+    readers[i].index = i;
+    readers[i].ssrc = i * 1000000;
+    readers[i].thread =
+        ThreadWrapper::CreateThread(ReaderThreadFunc, &readers[i], "reader");
+    ASSERT_TRUE(readers[i].thread->Start());
+  }
+  // Let the readers get going, so that they overlap with the writes.
+  while (num_reads_.Value() < kNumThreads)
+    SleepMs(1);
+
+  for (int i = 0; i < kNumCreateDeleteCalls; ++i) {
+    // The readers are stopped below, so do not return early here.
+    const int channel = base_->CreateChannel();
+    EXPECT_NE(-1, channel);
+    EXPECT_EQ(0, base_->DeleteChannel(channel));
+  }
+
+  for (int i = 0; i < kNumThreads; ++i)
+    EXPECT_TRUE(readers[i].thread->Stop());
+
+  EXPECT_EQ(0, num_errors_.Value());
+  for (size_t i = 0; i < channels_.size(); ++i)
+    EXPECT_EQ(0, base_->DeleteChannel(channels_[i]));
+}
+
+}  // namespace voe
+}  // namespace webrtc
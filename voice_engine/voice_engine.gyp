@@ -121,6 +121,7 @@
             '<(webrtc_root)/test/test.gyp:test_support_main',
           ],
           'sources': [
+            'channel_manager_unittest.cc',
             'channel_unittest.cc',
             'network_predictor_unittest.cc',
             'transmit_mixer_unittest.cc',